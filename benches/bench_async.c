@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_async.c */
+
+#include <core/fmt/tobuf.h>
+#include <core/mem/sysalc.h>
+#include <core/msg/asrt.h>
+#include <std/alloc/bump.h>
+#include <std/async/runtime.h>
+#include <std/test/bench.h>
+#include <fcntl.h>    // open
+#include <sys/stat.h> // mkdir
+#include <unistd.h>   // read, write, close, unlink
+
+#define NFILES 4000
+#define FILE_BYTES (16 * 1024)
+#define CHUNK (64 * 1024)
+#define ITERS 3
+
+static SystemAlloc g_sys;
+
+DEFINE_ALLOC_RELEASER(Bump, BUMP)
+
+static char g_dir[64];
+static char g_paths[NFILES][96];
+
+/* 每读到一块数据做的 CPU 工作: FNV-1a */
+static u64
+checksum(u64 h, const u8 *data, usize len)
+{
+  for (usize i = 0; i < len; i++)
+  {
+    h = (h ^ data[i]) * 0x100000001B3ull;
+  }
+  return h;
+}
+
+/*
+ * ===================================================================
+ * 基线: 一个线程顺序地阻塞读取
+ * ===================================================================
+ */
+
+static u64
+read_all_blocking(void)
+{
+  static u8 buf[CHUNK];
+  u64 total = 0;
+  for (usize i = 0; i < NFILES; i++)
+  {
+    int fd = open(g_paths[i], O_RDONLY);
+    u64 h = 0xCBF29CE484222325ull;
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0)
+    {
+      h = checksum(h, buf, (usize)n);
+    }
+    close(fd);
+    total += h;
+  }
+  return total;
+}
+
+/*
+ * ===================================================================
+ * 协程: open, 分块 read + 校验, close
+ * ===================================================================
+ */
+
+typedef struct Reader
+{
+  AsyncTask task;
+  const char *path;
+  i32 fd;
+  u64 off;
+  u64 hash;
+  u64 *total;
+  u8 buf[CHUNK];
+} Reader;
+
+static AsyncPoll
+reader(AsyncTask *t)
+{
+  Reader *r = (Reader *)t;
+  ASYNC_BEGIN(t);
+  ASYNC_AWAIT_OPEN(t, r->path, O_RDONLY, 0);
+  if (t->io_result < 0)
+    ASYNC_RETURN(t);
+  r->fd = (i32)t->io_result;
+  r->hash = 0xCBF29CE484222325ull;
+  for (;;)
+  {
+    ASYNC_AWAIT_READ(t, r->fd, r->buf, CHUNK, r->off);
+    if (t->io_result <= 0)
+      break;
+    r->hash = checksum(r->hash, r->buf, (usize)t->io_result);
+    r->off += (u64)t->io_result;
+  }
+  *r->total += r->hash;
+  ASYNC_AWAIT_CLOSE(t, r->fd);
+  ASYNC_END(t);
+}
+
+/* 每轮的协程帧都从 arena 分配, 结束后整体重置 */
+static u64
+read_all_async(AsyncRt *rt, Bump *arena)
+{
+  u64 total = 0;
+  for (usize i = 0; i < NFILES; i++)
+  {
+    Reader *r = ASYNC_NEW(BUMP, arena, Reader, reader);
+    r->path = g_paths[i];
+    r->total = &total;
+    async_spawn(rt, &r->task);
+  }
+  async_rt_run(rt);
+  bump_reset(arena);
+  return total;
+}
+
+int
+main(void)
+{
+  format_to_buf(g_dir, sizeof(g_dir), "/tmp/libkx_bench_async_{}", (i64)getpid());
+  mkdir(g_dir, 0700);
+  static u8 content[FILE_BYTES];
+  for (usize i = 0; i < NFILES; i++)
+  {
+    format_to_buf(g_paths[i], sizeof(g_paths[i]), "{}/{}", (str)g_dir, i);
+    for (usize k = 0; k < FILE_BYTES; k++)
+    {
+      content[k] = (u8)(i + k * 13);
+    }
+    int fd = open(g_paths[i], O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (write(fd, content, FILE_BYTES) != FILE_BYTES)
+    {
+      panic("Failed to create {}", (str)g_paths[i]);
+    }
+    close(fd);
+  }
+
+  /* 文件刚写完, 都在页缓存中: 结果反映的是每个文件的系统调用与调度开销 */
+  BENCH_GROUP("4000 files x 16 KiB, open + read + FNV-1a + close (ns per pass)");
+  u64 expect = read_all_blocking();
+  u64 sink = 0;
+  BENCH("blocking, sequential", ITERS, { sink += read_all_blocking(); });
+
+  Bump arena;
+  bump_init(&arena, &g_sys);
+  static const AsyncBackend backends[] = {ASYNC_BACKEND_THREADS, ASYNC_BACKEND_URING};
+  static const usize entries[] = {32, 256};
+  for (usize b = 0; b < 2; b++)
+  {
+    for (usize e = 0; e < 2; e++)
+    {
+      AsyncConfig cfg = {.backend = backends[b], .entries = entries[e]};
+      Option_AsyncRtPtr opt = async_rt_new(&g_sys, &cfg);
+      if (!ois_some(opt))
+      {
+        format_to_file(stdout, "  (io_uring unavailable, skipped)\n");
+        break;
+      }
+      AsyncRt *rt = opt.value.some;
+      asrt_msg(read_all_async(rt, &arena) == expect, "Async read produced a different checksum");
+      char label[64];
+      format_to_buf(label,
+                    sizeof(label),
+                    "async {}, {} in flight",
+                    (str)(backends[b] == ASYNC_BACKEND_URING ? "io_uring" : "threads"),
+                    entries[e]);
+      BENCH(label, ITERS, { sink += read_all_async(rt, &arena); });
+      async_rt_free(rt);
+    }
+  }
+  bench_clobber(&sink);
+  bump_destroy(&arena);
+
+  for (usize i = 0; i < NFILES; i++)
+  {
+    unlink(g_paths[i]);
+  }
+  rmdir(g_dir);
+  return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_async_log.c */
+
+#include <core/fmt/tofile.h>
+#include <std/log/async.h>
+#include <std/test/bench.h>
+#include <fcntl.h> // open
+#include <stdio.h>
+#include <threads.h>
+#include <unistd.h> // close
+
+#define LINES_PER_THREAD 200000
+#define MAX_THREADS 4
+
+static FILE *g_unbuffered;
+
+static int
+stdio_producer(void *arg)
+{
+  u64 id = (u64)(uintptr_t)arg;
+  for (u64 i = 0; i < LINES_PER_THREAD; i++)
+  {
+    format_to_file(g_unbuffered, "[worker {}] step {} t={}\n", id, i, (f64)i * 0.25);
+  }
+  return 0;
+}
+
+static int
+async_producer(void *arg)
+{
+  u64 id = (u64)(uintptr_t)arg;
+  for (u64 i = 0; i < LINES_PER_THREAD; i++)
+  {
+    format_to_async("[worker {}] step {} t={}\n", id, i, (f64)i * 0.25);
+  }
+  return 0;
+}
+
+/* 启动 nthreads 个生产者并计时 (包含最后的冲刷) */
+static u64
+run(thrd_start_t producer, int nthreads, bool async)
+{
+  thrd_t threads[MAX_THREADS];
+  u64 t0 = bench_now_ns();
+  for (int t = 0; t < nthreads; t++)
+  {
+    thrd_create(&threads[t], producer, (void *)(uintptr_t)t);
+  }
+  for (int t = 0; t < nthreads; t++)
+  {
+    thrd_join(threads[t], NULL);
+  }
+  if (async)
+  {
+    async_log_flush();
+  }
+  return bench_now_ns() - t0;
+}
+
+int
+main(void)
+{
+  g_unbuffered = fopen("/dev/null", "w");
+  int fd = open("/dev/null", O_WRONLY);
+  if (g_unbuffered == NULL || fd < 0)
+  {
+    return 1;
+  }
+  setvbuf(g_unbuffered, NULL, _IONBF, 0);
+
+  BENCH_GROUP("log lines from N threads (stderr-like sink)");
+  async_log_start(fd, 5);
+  for (int n = 1; n <= MAX_THREADS; n *= 2)
+  {
+    u64 lines = (u64)n * LINES_PER_THREAD;
+    format_to_file(stdout, "  threads = {}\n", n);
+    bench_report("  format_to_file (unbuffered FILE*)", lines, run(stdio_producer, n, false));
+    bench_report("  format_to_async (batched writev)", lines, run(async_producer, n, true));
+  }
+  async_log_stop();
+
+  fclose(g_unbuffered);
+  close(fd);
+  return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_binlog.c */
+
+#include <core/fmt/tofd.h>
+#include <std/log/binlog.h>
+#include <std/test/bench.h>
+#include <fcntl.h>  // open
+#include <unistd.h> // close
+
+#define ITERS 1000000
+
+/* 每写这么多条就解码一次, 保证环形缓冲区不会写满 */
+#define DRAIN_EVERY 512
+
+static u64 g_ids[16];
+static f64 g_doubles[16];
+static str g_names[4] = {"parser", "lexer", "codegen", "linker"};
+
+static void
+init_args(void)
+{
+  u64 seed = 0x243f6a8885a308d3ull;
+  for (usize i = 0; i < 16; i++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    g_ids[i] = seed;
+    g_doubles[i] = (f64)(seed >> 11) / (f64)(1ull << 40);
+  }
+}
+
+static void
+bench_hot_path(int fd)
+{
+  BENCH_GROUP("log line, caller-side cost");
+
+  /* 只测记录本身: 解码在计时之外完成 */
+  u64 record_ns = 0;
+  for (u64 done = 0; done < ITERS; done += DRAIN_EVERY)
+  {
+    u64 t0 = bench_now_ns();
+    for (u64 i = done; i < done + DRAIN_EVERY; i++)
+    {
+      binlog("[{}] id={} t={} step {}", g_names[i & 3], g_ids[i & 15], g_doubles[i & 15], i);
+    }
+    record_ns += bench_now_ns() - t0;
+    binlog_drain_to_fd(fd);
+  }
+  bench_report("binlog (record only)", ITERS, record_ns);
+
+  BENCH("format_to_fd (format + write)", ITERS, {
+    u64 i = __bench_i;
+    format_to_fd(fd,
+                 "[{}] id={} t={} step {}\n",
+                 g_names[i & 3],
+                 g_ids[i & 15],
+                 g_doubles[i & 15],
+                 i);
+  });
+
+  /* 记录 + 解码的总吞吐 */
+  BENCH("binlog + drain (end to end)", ITERS, {
+    u64 i = __bench_i;
+    binlog("[{}] id={} t={} step {}", g_names[i & 3], g_ids[i & 15], g_doubles[i & 15], i);
+    if ((i % DRAIN_EVERY) == DRAIN_EVERY - 1)
+    {
+      binlog_drain_to_fd(fd);
+    }
+  });
+  binlog_drain_to_fd(fd);
+}
+
+int
+main(void)
+{
+  init_args();
+  int fd = open("/dev/null", O_WRONLY);
+  if (fd < 0)
+  {
+    return 1;
+  }
+  bench_hot_path(fd);
+  close(fd);
+  return 0;
+}
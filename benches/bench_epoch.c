@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_epoch.c */
+
+#include <core/mem/sysalc.h>
+#include <std/test/bench.h>
+#include <std/thread/epoch.h>
+#include <threads.h>
+
+#define READS 10000000
+#define RETIRES 1000000
+
+static SystemAlloc g_sys;
+
+DEFINE_ALLOC_RELEASER(SystemAlloc, SYSTEM)
+
+typedef struct Node
+{
+  u64 value;
+  struct Node *next;
+} Node;
+
+int
+main(void)
+{
+  EpochDomain *d = oexpect(epoch_domain_new(&g_sys), "Failed to create domain");
+  EpochHandle *h = epoch_register(d);
+
+  Node shared = {.value = 1, .next = NULL};
+  _Atomic(Node *) head = &shared;
+  u64 sink = 0;
+
+  /* 读路径: 保护一次共享指针读取的代价 */
+  BENCH_GROUP("read-side protection, per read");
+  BENCH("unprotected load", READS, {
+    sink += atomic_load_explicit(&head, memory_order_acquire)->value;
+  });
+  BENCH("epoch_pin / epoch_unpin", READS, {
+    epoch_pin(h);
+    sink += atomic_load_explicit(&head, memory_order_acquire)->value;
+    epoch_unpin(h);
+  });
+  _Atomic usize refcount = 0;
+  BENCH("atomic refcount inc / dec", READS, {
+    atomic_fetch_add(&refcount, 1);
+    sink += atomic_load_explicit(&head, memory_order_acquire)->value;
+    atomic_fetch_sub(&refcount, 1);
+  });
+  mtx_t lock;
+  mtx_init(&lock, mtx_plain);
+  BENCH("mtx_lock / mtx_unlock", READS, {
+    mtx_lock(&lock);
+    sink += atomic_load_explicit(&head, memory_order_acquire)->value;
+    mtx_unlock(&lock);
+  });
+  mtx_destroy(&lock);
+
+  /* 写路径: 分配后立即释放, 对比退休后批量释放 */
+  BENCH_GROUP("write-side, per alloc + free");
+  BENCH("immediate RELEASE", RETIRES, {
+    Node *n = ALLOC(SYSTEM, &g_sys, LAYOUT_OF(Node));
+    bench_clobber(n);
+    RELEASE(SYSTEM, &g_sys, n, LAYOUT_OF(Node));
+  });
+  BENCH("EPOCH_RETIRE (batched)", RETIRES, {
+    Node *n = ALLOC(SYSTEM, &g_sys, LAYOUT_OF(Node));
+    bench_clobber(n);
+    EPOCH_RETIRE(h, SYSTEM, &g_sys, n, LAYOUT_OF(Node));
+  });
+  bench_clobber(&sink);
+
+  epoch_unregister(h);
+  epoch_domain_free(d);
+  return 0;
+}
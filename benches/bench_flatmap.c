@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_flatmap.c */
+
+#include <core/mem/sysalc.h>
+#include <std/flatmap.h>
+#include <std/hashmap.h>
+#include <std/test/bench.h>
+
+/* 4M 个键, 从 [0, 4 * N) 中随机选取 (平均间隔 4) */
+#define N (4u << 20)
+#define QUERIES (1u << 20)
+
+/* 区间查询的宽度: 平均覆盖 16 个键 */
+#define RANGE_WIDTH 64
+
+static inline Ordering
+cmp_u64(const u64 *a, const u64 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+DEFINE_FLAT_SET(U64Set, u64, cmp_u64, SystemAlloc, SYSTEM)
+DEFINE_HASHMAP(U64Map, u64, u64, SystemAlloc, SYSTEM, hash_fn_u64, cmp_fn_u64)
+
+static SystemAlloc g_sys;
+static u64 g_rng = 0x9E3779B97F4A7C15ull;
+
+static u64
+next_rand(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+/* 手写的 "朴素" 二分: 每层一个难以预测的分支 */
+static usize
+naive_lower_bound(const u64 *keys, usize len, u64 key)
+{
+  usize lo = 0, hi = len;
+  while (lo < hi)
+  {
+    usize mid = lo + (hi - lo) / 2;
+    if (keys[mid] < key)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+int
+main(void)
+{
+  Layout layout = LAYOUT_OF_ARRAY(u64, N);
+  u64 *items = ALLOC(SYSTEM, &g_sys, layout);
+  for (usize i = 0; i < N; i++)
+  {
+    items[i] = next_rand() % (4ull * N);
+  }
+
+  U64Set set;
+  U64Set_init(&set, &g_sys);
+  U64Set_build(&set, items, N);
+  U64Map *map = U64Map_new(&g_sys);
+  for (usize i = 0; i < set.keys.len; i++)
+  {
+    U64Map_put(map, set.keys.data[i], i);
+  }
+
+  static u64 queries[QUERIES];
+  for (usize i = 0; i < QUERIES; i++)
+  {
+    queries[i] = next_rand() % (4ull * N);
+  }
+
+  usize sink = 0;
+  BENCH_GROUP("1M point lookups in 4M sorted u64");
+  BENCH("naive binary search", 5, {
+    for (usize i = 0; i < QUERIES; i++)
+    {
+      sink += naive_lower_bound(set.keys.data, set.keys.len, queries[i]);
+    }
+  });
+  BENCH("branchless lower_bound", 5, {
+    for (usize i = 0; i < QUERIES; i++)
+    {
+      sink += U64Set_lower_bound(&set, &queries[i]);
+    }
+  });
+  U64Set_build_index(&set);
+  BENCH("Eytzinger + prefetch", 5, {
+    for (usize i = 0; i < QUERIES; i++)
+    {
+      sink += U64Set_lower_bound(&set, &queries[i]);
+    }
+  });
+  BENCH("DEFINE_HASHMAP get", 5, {
+    for (usize i = 0; i < QUERIES; i++)
+    {
+      sink += ois_some(U64Map_get(map, queries[i]));
+    }
+  });
+
+  /* 区间查询: 有序数组两次二分; 哈希表只能逐个探测区间内的每个整数 */
+  BENCH_GROUP("1M range counts [x, x + 64) in 4M sorted u64");
+  BENCH("flat set range (Eytzinger)", 5, {
+    for (usize i = 0; i < QUERIES; i++)
+    {
+      u64 hi = queries[i] + RANGE_WIDTH;
+      sink += U64Set_range(&set, &queries[i], &hi, NULL);
+    }
+  });
+  U64Set_drop_index(&set);
+  BENCH("flat set range (branchless)", 5, {
+    for (usize i = 0; i < QUERIES; i++)
+    {
+      u64 hi = queries[i] + RANGE_WIDTH;
+      sink += U64Set_range(&set, &queries[i], &hi, NULL);
+    }
+  });
+  BENCH("DEFINE_HASHMAP probe every key", 1, {
+    for (usize i = 0; i < QUERIES; i++)
+    {
+      for (u64 k = queries[i]; k < queries[i] + RANGE_WIDTH; k++)
+      {
+        sink += ois_some(U64Map_get(map, k));
+      }
+    }
+  });
+  bench_clobber(&sink);
+
+  U64Map_free(map);
+  U64Set_deinit(&set);
+  RELEASE(SYSTEM, &g_sys, items, layout);
+  return 0;
+}
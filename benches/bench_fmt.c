@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_fmt.c */
+
+#include <core/fmt/num.h>
+#include <core/fmt/tobuf.h>
+#include <core/fmt/tofd.h>
+#include <core/fmt/tofile.h>
+#include <core/mem/sysalc.h>
+#include <std/string.h>
+#include <std/test/bench.h>
+#include <fcntl.h> // open
+#include <stdio.h>
+#include <unistd.h> // close
+
+#define ITERS 1000000
+
+static SystemAlloc g_sys;
+
+/* 一组混合类型的参数, 模拟典型的日志行 */
+static i32 g_ints[16];
+static u64 g_ids[16];
+static f64 g_doubles[16];
+static f32 g_floats[16];
+static str g_names[16];
+
+static void
+init_args(void)
+{
+  static str names[4] = {"parser", "lexer", "codegen", "linker"};
+  u64 seed = 0x243f6a8885a308d3ull;
+  for (usize i = 0; i < 16; i++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    g_ints[i] = (i32)(seed >> 40) - (1 << 22);
+    g_ids[i] = seed;
+    g_doubles[i] = (f64)(seed >> 11) / (f64)(1ull << 40);
+    g_floats[i] = (f32)g_doubles[i] * 0.001f;
+    g_names[i] = names[i % 4];
+  }
+}
+
+static void
+bench_numbers(void)
+{
+  BENCH_GROUP("number -> text");
+  char buf[FMT_NUM_BUF_SIZE];
+
+  BENCH("fmt_i64", ITERS, {
+    fmt_i64(buf, g_ints[__bench_i & 15]);
+    bench_clobber(buf);
+  });
+  BENCH("snprintf %d", ITERS, {
+    snprintf(buf, sizeof(buf), "%d", g_ints[__bench_i & 15]);
+    bench_clobber(buf);
+  });
+  BENCH("fmt_u64 (20 digits)", ITERS, {
+    fmt_u64(buf, g_ids[__bench_i & 15]);
+    bench_clobber(buf);
+  });
+  BENCH("snprintf %llu", ITERS, {
+    snprintf(buf, sizeof(buf), "%llu", (unsigned long long)g_ids[__bench_i & 15]);
+    bench_clobber(buf);
+  });
+  BENCH("fmt_f64 (shortest)", ITERS, {
+    fmt_f64(buf, g_doubles[__bench_i & 15]);
+    bench_clobber(buf);
+  });
+  BENCH("snprintf %.17g", ITERS, {
+    snprintf(buf, sizeof(buf), "%.17g", g_doubles[__bench_i & 15]);
+    bench_clobber(buf);
+  });
+  BENCH("fmt_f32 (shortest)", ITERS, {
+    fmt_f32(buf, g_floats[__bench_i & 15]);
+    bench_clobber(buf);
+  });
+}
+
+static void
+bench_format(void)
+{
+  BENCH_GROUP("mixed-type format");
+
+  sstring *s = sstring_new(&g_sys);
+  BENCH("s_format", ITERS, {
+    usize i = __bench_i & 15;
+    sstring_clear(s);
+    s_format(s,
+             "[{}] id={} delta={} t={} load={}\n",
+             g_names[i],
+             g_ids[i],
+             g_ints[i],
+             g_doubles[i],
+             g_floats[i]);
+    bench_clobber(s_as_str(s));
+  });
+  sstring_destroy(s);
+
+  char line[256];
+  BENCH("snprintf (baseline)", ITERS, {
+    usize i = __bench_i & 15;
+    snprintf(line,
+             sizeof(line),
+             "[%s] id=%llu delta=%d t=%.17g load=%.9g\n",
+             g_names[i],
+             (unsigned long long)g_ids[i],
+             g_ints[i],
+             g_doubles[i],
+             (double)g_floats[i]);
+    bench_clobber(line);
+  });
+
+  FILE *null = fopen("/dev/null", "w");
+  if (null == NULL)
+  {
+    return;
+  }
+  BENCH("format_to_file (/dev/null)", ITERS, {
+    usize i = __bench_i & 15;
+    format_to_file(null,
+                   "[{}] id={} delta={} t={} load={}\n",
+                   g_names[i],
+                   g_ids[i],
+                   g_ints[i],
+                   g_doubles[i],
+                   g_floats[i]);
+  });
+  BENCH("fprintf (/dev/null, baseline)", ITERS, {
+    usize i = __bench_i & 15;
+    fprintf(null,
+            "[%s] id=%llu delta=%d t=%.17g load=%.9g\n",
+            g_names[i],
+            (unsigned long long)g_ids[i],
+            g_ints[i],
+            g_doubles[i],
+            (double)g_floats[i]);
+  });
+  fclose(null);
+}
+
+/* 格式说明: 十六进制 + 0 填充, 右对齐, 固定精度 (都写进栈上缓冲区) */
+static void
+bench_specs(void)
+{
+  BENCH_GROUP("width / hex / precision specs");
+
+  char line[128];
+  BENCH("format_to_buf \"{}\" (no specs)", ITERS, {
+    usize i = __bench_i & 15;
+    format_to_buf(line, sizeof(line), "{} {} {}", g_ids[i], g_names[i], g_doubles[i]);
+    bench_clobber(line);
+  });
+  BENCH("format_to_buf {:016x} {:>10} {:.3}", ITERS, {
+    usize i = __bench_i & 15;
+    format_to_buf(
+      line, sizeof(line), "{:016x} {:>10} {:.3}", g_ids[i], g_names[i], g_doubles[i]);
+    bench_clobber(line);
+  });
+  BENCH("snprintf %016llx %10s %.3f", ITERS, {
+    usize i = __bench_i & 15;
+    snprintf(line,
+             sizeof(line),
+             "%016llx %10s %.3f",
+             (unsigned long long)g_ids[i],
+             g_names[i],
+             g_doubles[i]);
+    bench_clobber(line);
+  });
+  BENCH("format_to_buf {:08} {:*^12}", ITERS, {
+    usize i = __bench_i & 15;
+    format_to_buf(line, sizeof(line), "{:08} {:*^12}", g_ints[i], g_names[i]);
+    bench_clobber(line);
+  });
+  BENCH("snprintf %08d %12s", ITERS, {
+    usize i = __bench_i & 15;
+    snprintf(line, sizeof(line), "%08d %12s", g_ints[i], g_names[i]);
+    bench_clobber(line);
+  });
+}
+
+/* 逐段扩容 vs 先计数再一次分配 (每次都是新字符串) */
+static void
+bench_exact(void)
+{
+  BENCH_GROUP("fresh string, long message");
+
+  BENCH("s_format (grow as needed)", ITERS, {
+    usize i = __bench_i & 15;
+    sstring *s = sstring_new(&g_sys);
+    s_format(s,
+             "component {} finished stage {} of job {} after {} seconds with score {} ({})",
+             g_names[i],
+             g_ints[i],
+             g_ids[i],
+             g_doubles[i],
+             g_floats[i],
+             g_names[(i + 1) & 15]);
+    bench_clobber(s_as_str(s));
+    sstring_destroy(s);
+  });
+  BENCH("s_format_exact (reserve once)", ITERS, {
+    usize i = __bench_i & 15;
+    sstring *s = sstring_new(&g_sys);
+    s_format_exact(s,
+                   "component {} finished stage {} of job {} after {} seconds with score {} ({})",
+                   g_names[i],
+                   g_ints[i],
+                   g_ids[i],
+                   g_doubles[i],
+                   g_floats[i],
+                   g_names[(i + 1) & 15]);
+    bench_clobber(s_as_str(s));
+    sstring_destroy(s);
+  });
+}
+
+/* 每次调用都解析格式串 vs 调用点缓存的段表 */
+static void
+bench_compiled(void)
+{
+  BENCH_GROUP("format string parsing");
+
+#define LONG_FMT                                                                                   \
+  "request handled: route={} status={} bytes={} elapsed_ms={} (cache hit ratio is {}, "            \
+  "see the dashboard for details)\n"
+
+  sstring *s = sstring_new(&g_sys);
+  BENCH("vformat_func (parse every call)", ITERS, {
+    usize i = __bench_i & 15;
+    sstring_clear(s);
+    vformat_func(s,
+                 sstring_push_char_adapter,
+                 sstring_push_bytes_adapter,
+                 LONG_FMT,
+                 5,
+                 TYPE_INFO(g_names[i]),
+                 TYPE_INFO(g_ints[i]),
+                 TYPE_INFO(g_ids[i]),
+                 TYPE_INFO(g_ints[(i + 1) & 15]),
+                 TYPE_INFO(g_floats[i]));
+    bench_clobber(s_as_str(s));
+  });
+  BENCH("vformat_cached (compiled once)", ITERS, {
+    usize i = __bench_i & 15;
+    sstring_clear(s);
+    vformat_cached(s,
+                   sstring_push_char_adapter,
+                   sstring_push_bytes_adapter,
+                   LONG_FMT,
+                   g_names[i],
+                   g_ints[i],
+                   g_ids[i],
+                   g_ints[(i + 1) & 15],
+                   g_floats[i]);
+    bench_clobber(s_as_str(s));
+  });
+  sstring_destroy(s);
+
+#undef LONG_FMT
+}
+
+/* dbg/panic 的输出路径: 无缓冲的 stderr (FILE*) 对比缓冲的 fd sink */
+static void
+bench_sinks(void)
+{
+  BENCH_GROUP("dbg-style line to unbuffered stderr");
+
+  FILE *unbuffered = fopen("/dev/null", "w");
+  int fd = open("/dev/null", O_WRONLY);
+  if (unbuffered == NULL || fd < 0)
+  {
+    return;
+  }
+  setvbuf(unbuffered, NULL, _IONBF, 0);
+
+  BENCH("format_to_file (unbuffered FILE*)", ITERS, {
+    usize i = __bench_i & 15;
+    format_to_file(unbuffered,
+                   "{}[DEBUG] ({}:{}) id={} t={}{}\n",
+                   "\x1b[38;2;100;210;255m",
+                   __FILE__,
+                   __LINE__,
+                   g_ids[i],
+                   g_doubles[i],
+                   "\x1b[0m");
+  });
+  BENCH("format_to_fd (one write)", ITERS, {
+    usize i = __bench_i & 15;
+    format_to_fd(fd,
+                 "{}[DEBUG] ({}:{}) id={} t={}{}\n",
+                 "\x1b[38;2;100;210;255m",
+                 __FILE__,
+                 __LINE__,
+                 g_ids[i],
+                 g_doubles[i],
+                 "\x1b[0m");
+  });
+
+  fclose(unbuffered);
+  close(fd);
+}
+
+int
+main(void)
+{
+  init_args();
+  bench_numbers();
+  bench_format();
+  bench_specs();
+  bench_compiled();
+  bench_exact();
+  bench_sinks();
+  return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_parallel.c */
+
+#include <core/fmt/tobuf.h>
+#include <core/mem/sysalc.h>
+#include <std/test/bench.h>
+#include <std/thread/parallel.h>
+#include <std/thread/pool.h>
+#include <std/vector.h>
+
+DEFINE_VECTOR(Vec_u64, u64, SystemAlloc, SYSTEM)
+
+#define N (1u << 24)
+#define ITERS 5
+
+static SystemAlloc g_sys;
+
+/*
+ * noipa: 基线直接调用时, 编译器会针对常量区间另外生成 (向量化的) 副本,
+ * 比较的就不再是同一份循环代码了。
+ */
+__attribute__((noipa)) static void
+scale_body(void *ctx, Range r)
+{
+  u64 *data = ((Vec_u64 *)ctx)->data;
+  for_range_in(i, r)
+  {
+    data[i] = data[i] * 3 + 1;
+  }
+}
+
+__attribute__((noipa)) static u64
+sum_body(void *ctx, Range r, u64 acc)
+{
+  const u64 *data = ((const Vec_u64 *)ctx)->data;
+  for_range_in(i, r)
+  {
+    acc += data[i];
+  }
+  return acc;
+}
+
+static u64
+sum_combine(u64 a, u64 b)
+{
+  return a + b;
+}
+
+DEFINE_PARALLEL_REDUCE(par_sum, u64, sum_body, sum_combine)
+
+int
+main(void)
+{
+  format_to_file(stdout, "(hardware threads: {})\n", pool_hardware_threads());
+
+  Vec_u64 vec;
+  Vec_u64_init(&vec, &g_sys);
+  Vec_u64_resize_with(&vec, N, 1);
+  u64 sink = 0;
+
+  BENCH_GROUP("16M u64, sequential for_range_in (ns per pass)");
+  BENCH("scale", ITERS, { scale_body(&vec, range(0, N)); });
+  BENCH("sum", ITERS, { sink += sum_body(&vec, range(0, N), 0); });
+
+  /* 线程数超过硬件线程数时, 结果反映的是调度开销而不是加速比 */
+  static const usize threads[] = {1, 2, 4, 8};
+  for (usize t = 0; t < sizeof(threads) / sizeof(threads[0]); t++)
+  {
+    char group[64];
+    format_to_buf(group, sizeof(group), "16M u64, {} thread(s) (ns per pass)", threads[t]);
+    BENCH_GROUP(group);
+
+    StealPool *pool = oexpect(steal_pool_new(&g_sys, threads[t]), "Failed to create pool");
+    BENCH("parallel_for_range scale, auto grain", ITERS, {
+      parallel_for_range(pool, range(0, N), 0, scale_body, &vec);
+    });
+    BENCH("parallel_for_range scale, grain 1024", ITERS, {
+      parallel_for_range(pool, range(0, N), 1024, scale_body, &vec);
+    });
+    BENCH("parallel_reduce sum, auto grain", ITERS, {
+      sink += par_sum(pool, range(0, N), 0, 0, &vec);
+    });
+    BENCH("parallel_reduce sum, grain 1024", ITERS, {
+      sink += par_sum(pool, range(0, N), 1024, 0, &vec);
+    });
+    steal_pool_free(pool);
+  }
+  bench_clobber(&sink);
+
+  Vec_u64_deinit(&vec);
+  return 0;
+}
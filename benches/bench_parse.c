@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_parse.c */
+
+#include <core/fmt/num.h>
+#include <core/fmt/parse.h>
+#include <std/test/bench.h>
+#include <stdlib.h> // strtod, strtoull
+#include <string.h> // memcpy
+
+#define ITERS 1000000
+#define SAMPLES 64
+
+/* 一段 "逗号分隔" 的文本, 样本是其中不以 '\0' 结尾的切片 */
+static char g_text[SAMPLES * FMT_NUM_BUF_SIZE];
+static vstr g_floats[SAMPLES];
+static vstr g_ints[SAMPLES];
+
+static void
+init_samples(void)
+{
+  u64 seed = 0x243f6a8885a308d3ull;
+  usize len = 0;
+  for (usize i = 0; i < SAMPLES; i++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    f64 d = (f64)(seed >> 11) / (f64)(1ull << 40) * (i % 2 ? 1e-3 : 1e5);
+    g_floats[i] = (vstr){.ptr = g_text + len, .len = fmt_f64(g_text + len, d)};
+    len += g_floats[i].len;
+    g_text[len++] = ',';
+  }
+  for (usize i = 0; i < SAMPLES; i++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    g_ints[i] = (vstr){.ptr = g_text + len, .len = fmt_u64(g_text + len, seed >> (i % 40))};
+    len += g_ints[i].len;
+    g_text[len++] = ',';
+  }
+}
+
+/* strtod 需要 '\0' 结尾: 先拷贝切片 (调用者现在的做法) */
+static inline const char *
+terminated(char *buf, vstr v)
+{
+  memcpy(buf, v.ptr, v.len);
+  buf[v.len] = '\0';
+  return buf;
+}
+
+static void
+bench_floats(void)
+{
+  BENCH_GROUP("vstr -> f64 (shortest repr, 64 samples)");
+  char buf[FMT_NUM_BUF_SIZE + 1];
+
+  BENCH("vstr_parse_f64", ITERS, {
+    f64 d = vstr_parse_f64(g_floats[__bench_i % SAMPLES]).value.ok;
+    bench_clobber(&d);
+  });
+  BENCH("copy + strtod", ITERS, {
+    f64 d = strtod(terminated(buf, g_floats[__bench_i % SAMPLES]), NULL);
+    bench_clobber(&d);
+  });
+}
+
+static void
+bench_integers(void)
+{
+  BENCH_GROUP("vstr -> u64 (64 samples)");
+  char buf[FMT_NUM_BUF_SIZE + 1];
+
+  BENCH("vstr_parse_u64", ITERS, {
+    u64 v = vstr_parse_u64(g_ints[__bench_i % SAMPLES]).value.ok;
+    bench_clobber(&v);
+  });
+  BENCH("copy + strtoull", ITERS, {
+    u64 v = strtoull(terminated(buf, g_ints[__bench_i % SAMPLES]), NULL, 10);
+    bench_clobber(&v);
+  });
+}
+
+int
+main(void)
+{
+  init_samples();
+  bench_floats();
+  bench_integers();
+  return 0;
+}
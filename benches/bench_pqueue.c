@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_pqueue.c */
+
+#include <core/mem/sysalc.h>
+#include <std/pqueue.h>
+#include <std/test/bench.h>
+
+static inline Ordering
+cmp_u64(const u64 *a, const u64 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+DEFINE_PRIORITY_QUEUE_ARITY(Heap2, u64, cmp_u64, 2, SystemAlloc, SYSTEM)
+DEFINE_PRIORITY_QUEUE(Heap4, u64, cmp_u64, SystemAlloc, SYSTEM)
+DEFINE_INDEXED_PRIORITY_QUEUE_ARITY(IdxHeap2, u64, cmp_u64, 2, SystemAlloc, SYSTEM)
+DEFINE_INDEXED_PRIORITY_QUEUE(IdxHeap4, u64, cmp_u64, SystemAlloc, SYSTEM)
+
+#define N (1u << 20)
+#define NODES (1u << 18)
+#define DEGREE 8
+
+static SystemAlloc g_sys;
+static u64 g_rng = 0x9e3779b97f4a7c15ull;
+
+static u64
+next_u64(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+/*
+ * ===================================================================
+ * 普通堆: 报告每个元素 (push + pop) 的耗时
+ * ===================================================================
+ */
+
+#define HEAP_BENCHES(Heap, label)                                                                  \
+  do                                                                                               \
+  {                                                                                                \
+    Heap q;                                                                                        \
+    Heap##_init(&q, &g_sys);                                                                       \
+    u64 sink = 0;                                                                                  \
+    u64 t0 = bench_now_ns();                                                                       \
+    for (usize i = 0; i < N; i++)                                                                  \
+    {                                                                                              \
+      Heap##_push(&q, keys[i]);                                                                    \
+    }                                                                                              \
+    for (u64 v = 0; Heap##_pop(&q, &v);)                                                           \
+    {                                                                                              \
+      sink += v;                                                                                   \
+    }                                                                                              \
+    bench_report(label " push all, pop all", N, bench_now_ns() - t0);                              \
+                                                                                                   \
+    t0 = bench_now_ns();                                                                           \
+    Heap##_heapify_from(&q, keys, N);                                                              \
+    for (u64 v = 0; Heap##_pop(&q, &v);)                                                           \
+    {                                                                                              \
+      sink += v;                                                                                   \
+    }                                                                                              \
+    bench_report(label " heapify, pop all", N, bench_now_ns() - t0);                               \
+                                                                                                   \
+    /* 保留最大的 4096 个: 稳态下的 push_pop */                                                    \
+    Heap##_heapify_from(&q, keys, 4096);                                                           \
+    t0 = bench_now_ns();                                                                           \
+    for (usize i = 4096; i < N; i++)                                                               \
+    {                                                                                              \
+      sink += Heap##_push_pop(&q, keys[i]);                                                        \
+    }                                                                                              \
+    bench_report(label " top-4096 push_pop", N - 4096, bench_now_ns() - t0);                       \
+    bench_clobber(&sink);                                                                          \
+    Heap##_deinit(&q);                                                                             \
+  } while (0)
+
+static void
+bench_heap(void)
+{
+  BENCH_GROUP("heap of 1M random u64 (ns per element)");
+
+  u64 *keys = (u64 *)ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(u64, N));
+  for (usize i = 0; i < N; i++)
+  {
+    keys[i] = next_u64();
+  }
+  HEAP_BENCHES(Heap2, "binary");
+  HEAP_BENCHES(Heap4, "4-ary ");
+  RELEASE(SYSTEM, &g_sys, keys, LAYOUT_OF_ARRAY(u64, N));
+}
+
+/*
+ * ===================================================================
+ * 索引堆: 随机图上的 Dijkstra
+ * ===================================================================
+ */
+
+typedef struct Graph
+{
+  u32 *to;     /* NODES * DEGREE 条边 */
+  u32 *weight; /* 对应权重 */
+  u64 *dist;
+} Graph;
+
+#define DIJKSTRA(IdxHeap, g)                                                                       \
+  do                                                                                               \
+  {                                                                                                \
+    IdxHeap q;                                                                                     \
+    IdxHeap##_init(&q, &g_sys);                                                                    \
+    for (usize i = 0; i < NODES; i++)                                                              \
+    {                                                                                              \
+      (g)->dist[i] = UINT64_MAX;                                                                   \
+    }                                                                                              \
+    (g)->dist[0] = 0;                                                                              \
+    IdxHeap##_push(&q, 0, 0);                                                                      \
+    usize u = 0;                                                                                   \
+    u64 d = 0;                                                                                     \
+    while (IdxHeap##_pop(&q, &u, &d))                                                              \
+    {                                                                                              \
+      for (usize e = u * DEGREE; e < (u + 1) * DEGREE; e++)                                        \
+      {                                                                                            \
+        usize v = (g)->to[e];                                                                      \
+        u64 nd = d + (g)->weight[e];                                                               \
+        if (nd < (g)->dist[v])                                                                     \
+        {                                                                                          \
+          (g)->dist[v] = nd;                                                                       \
+          IdxHeap##_push_or_decrease(&q, v, nd);                                                   \
+        }                                                                                          \
+      }                                                                                            \
+    }                                                                                              \
+    IdxHeap##_deinit(&q);                                                                          \
+  } while (0)
+
+static void
+bench_dijkstra(void)
+{
+  BENCH_GROUP("Dijkstra, 256K nodes x 8 edges (ns per node)");
+
+  Graph g;
+  g.to = (u32 *)ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(u32, NODES * DEGREE));
+  g.weight = (u32 *)ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(u32, NODES * DEGREE));
+  g.dist = (u64 *)ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(u64, NODES));
+  for (usize e = 0; e < NODES * DEGREE; e++)
+  {
+    g.to[e] = (u32)(next_u64() % NODES);
+    g.weight[e] = (u32)(next_u64() % 1000) + 1;
+  }
+
+  u64 t0 = bench_now_ns();
+  DIJKSTRA(IdxHeap2, &g);
+  bench_report("binary indexed heap", NODES, bench_now_ns() - t0);
+  u64 check = g.dist[NODES - 1];
+
+  t0 = bench_now_ns();
+  DIJKSTRA(IdxHeap4, &g);
+  bench_report("4-ary indexed heap", NODES, bench_now_ns() - t0);
+  check ^= g.dist[NODES - 1];
+  bench_clobber(&check);
+
+  RELEASE(SYSTEM, &g_sys, g.to, LAYOUT_OF_ARRAY(u32, NODES * DEGREE));
+  RELEASE(SYSTEM, &g_sys, g.weight, LAYOUT_OF_ARRAY(u32, NODES * DEGREE));
+  RELEASE(SYSTEM, &g_sys, g.dist, LAYOUT_OF_ARRAY(u64, NODES));
+}
+
+int
+main(void)
+{
+  bench_heap();
+  bench_dijkstra();
+  return 0;
+}
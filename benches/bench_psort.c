@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_psort.c */
+
+#include <core/fmt/tobuf.h>
+#include <core/mem/sysalc.h>
+#include <std/test/bench.h>
+#include <std/thread/psort.h>
+
+/* 10M 个 u64; 每次迭代都先从 input 拷回原始数据 */
+#define N (10u * 1000u * 1000u)
+#define ITERS 3
+
+static inline Ordering
+cmp_u64(const u64 *a, const u64 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+DEFINE_SORT(u64s, u64, cmp_u64)
+DEFINE_PARALLEL_SORT(u64s, u64, SystemAlloc, SYSTEM)
+
+static SystemAlloc g_sys;
+static u64 g_rng = 0x9E3779B97F4A7C15ull;
+
+static u64
+next_rand(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+int
+main(void)
+{
+  Layout layout = LAYOUT_OF_ARRAY(u64, N);
+  u64 *input = ALLOC(SYSTEM, &g_sys, layout);
+  u64 *data = ALLOC(SYSTEM, &g_sys, layout);
+  for (usize i = 0; i < N; i++)
+  {
+    input[i] = next_rand();
+  }
+
+  format_to_file(stdout, "(hardware threads: {})\n", pool_hardware_threads());
+  BENCH_GROUP("10M random u64, parallel merge sort");
+
+  BENCH("sequential pdqsort", ITERS, {
+    memcpy(data, input, N * sizeof(u64));
+    u64s_sort(data, N);
+    bench_clobber(data);
+  });
+
+  /* 线程数超过硬件线程数时, 结果反映的是调度开销而不是加速比 */
+  static const usize threads[] = {1, 2, 4, 8, 16, 32, 64};
+  for (usize t = 0; t < sizeof(threads) / sizeof(threads[0]); t++)
+  {
+    ThreadPool *pool = oexpect(pool_new(&g_sys, threads[t]), "Failed to create pool");
+    char name[32];
+    format_to_buf(name, sizeof(name), "{} thread(s)", threads[t]);
+    BENCH(name, ITERS, {
+      memcpy(data, input, N * sizeof(u64));
+      u64s_par_sort(pool, &g_sys, data, N);
+      bench_clobber(data);
+    });
+    pool_free(pool);
+  }
+
+  RELEASE(SYSTEM, &g_sys, input, layout);
+  RELEASE(SYSTEM, &g_sys, data, layout);
+  return 0;
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_queue.c */
+
+#include <core/fmt/tobuf.h>
+#include <core/mem/sysalc.h>
+#include <std/test/bench.h>
+#include <std/thread/queue.h>
+#include <std/vector.h>
+#include <threads.h>
+
+DEFINE_SPSC_QUEUE(Ring_u64, u64, SystemAlloc, SYSTEM)
+DEFINE_MPMC_QUEUE(Mpmc_u64, u64, SystemAlloc, SYSTEM)
+DEFINE_VECTOR(Vec_u64, u64, SystemAlloc, SYSTEM)
+
+/* 每个生产者发送的消息数 */
+#define ITEMS (1u << 20)
+#define CAPACITY 1024
+#define BATCH 32
+#define PING_PONGS 100000
+
+static SystemAlloc g_sys;
+
+/*
+ * ===================================================================
+ * 吞吐量: 每一项报告的是 "每条消息" 的耗时
+ * ===================================================================
+ */
+
+typedef struct Pipe
+{
+  Ring_u64 ring;
+  Mpmc_u64 mpmc;
+  Vec_u64 vec; /* 基线: 互斥锁保护的 Vector 当作队列 */
+  usize vec_head;
+  mtx_t lock;
+  bool batched;
+  _Atomic usize consumed;
+  usize total;
+} Pipe;
+
+static int
+spsc_producer(void *arg)
+{
+  Pipe *p = (Pipe *)arg;
+  u64 batch[BATCH];
+  for (u64 i = 0; i < ITEMS;)
+  {
+    if (p->batched)
+    {
+      usize n = ITEMS - i < BATCH ? ITEMS - i : BATCH;
+      for (usize k = 0; k < n; k++)
+      {
+        batch[k] = i + k;
+      }
+      usize pushed = Ring_u64_push_n(&p->ring, batch, n);
+      i += pushed;
+      if (pushed == 0)
+        thrd_yield();
+    }
+    else if (Ring_u64_push(&p->ring, i))
+    {
+      i++;
+    }
+    else
+    {
+      thrd_yield();
+    }
+  }
+  return 0;
+}
+
+static int
+spsc_consumer(void *arg)
+{
+  Pipe *p = (Pipe *)arg;
+  u64 batch[BATCH];
+  u64 sum = 0;
+  for (usize got = 0; got < ITEMS;)
+  {
+    usize n = 0;
+    if (p->batched)
+    {
+      n = Ring_u64_pop_n(&p->ring, batch, BATCH);
+      for (usize k = 0; k < n; k++)
+      {
+        sum += batch[k];
+      }
+    }
+    else if (Ring_u64_pop(&p->ring, &batch[0]))
+    {
+      sum += batch[0];
+      n = 1;
+    }
+    got += n;
+    if (n == 0)
+      thrd_yield();
+  }
+  bench_clobber(&sum);
+  return 0;
+}
+
+static int
+mpmc_producer(void *arg)
+{
+  Pipe *p = (Pipe *)arg;
+  for (u64 i = 0; i < ITEMS; i++)
+  {
+    while (!Mpmc_u64_push(&p->mpmc, i))
+    {
+      thrd_yield();
+    }
+  }
+  return 0;
+}
+
+static int
+mpmc_consumer(void *arg)
+{
+  Pipe *p = (Pipe *)arg;
+  u64 v = 0;
+  while (atomic_load_explicit(&p->consumed, memory_order_relaxed) < p->total)
+  {
+    if (Mpmc_u64_pop(&p->mpmc, &v))
+      atomic_fetch_add_explicit(&p->consumed, 1, memory_order_relaxed);
+    else
+      thrd_yield();
+  }
+  return 0;
+}
+
+static int
+mutex_producer(void *arg)
+{
+  Pipe *p = (Pipe *)arg;
+  for (u64 i = 0; i < ITEMS; i++)
+  {
+    mtx_lock(&p->lock);
+    Vec_u64_push(&p->vec, i);
+    mtx_unlock(&p->lock);
+  }
+  return 0;
+}
+
+static int
+mutex_consumer(void *arg)
+{
+  Pipe *p = (Pipe *)arg;
+  for (usize got = 0; got < ITEMS;)
+  {
+    mtx_lock(&p->lock);
+    bool any = p->vec_head < p->vec.len;
+    if (any)
+    {
+      p->vec_head++;
+      got++;
+      /* 读空时整体回收, 否则向量会无限增长 */
+      if (p->vec_head == p->vec.len)
+      {
+        Vec_u64_clear(&p->vec);
+        p->vec_head = 0;
+      }
+    }
+    mtx_unlock(&p->lock);
+    if (!any)
+      thrd_yield();
+  }
+  return 0;
+}
+
+/* 启动 pairs 对生产者 / 消费者, 返回每条消息的平均耗时 */
+static void
+run_pairs(str name, thrd_start_t producer, thrd_start_t consumer, usize pairs, Pipe *p)
+{
+  thrd_t threads[16];
+  p->total = pairs * ITEMS;
+  atomic_store(&p->consumed, 0);
+
+  u64 t0 = bench_now_ns();
+  for (usize i = 0; i < pairs; i++)
+  {
+    thrd_create(&threads[2 * i], producer, p);
+    thrd_create(&threads[2 * i + 1], consumer, p);
+  }
+  for (usize i = 0; i < 2 * pairs; i++)
+  {
+    thrd_join(threads[i], NULL);
+  }
+  bench_report(name, p->total, bench_now_ns() - t0);
+}
+
+static void
+bench_throughput(void)
+{
+  BENCH_GROUP("throughput (ns per message, 1M messages per producer)");
+
+  static Pipe p;
+  Ring_u64_init(&p.ring, &g_sys, CAPACITY);
+  Mpmc_u64_init(&p.mpmc, &g_sys, CAPACITY);
+  Vec_u64_init(&p.vec, &g_sys);
+  mtx_init(&p.lock, mtx_plain);
+
+  p.batched = false;
+  run_pairs("mutex + Vector, 1 pair", mutex_producer, mutex_consumer, 1, &p);
+  run_pairs("SPSC ring, 1 pair", spsc_producer, spsc_consumer, 1, &p);
+  p.batched = true;
+  run_pairs("SPSC ring batched (32), 1 pair", spsc_producer, spsc_consumer, 1, &p);
+
+  static const usize pairs[] = {1, 2, 4, 8};
+  for (usize i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i++)
+  {
+    char name[48];
+    format_to_buf(name, sizeof(name), "MPMC queue, {} pair(s)", pairs[i]);
+    run_pairs(name, mpmc_producer, mpmc_consumer, pairs[i], &p);
+  }
+
+  mtx_destroy(&p.lock);
+  Vec_u64_deinit(&p.vec);
+  Mpmc_u64_deinit(&p.mpmc);
+  Ring_u64_deinit(&p.ring);
+}
+
+/*
+ * ===================================================================
+ * 延迟: 两个线程通过一对队列来回传递一条消息
+ * ===================================================================
+ */
+
+typedef struct PingPong
+{
+  Ring_u64 ping;
+  Ring_u64 pong;
+  Mpmc_u64 mping;
+  Mpmc_u64 mpong;
+  bool use_mpmc;
+} PingPong;
+
+static int
+echo_main(void *arg)
+{
+  PingPong *pp = (PingPong *)arg;
+  u64 v = 0;
+  for (u32 i = 0; i < PING_PONGS; i++)
+  {
+    if (pp->use_mpmc)
+    {
+      while (!Mpmc_u64_pop(&pp->mping, &v))
+        thrd_yield();
+      while (!Mpmc_u64_push(&pp->mpong, v + 1))
+        thrd_yield();
+    }
+    else
+    {
+      while (!Ring_u64_pop(&pp->ping, &v))
+        thrd_yield();
+      while (!Ring_u64_push(&pp->pong, v + 1))
+        thrd_yield();
+    }
+  }
+  return 0;
+}
+
+static void
+bench_latency(void)
+{
+  BENCH_GROUP("latency (ns per round trip)");
+
+  static PingPong pp;
+  Ring_u64_init(&pp.ping, &g_sys, 16);
+  Ring_u64_init(&pp.pong, &g_sys, 16);
+  Mpmc_u64_init(&pp.mping, &g_sys, 16);
+  Mpmc_u64_init(&pp.mpong, &g_sys, 16);
+
+  for (int mode = 0; mode < 2; mode++)
+  {
+    pp.use_mpmc = mode == 1;
+    thrd_t echo;
+    thrd_create(&echo, echo_main, &pp);
+    u64 v = 0;
+    BENCH(pp.use_mpmc ? "MPMC ping-pong" : "SPSC ping-pong", PING_PONGS, {
+      if (pp.use_mpmc)
+      {
+        Mpmc_u64_push(&pp.mping, v);
+        while (!Mpmc_u64_pop(&pp.mpong, &v))
+          thrd_yield();
+      }
+      else
+      {
+        Ring_u64_push(&pp.ping, v);
+        while (!Ring_u64_pop(&pp.pong, &v))
+          thrd_yield();
+      }
+    });
+    thrd_join(echo, NULL);
+    bench_clobber(&v);
+  }
+
+  Ring_u64_deinit(&pp.ping);
+  Ring_u64_deinit(&pp.pong);
+  Mpmc_u64_deinit(&pp.mping);
+  Mpmc_u64_deinit(&pp.mpong);
+}
+
+int
+main(void)
+{
+  bench_throughput();
+  bench_latency();
+  return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_sort.c */
+
+#include <core/mem/sysalc.h>
+#include <std/sort.h>
+#include <std/test/bench.h>
+#include <stdlib.h>
+
+/* 10M 个元素; 每次迭代都先从 input 拷回原始数据 (拷贝计入所有项) */
+#define N (10u * 1000u * 1000u)
+#define ITERS 3
+
+static inline Ordering
+cmp_u32(const u32 *a, const u32 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+static inline Ordering
+cmp_f64(const f64 *a, const f64 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+DEFINE_SORT(u32s, u32, cmp_u32)
+DEFINE_SORT(f64s, f64, cmp_f64)
+
+static int
+qsort_cmp_u32(const void *a, const void *b)
+{
+  u32 x = *(const u32 *)a, y = *(const u32 *)b;
+  return (x > y) - (x < y);
+}
+
+static int
+qsort_cmp_f64(const void *a, const void *b)
+{
+  f64 x = *(const f64 *)a, y = *(const f64 *)b;
+  return (x > y) - (x < y);
+}
+
+static u64 g_rng = 0x9E3779B97F4A7C15ull;
+
+static u64
+next_rand(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+static void
+bench_u32(u32 *input, u32 *data, u32 *scratch, str group)
+{
+  BENCH_GROUP(group);
+
+  BENCH("qsort", ITERS, {
+    memcpy(data, input, N * sizeof(u32));
+    qsort(data, N, sizeof(u32), qsort_cmp_u32);
+    bench_clobber(data);
+  });
+  BENCH("DEFINE_SORT (pdqsort)", ITERS, {
+    memcpy(data, input, N * sizeof(u32));
+    u32s_sort(data, N);
+    bench_clobber(data);
+  });
+  BENCH("radix_sort_u32", ITERS, {
+    memcpy(data, input, N * sizeof(u32));
+    radix_sort_u32(data, N, scratch);
+    bench_clobber(data);
+  });
+}
+
+static void
+bench_f64(f64 *input, f64 *data, f64 *scratch)
+{
+  BENCH_GROUP("10M random f64");
+
+  BENCH("qsort", ITERS, {
+    memcpy(data, input, N * sizeof(f64));
+    qsort(data, N, sizeof(f64), qsort_cmp_f64);
+    bench_clobber(data);
+  });
+  BENCH("DEFINE_SORT (pdqsort)", ITERS, {
+    memcpy(data, input, N * sizeof(f64));
+    f64s_sort(data, N);
+    bench_clobber(data);
+  });
+  BENCH("radix_sort_f64", ITERS, {
+    memcpy(data, input, N * sizeof(f64));
+    radix_sort_f64(data, N, scratch);
+    bench_clobber(data);
+  });
+}
+
+int
+main(void)
+{
+  Layout l32 = LAYOUT_OF_ARRAY(u32, N);
+  u32 *input = ALLOC(SYSTEM, NULL, l32);
+  u32 *data = ALLOC(SYSTEM, NULL, l32);
+  u32 *scratch = ALLOC(SYSTEM, NULL, l32);
+
+  for (usize i = 0; i < N; i++)
+  {
+    input[i] = (u32)next_rand();
+  }
+  bench_u32(input, data, scratch, "10M random u32");
+
+  /* 几乎有序: pdqsort 的模式检测让它接近线性 */
+  for (usize i = 0; i < N; i++)
+  {
+    input[i] = (u32)i + (next_rand() % 1000 == 0 ? (u32)next_rand() : 0);
+  }
+  bench_u32(input, data, scratch, "10M nearly sorted u32");
+
+  RELEASE(SYSTEM, NULL, input, l32);
+  RELEASE(SYSTEM, NULL, data, l32);
+  RELEASE(SYSTEM, NULL, scratch, l32);
+
+  Layout l64 = LAYOUT_OF_ARRAY(f64, N);
+  f64 *finput = ALLOC(SYSTEM, NULL, l64);
+  f64 *fdata = ALLOC(SYSTEM, NULL, l64);
+  f64 *fscratch = ALLOC(SYSTEM, NULL, l64);
+  for (usize i = 0; i < N; i++)
+  {
+    finput[i] = (f64)(i64)next_rand() * 0x1p-40;
+  }
+  bench_f64(finput, fdata, fscratch);
+
+  RELEASE(SYSTEM, NULL, finput, l64);
+  RELEASE(SYSTEM, NULL, fdata, l64);
+  RELEASE(SYSTEM, NULL, fscratch, l64);
+  return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_steal.c */
+
+#include <core/fmt/tobuf.h>
+#include <core/mem/sysalc.h>
+#include <std/test/bench.h>
+#include <std/thread/pool.h>
+#include <std/thread/steal.h>
+
+#define FIB_N 30
+/* 小于此值的子问题顺序计算 */
+#define FIB_CUTOFF 12
+
+#define LOOP_N (1u << 22)
+#define LOOP_GRAIN 4096
+#define ITERS 3
+
+static SystemAlloc g_sys;
+
+/*
+ * ===================================================================
+ * fib: 细粒度 fork-join (每个任务只做几次加法)
+ * ===================================================================
+ */
+
+typedef struct Fib
+{
+  u32 n;
+  u32 cutoff;
+  u64 result;
+} Fib;
+
+static u64
+fib_seq(u32 n)
+{
+  return n < 2 ? n : fib_seq(n - 1) + fib_seq(n - 2);
+}
+
+static void
+fib_task(void *ctx)
+{
+  Fib *f = (Fib *)ctx;
+  if (f->n < f->cutoff || f->n < 2)
+  {
+    f->result = fib_seq(f->n);
+    return;
+  }
+  Fib a = {.n = f->n - 1, .cutoff = f->cutoff};
+  Fib b = {.n = f->n - 2, .cutoff = f->cutoff};
+  StealTask *t = steal_spawn(fib_task, &a);
+  fib_task(&b);
+  steal_join(t);
+  f->result = a.result + b.result;
+}
+
+/*
+ * ===================================================================
+ * 并行循环: out[i] = 多项式(in[i])
+ * ===================================================================
+ */
+
+typedef struct Loop
+{
+  const f64 *in;
+  f64 *out;
+  usize begin;
+  usize end;
+} Loop;
+
+static void
+loop_body(const f64 *in, f64 *out, usize begin, usize end)
+{
+  for (usize i = begin; i < end; i++)
+  {
+    f64 x = in[i];
+    out[i] = ((x * 0.25 + 1.5) * x - 2.0) * x + 3.0;
+  }
+}
+
+/* 递归二分, 直到区间不超过 LOOP_GRAIN */
+static void
+loop_task(void *ctx)
+{
+  Loop *l = (Loop *)ctx;
+  if (l->end - l->begin <= LOOP_GRAIN)
+  {
+    loop_body(l->in, l->out, l->begin, l->end);
+    return;
+  }
+  usize mid = l->begin + (l->end - l->begin) / 2;
+  Loop left = {.in = l->in, .out = l->out, .begin = l->begin, .end = mid};
+  Loop right = {.in = l->in, .out = l->out, .begin = mid, .end = l->end};
+  StealTask *t = steal_spawn(loop_task, &left);
+  loop_task(&right);
+  steal_join(t);
+}
+
+/* 基线: pool_run 的每个任务处理一个 LOOP_GRAIN 大小的块 */
+static void
+loop_chunk(void *ctx, usize index)
+{
+  Loop *l = (Loop *)ctx;
+  usize begin = index * LOOP_GRAIN;
+  usize end = begin + LOOP_GRAIN < l->end ? begin + LOOP_GRAIN : l->end;
+  loop_body(l->in, l->out, begin, end);
+}
+
+int
+main(void)
+{
+  format_to_file(stdout, "(hardware threads: {})\n", pool_hardware_threads());
+
+  f64 *in = ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(f64, LOOP_N));
+  f64 *out = ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(f64, LOOP_N));
+  for (usize i = 0; i < LOOP_N; i++)
+  {
+    in[i] = (f64)i;
+  }
+  Loop loop = {.in = in, .out = out, .begin = 0, .end = LOOP_N};
+
+  BENCH_GROUP("fib(30), sequential baseline");
+  u64 sink = 0;
+  BENCH("fib_seq", ITERS, { sink += fib_seq(FIB_N); });
+  BENCH_GROUP("parallel loop over 4M f64, sequential baseline");
+  BENCH("loop_body", ITERS, {
+    loop_body(in, out, 0, LOOP_N);
+    bench_clobber(out);
+  });
+
+  /* 线程数超过硬件线程数时, 结果反映的是调度开销而不是加速比 */
+  static const usize threads[] = {1, 2, 4, 8};
+  for (usize t = 0; t < sizeof(threads) / sizeof(threads[0]); t++)
+  {
+    char group[64];
+    format_to_buf(group, sizeof(group), "{} thread(s)", threads[t]);
+    BENCH_GROUP(group);
+
+    StealPool *steal = oexpect(steal_pool_new(&g_sys, threads[t]), "Failed to create pool");
+    ThreadPool *pool = oexpect(pool_new(&g_sys, threads[t]), "Failed to create pool");
+
+    BENCH("fib(30), spawn every call", ITERS, {
+      Fib f = {.n = FIB_N, .cutoff = 2};
+      steal_pool_run(steal, fib_task, &f);
+      sink += f.result;
+    });
+    BENCH("fib(30), cutoff 12", ITERS, {
+      Fib f = {.n = FIB_N, .cutoff = FIB_CUTOFF};
+      steal_pool_run(steal, fib_task, &f);
+      sink += f.result;
+    });
+    BENCH("loop, steal (recursive split)", ITERS, {
+      steal_pool_run(steal, loop_task, &loop);
+      bench_clobber(out);
+    });
+    BENCH("loop, pool_run (flat chunks)", ITERS, {
+      pool_run(pool, (LOOP_N + LOOP_GRAIN - 1) / LOOP_GRAIN, loop_chunk, &loop);
+      bench_clobber(out);
+    });
+
+    pool_free(pool);
+    steal_pool_free(steal);
+  }
+  bench_clobber(&sink);
+
+  RELEASE(SYSTEM, &g_sys, in, LAYOUT_OF_ARRAY(f64, LOOP_N));
+  RELEASE(SYSTEM, &g_sys, out, LAYOUT_OF_ARRAY(f64, LOOP_N));
+  return 0;
+}
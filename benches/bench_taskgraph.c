@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_taskgraph.c */
+
+#include <core/fmt/tobuf.h>
+#include <core/mem/sysalc.h>
+#include <std/test/bench.h>
+#include <std/thread/pool.h>
+#include <std/thread/taskgraph.h>
+
+/* 分层 DAG: 每层 WIDTH 个任务, 每个任务依赖上一层的两个任务 */
+#define LAYERS 64
+#define WIDTH 64
+#define TASKS (LAYERS * WIDTH)
+#define ITERS 20
+
+static SystemAlloc g_sys;
+
+/* 每个任务的工作量: WORK 次乘加 */
+static usize g_work;
+
+__attribute__((noipa)) static u64
+spin(u64 x, usize n)
+{
+  for (usize i = 0; i < n; i++)
+  {
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+  }
+  return x;
+}
+
+static TaskResult
+layer_task(void *ctx, const anyptr *inputs, usize ninputs)
+{
+  u64 *out = (u64 *)ctx;
+  u64 x = 1;
+  for (usize i = 0; i < ninputs; i++)
+  {
+    x += *(const u64 *)inputs[i];
+  }
+  *out = spin(x, g_work);
+  return TASK_OK(out);
+}
+
+/* 顺序基线: 逐层直接计算 */
+static u64
+layers_seq(u64 *out)
+{
+  for (usize l = 0; l < LAYERS; l++)
+  {
+    for (usize w = 0; w < WIDTH; w++)
+    {
+      u64 x = 1;
+      if (l != 0)
+      {
+        x += out[(l - 1) * WIDTH + w] + out[(l - 1) * WIDTH + (w + 1) % WIDTH];
+      }
+      out[l * WIDTH + w] = spin(x, g_work);
+    }
+  }
+  return out[TASKS - 1];
+}
+
+int
+main(void)
+{
+  format_to_file(stdout, "(hardware threads: {})\n", pool_hardware_threads());
+
+  u64 *out = ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(u64, TASKS));
+  TaskGraph *g = oexpect(task_graph_new(&g_sys), "Failed to create graph");
+  for (usize l = 0; l < LAYERS; l++)
+  {
+    for (usize w = 0; w < WIDTH; w++)
+    {
+      TaskId deps[2] = {(l - 1) * WIDTH + w, (l - 1) * WIDTH + (w + 1) % WIDTH};
+      task_graph_add(g, layer_task, &out[l * WIDTH + w], deps, l == 0 ? 0 : 2);
+    }
+  }
+  u64 sink = 0;
+
+  static const usize work[] = {0, 1000};
+  static const usize threads[] = {1, 2, 4};
+  for (usize k = 0; k < sizeof(work) / sizeof(work[0]); k++)
+  {
+    g_work = work[k];
+    char group[96];
+    format_to_buf(
+      group, sizeof(group), "64x64 layered DAG, {} mul-adds per task (ns per run)", g_work);
+    BENCH_GROUP(group);
+
+    BENCH("sequential loop", ITERS, { sink += layers_seq(out); });
+    BENCH("task_graph_run, no pool", ITERS, {
+      task_graph_run(g, NULL);
+      sink += out[TASKS - 1];
+    });
+    for (usize t = 0; t < sizeof(threads) / sizeof(threads[0]); t++)
+    {
+      StealPool *pool = oexpect(steal_pool_new(&g_sys, threads[t]), "Failed to create pool");
+      char label[64];
+      format_to_buf(label, sizeof(label), "task_graph_run, {} thread(s)", threads[t]);
+      BENCH(label, ITERS, {
+        task_graph_run(g, pool);
+        sink += out[TASKS - 1];
+      });
+      steal_pool_free(pool);
+    }
+  }
+  bench_clobber(&sink);
+
+  task_graph_free(g);
+  RELEASE(SYSTEM, &g_sys, out, LAYOUT_OF_ARRAY(u64, TASKS));
+  return 0;
+}
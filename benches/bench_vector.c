@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* benches/bench_vector.c */
+
+#include <core/mem/sysalc.h>
+#include <std/segvec.h>
+#include <std/soa_vector.h>
+#include <std/test/bench.h>
+#include <std/vector.h>
+
+DEFINE_VECTOR(Vec_u32, u32, SystemAlloc, SYSTEM)
+DEFINE_SEGVEC(SegVec_u32, u32, SystemAlloc, SYSTEM)
+
+/* 一个典型的 "胖" 结构体: 热循环只读 mass */
+typedef struct Body
+{
+  f64 pos[3];
+  f64 vel[3];
+  f64 mass;
+  u64 id;
+} Body;
+
+DEFINE_VECTOR(Vec_body, Body, SystemAlloc, SYSTEM)
+
+#define BODY_FIELDS(X, ctx)                                                                        \
+  X(ctx, f64, px)                                                                                  \
+  X(ctx, f64, py)                                                                                  \
+  X(ctx, f64, pz)                                                                                  \
+  X(ctx, f64, vx)                                                                                  \
+  X(ctx, f64, vy)                                                                                  \
+  X(ctx, f64, vz)                                                                                  \
+  X(ctx, f64, mass)                                                                                \
+  X(ctx, u64, id)
+
+DEFINE_SOA_VECTOR(Bodies, BODY_FIELDS, SystemAlloc, SYSTEM)
+
+#define ITERS 20000
+
+/* 每次追加的切片长度 */
+#define CHUNK 64
+
+static SystemAlloc g_sys;
+static u32 g_chunk[CHUNK];
+
+/* 逐个 push vs 一次扩容 + memcpy */
+static void
+bench_append(void)
+{
+  BENCH_GROUP("append 64-element slices");
+
+  Vec_u32 vec;
+  Vec_u32_init(&vec, &g_sys);
+
+  BENCH("push loop", ITERS, {
+    for (usize i = 0; i < CHUNK; i++)
+    {
+      Vec_u32_push(&vec, g_chunk[i]);
+    }
+    bench_clobber(vec.data);
+    if (vec.len >= (1u << 20))
+    {
+      Vec_u32_clear(&vec);
+    }
+  });
+
+  Vec_u32_clear(&vec);
+  BENCH("extend_from_slice", ITERS, {
+    Vec_u32_extend_from_slice(&vec, g_chunk, CHUNK);
+    bench_clobber(vec.data);
+    if (vec.len >= (1u << 20))
+    {
+      Vec_u32_clear(&vec);
+    }
+  });
+
+  Vec_u32_deinit(&vec);
+}
+
+/* 在中间插入一段: 逐个插入 (每次 memmove) vs insert_range (一次 memmove) */
+static void
+bench_insert(void)
+{
+  BENCH_GROUP("insert 64 elements into the middle of 4096");
+
+  Vec_u32 vec;
+  Vec_u32_init(&vec, &g_sys);
+  Vec_u32_resize_with(&vec, 4096, 0);
+
+  BENCH("insert_range one by one", ITERS / 10, {
+    for (usize i = 0; i < CHUNK; i++)
+    {
+      Vec_u32_insert_range(&vec, 2048 + i, &g_chunk[i], 1);
+    }
+    Vec_u32_remove_range(&vec, 2048, 2048 + CHUNK);
+    bench_clobber(vec.data);
+  });
+
+  BENCH("insert_range (whole slice)", ITERS / 10, {
+    Vec_u32_insert_range(&vec, 2048, g_chunk, CHUNK);
+    Vec_u32_remove_range(&vec, 2048, 2048 + CHUNK);
+    bench_clobber(vec.data);
+  });
+
+  Vec_u32_deinit(&vec);
+}
+
+/* 从空开始增长到 1M 个元素: 翻倍时整体搬迁 vs 只分配新段 */
+#define GROW_TO (1u << 20)
+
+static void
+bench_grow(void)
+{
+  BENCH_GROUP("grow to 1M elements, then sum");
+
+  BENCH("vector push (realloc + copy)", 20, {
+    Vec_u32 vec;
+    Vec_u32_init(&vec, &g_sys);
+    for (u32 i = 0; i < GROW_TO; i++)
+    {
+      Vec_u32_push(&vec, i);
+    }
+    bench_clobber(vec.data);
+    Vec_u32_deinit(&vec);
+  });
+
+  BENCH("segvec push (stable segments)", 20, {
+    SegVec_u32 vec;
+    SegVec_u32_init(&vec, &g_sys);
+    for (u32 i = 0; i < GROW_TO; i++)
+    {
+      SegVec_u32_push(&vec, i);
+    }
+    bench_clobber(vec.segs);
+    SegVec_u32_deinit(&vec);
+  });
+
+  /*
+   * 上面两项都包含从系统拿新内存的缺页开销 (释放的大段会被 glibc 还给系统)。
+   * 段已分配好时, push 只是 *tail++ = x:
+   */
+  SegVec_u32 seg;
+  SegVec_u32_init(&seg, &g_sys);
+  SegVec_u32_reserve_to(&seg, GROW_TO);
+  BENCH("segvec push (segments reused after clear)", 20, {
+    SegVec_u32_clear(&seg);
+    for (u32 i = 0; i < GROW_TO; i++)
+    {
+      SegVec_u32_push(&seg, i);
+    }
+    bench_clobber(seg.segs);
+  });
+
+  u64 sum = 0;
+  BENCH("segvec sum via _get", 20, {
+    for (usize i = 0; i < GROW_TO; i++)
+    {
+      sum += *SegVec_u32_get(&seg, i);
+    }
+  });
+  BENCH("segvec sum via for_segvec_slices", 20, {
+    for_segvec_slices(SegVec_u32, s, &seg)
+    {
+      for (usize i = 0; i < s.len; i++)
+      {
+        sum += s.ptr[i];
+      }
+    }
+  });
+  bench_clobber(&sum);
+  SegVec_u32_deinit(&seg);
+}
+
+/* 只读一个字段: AoS 每次取 64 字节只用 8 字节, SoA 连续读 */
+#define BODIES (1u << 20)
+
+static void
+bench_soa(void)
+{
+  BENCH_GROUP("sum one field of 1M 64-byte structs");
+
+  Vec_body aos;
+  Vec_body_init(&aos, &g_sys);
+  Bodies soa;
+  Bodies_init(&soa, &g_sys);
+  for (u32 i = 0; i < BODIES; i++)
+  {
+    Vec_body_push(&aos, (Body){.mass = (f64)i, .id = i});
+    Bodies_push(&soa, (Bodies_Row){.mass = (f64)i, .id = i});
+  }
+
+  f64 sum = 0;
+  BENCH("DEFINE_VECTOR of structs (AoS)", 50, {
+    const Body *b = Vec_body_as_const_ptr(&aos);
+    for (usize i = 0; i < BODIES; i++)
+    {
+      sum += b[i].mass;
+    }
+  });
+  BENCH("DEFINE_SOA_VECTOR mass column", 50, {
+    const f64 *mass = Bodies_mass_ptr(&soa);
+    for (usize i = 0; i < BODIES; i++)
+    {
+      sum += mass[i];
+    }
+  });
+  bench_clobber(&sum);
+
+  Vec_body_deinit(&aos);
+  Bodies_deinit(&soa);
+}
+
+int
+main(void)
+{
+  for (u32 i = 0; i < CHUNK; i++)
+  {
+    g_chunk[i] = i * 2654435761u;
+  }
+  bench_append();
+  bench_insert();
+  bench_grow();
+  bench_soa();
+  return 0;
+}
@@ -0,0 +1,654 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/core/fmt/num.c */
+
+#include <core/fmt/num.h>
+#include <core/fmt/pow10.h>
+#include <string.h> // memcpy
+
+/*
+ * ===================================================================
+ * 1. 整数
+ * ===================================================================
+ */
+
+/* "00" "01" ... "99" */
+static const char DIGIT_PAIRS[200] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
+static const char HEX_DIGITS[16] = "0123456789abcdef";
+
+static inline usize
+count_digits(u64 v)
+{
+  usize n = 1;
+  for (;;)
+  {
+    if (v < 10)
+    {
+      return n;
+    }
+    if (v < 100)
+    {
+      return n + 1;
+    }
+    if (v < 1000)
+    {
+      return n + 2;
+    }
+    if (v < 10000)
+    {
+      return n + 3;
+    }
+    v /= 10000;
+    n += 4;
+  }
+}
+
+/* 从 end 向前写出 v 的十进制数字 (调用者已按 count_digits 留好空间) */
+static inline void
+write_digits_backward(char *end, u64 v)
+{
+  while (v >= 100)
+  {
+    u64 q = v / 100;
+    usize r = (usize)(v - q * 100) * 2;
+    end -= 2;
+    memcpy(end, DIGIT_PAIRS + r, 2);
+    v = q;
+  }
+  if (v >= 10)
+  {
+    end -= 2;
+    memcpy(end, DIGIT_PAIRS + v * 2, 2);
+  }
+  else
+  {
+    *--end = (char)('0' + v);
+  }
+}
+
+usize
+fmt_u64(char *buf, u64 value)
+{
+  usize n = count_digits(value);
+  write_digits_backward(buf + n, value);
+  return n;
+}
+
+usize
+fmt_i64(char *buf, i64 value)
+{
+  if (value < 0)
+  {
+    buf[0] = '-';
+    /* 0 - (u64) 对 INT64_MIN 也正确 */
+    return 1 + fmt_u64(buf + 1, 0 - (u64)value);
+  }
+  return fmt_u64(buf, (u64)value);
+}
+
+static const char HEX_DIGITS_UPPER[16] = "0123456789ABCDEF";
+
+/* 2 的幂进制 (每位 bits 个二进制位), 按 digits 表查出每一位 */
+static inline usize
+write_radix_pow2(char *buf, u64 value, u32 bits, const char *digits)
+{
+  u64 mask = (1ull << bits) - 1;
+  usize n = 1;
+  while (n * bits < 64 && (value >> (n * bits)) != 0)
+  {
+    n++;
+  }
+  for (usize i = n; i > 0; i--)
+  {
+    buf[i - 1] = digits[value & mask];
+    value >>= bits;
+  }
+  return n;
+}
+
+usize
+fmt_hex_u64(char *buf, u64 value)
+{
+  return write_radix_pow2(buf, value, 4, HEX_DIGITS);
+}
+
+usize
+fmt_hex_upper_u64(char *buf, u64 value)
+{
+  return write_radix_pow2(buf, value, 4, HEX_DIGITS_UPPER);
+}
+
+usize
+fmt_bin_u64(char *buf, u64 value)
+{
+  return write_radix_pow2(buf, value, 1, HEX_DIGITS);
+}
+
+usize
+fmt_ptr(char *buf, const void *ptr)
+{
+  buf[0] = '0';
+  buf[1] = 'x';
+  return 2 + fmt_hex_u64(buf + 2, (u64)(uintptr_t)ptr);
+}
+
+/*
+ * ===================================================================
+ * 2. 浮点数: Schubfach
+ * ===================================================================
+ *
+ * 参考: Raffaello Giulietti, "The Schubfach way to render doubles" (2020)。
+ *
+ * 对二进制浮点数 v = c * 2^q, 它的舍入区间 [vl, vr] 内的任何十进制数
+ * 解析回来都等于 v。算法选一个 k, 使 10^-k * v 落在一个足够窄的整数范围内,
+ * 然后只需检查 s = floor(v * 10^-k) 及其十分之一是否落在区间内。
+ * 乘法 v * 10^-k 借助 pow10 表做 128 位 (f32 为 64 位) 的定点运算,
+ * 结果向奇数舍入 (round-to-odd), 从而能精确判断边界。
+ */
+
+/* floor(e * log10(2)) */
+static inline i32
+floor_log10_pow2(i32 e)
+{
+  return (e * 1262611) >> 22;
+}
+
+/* floor(e * log10(2) - log10(4/3)) */
+static inline i32
+floor_log10_three_quarters_pow2(i32 e)
+{
+  return (e * 1262611 - 524031) >> 22;
+}
+
+/* floor(e * log2(10)) */
+static inline i32
+floor_log2_pow10(i32 e)
+{
+  return (e * 1741647) >> 19;
+}
+
+/* (g * cp) >> 128, 不为整数时把最低位置 1 (round-to-odd) */
+static inline u64
+round_to_odd_64(u64 g_hi, u64 g_lo, u64 cp)
+{
+  __uint128_t x = (__uint128_t)g_lo * cp;
+  __uint128_t y = (__uint128_t)g_hi * cp + (u64)(x >> 64);
+  u64 y1 = (u64)(y >> 64);
+  u64 y0 = (u64)y;
+  return y1 | (y0 > 1);
+}
+
+/* (g * cp) >> 64, 不为整数时把最低位置 1 (round-to-odd) */
+static inline u32
+round_to_odd_32(u64 g, u32 cp)
+{
+  u64 b01 = (u64)(u32)g * cp;
+  u64 b11 = (g >> 32) * cp;
+  u64 hi = b11 + (b01 >> 32);
+  u32 y1 = (u32)(hi >> 32);
+  u32 y0 = (u32)hi;
+  return y1 | (y0 > 1);
+}
+
+/* 十进制结果: value = digits * 10^exp */
+typedef struct
+{
+  u64 digits;
+  i32 exp;
+} Decimal;
+
+/*
+ * 在 [lower, upper] 内找最短的数字串。
+ * 先试 s/10 (少一位), 再试 s 和 s+1, 最后退回到最接近 vb 的那个。
+ */
+#define SCHUBFACH_PICK(T, s, vb, lower, upper, k)                                                  \
+  do                                                                                               \
+  {                                                                                                \
+    if ((s) >= 10)                                                                                 \
+    {                                                                                              \
+      T sp = (s) / 10;                                                                             \
+      bool u_in = (lower) <= 40 * sp;                                                              \
+      bool w_in = 40 * sp + 40 <= (upper);                                                         \
+      if (u_in != w_in)                                                                            \
+      {                                                                                            \
+        return (Decimal){sp + w_in, (k) + 1};                                                      \
+      }                                                                                            \
+    }                                                                                              \
+    bool u_in = (lower) <= 4 * (s);                                                                \
+    bool w_in = 4 * (s) + 4 <= (upper);                                                            \
+    if (u_in != w_in)                                                                              \
+    {                                                                                              \
+      return (Decimal){(s) + w_in, (k)};                                                           \
+    }                                                                                              \
+    T mid = 4 * (s) + 2;                                                                           \
+    bool round_up = (vb) > mid || ((vb) == mid && ((s) & 1) != 0);                                 \
+    return (Decimal){(s) + round_up, (k)};                                                         \
+  } while (0)
+
+/* 要求 bits 是有限且非零的 f64 */
+static Decimal
+to_decimal_f64(u64 bits)
+{
+  u64 fraction = bits & ((1ull << 52) - 1);
+  i32 biased = (i32)((bits >> 52) & 0x7ff);
+  u64 c;
+  i32 q;
+
+  if (biased != 0)
+  {
+    c = (1ull << 52) | fraction;
+    q = biased - 1075;
+    /* 快速路径: 小整数 */
+    if (q <= 0 && q > -53 && (c & ((1ull << -q) - 1)) == 0)
+    {
+      return (Decimal){c >> -q, 0};
+    }
+  }
+  else
+  {
+    c = fraction;
+    q = -1074;
+  }
+
+  bool is_even = (c & 1) == 0;
+  bool lower_closer = fraction == 0 && biased > 1;
+
+  u64 cbl = 4 * c - 2 + lower_closer;
+  u64 cb = 4 * c;
+  u64 cbr = 4 * c + 2;
+
+  i32 k = lower_closer ? floor_log10_three_quarters_pow2(q) : floor_log10_pow2(q);
+  i32 h = q + floor_log2_pow10(-k) + 1;
+
+  /* 表中是向下取整的值, +1 得到向上取整的 g */
+  const u64 *g = fmt_pow10_128[-k - FMT_POW10_MIN];
+  u64 g_lo = g[1] + 1;
+  u64 g_hi = g[0] + (g_lo == 0);
+
+  u64 vbl = round_to_odd_64(g_hi, g_lo, cbl << h);
+  u64 vb = round_to_odd_64(g_hi, g_lo, cb << h);
+  u64 vbr = round_to_odd_64(g_hi, g_lo, cbr << h);
+
+  u64 lower = vbl + !is_even;
+  u64 upper = vbr - !is_even;
+  u64 s = vb / 4;
+
+  SCHUBFACH_PICK(u64, s, vb, lower, upper, k);
+}
+
+/* 要求 bits 是有限且非零的 f32 */
+static Decimal
+to_decimal_f32(u32 bits)
+{
+  u32 fraction = bits & ((1u << 23) - 1);
+  i32 biased = (i32)((bits >> 23) & 0xff);
+  u32 c;
+  i32 q;
+
+  if (biased != 0)
+  {
+    c = (1u << 23) | fraction;
+    q = biased - 150;
+    if (q <= 0 && q > -24 && (c & ((1u << -q) - 1)) == 0)
+    {
+      return (Decimal){c >> -q, 0};
+    }
+  }
+  else
+  {
+    c = fraction;
+    q = -149;
+  }
+
+  bool is_even = (c & 1) == 0;
+  bool lower_closer = fraction == 0 && biased > 1;
+
+  u32 cbl = 4 * c - 2 + lower_closer;
+  u32 cb = 4 * c;
+  u32 cbr = 4 * c + 2;
+
+  i32 k = lower_closer ? floor_log10_three_quarters_pow2(q) : floor_log10_pow2(q);
+  i32 h = q + floor_log2_pow10(-k) + 1;
+
+  /* f32 只需要 64 位精度: 取高 64 位并向上取整 */
+  u64 g = fmt_pow10_128[-k - FMT_POW10_MIN][0] + 1;
+
+  u32 vbl = round_to_odd_32(g, cbl << h);
+  u32 vb = round_to_odd_32(g, cb << h);
+  u32 vbr = round_to_odd_32(g, cbr << h);
+
+  u32 lower = vbl + !is_even;
+  u32 upper = vbr - !is_even;
+  u32 s = vb / 4;
+
+  SCHUBFACH_PICK(u32, s, vb, lower, upper, k);
+}
+
+#undef SCHUBFACH_PICK
+
+/*
+ * ===================================================================
+ * 3. 浮点数: 文本布局
+ * ===================================================================
+ */
+
+/*
+ * 把 digits * 10^exp 按 Python repr 的规则排版:
+ * 小数点位置 decpt 在 (-4, 16] 内用定点表示, 否则用科学计数法。
+ */
+static usize
+write_decimal(char *buf, bool negative, Decimal d)
+{
+  while (d.digits % 10 == 0)
+  {
+    d.digits /= 10;
+    d.exp++;
+  }
+
+  char digits[20];
+  i32 n = (i32)fmt_u64(digits, d.digits);
+  i32 decpt = n + d.exp; /* value = 0.digits * 10^decpt */
+
+  char *p = buf;
+  if (negative)
+  {
+    *p++ = '-';
+  }
+
+  if (decpt > -4 && decpt <= 16)
+  {
+    if (decpt <= 0)
+    {
+      /* 0.000ddd */
+      *p++ = '0';
+      *p++ = '.';
+      memset(p, '0', (usize)-decpt);
+      p += -decpt;
+      memcpy(p, digits, (usize)n);
+      p += n;
+    }
+    else if (decpt >= n)
+    {
+      /* ddd000.0 */
+      memcpy(p, digits, (usize)n);
+      p += n;
+      memset(p, '0', (usize)(decpt - n));
+      p += decpt - n;
+      *p++ = '.';
+      *p++ = '0';
+    }
+    else
+    {
+      /* ddd.ddd */
+      memcpy(p, digits, (usize)decpt);
+      p += decpt;
+      *p++ = '.';
+      memcpy(p, digits + decpt, (usize)(n - decpt));
+      p += n - decpt;
+    }
+  }
+  else
+  {
+    /* d.ddde+XX */
+    *p++ = digits[0];
+    if (n > 1)
+    {
+      *p++ = '.';
+      memcpy(p, digits + 1, (usize)(n - 1));
+      p += n - 1;
+    }
+    *p++ = 'e';
+    i32 e = decpt - 1;
+    if (e < 0)
+    {
+      *p++ = '-';
+      e = -e;
+    }
+    else
+    {
+      *p++ = '+';
+    }
+    if (e < 10)
+    {
+      *p++ = '0';
+    }
+    p += fmt_u64(p, (u64)e);
+  }
+
+  return (usize)(p - buf);
+}
+
+/* nan / inf / 0 的公共处理, 返回 0 表示是普通的非零有限值 */
+static inline usize
+write_special(char *buf, bool negative, bool is_nan, bool is_inf, bool is_zero)
+{
+  if (is_nan)
+  {
+    memcpy(buf, "nan", 3);
+    return 3;
+  }
+  usize n = 0;
+  if (negative)
+  {
+    buf[n++] = '-';
+  }
+  if (is_inf)
+  {
+    memcpy(buf + n, "inf", 3);
+    return n + 3;
+  }
+  if (is_zero)
+  {
+    memcpy(buf + n, "0.0", 3);
+    return n + 3;
+  }
+  return 0;
+}
+
+usize
+fmt_f64(char *buf, f64 value)
+{
+  u64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  bool negative = (bits >> 63) != 0;
+  u64 biased = (bits >> 52) & 0x7ff;
+  u64 fraction = bits & ((1ull << 52) - 1);
+
+  usize n = write_special(buf,
+                          negative,
+                          biased == 0x7ff && fraction != 0,
+                          biased == 0x7ff && fraction == 0,
+                          biased == 0 && fraction == 0);
+  if (n != 0)
+  {
+    return n;
+  }
+  return write_decimal(buf, negative, to_decimal_f64(bits));
+}
+
+usize
+fmt_f32(char *buf, f32 value)
+{
+  u32 bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  bool negative = (bits >> 31) != 0;
+  u32 biased = (bits >> 23) & 0xff;
+  u32 fraction = bits & ((1u << 23) - 1);
+
+  usize n = write_special(buf,
+                          negative,
+                          biased == 0xff && fraction != 0,
+                          biased == 0xff && fraction == 0,
+                          biased == 0 && fraction == 0);
+  if (n != 0)
+  {
+    return n;
+  }
+  return write_decimal(buf, negative, to_decimal_f32(bits));
+}
+
+/*
+ * ===================================================================
+ * 4. 浮点数: 指定精度的定点表示
+ * ===================================================================
+ *
+ * v = m * 2^e。对 e < 0, 要求的是 round(m * 10^p / 2^-e),
+ * m < 2^53 且 10^p < 2^64, 乘积放得进 128 位, 移位时按
+ * "四舍六入五成双" 处理被移出的部分, 结果是精确的。
+ * e >= 0 时 v 本身是整数, 小数部分全是 0。
+ */
+
+static const u64 POW10_U64[FMT_MAX_PRECISION + 1] = {
+  1ull,
+  10ull,
+  100ull,
+  1000ull,
+  10000ull,
+  100000ull,
+  1000000ull,
+  10000000ull,
+  100000000ull,
+  1000000000ull,
+  10000000000ull,
+  100000000000ull,
+  1000000000000ull,
+  10000000000000ull,
+  100000000000000ull,
+  1000000000000000ull,
+  10000000000000000ull,
+  100000000000000000ull,
+  1000000000000000000ull,
+  10000000000000000000ull,
+};
+
+/* 写出恰好 width 位的十进制数字 (左侧补 0) */
+static inline void
+write_digits_fixed(char *buf, u64 v, usize width)
+{
+  memset(buf, '0', width);
+  if (v != 0)
+  {
+    write_digits_backward(buf + width, v);
+  }
+}
+
+/* 128 位无符号整数的十进制表示: 按 10^19 分块 */
+static usize
+fmt_u128(char *buf, __uint128_t v)
+{
+  if ((v >> 64) == 0)
+  {
+    return fmt_u64(buf, (u64)v);
+  }
+  __uint128_t hi = v / POW10_U64[19];
+  u64 lo = (u64)(v - hi * POW10_U64[19]);
+  usize n = fmt_u128(buf, hi);
+  write_digits_fixed(buf + n, lo, 19);
+  return n + 19;
+}
+
+usize
+fmt_f64_fixed(char *buf, f64 value, u32 precision)
+{
+  if (precision > FMT_MAX_PRECISION)
+  {
+    precision = FMT_MAX_PRECISION;
+  }
+
+  u64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  bool negative = (bits >> 63) != 0;
+  u64 biased = (bits >> 52) & 0x7ff;
+  u64 fraction = bits & ((1ull << 52) - 1);
+
+  if (biased == 0x7ff)
+  {
+    return write_special(buf, negative, fraction != 0, fraction == 0, false);
+  }
+
+  char *p = buf;
+  if (negative)
+  {
+    *p++ = '-';
+  }
+
+  u64 m = biased == 0 ? fraction : fraction | (1ull << 52);
+  i32 e = biased == 0 ? -1074 : (i32)biased - 1075;
+
+  if (e >= 0)
+  {
+    if (e <= 64)
+    {
+      p += fmt_u128(p, (__uint128_t)m << e);
+    }
+    else
+    {
+      /* 超过 2^117: 用最短往返表示的数字补 0 (不再逐位精确) */
+      Decimal d = to_decimal_f64(bits & ~(1ull << 63));
+      p += fmt_u64(p, d.digits);
+      memset(p, '0', (usize)d.exp);
+      p += d.exp;
+    }
+    if (precision != 0)
+    {
+      *p++ = '.';
+      memset(p, '0', precision);
+      p += precision;
+    }
+    return (usize)(p - buf);
+  }
+
+  /* n = round(m * 10^p / 2^s), 结果小于 2^117 */
+  __uint128_t scaled = (__uint128_t)m * POW10_U64[precision];
+  u32 s = (u32)-e;
+  __uint128_t n = 0;
+  if (s <= 117)
+  {
+    n = scaled >> s;
+    __uint128_t rem = scaled & ((((__uint128_t)1) << s) - 1);
+    __uint128_t half = ((__uint128_t)1) << (s - 1);
+    if (rem > half || (rem == half && (n & 1) != 0))
+    {
+      n++;
+    }
+  }
+
+  __uint128_t int_part = n / POW10_U64[precision];
+  p += fmt_u128(p, int_part);
+  if (precision != 0)
+  {
+    *p++ = '.';
+    write_digits_fixed(p, (u64)(n - int_part * POW10_U64[precision]), precision);
+    p += precision;
+  }
+  return (usize)(p - buf);
+}
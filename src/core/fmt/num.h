@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/core/fmt/num.h */
+#pragma once
+
+/**
+ * @file
+ * @brief 数字 -> 文本的快速转换 (不依赖 snprintf 和 locale)。
+ *
+ * - 整数: 每次除以 100, 用 "两位数字表" 一次写出两个字符。
+ * - 浮点数: Schubfach 算法, 输出能精确往返 (round-trip) 的最短十进制表示,
+ * 风格与 Python 的 repr 一致:
+ * 1.0, 0.1, 123.456, 1e+16, 1.5e-05, -0.0, nan, inf, -inf
+ *
+ * 所有函数都把结果写入调用者提供的缓冲区 (不写 '\0'), 返回写入的字节数。
+ * 缓冲区至少需要 FMT_NUM_BUF_SIZE 字节。
+ */
+
+#include <core/type.h> // u64, i64, f32, f64, usize
+
+/** @brief 任意一个 fmt_* 函数输出的最大长度 (含余量)。 */
+#define FMT_NUM_BUF_SIZE 32
+
+/** @brief fmt_bin_u64 输出的最大长度。 */
+#define FMT_NUM_BIN_BUF_SIZE 64
+
+/** @brief fmt_f64_fixed 支持的最大精度。 */
+#define FMT_MAX_PRECISION 19
+
+/** @brief fmt_f64_fixed 输出的最大长度: 符号 + 309 位整数 + '.' + 19 位小数 (含余量)。 */
+#define FMT_FIXED_BUF_SIZE 352
+
+/** @brief 无符号整数的十进制表示。 */
+usize fmt_u64(char *buf, u64 value);
+
+/** @brief 有符号整数的十进制表示。 */
+usize fmt_i64(char *buf, i64 value);
+
+/** @brief 无符号整数的十六进制表示 (小写, 无前缀)。 */
+usize fmt_hex_u64(char *buf, u64 value);
+
+/** @brief 无符号整数的十六进制表示 (大写, 无前缀)。 */
+usize fmt_hex_upper_u64(char *buf, u64 value);
+
+/** @brief 无符号整数的二进制表示 (无前缀, 最多 64 位, 需要 FMT_NUM_BIN_BUF_SIZE 字节)。 */
+usize fmt_bin_u64(char *buf, u64 value);
+
+/** @brief f64 的最短往返表示。 */
+usize fmt_f64(char *buf, f64 value);
+
+/**
+ * @brief f32 的最短往返表示。
+ *
+ * 按 f32 的精度取最短: 0.1f 输出 "0.1", 而不是 "0.10000000149011612"。
+ */
+usize fmt_f32(char *buf, f32 value);
+
+/**
+ * @brief f64 的定点表示, 小数点后恰好 precision 位 (四舍六入五成双)。
+ *
+ * 按 v 的精确二进制值舍入, 与 printf("%.*f") 一致: 2.675 -> "2.67"。
+ * |v| >= 2^117 时整数部分用最短往返表示的数字补 0。
+ * precision 超过 FMT_MAX_PRECISION 时按 FMT_MAX_PRECISION 处理。
+ */
+usize fmt_f64_fixed(char *buf, f64 value, u32 precision);
+
+/** @brief 指针地址, 形如 "0x7ffd5c1e2a40"。 */
+usize fmt_ptr(char *buf, const void *ptr);
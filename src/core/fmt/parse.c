@@ -0,0 +1,561 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/core/fmt/parse.c */
+
+#include <core/fmt/num.h> // fmt_i64
+#include <core/fmt/parse.h>
+#include <core/fmt/pow10.h>
+#include <stdlib.h> // strtod (慢路径)
+#include <string.h> // memcpy
+
+/*
+ * ===================================================================
+ * 1. SWAR: 一次处理 8 个数字
+ * ===================================================================
+ */
+
+static inline bool
+is_digit(char c)
+{
+  return (unsigned char)(c - '0') < 10;
+}
+
+/* 按小端序读入 8 个字节 */
+static inline u64
+load_u64_le(const char *p)
+{
+  u64 val;
+  memcpy(&val, p, sizeof(val));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  val = __builtin_bswap64(val);
+#endif
+  return val;
+}
+
+/* 8 个字节是否全是 '0'..'9' */
+static inline bool
+is_eight_digits(u64 val)
+{
+  return ((val & 0xF0F0F0F0F0F0F0F0ull) |
+          (((val + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+         0x3333333333333333ull;
+}
+
+/* 把 8 个 ASCII 数字合成一个整数: 先两两合并, 再用两次乘法合并成 4 位和 8 位 */
+static inline u32
+parse_eight_digits(u64 val)
+{
+  const u64 mask = 0x000000FF000000FFull;
+  const u64 mul1 = 0x000F424000000064ull; /* 100 + (1000000 << 32) */
+  const u64 mul2 = 0x0000271000000001ull; /* 1 + (10000 << 32) */
+  val -= 0x3030303030303030ull;
+  val = (val * 10) + (val >> 8);
+  val = (((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32;
+  return (u32)val;
+}
+
+/*
+ * ===================================================================
+ * 2. 整数
+ * ===================================================================
+ */
+
+/* 解析 [p, end) 中的无符号数字串 (至少一位) */
+static Result_u64_ParseError
+parse_digits_u64(const char *p, const char *end)
+{
+  if (p == end)
+  {
+    return Err(u64, ParseError, PARSE_EMPTY);
+  }
+
+  /* 前 16 位不会溢出 (10^16 < 2^64), 可以放心地按 8 位一组累加 */
+  u64 value = 0;
+  const char *fast_end = end - p > 16 ? p + 16 : end;
+  while (fast_end - p >= 8)
+  {
+    u64 chunk = load_u64_le(p);
+    if (!is_eight_digits(chunk))
+    {
+      break;
+    }
+    value = value * 100000000 + parse_eight_digits(chunk);
+    p += 8;
+  }
+
+  for (; p < end; p++)
+  {
+    if (!is_digit(*p))
+    {
+      return Err(u64, ParseError, PARSE_INVALID);
+    }
+    if (__builtin_mul_overflow(value, 10, &value) ||
+        __builtin_add_overflow(value, (u64)(*p - '0'), &value))
+    {
+      /* 仍然要区分 "非法字符" 和 "溢出" */
+      for (p++; p < end; p++)
+      {
+        if (!is_digit(*p))
+        {
+          return Err(u64, ParseError, PARSE_INVALID);
+        }
+      }
+      return Err(u64, ParseError, PARSE_OVERFLOW);
+    }
+  }
+  return Ok(u64, ParseError, value);
+}
+
+Result_u64_ParseError
+vstr_parse_u64(vstr v)
+{
+  const char *p = v.ptr;
+  const char *end = v.ptr + v.len;
+  if (p != end && *p == '+')
+  {
+    p++;
+  }
+  return parse_digits_u64(p, end);
+}
+
+Result_i64_ParseError
+vstr_parse_i64(vstr v)
+{
+  const char *p = v.ptr;
+  const char *end = v.ptr + v.len;
+  bool negative = false;
+  if (p != end && (*p == '+' || *p == '-'))
+  {
+    negative = *p == '-';
+    p++;
+  }
+
+  Result_u64_ParseError r = parse_digits_u64(p, end);
+  if (ris_err(r))
+  {
+    return Err(i64, ParseError, r.value.err);
+  }
+
+  u64 magnitude = r.value.ok;
+  u64 limit = negative ? (u64)INT64_MAX + 1 : (u64)INT64_MAX;
+  if (magnitude > limit)
+  {
+    return Err(i64, ParseError, PARSE_OVERFLOW);
+  }
+  return Ok(i64, ParseError, negative ? (i64)(0 - magnitude) : (i64)magnitude);
+}
+
+/*
+ * ===================================================================
+ * 3. 浮点数
+ * ===================================================================
+ */
+
+/* 最多累积的有效数字 (10^19 < 2^64) */
+#define MAX_MANTISSA_DIGITS 19
+
+/* Clinger 快速路径: 10^0 .. 10^22 都能被 f64 精确表示 */
+static const f64 EXACT_POW10[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/* 词法分析的结果: value = w * 10^q (w 可能被截断到 19 位) */
+typedef struct
+{
+  u64 w;
+  i64 q;
+  bool truncated;
+  const char *int_start, *int_end;   /* 整数部分的数字 */
+  const char *frac_start, *frac_end; /* 小数部分的数字 */
+  i64 exp_explicit;                  /* e 后面的指数 (已限幅) */
+} DecimalParts;
+
+/* 不区分大小写地匹配 [p, end) 是否恰好是 word */
+static inline bool
+match_word(const char *p, const char *end, const char *word)
+{
+  usize n = strlen(word);
+  if ((usize)(end - p) != n)
+  {
+    return false;
+  }
+  for (usize i = 0; i < n; i++)
+  {
+    if ((p[i] | 0x20) != word[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* 扫描数字, 返回 false 表示语法错误 */
+static bool
+lex_decimal(const char *p, const char *end, DecimalParts *out)
+{
+  u64 w = 0;
+
+  out->int_start = p;
+  while (p < end && is_digit(*p))
+  {
+    w = w * 10 + (u64)(*p - '0'); /* 位数过多时溢出, 下面会重新计算 */
+    p++;
+  }
+  out->int_end = p;
+
+  out->frac_start = out->frac_end = p;
+  if (p < end && *p == '.')
+  {
+    p++;
+    out->frac_start = p;
+    while (end - p >= 8)
+    {
+      u64 chunk = load_u64_le(p);
+      if (!is_eight_digits(chunk))
+      {
+        break;
+      }
+      w = w * 100000000 + parse_eight_digits(chunk);
+      p += 8;
+    }
+    while (p < end && is_digit(*p))
+    {
+      w = w * 10 + (u64)(*p - '0');
+      p++;
+    }
+    out->frac_end = p;
+  }
+
+  i64 digit_count = (out->int_end - out->int_start) + (out->frac_end - out->frac_start);
+  if (digit_count == 0)
+  {
+    return false;
+  }
+
+  out->exp_explicit = 0;
+  if (p < end && (*p | 0x20) == 'e')
+  {
+    p++;
+    bool exp_negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+    {
+      exp_negative = *p == '-';
+      p++;
+    }
+    if (p == end || !is_digit(*p))
+    {
+      return false;
+    }
+    i64 e = 0;
+    for (; p < end && is_digit(*p); p++)
+    {
+      /* 限幅: 再大的指数结果也只是 inf 或 0 */
+      if (e < 0x10000)
+      {
+        e = e * 10 + (*p - '0');
+      }
+    }
+    out->exp_explicit = exp_negative ? -e : e;
+  }
+  if (p != end)
+  {
+    return false;
+  }
+
+  out->w = w;
+  out->q = out->exp_explicit - (out->frac_end - out->frac_start);
+  out->truncated = false;
+
+  if (digit_count > MAX_MANTISSA_DIGITS)
+  {
+    /* 前导零不算有效数字 */
+    const char *s = out->int_start;
+    while (s < out->frac_end && (*s == '0' || *s == '.'))
+    {
+      digit_count -= *s == '0';
+      s++;
+    }
+
+    if (digit_count > MAX_MANTISSA_DIGITS)
+    {
+      /* 只保留前 19 位有效数字 */
+      out->truncated = true;
+      w = 0;
+      s = out->int_start;
+      while (w < 1000000000000000000ull && s < out->int_end)
+      {
+        w = w * 10 + (u64)(*s++ - '0');
+      }
+      if (w >= 1000000000000000000ull)
+      {
+        out->q = out->exp_explicit + (out->int_end - s);
+      }
+      else
+      {
+        s = out->frac_start;
+        while (w < 1000000000000000000ull && s < out->frac_end)
+        {
+          w = w * 10 + (u64)(*s++ - '0');
+        }
+        out->q = out->exp_explicit - (s - out->frac_start);
+      }
+      out->w = w;
+    }
+  }
+  return true;
+}
+
+/* 二进制结果: 尚未加上符号位的 f64 位模式, 失败时 power2 < 0 */
+typedef struct
+{
+  u64 mantissa;
+  i32 power2;
+} AdjustedMantissa;
+
+#define F64_MANTISSA_BITS 52
+#define F64_INFINITE_POWER 0x7FF
+
+/* floor(log2(10^q)) + 63 */
+static inline i32
+power_of_q(i32 q)
+{
+  return (((152170 + 65536) * q) >> 16) + 63;
+}
+
+/*
+ * w * 10^q 的 128 位截断乘积, 至少精确到高 55 位。
+ *
+ * 表中存的是向下取整的尾数; Eisel-Lemire 的正确性证明要求
+ * -27 <= q < 0 时使用向上取整的值 (这些 5^-q 的倒数不是整数, 且
+ * 128 位能装下全部有效位), 所以这里把它们 +1。
+ */
+static inline __uint128_t
+product_approximation(i64 q, u64 w)
+{
+  const u64 *entry = fmt_pow10_128[q - FMT_POW10_MIN];
+  u64 hi = entry[0];
+  u64 lo = entry[1];
+  if (q < 0 && q >= -27)
+  {
+    lo++;
+    hi += lo == 0;
+  }
+
+  const u64 precision_mask = ~0ull >> (F64_MANTISSA_BITS + 3);
+  __uint128_t first = (__uint128_t)w * hi;
+  if (((u64)(first >> 64) & precision_mask) == precision_mask)
+  {
+    __uint128_t second = (__uint128_t)w * lo;
+    u64 first_lo = (u64)first + (u64)(second >> 64);
+    u64 first_hi = (u64)(first >> 64) + (first_lo < (u64)(second >> 64));
+    first = ((__uint128_t)first_hi << 64) | first_lo;
+  }
+  return first;
+}
+
+/* Eisel-Lemire: 把 w * 10^q 舍入到最近的 f64 */
+static AdjustedMantissa
+compute_float(i64 q, u64 w)
+{
+  if (w == 0 || q < FMT_POW10_MIN)
+  {
+    return (AdjustedMantissa){0, 0};
+  }
+  if (q > 308)
+  {
+    return (AdjustedMantissa){0, F64_INFINITE_POWER};
+  }
+
+  i32 lz = __builtin_clzll(w);
+  w <<= lz;
+  __uint128_t product = product_approximation(q, w);
+  u64 product_hi = (u64)(product >> 64);
+  u64 product_lo = (u64)product;
+
+  i32 upperbit = (i32)(product_hi >> 63);
+  i32 shift = upperbit + 64 - F64_MANTISSA_BITS - 3;
+  AdjustedMantissa am = {
+    .mantissa = product_hi >> shift,
+    .power2 = power_of_q((i32)q) + upperbit - lz + 1023,
+  };
+
+  if (am.power2 <= 0)
+  {
+    /* 次正规数 */
+    if (-am.power2 + 1 >= 64)
+    {
+      return (AdjustedMantissa){0, 0};
+    }
+    am.mantissa >>= -am.power2 + 1;
+    am.mantissa += am.mantissa & 1;
+    am.mantissa >>= 1;
+    am.power2 = am.mantissa < (1ull << F64_MANTISSA_BITS) ? 0 : 1;
+    return am;
+  }
+
+  /* 恰好位于两个 f64 正中间时, 舍入到偶数 */
+  if (product_lo <= 1 && q >= -4 && q <= 23 && (am.mantissa & 3) == 1 &&
+      (am.mantissa << shift) == product_hi)
+  {
+    am.mantissa &= ~1ull;
+  }
+
+  am.mantissa += am.mantissa & 1;
+  am.mantissa >>= 1;
+  if (am.mantissa >= (2ull << F64_MANTISSA_BITS))
+  {
+    am.mantissa = 1ull << F64_MANTISSA_BITS;
+    am.power2++;
+  }
+  am.mantissa &= ~(1ull << F64_MANTISSA_BITS);
+  if (am.power2 >= F64_INFINITE_POWER)
+  {
+    return (AdjustedMantissa){0, F64_INFINITE_POWER};
+  }
+  return am;
+}
+
+static inline f64
+to_f64(bool negative, AdjustedMantissa am)
+{
+  u64 bits = am.mantissa | ((u64)am.power2 << F64_MANTISSA_BITS) | ((u64)negative << 63);
+  f64 value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/* 慢路径中保留的有效数字个数: 超过 f64 判定舍入所需的 767 位 */
+#define SLOW_MAX_DIGITS 800
+
+/* 慢路径的规范化状态: value = digits * 10^scale (+ 粘滞位) */
+typedef struct
+{
+  char *out;
+  usize kept;
+  bool sticky;
+  i64 scale;
+} SlowDigits;
+
+static inline void
+slow_push_digit(SlowDigits *self, char c, bool in_frac)
+{
+  if (self->kept == 0 && c == '0')
+  {
+    self->scale -= in_frac; /* 前导零 */
+  }
+  else if (self->kept < SLOW_MAX_DIGITS)
+  {
+    self->out[self->kept++] = c;
+    self->scale -= in_frac;
+  }
+  else
+  {
+    self->scale += !in_frac; /* 被丢弃的数字只留下粘滞位 */
+    self->sticky |= c != '0';
+  }
+}
+
+/*
+ * 慢路径: 把数字规范化成 "有效数字 + 粘滞位 + 指数" 的有界字符串, 交给 strtod。
+ * 只在有效数字超过 19 位且 w 与 w + 1 舍入结果不同时才会走到这里。
+ */
+static f64
+parse_slow(bool negative, const DecimalParts *parts)
+{
+  char buf[1 + SLOW_MAX_DIGITS + 2 + FMT_NUM_BUF_SIZE];
+  buf[0] = negative ? '-' : '+';
+
+  SlowDigits d = {.out = buf + 1, .kept = 0, .sticky = false, .scale = parts->exp_explicit};
+  for (const char *s = parts->int_start; s < parts->int_end; s++)
+  {
+    slow_push_digit(&d, *s, false);
+  }
+  for (const char *s = parts->frac_start; s < parts->frac_end; s++)
+  {
+    slow_push_digit(&d, *s, true);
+  }
+
+  if (d.kept == 0)
+  {
+    return negative ? -0.0 : 0.0;
+  }
+  usize len = 1 + d.kept;
+  if (d.sticky)
+  {
+    buf[len++] = '1';
+    d.scale--;
+  }
+  buf[len++] = 'e';
+  len += fmt_i64(buf + len, d.scale);
+  buf[len] = '\0';
+  return strtod(buf, NULL);
+}
+
+Result_f64_ParseError
+vstr_parse_f64(vstr v)
+{
+  const char *p = v.ptr;
+  const char *end = v.ptr + v.len;
+  bool negative = false;
+  if (p != end && (*p == '+' || *p == '-'))
+  {
+    negative = *p == '-';
+    p++;
+  }
+  if (p == end)
+  {
+    return Err(f64, ParseError, PARSE_EMPTY);
+  }
+
+  DecimalParts parts;
+  if (!lex_decimal(p, end, &parts))
+  {
+    if (match_word(p, end, "inf") || match_word(p, end, "infinity"))
+    {
+      return Ok(f64, ParseError, negative ? -__builtin_inf() : __builtin_inf());
+    }
+    if (match_word(p, end, "nan"))
+    {
+      return Ok(f64, ParseError, negative ? -__builtin_nan("") : __builtin_nan(""));
+    }
+    return Err(f64, ParseError, PARSE_INVALID);
+  }
+
+  /* Clinger: w 和 10^|q| 都能精确表示时, 一次 IEEE 乘除就是正确舍入的结果 */
+  if (!parts.truncated && parts.q >= -22 && parts.q <= 22 &&
+      parts.w <= (1ull << (F64_MANTISSA_BITS + 1)))
+  {
+    f64 value = (f64)parts.w;
+    value = parts.q < 0 ? value / EXACT_POW10[-parts.q] : value * EXACT_POW10[parts.q];
+    return Ok(f64, ParseError, negative ? -value : value);
+  }
+
+  AdjustedMantissa am = compute_float(parts.q, parts.w);
+  if (parts.truncated)
+  {
+    /* 真实值在 w 和 w + 1 之间: 两端舍入一致时结果确定 */
+    AdjustedMantissa upper = compute_float(parts.q, parts.w + 1);
+    if (upper.mantissa != am.mantissa || upper.power2 != am.power2)
+    {
+      return Ok(f64, ParseError, parse_slow(negative, &parts));
+    }
+  }
+  return Ok(f64, ParseError, to_f64(negative, am));
+}
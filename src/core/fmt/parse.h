@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/core/fmt/parse.h */
+#pragma once
+
+/**
+ * @file
+ * @brief 文本 -> 数字的快速解析 (num.h 的反方向)。
+ *
+ * 直接作用于 vstr, 不要求 '\0' 结尾, 也不依赖 locale:
+ * - 整数: SWAR, 一次把 8 个 ASCII 数字合成一个整数。
+ * - 浮点数: Clinger 快速路径 + Eisel-Lemire 算法 (与 fmt_f64 共享
+ * pow10.h 中的 128 位尾数表); 有效数字超过 19 位且无法判定舍入时,
+ * 才退回 strtod (只拷贝有界的规范化数字串)。
+ *
+ * 整个 vstr 必须恰好是一个数字: 不跳过空白, 不接受尾随字符。
+ * - 整数: [+-]?[0-9]+ (u64 只接受 '+')
+ * - 浮点数: [+-]?([0-9]+(\.[0-9]*)?|\.[0-9]+)([eE][+-]?[0-9]+)?
+ * 以及 inf, infinity, nan (不区分大小写)。
+ * 超出范围的浮点数得到 ±inf 或 ±0.0 (与 strtod 相同), 不视为错误。
+ */
+
+#include <core/result.h> // DEFINE_RESULT
+#include <core/type.h>   // vstr, u64, i64, f64
+
+/** @brief 解析失败的原因。 */
+typedef enum ParseError
+{
+  PARSE_EMPTY,    /* 输入为空 (或只有符号) */
+  PARSE_INVALID,  /* 含有非法字符 */
+  PARSE_OVERFLOW, /* 整数超出目标类型的范围 */
+} ParseError;
+
+DEFINE_RESULT(u64, ParseError)
+DEFINE_RESULT(i64, ParseError)
+DEFINE_RESULT(f64, ParseError)
+
+/** @brief 把 vstr 解析为 u64。 */
+Result_u64_ParseError vstr_parse_u64(vstr v);
+
+/** @brief 把 vstr 解析为 i64。 */
+Result_i64_ParseError vstr_parse_i64(vstr v);
+
+/**
+ * @brief 把 vstr 解析为最接近的 f64 (round-to-nearest-even)。
+ *
+ * 对 fmt_f64 的输出精确往返: vstr_parse_f64(fmt_f64(x)) == x。
+ */
+Result_f64_ParseError vstr_parse_f64(vstr v);
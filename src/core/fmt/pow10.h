@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/core/fmt/pow10.h */
+#pragma once
+
+/**
+ * @file
+ * @brief (内部) 10 的幂的 128 位尾数表。
+ *
+ * 浮点数的 "最短往返" 格式化 (Schubfach) 和快速解析 (Eisel-Lemire)
+ * 都需要 10^m 的高精度近似值, 两者共享这一张表。
+ */
+
+#include <core/type.h> // u64
+
+/** @brief 表中最小的十进制指数 m。 */
+#define FMT_POW10_MIN (-342)
+/** @brief 表中最大的十进制指数 m。 */
+#define FMT_POW10_MAX 324
+
+/**
+ * @brief fmt_pow10_128[m - FMT_POW10_MIN] = { hi, lo }
+ *
+ * 128 位整数 (hi:lo) 等于 floor(10^m * 2^(127 - floor(log2(10^m)))),
+ * 即最高位恒为 1 的归一化尾数。
+ */
+extern const u64 fmt_pow10_128[FMT_POW10_MAX - FMT_POW10_MIN + 1][2];
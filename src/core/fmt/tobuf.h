@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/core/fmt/tobuf.h */
+#pragma once
+
+/**
+ * @file
+ * @brief 计数 Sink 与定长缓冲区 Sink。
+ *
+ * - format_len: 只计算输出长度, 不写任何内存。
+ * - format_to_buf: 写入调用者提供的定长缓冲区, 放不下时截断并报告。
+ */
+
+#include <core/fmt/vformat.h> // L1 引擎
+#include <core/type.h>        // L0 类型
+#include <string.h>           // memcpy
+
+/*
+ * ===================================================================
+ * 1. 计数 Sink
+ * ===================================================================
+ */
+
+typedef struct CountSink
+{
+  usize len;
+} CountSink;
+
+static inline void
+count_sink_push_char_adapter(void *sink, char c)
+{
+  (void)c;
+  ((CountSink *)sink)->len += 1;
+}
+static inline void
+count_sink_push_bytes_adapter(void *sink, const char *bytes, usize len)
+{
+  (void)bytes;
+  ((CountSink *)sink)->len += len;
+}
+
+/**
+ * @brief 计算格式化输出的精确字节数 (不含 '\0')。
+ *
+ * 数字由 core/fmt/num.h 格式化到栈上的临时缓冲区后计数, 不分配内存。
+ *
+ * @return (usize) 输出长度。
+ * @example
+ * usize n = format_len("id={} name={}", id, name);
+ */
+#define format_len(fmt, ...)                                                                       \
+  ({                                                                                               \
+    CountSink __count_sink = {0};                                                                  \
+    vformat_cached((void *)&__count_sink,                                                          \
+                   count_sink_push_char_adapter,                                                   \
+                   count_sink_push_bytes_adapter,                                                  \
+                   (fmt)__VA_OPT__(, ) __VA_ARGS__);                                               \
+    __count_sink.len;                                                                              \
+  })
+
+/*
+ * ===================================================================
+ * 2. 定长缓冲区 Sink
+ * ===================================================================
+ */
+
+/**
+ * @brief 写入定长缓冲区的 Sink。
+ *
+ * 最多写入 cap - 1 个字节 (留一个给 '\0'), 但 needed 始终累计完整长度。
+ */
+typedef struct BufSink
+{
+  char *buf;
+  usize cap;
+  usize len;    /* 已写入的字节数 */
+  usize needed; /* 完整输出所需的字节数 */
+} BufSink;
+
+/**
+ * @brief format_to_buf 的结果。
+ */
+typedef struct FmtBufResult
+{
+  usize len;      /* 实际写入的字节数 (不含 '\0') */
+  usize needed;   /* 完整输出的字节数 (不含 '\0') */
+  bool truncated; /* needed > len */
+} FmtBufResult;
+
+static inline void
+buf_sink_push_bytes_adapter(void *sink, const char *bytes, usize len)
+{
+  BufSink *self = (BufSink *)sink;
+  self->needed += len;
+  usize room = self->cap == 0 ? 0 : self->cap - 1 - self->len;
+  usize n = len < room ? len : room;
+  if (n != 0)
+  {
+    memcpy(self->buf + self->len, bytes, n);
+    self->len += n;
+  }
+}
+static inline void
+buf_sink_push_char_adapter(void *sink, char c)
+{
+  buf_sink_push_bytes_adapter(sink, &c, 1);
+}
+
+/** @brief (内部) 写入结尾的 '\0' 并生成结果。 */
+static inline FmtBufResult
+buf_sink_finish(BufSink *self)
+{
+  if (self->cap != 0)
+  {
+    self->buf[self->len] = '\0';
+  }
+  return (FmtBufResult){self->len, self->needed, self->needed > self->len};
+}
+
+/**
+ * @brief 格式化到调用者提供的定长缓冲区 (总是以 '\0' 结尾, 除非 cap == 0)。
+ *
+ * @return (FmtBufResult) 写入长度, 完整长度以及是否被截断。
+ * @example
+ * char line[64];
+ * FmtBufResult r = format_to_buf(line, sizeof(line), "x={}", x);
+ * if (r.truncated) { ... }
+ */
+#define format_to_buf(buf, cap, fmt, ...)                                                          \
+  ({                                                                                               \
+    BufSink __buf_sink = {(buf), (cap), 0, 0};                                                     \
+    vformat_cached((void *)&__buf_sink,                                                            \
+                   buf_sink_push_char_adapter,                                                     \
+                   buf_sink_push_bytes_adapter,                                                    \
+                   (fmt)__VA_OPT__(, ) __VA_ARGS__);                                               \
+    buf_sink_finish(&__buf_sink);                                                                  \
+  })
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/core/fmt/tofd.c */
+
+#include <core/fmt/tofd.h>
+#include <errno.h>   // EINTR
+#include <stdarg.h>  // va_list
+#include <sys/uio.h> // writev, struct iovec
+#include <unistd.h>  // write
+
+/* 一次 writev 调用最多提交的段数 (Linux 的 IOV_MAX) */
+#define WRITEV_MAX_SEGS 1024
+
+bool
+fd_write_all(int fd, const char *bytes, usize len)
+{
+  while (len > 0)
+  {
+    ssize_t n = write(fd, bytes, len);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    bytes += n;
+    len -= (usize)n;
+  }
+  return true;
+}
+
+bool
+fd_write_all2(int fd, const char *a, usize a_len, const char *b, usize b_len)
+{
+  while (a_len > 0)
+  {
+    struct iovec iov[2] = {
+      {.iov_base = (void *)a, .iov_len = a_len},
+      {.iov_base = (void *)b, .iov_len = b_len},
+    };
+    ssize_t n = writev(fd, iov, 2);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    /* 部分写入: 先消耗 a, 再消耗 b */
+    usize done = (usize)n;
+    if (done < a_len)
+    {
+      a += done;
+      a_len -= done;
+      continue;
+    }
+    done -= a_len;
+    a_len = 0;
+    b += done;
+    b_len -= done;
+  }
+  return fd_write_all(fd, b, b_len);
+}
+
+bool
+fd_writev_all(int fd, struct iovec *iov, int count)
+{
+  /* 跳过开头的空段 */
+  while (count > 0 && iov->iov_len == 0)
+  {
+    iov++;
+    count--;
+  }
+
+  while (count > 0)
+  {
+    ssize_t n = writev(fd, iov, count > WRITEV_MAX_SEGS ? WRITEV_MAX_SEGS : count);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    /* 消耗已写完的段, 并推进写了一半的段 */
+    usize done = (usize)n;
+    while (count > 0 && done >= iov->iov_len)
+    {
+      done -= iov->iov_len;
+      iov++;
+      count--;
+    }
+    if (count > 0)
+    {
+      iov->iov_base = (char *)iov->iov_base + done;
+      iov->iov_len -= done;
+    }
+  }
+  return true;
+}
+
+/* 不允许内联: FdSink 的缓冲区必须留在这个栈帧里, 而不是调用者的栈帧里 */
+__attribute__((noinline)) bool
+fd_format_func(int fd, const FmtCompiled *compiled, const char *fmt, int count, ...)
+{
+  FdSink sink;
+  fd_sink_init(&sink, fd);
+
+  va_list args;
+  va_start(args, count);
+  vformat_compiled_va(&sink,
+                      fd_sink_push_char_adapter,
+                      fd_sink_push_bytes_adapter,
+                      compiled,
+                      fmt,
+                      count,
+                      args);
+  va_end(args);
+
+  return fd_sink_flush(&sink);
+}
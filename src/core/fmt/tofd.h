@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/core/fmt/tofd.h */
+#pragma once
+
+/**
+ * @file
+ * @brief 带缓冲的文件描述符 Sink。
+ *
+ * `format_to_file(stderr, ...)` 对每个片段都要走一次加锁的 stdio 调用,
+ * 而 stderr 没有缓冲, 每次调用又是一次 write 系统调用。
+ * FdSink 把整条消息先攒在栈上的缓冲区里, 最后用一次 write 写出;
+ * 放不下时, 用一次 writev 把缓冲区和新数据一起写出。
+ */
+
+#include <core/fmt/vformat.h> // L1 引擎
+#include <core/type.h>        // L0 类型
+#include <string.h>           // memcpy
+#include <sys/uio.h>          // struct iovec
+#include <unistd.h>           // STDERR_FILENO
+
+/** @brief 每个 FdSink 的缓冲区大小 (字节)。 */
+#define FD_SINK_BUF_SIZE 4096
+
+/**
+ * @brief 栈上的缓冲 Sink。
+ */
+typedef struct FdSink
+{
+  int fd;
+  bool failed; /* 是否发生过写错误 */
+  usize len;
+  char buf[FD_SINK_BUF_SIZE];
+} FdSink;
+
+/*
+ * ===================================================================
+ * 1. 底层写入 (在 tofd.c 中实现)
+ * ===================================================================
+ */
+
+/**
+ * @brief 把一段字节完整写入 fd (处理部分写入和 EINTR)。
+ * @return 全部写入时返回 true。
+ */
+bool fd_write_all(int fd, const char *bytes, usize len);
+
+/**
+ * @brief 用一次 (或尽量少的) writev 写出 a 和 b 两段字节。
+ * @return 全部写入时返回 true。
+ */
+bool fd_write_all2(int fd, const char *a, usize a_len, const char *b, usize b_len);
+
+/**
+ * @brief 用尽量少的 writev 写出 count 段字节 (处理部分写入和 EINTR)。
+ *
+ * @note iov 数组会被就地修改 (用于记录部分写入的进度)。
+ * @return 全部写入时返回 true。
+ */
+bool fd_writev_all(int fd, struct iovec *iov, int count);
+
+/*
+ * ===================================================================
+ * 2. Sink API
+ * ===================================================================
+ */
+
+static inline void
+fd_sink_init(FdSink *self, int fd)
+{
+  self->fd = fd;
+  self->failed = false;
+  self->len = 0;
+}
+
+/**
+ * @brief 把缓冲区中的内容写出。
+ * @return 目前为止所有写入都成功时返回 true。
+ */
+static inline bool
+fd_sink_flush(FdSink *self)
+{
+  if (self->len != 0)
+  {
+    self->failed |= !fd_write_all(self->fd, self->buf, self->len);
+    self->len = 0;
+  }
+  return !self->failed;
+}
+
+static inline void
+fd_sink_push_bytes_adapter(void *sink, const char *bytes, usize len)
+{
+  FdSink *self = (FdSink *)sink;
+  if (len <= FD_SINK_BUF_SIZE - self->len)
+  {
+    memcpy(self->buf + self->len, bytes, len);
+    self->len += len;
+    return;
+  }
+  /* 放不下: 缓冲区和新数据一起交给 writev */
+  self->failed |= !fd_write_all2(self->fd, self->buf, self->len, bytes, len);
+  self->len = 0;
+}
+
+static inline void
+fd_sink_push_char_adapter(void *sink, char c)
+{
+  FdSink *self = (FdSink *)sink;
+  if (self->len == FD_SINK_BUF_SIZE)
+  {
+    fd_sink_flush(self);
+  }
+  self->buf[self->len++] = c;
+}
+
+/*
+ * ===================================================================
+ * 3. 格式化宏
+ * ===================================================================
+ */
+
+/**
+ * @brief (内部) format_to_fd 的实现, 在 tofd.c 中以 noinline 方式定义。
+ *
+ * FdSink 的 4 KiB 缓冲区只存在于这个函数自己的栈帧里。
+ * asrt/panic/dbg 会被内联进很多热路径, 如果把 Sink 放在宏展开处,
+ * 每个调用者的栈帧都会因此多出 4 KiB。
+ *
+ * @return 全部写入成功时返回 true。
+ */
+bool fd_format_func(int fd, const FmtCompiled *compiled, const char *fmt, int count, ...);
+
+/**
+ * @brief (底层 API) 格式化到一个文件描述符 (例如 STDERR_FILENO)。
+ *
+ * 整条消息在缓冲区中攒好后一次写出, 不经过 stdio, 也不加锁。
+ * panic 和 dbg 使用这个宏。
+ *
+ * @return (bool) 全部写入成功时为 true。
+ */
+#define format_to_fd(fd, fmt, ...)                                                                 \
+  ({                                                                                               \
+    const char *__fmt = (fmt);                                                                     \
+    fd_format_func((fd),                                                                           \
+                   FMT_CACHE_LOOKUP(fmt),                                                          \
+                   __fmt,                                                                          \
+                   ARGS_COUNT(__VA_ARGS__) __VA_OPT__(, ) EXPAND_ALL(TYPE_INFO, __VA_ARGS__));     \
+  })
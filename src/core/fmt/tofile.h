@@ -45,8 +45,7 @@ file_sink_push_bytes_adapter(void *sink, const char *bytes, usize len)
  * 它不依赖 sstring/bstring。
  */
 #define format_to_file(sink, fmt, ...)                                                             \
-  vformat_func((void *)(sink),                                                                     \
-               file_sink_push_char_adapter,                                                        \
-               file_sink_push_bytes_adapter,                                                       \
-               (fmt),                                                                              \
-               ARGS_COUNT(__VA_ARGS__) __VA_OPT__(, ) EXPAND_ALL(TYPE_INFO, __VA_ARGS__))
+  vformat_cached((void *)(sink),                                                                   \
+                 file_sink_push_char_adapter,                                                      \
+                 file_sink_push_bytes_adapter,                                                     \
+                 (fmt)__VA_OPT__(, ) __VA_ARGS__)
@@ -19,20 +19,22 @@
 
 /* src/std/fmt/format.c */
 
+#include <core/fmt/num.h>   // fmt_i64, fmt_u64, fmt_f64, ...
+#include <core/fmt/tobuf.h> // BufSink
 #include <core/fmt/vformat.h>
 /* #include <std/io/sink.h> (不再需要) */
 #include <core/type.h>
-#include <inttypes.h>
 #include <stdarg.h>
-#include <stdio.h>
 #include <string.h>
 
 /*
  * 用于将数字/指针转换为字符串的临时缓冲区大小。
- * 64位整数(20位) + 浮点数(e.g., -1.234567e+300) +
- * 指针(0x...) 64 字节通常是安全的。
+ * 数字由 core/fmt/num.h 直接写出, 不经过 snprintf (没有 locale 和格式串解析)。
  */
-#define TEMP_BUF_SIZE 64
+#define TEMP_BUF_SIZE FMT_NUM_BUF_SIZE
+
+/* vformat_exact_func 先在栈上暂存的字节数, 更长的消息才需要第二遍格式化 */
+#define FMT_EXACT_STACK_SIZE 512
 
 /*
  * ===================================================================
@@ -40,10 +42,510 @@
  * ===================================================================
  */
 
+/**
+ * @brief (内部) 从 va_list 中读取一个 TYPE_* 标记的值。
+ *
+ * 窄类型在可变参数中已被提升 (char/i8/i16 -> int, float -> double)。
+ */
+static FmtArg
+fmt_arg_read(int type, va_list *args)
+{
+  FmtArg arg = {.type = type};
+
+  switch (type)
+  {
+  /* --- 字符串和字符 --- */
+  case TYPE_STR:
+  case TYPE_MUT_STR:
+    arg.as.s = va_arg(*args, const char *);
+    break;
+  case TYPE_CHAR:
+    // 'char' 被提升为 'int'
+    arg.as.c = (char)va_arg(*args, int);
+    break;
+
+  /* --- 有符号整数 --- */
+  case TYPE_I8:
+  case TYPE_I16:
+  case TYPE_I32:
+    // 'i8', 'i16' 被提升为 'int'
+    arg.as.i = va_arg(*args, int);
+    break;
+  case TYPE_I64:
+    arg.as.i = va_arg(*args, i64);
+    break;
+
+  /* --- 无符号整数 --- */
+  case TYPE_U8:
+  case TYPE_U16:
+    // 'u8', 'u16' 被提升为 'unsigned int'
+    arg.as.u = va_arg(*args, unsigned int);
+    break;
+  case TYPE_U32:
+    arg.as.u = va_arg(*args, u32);
+    break;
+  case TYPE_U64:
+    arg.as.u = va_arg(*args, u64);
+    break;
+
+  /* --- 浮点数 --- */
+  case TYPE_FLOAT:
+  case TYPE_DOUBLE:
+    // 'float' 被提升为 'double'
+    arg.as.f = va_arg(*args, double);
+    break;
+
+  /* --- 指针 --- */
+  case TYPE_ANY: // void*
+    arg.as.p = va_arg(*args, void *);
+    break;
+
+  case TYPE_VSTR:
+    // vstr 是一个 struct，按值传递
+    arg.as.v = va_arg(*args, vstr);
+    break;
+
+  /* --- 错误处理 --- */
+  case TYPE_NONE:
+  default:
+    // 不支持的类型或 `default` 匹配
+    // 尝试跳过这个未知参数。这有风险,
+    // 因为不知道它的大小, 但 `void*` 通常是安全的。
+    (void)va_arg(*args, void *);
+    arg.type = TYPE_NONE;
+    break;
+  }
+
+  return arg;
+}
+
+/**
+ * @brief (内部) 把一个 FmtArg 格式化后推送到 Sink。
+ */
+static void
+fmt_arg_write(void *sink, sink_char_fn push_c, sink_bytes_fn push_b, const FmtArg *arg)
+{
+  char temp_buf[TEMP_BUF_SIZE];
+  usize len = 0;
+
+  switch (arg->type)
+  {
+  case TYPE_STR:
+  case TYPE_MUT_STR: {
+    const char *data = arg->as.s;
+    if (data == NULL)
+    {
+      data = "(null)"; // 安全处理
+    }
+    push_b(sink, data, strlen(data));
+    return;
+  }
+  case TYPE_CHAR:
+    push_c(sink, arg->as.c);
+    return;
+
+  case TYPE_I8:
+  case TYPE_I16:
+  case TYPE_I32:
+  case TYPE_I64:
+    len = fmt_i64(temp_buf, arg->as.i);
+    break;
+
+  case TYPE_U8:
+  case TYPE_U16:
+  case TYPE_U32:
+  case TYPE_U64:
+    len = fmt_u64(temp_buf, arg->as.u);
+    break;
+
+  case TYPE_FLOAT:
+    // 转回 f32 以按 f32 的精度取最短表示
+    len = fmt_f32(temp_buf, (f32)arg->as.f);
+    break;
+  case TYPE_DOUBLE:
+    len = fmt_f64(temp_buf, arg->as.f);
+    break;
+
+  case TYPE_ANY:
+    len = fmt_ptr(temp_buf, arg->as.p);
+    break;
+
+  case TYPE_VSTR:
+    if (arg->as.v.ptr != NULL)
+    {
+      push_b(sink, arg->as.v.ptr, arg->as.v.len);
+    }
+    else
+    {
+      const char *null_msg = "(null vstr)";
+      push_b(sink, null_msg, strlen(null_msg));
+    }
+    return;
+
+  case TYPE_NONE:
+  default: {
+    const char *err_msg = "[?BAD_TYPE?]";
+    push_b(sink, err_msg, strlen(err_msg));
+    return;
+  }
+  }
+
+  push_b(sink, temp_buf, len);
+}
+
+/*
+ * ===================================================================
+ * 3. 格式说明 "{:...}"
+ * ===================================================================
+ */
+
+static const FmtSpec FMT_SPEC_PLAIN = {
+  .fill = ' ',
+  .align = FMT_ALIGN_NONE,
+  .type = 0,
+  .zero_pad = false,
+  .width = 0,
+  .precision = FMT_NO_PRECISION,
+};
+
+static inline bool
+fmt_spec_is_plain(const FmtSpec *spec)
+{
+  return spec->width == 0 && spec->type == 0 && spec->precision == FMT_NO_PRECISION;
+}
+
+static inline u8
+fmt_align_of(char c)
+{
+  switch (c)
+  {
+  case '<':
+    return FMT_ALIGN_LEFT;
+  case '>':
+    return FMT_ALIGN_RIGHT;
+  case '^':
+    return FMT_ALIGN_CENTER;
+  default:
+    return FMT_ALIGN_NONE;
+  }
+}
+
+static inline bool
+fmt_is_digit(char c)
+{
+  return (unsigned char)(c - '0') < 10;
+}
+
+/**
+ * @brief (内部) 解析 p 处 ('{') 开始的占位符。
+ * @return 占位符的长度; 不是合法的占位符时返回 0。
+ */
+static usize
+fmt_parse_placeholder(const char *p, const char *end, FmtSpec *spec)
+{
+  *spec = FMT_SPEC_PLAIN;
+  if (end - p >= 2 && p[1] == '}')
+  {
+    return 2;
+  }
+  if (end - p < 3 || p[1] != ':')
+  {
+    return 0;
+  }
+
+  const char *s = p + 2;
+  if (end - s >= 2 && s[0] != '}' && fmt_align_of(s[1]) != FMT_ALIGN_NONE)
+  {
+    spec->fill = s[0];
+    spec->align = fmt_align_of(s[1]);
+    s += 2;
+  }
+  else if (s < end && fmt_align_of(s[0]) != FMT_ALIGN_NONE)
+  {
+    spec->align = fmt_align_of(s[0]);
+    s++;
+  }
+
+  if (s < end && *s == '0')
+  {
+    spec->zero_pad = true;
+    s++;
+  }
+
+  u32 width = 0;
+  for (; s < end && fmt_is_digit(*s); s++)
+  {
+    width = width * 10 + (u32)(*s - '0');
+    if (width > UINT16_MAX)
+    {
+      return 0;
+    }
+  }
+  spec->width = (u16)width;
+
+  if (s < end && *s == '.')
+  {
+    s++;
+    if (s == end || !fmt_is_digit(*s))
+    {
+      return 0;
+    }
+    u32 precision = 0;
+    for (; s < end && fmt_is_digit(*s); s++)
+    {
+      precision = precision * 10 + (u32)(*s - '0');
+      if (precision > FMT_MAX_PRECISION)
+      {
+        return 0;
+      }
+    }
+    spec->precision = (u16)precision;
+  }
+
+  if (s < end && (*s == 'x' || *s == 'X' || *s == 'b'))
+  {
+    spec->type = (u8)*s++;
+  }
+
+  if (s == end || *s != '}')
+  {
+    return 0;
+  }
+  return (usize)(s + 1 - p);
+}
+
+/* 填充用的常量块, 一次 push_b 最多推送 sizeof 个字节 */
+static const char FILL_SPACES[32] = "                                ";
+static const char FILL_ZEROS[32] = "00000000000000000000000000000000";
+
+static void
+fmt_push_fill(void *sink, sink_bytes_fn push_b, char fill, usize n)
+{
+  char custom[sizeof(FILL_SPACES)];
+  const char *block = FILL_SPACES;
+  if (fill == '0')
+  {
+    block = FILL_ZEROS;
+  }
+  else if (fill != ' ')
+  {
+    memset(custom, fill, sizeof(custom));
+    block = custom;
+  }
+
+  while (n > 0)
+  {
+    usize chunk = n < sizeof(FILL_SPACES) ? n : sizeof(FILL_SPACES);
+    push_b(sink, block, chunk);
+    n -= chunk;
+  }
+}
+
+/* UTF-8 字符数: 不计续字节 (10xxxxxx) */
+static inline usize
+fmt_utf8_count(const char *s, usize len)
+{
+  usize n = 0;
+  for (usize i = 0; i < len; i++)
+  {
+    n += ((unsigned char)s[i] & 0xC0) != 0x80;
+  }
+  return n;
+}
+
+/* 按宽度和对齐方式推送一段已经格式化好的文本 */
+static void
+fmt_push_padded(void *sink,
+                sink_bytes_fn push_b,
+                const char *body,
+                usize len,
+                bool numeric,
+                const FmtSpec *spec)
+{
+  usize chars = numeric ? len : fmt_utf8_count(body, len);
+  if (spec->width <= chars)
+  {
+    push_b(sink, body, len);
+    return;
+  }
+  usize pad = spec->width - chars;
+
+  if (numeric && spec->zero_pad)
+  {
+    /* 符号在前, 0 在符号和数字之间 */
+    if (len > 0 && body[0] == '-')
+    {
+      push_b(sink, body, 1);
+      body++;
+      len--;
+    }
+    fmt_push_fill(sink, push_b, '0', pad);
+    push_b(sink, body, len);
+    return;
+  }
+
+  u8 align = spec->align != FMT_ALIGN_NONE ? spec->align
+             : numeric                    ? FMT_ALIGN_RIGHT
+                                          : FMT_ALIGN_LEFT;
+  usize left = align == FMT_ALIGN_RIGHT ? pad : align == FMT_ALIGN_CENTER ? pad / 2 : 0;
+  fmt_push_fill(sink, push_b, spec->fill, left);
+  push_b(sink, body, len);
+  fmt_push_fill(sink, push_b, spec->fill, pad - left);
+}
+
+/* 整数按 'x' / 'X' / 'b' 输出 */
+static inline usize
+fmt_radix(char *buf, u64 value, u8 type)
+{
+  switch (type)
+  {
+  case 'x':
+    return fmt_hex_u64(buf, value);
+  case 'X':
+    return fmt_hex_upper_u64(buf, value);
+  default:
+    return fmt_bin_u64(buf, value);
+  }
+}
+
+/* 有符号整数在其类型宽度内的补码 (用于十六进制和二进制) */
+static inline u64
+fmt_twos_complement(const FmtArg *arg)
+{
+  switch (arg->type)
+  {
+  case TYPE_I8:
+    return (u8)arg->as.i;
+  case TYPE_I16:
+    return (u16)arg->as.i;
+  case TYPE_I32:
+    return (u32)arg->as.i;
+  default:
+    return (u64)arg->as.i;
+  }
+}
+
+/**
+ * @brief (内部) 按格式说明推送一个 FmtArg。
+ *
+ * 没有格式说明的 "{}" 直接走 fmt_arg_write。
+ */
+static void
+fmt_arg_write_spec(
+  void *sink, sink_char_fn push_c, sink_bytes_fn push_b, const FmtArg *arg, const FmtSpec *spec)
+{
+  if (fmt_spec_is_plain(spec))
+  {
+    fmt_arg_write(sink, push_c, push_b, arg);
+    return;
+  }
+
+  char buf[FMT_FIXED_BUF_SIZE];
+  const char *body = buf;
+  usize len = 0;
+  bool numeric = true;
+
+  switch (arg->type)
+  {
+  case TYPE_I8:
+  case TYPE_I16:
+  case TYPE_I32:
+  case TYPE_I64:
+    len = spec->type != 0 ? fmt_radix(buf, fmt_twos_complement(arg), spec->type)
+                          : fmt_i64(buf, arg->as.i);
+    break;
+
+  case TYPE_U8:
+  case TYPE_U16:
+  case TYPE_U32:
+  case TYPE_U64:
+    len = spec->type != 0 ? fmt_radix(buf, arg->as.u, spec->type) : fmt_u64(buf, arg->as.u);
+    break;
+
+  case TYPE_FLOAT:
+  case TYPE_DOUBLE:
+    if (spec->precision != FMT_NO_PRECISION)
+    {
+      len = fmt_f64_fixed(buf, arg->as.f, spec->precision);
+    }
+    else
+    {
+      len = arg->type == TYPE_FLOAT ? fmt_f32(buf, (f32)arg->as.f) : fmt_f64(buf, arg->as.f);
+    }
+    break;
+
+  case TYPE_ANY:
+    len = fmt_ptr(buf, arg->as.p);
+    break;
+
+  case TYPE_STR:
+  case TYPE_MUT_STR:
+    body = arg->as.s != NULL ? arg->as.s : "(null)";
+    len = strlen(body);
+    numeric = false;
+    break;
+
+  case TYPE_VSTR:
+    body = arg->as.v.ptr != NULL ? arg->as.v.ptr : "(null vstr)";
+    len = arg->as.v.ptr != NULL ? arg->as.v.len : strlen(body);
+    numeric = false;
+    break;
+
+  case TYPE_CHAR:
+    buf[0] = arg->as.c;
+    len = 1;
+    numeric = false;
+    break;
+
+  case TYPE_NONE:
+  default:
+    body = "[?BAD_TYPE?]";
+    len = strlen(body);
+    numeric = false;
+    break;
+  }
+
+  fmt_push_padded(sink, push_b, body, len, numeric, spec);
+}
+
+/*
+ * ===================================================================
+ * 4. 引擎
+ * ===================================================================
+ */
+
+/**
+ * @brief (内部) 参数来源: 可变参数 (va) 或已收集好的数组 (arr), 二选一。
+ */
+typedef struct ArgCursor
+{
+  va_list *va;
+  const FmtArg *arr;
+} ArgCursor;
+
+static inline void
+cursor_write_next(ArgCursor *cur,
+                  void *sink,
+                  sink_char_fn push_c,
+                  sink_bytes_fn push_b,
+                  const FmtSpec *spec)
+{
+  if (cur->arr != NULL)
+  {
+    fmt_arg_write_spec(sink, push_c, push_b, cur->arr++, spec);
+    return;
+  }
+  // 从 va_list 读取 TYPE ID, 再读取值
+  int type = va_arg(*cur->va, int);
+  FmtArg arg = fmt_arg_read(type, cur->va);
+  fmt_arg_write_spec(sink, push_c, push_b, &arg, spec);
+}
+
 /**
  * @brief 核心格式化引擎。
  *
  * 新签名: 接收 sink 和两个函数指针。
+ * 两个占位符之间的字面文本用一次 push_b 整段推送, 而不是逐字符推送。
  */
 static void
 vformat_engine(void *sink,
@@ -51,163 +553,120 @@ vformat_engine(void *sink,
                sink_bytes_fn push_b, // 接收的函数指针
                const char *fmt,
                int count,
-               va_list args)
+               ArgCursor *args)
 {
   if (fmt == NULL || sink == NULL || push_c == NULL || push_b == NULL)
   {
     return;
   }
 
-  char temp_buf[TEMP_BUF_SIZE] = {0};
-  int fmtlen = (int)strlen(fmt);
+  const char *lit = fmt; // 尚未推送的字面文本的起点
+  const char *end = fmt + strlen(fmt);
+  const char *cur = fmt;
   int param_index = 0;
 
-  for (int i = 0; i < fmtlen; i++)
+  FmtSpec spec;
+  while ((cur = memchr(cur, '{', (usize)(end - cur))) != NULL)
   {
-    bool match = false;
-    // 仅匹配 "{}"
-    if (fmt[i] == '{' && i + 1 < fmtlen && fmt[i + 1] == '}')
+    // 仅匹配 "{}" 和 "{:...}", 其余的 '{' 属于字面文本
+    usize n = fmt_parse_placeholder(cur, end, &spec);
+    if (n == 0)
     {
-      i = i + 1; // 跳过 '}'
-      match = true;
+      cur++;
+      continue;
     }
 
-    if (match)
+    if (param_index >= count)
     {
-      // 匹配到 "{}", 尝试处理一个参数
-      if (param_index >= count)
-      {
-        // 参数不足, 推送 "{}" 字面量
-        push_c(sink, '{');
-        push_c(sink, '}');
-        continue;
-      }
-
-      param_index++;
-
-      // 1. 从 va_list 读取 TYPE ID
-      int type = va_arg(args, int);
-      int len = 0;
-
-      // 2. 根据 TYPE ID 读取值并推送到 Sink
-      switch (type)
-      {
-      /* --- 字符串和字符 --- */
-      case TYPE_STR:
-      case TYPE_MUT_STR: {
-        char *data = va_arg(args, char *);
-        if (data == NULL)
-        {
-          data = "(null)"; // 安全处理
-        }
-        len = (int)strlen(data);
-        push_b(sink, data, (usize)len);
-        break;
-      }
-      case TYPE_CHAR: {
-        // 'char' 被提升为 'int'
-        int data = va_arg(args, int);
-        push_c(sink, (char)data);
-        break;
-      }
-
-      /* --- 有符号整数 --- */
-      case TYPE_I8:
-      case TYPE_I16:
-      case TYPE_I32: {
-        // 'i8', 'i16' 被提升为 'int'
-        int data = va_arg(args, int);
-        len = snprintf(temp_buf, TEMP_BUF_SIZE, "%d", data);
-        push_b(sink, temp_buf, (usize)len);
-        break;
-      }
-      case TYPE_I64: {
-        i64 data = va_arg(args, i64);
-        len = snprintf(temp_buf, TEMP_BUF_SIZE, "%" PRId64, data);
-        push_b(sink, temp_buf, (usize)len);
-        break;
-      }
+      // 参数不足, 占位符原样保留在字面文本中
+      cur += n;
+      continue;
+    }
 
-      /* --- 无符号整数 --- */
-      case TYPE_U8:
-      case TYPE_U16: {
-        // 'u8', 'u16' 被提升为 'unsigned int'
-        unsigned int data = va_arg(args, unsigned int);
-        len = snprintf(temp_buf, TEMP_BUF_SIZE, "%u", data);
-        push_b(sink, temp_buf, (usize)len);
-        break;
-      }
-      case TYPE_U32: {
-        u32 data = va_arg(args, u32);
-        len = snprintf(temp_buf, TEMP_BUF_SIZE, "%u", data);
-        push_b(sink, temp_buf, (usize)len);
-        break;
-      }
-      case TYPE_U64: {
-        u64 data = va_arg(args, u64);
-        len = snprintf(temp_buf, TEMP_BUF_SIZE, "%" PRIu64, data);
-        push_b(sink, temp_buf, (usize)len);
-        break;
-      }
+    if (cur > lit)
+    {
+      push_b(sink, lit, (usize)(cur - lit));
+    }
+    cur += n; // 跳过占位符
+    lit = cur;
 
-      /* --- 浮点数 --- */
-      case TYPE_FLOAT:
-      case TYPE_DOUBLE: {
-        // 'float' 被提升为 'double'
-        double data = va_arg(args, double);
-        len = snprintf(temp_buf, TEMP_BUF_SIZE, "%f", data);
-        push_b(sink, temp_buf, (usize)len);
-        break;
-      }
+    param_index++;
+    cursor_write_next(args, sink, push_c, push_b, &spec);
+  }
 
-      /* --- 指针 --- */
-      case TYPE_ANY: // void*
-      {
-        void *data = va_arg(args, void *);
-        len = snprintf(temp_buf, TEMP_BUF_SIZE, "%p", data);
-        push_b(sink, temp_buf, (usize)len);
-        break;
-      }
+  if (end > lit)
+  {
+    push_b(sink, lit, (usize)(end - lit));
+  }
+}
 
-      case TYPE_VSTR: {
-        // vstr 是一个 struct，按值传递
-        vstr data = va_arg(args, vstr);
-        if (data.ptr != NULL)
-        {
-          push_b(sink, data.ptr, data.len);
-        }
-        else
-        {
-          const char *null_msg = "(null vstr)";
-          push_b(sink, null_msg, strlen(null_msg));
-        }
-        break;
-      }
+/**
+ * @brief 按预编译段表格式化: 只推送片段和参数, 不再解析格式串。
+ *
+ * 输出与 vformat_engine 完全一致 (包括参数不足时保留占位符原文)。
+ */
+static void
+vformat_compiled_engine(void *sink,
+                        sink_char_fn push_c,
+                        sink_bytes_fn push_b,
+                        const FmtCompiled *compiled,
+                        int count,
+                        ArgCursor *args)
+{
+  if (sink == NULL || push_c == NULL || push_b == NULL)
+  {
+    return;
+  }
 
-      /* --- 错误处理 --- */
-      case TYPE_NONE:
-      default: {
-        // 不支持的类型或 `default` 匹配
-        // 尝试跳过这个未知参数。这有风险,
-        // 因为不知道它的大小, 但 `void*` 通常是安全的。
-        (void)va_arg(args, void *);
-        const char *err_msg = "[?BAD_TYPE?]";
-        push_b(sink, err_msg, strlen(err_msg));
-        break;
-      }
-      } // end switch
+  const char *fmt = compiled->fmt;
+  u32 last = compiled->nseg - 1;
+  for (u32 i = 0; i <= last; i++)
+  {
+    const FmtSegment *seg = &compiled->segs[i];
+    if (seg->len != 0)
+    {
+      push_b(sink, fmt + seg->start, seg->len);
+    }
+    if (i == last)
+    {
+      break;
+    }
+    if ((int)i < count)
+    {
+      cursor_write_next(args, sink, push_c, push_b, &compiled->specs[i]);
     }
     else
     {
-      // 非占位符, 只是一个普通字符
-      push_c(sink, fmt[i]);
+      // 参数不足: 推送占位符原文 (本段末尾到下一段开头)
+      u32 slot = seg->start + seg->len;
+      push_b(sink, fmt + slot, compiled->segs[i + 1].start - slot);
     }
-  } // end for
+  }
+}
+
+/** @brief (内部) 有段表时走段表, 否则运行时解析。 */
+static inline void
+vformat_dispatch(void *sink,
+                 sink_char_fn push_c,
+                 sink_bytes_fn push_b,
+                 const FmtCompiled *compiled,
+                 const char *fmt,
+                 int count,
+                 ArgCursor *args)
+{
+  if (compiled != NULL)
+  {
+    vformat_compiled_engine(sink, push_c, push_b, compiled, count, args);
+  }
+  else
+  {
+    vformat_engine(sink, push_c, push_b, fmt, count, args);
+  }
 }
 
 /*
  * ===================================================================
- * 3. 公共 API 实现 (在 .h 中声明)
+ * 5. 公共 API 实现 (在 .h 中声明)
  * ===================================================================
  */
 
@@ -219,7 +678,171 @@ vformat_func(
   va_start(args, count);
 
   // 将所有参数传递给核心引擎
-  vformat_engine(sink, push_char, push_bytes, fmt, count, args);
+  ArgCursor cursor = {.va = &args};
+  vformat_engine(sink, push_char, push_bytes, fmt, count, &cursor);
+
+  va_end(args);
+}
+
+void
+vformat_args(void *sink,
+             sink_char_fn push_char,
+             sink_bytes_fn push_bytes,
+             const FmtCompiled *compiled,
+             const char *fmt,
+             int count,
+             const FmtArg *args)
+{
+  ArgCursor cursor = {.arr = args};
+  vformat_dispatch(sink, push_char, push_bytes, compiled, fmt, count, &cursor);
+}
+
+void
+fmt_args_from_va(FmtArg *out, int count, va_list args)
+{
+  va_list ap;
+  va_copy(ap, args);
+  for (int i = 0; i < count; i++)
+  {
+    int type = va_arg(ap, int);
+    out[i] = fmt_arg_read(type, &ap);
+  }
+  va_end(ap);
+}
+
+bool
+fmt_compile(FmtCompiled *out, const char *fmt)
+{
+  if (fmt == NULL)
+  {
+    return false;
+  }
+  usize fmtlen = strlen(fmt);
+  if (fmtlen > (usize)UINT32_MAX)
+  {
+    return false;
+  }
+
+  out->fmt = fmt;
+  out->nseg = 0;
+
+  const char *end = fmt + fmtlen;
+  const char *lit = fmt;
+  const char *cur = fmt;
+  while (out->nseg < FMT_MAX_ARGS && (cur = memchr(cur, '{', (usize)(end - cur))) != NULL)
+  {
+    usize n = fmt_parse_placeholder(cur, end, &out->specs[out->nseg]);
+    if (n == 0)
+    {
+      cur++;
+      continue;
+    }
+    out->segs[out->nseg++] = (FmtSegment){(u32)(lit - fmt), (u32)(cur - lit)};
+    cur += n;
+    lit = cur;
+  }
+  /* 最后一段: 剩余的全部文本 */
+  out->segs[out->nseg++] = (FmtSegment){(u32)(lit - fmt), (u32)(end - lit)};
+  return true;
+}
+
+const FmtCompiled *
+fmt_cache_fill(FmtCache *cache, const char *fmt)
+{
+  int expected = FMT_CACHE_EMPTY;
+  if (!atomic_compare_exchange_strong_explicit(
+        &cache->state, &expected, FMT_CACHE_BUSY, memory_order_acquire, memory_order_acquire))
+  {
+    /* 另一个线程正在编译 (或已完成), 这次先走运行时解析 */
+    return NULL;
+  }
+
+  if (!fmt_compile(&cache->compiled, fmt))
+  {
+    atomic_store_explicit(&cache->state, FMT_CACHE_FAILED, memory_order_release);
+    return NULL;
+  }
+  atomic_store_explicit(&cache->state, FMT_CACHE_READY, memory_order_release);
+  return &cache->compiled;
+}
+
+void
+vformat_compiled_func(void *sink,
+                      sink_char_fn push_char,
+                      sink_bytes_fn push_bytes,
+                      const FmtCompiled *compiled,
+                      const char *fmt,
+                      int count,
+                      ...)
+{
+  va_list args;
+  va_start(args, count);
+
+  ArgCursor cursor = {.va = &args};
+  vformat_dispatch(sink, push_char, push_bytes, compiled, fmt, count, &cursor);
+
+  va_end(args);
+}
+
+void
+vformat_compiled_va(void *sink,
+                    sink_char_fn push_char,
+                    sink_bytes_fn push_bytes,
+                    const FmtCompiled *compiled,
+                    const char *fmt,
+                    int count,
+                    va_list args)
+{
+  va_list ap;
+  va_copy(ap, args);
+
+  ArgCursor cursor = {.va = &ap};
+  vformat_dispatch(sink, push_char, push_bytes, compiled, fmt, count, &cursor);
+
+  va_end(ap);
+}
+
+void
+vformat_exact_func(void *sink,
+                   sink_reserve_fn reserve,
+                   sink_char_fn push_char,
+                   sink_bytes_fn push_bytes,
+                   const FmtCompiled *compiled,
+                   const char *fmt,
+                   int count,
+                   ...)
+{
+  va_list args;
+  va_start(args, count);
+  va_list again;
+  va_copy(again, args);
+
+  // 第一遍: 先格式化到栈上的缓冲区, 同时得到精确长度
+  char stack_buf[FMT_EXACT_STACK_SIZE];
+  BufSink staged = {stack_buf, sizeof(stack_buf), 0, 0};
+  ArgCursor cursor = {.va = &args};
+  vformat_dispatch(&staged,
+                   buf_sink_push_char_adapter,
+                   buf_sink_push_bytes_adapter,
+                   compiled,
+                   fmt,
+                   count,
+                   &cursor);
+
+  // 一次性预留, 之后的写入不会再扩容
+  reserve(sink, staged.needed);
+  if (staged.needed == staged.len)
+  {
+    // 常见情况: 整条消息都在栈上, 一次拷贝即可
+    push_bytes(sink, stack_buf, staged.len);
+  }
+  else
+  {
+    // 消息太长: 按已知长度直接写入 sink
+    ArgCursor second = {.va = &again};
+    vformat_dispatch(sink, push_char, push_bytes, compiled, fmt, count, &second);
+  }
 
+  va_end(again);
   va_end(args);
 }
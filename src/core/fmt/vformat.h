@@ -28,6 +28,7 @@
 
 #include <core/type.h> // libkx: For i8, u8, ..., bool, etc.
 #include <stdarg.h>    // C Standard: For va_list
+#include <stdatomic.h> // C Standard: For FmtCache
 
 /*
  * ===================================================================
@@ -174,6 +175,8 @@
  */
 typedef void (*sink_char_fn)(void *sink, char c);
 typedef void (*sink_bytes_fn)(void *sink, const char *bytes, usize len);
+/* 预留至少 additional 字节的空间 (用于 "先计数, 再一次分配" 的格式化) */
+typedef void (*sink_reserve_fn)(void *sink, usize additional);
 
 /**
  * @brief (内部) C 可变参数函数 (vformat_func)
@@ -182,3 +185,278 @@ typedef void (*sink_bytes_fn)(void *sink, const char *bytes, usize len);
  */
 void vformat_func(
   void *sink, sink_char_fn push_char, sink_bytes_fn push_bytes, const char *fmt, int count, ...);
+
+/*
+ * ===================================================================
+ * 6. 预编译格式串
+ * ===================================================================
+ *
+ * 格式串几乎总是字符串字面量, 没必要每次调用都逐字节寻找 "{}"。
+ * fmt_compile 把它编译成 "字面文本片段 + 参数槽" 交替的段表:
+ *
+ * "id={} name={}\n" -> [ "id=" ] {} [ " name=" ] {} [ "\n" ]
+ *
+ * 之后引擎只需按段表推送, 运行时不再解析 (包括 "{:...}" 中的格式说明)。
+ * vformat_cached 在每个调用点放一个 static FmtCache,
+ * 第一次调用时编译, 之后直接复用。
+ *
+ * 只有字符串字面量才走缓存: 字面量的内容不会变, 命中时比较一次地址即可。
+ * 其他格式串 (栈上的缓冲区, 原地修改过的字符串...) 可能在同一地址换了内容,
+ * 一律直接运行时解析。
+ */
+
+/** @brief 参数槽的最大数量 (与 EXPAND_ALL 的上限一致)。 */
+#define FMT_MAX_ARGS 16
+
+/*
+ * 占位符语法: "{}" 或 "{:[[fill]align][0][width][.precision][type]}"
+ *
+ * - align:     '<' 左对齐, '>' 右对齐, '^' 居中 (默认: 数字右对齐, 其余左对齐)
+ * - fill:      对齐时使用的填充字符 (单字节, 默认空格)
+ * - '0':       数字在符号之后补 0 (忽略 fill 和 align)
+ * - width:     最小宽度 (字符串按 UTF-8 字符计)
+ * - precision: 浮点数小数点后的位数 (最多 FMT_MAX_PRECISION 位)
+ * - type:      'x' / 'X' 十六进制, 'b' 二进制 (仅整数; 负数按其类型宽度的补码输出)
+ *
+ * "{:x}" "{:08}" "{:>10}" "{:.3}" "{:*^9}" "{:#>6.2}" ...
+ * 不合法的说明 (例如 "{:q}") 不算占位符, 按字面文本输出。
+ */
+
+/** @brief FmtSpec.precision 的 "未指定" 值。 */
+#define FMT_NO_PRECISION 0xFFFF
+
+#define FMT_ALIGN_NONE 0
+#define FMT_ALIGN_LEFT 1
+#define FMT_ALIGN_RIGHT 2
+#define FMT_ALIGN_CENTER 3
+
+/**
+ * @brief 一个占位符的格式说明 (由格式串解析得到, 每个槽一份)。
+ */
+typedef struct FmtSpec
+{
+  char fill;     /* 填充字符 */
+  u8 align;      /* FMT_ALIGN_* */
+  u8 type;       /* 0, 'x', 'X' 或 'b' */
+  bool zero_pad; /* '0' 标志 */
+  u16 width;
+  u16 precision; /* FMT_NO_PRECISION 表示未指定 */
+} FmtSpec;
+
+/**
+ * @brief 一个字面文本片段: fmt[start, start + len)。
+ *
+ * 除最后一段外, 每段后面都紧跟一个参数槽; 槽的原文 (例如 "{:x}")
+ * 位于本段末尾和下一段开头之间。
+ */
+typedef struct FmtSegment
+{
+  u32 start;
+  u32 len;
+} FmtSegment;
+
+/**
+ * @brief 编译后的格式串。
+ *
+ * 超过 FMT_MAX_ARGS 个 "{}" 时, 多余的部分并入最后一段字面文本
+ * (反正也不会有对应的参数)。
+ */
+typedef struct FmtCompiled
+{
+  const char *fmt; /* 编译时的格式串 (用于校验缓存) */
+  u32 nseg;        /* 段数 = 参数槽数 + 1 */
+  FmtSegment segs[FMT_MAX_ARGS + 1];
+  FmtSpec specs[FMT_MAX_ARGS]; /* 每个参数槽的格式说明 (编译时解析一次) */
+} FmtCompiled;
+
+/**
+ * @brief 把 fmt 编译成段表。
+ * @return fmt 为 NULL 或过长 (超过 u32) 时返回 false。
+ */
+bool fmt_compile(FmtCompiled *out, const char *fmt);
+
+#define FMT_CACHE_EMPTY 0
+#define FMT_CACHE_BUSY 1
+#define FMT_CACHE_READY 2
+#define FMT_CACHE_FAILED 3
+
+/**
+ * @brief (内部) 每个调用点一份的编译缓存。
+ */
+typedef struct FmtCache
+{
+  _Atomic int state;
+  FmtCompiled compiled;
+} FmtCache;
+
+/**
+ * @brief (内部) 缓存未就绪时的慢路径: 抢到编译权的线程负责编译。
+ * @return 编译好的段表; 其他线程正在编译或编译失败时返回 NULL。
+ */
+const FmtCompiled *fmt_cache_fill(FmtCache *cache, const char *fmt);
+
+/**
+ * @brief (内部) 取出调用点缓存的段表。
+ *
+ * 返回 NULL 时调用者应退回到运行时解析 (结果完全相同)。
+ * 同一调用点传入了不同的 fmt 时也返回 NULL (例如内联函数中的调用点)。
+ * fmt 必须是字符串字面量, 通过 FMT_CACHE_LOOKUP 调用。
+ */
+static inline const FmtCompiled *
+fmt_cache_get(FmtCache *cache, const char *fmt)
+{
+  int state = atomic_load_explicit(&cache->state, memory_order_acquire);
+  if (state == FMT_CACHE_READY)
+  {
+    return cache->compiled.fmt == fmt ? &cache->compiled : NULL;
+  }
+  if (state == FMT_CACHE_EMPTY)
+  {
+    return fmt_cache_fill(cache, fmt);
+  }
+  return NULL;
+}
+
+/**
+ * @brief (内部) fmt 是字符串字面量时查调用点缓存, 否则返回 NULL (运行时解析)。
+ *
+ * __builtin_constant_p 不对参数求值; 对栈上或静态的缓冲区它都返回 0。
+ * 放在 __builtin_choose_expr 里由前端直接求值, 非字面量的调用点不会生成 FmtCache。
+ */
+#define FMT_CACHE_LOOKUP(fmt)                                                                      \
+  __builtin_choose_expr(__builtin_constant_p(fmt),                                                 \
+                        ({                                                                         \
+                          static FmtCache __fmt_cache;                                             \
+                          fmt_cache_get(&__fmt_cache, (fmt));                                      \
+                        }),                                                                        \
+                        (const FmtCompiled *)NULL)
+
+/**
+ * @brief (内部) 按段表格式化的可变参数函数。
+ *
+ * compiled 为 NULL 时等价于 vformat_func(..., fmt, count, ...)。
+ */
+void vformat_compiled_func(void *sink,
+                           sink_char_fn push_char,
+                           sink_bytes_fn push_bytes,
+                           const FmtCompiled *compiled,
+                           const char *fmt,
+                           int count,
+                           ...);
+
+/**
+ * @brief (内部) vformat_compiled_func 的 va_list 版本, 供需要自己持有 Sink 的包装函数使用。
+ *
+ * args 本身不会被消耗 (内部使用 va_copy)。
+ */
+void vformat_compiled_va(void *sink,
+                         sink_char_fn push_char,
+                         sink_bytes_fn push_bytes,
+                         const FmtCompiled *compiled,
+                         const char *fmt,
+                         int count,
+                         va_list args);
+
+/**
+ * @brief (内部) 带调用点缓存的格式化, 所有 Sink 宏都通过它调用引擎。
+ *
+ * @example
+ * vformat_cached(sink, my_push_char, my_push_bytes, "x={}", x);
+ */
+#define vformat_cached(sink, push_char, push_bytes, fmt, ...)                                      \
+  ({                                                                                               \
+    const char *__fmt = (fmt);                                                                     \
+    vformat_compiled_func((sink),                                                                  \
+                          (push_char),                                                             \
+                          (push_bytes),                                                            \
+                          FMT_CACHE_LOOKUP(fmt),                                                   \
+                          __fmt,                                                                   \
+                          ARGS_COUNT(__VA_ARGS__)                                                  \
+                            __VA_OPT__(, ) EXPAND_ALL(TYPE_INFO, __VA_ARGS__));                    \
+  })
+
+/*
+ * ===================================================================
+ * 7. 精确长度格式化
+ * ===================================================================
+ */
+
+/**
+ * @brief (内部) 精确长度格式化: 得到输出的精确长度后只调用一次 reserve。
+ *
+ * 先格式化到栈上的暂存区 (同时计数); 放得下时直接整段拷贝进 sink,
+ * 否则按已知长度再格式化一遍 (va_copy, 参数只求值一次)。
+ */
+void vformat_exact_func(void *sink,
+                        sink_reserve_fn reserve,
+                        sink_char_fn push_char,
+                        sink_bytes_fn push_bytes,
+                        const FmtCompiled *compiled,
+                        const char *fmt,
+                        int count,
+                        ...);
+
+/**
+ * @brief (内部) vformat_exact_func 的调用点缓存版本。
+ */
+#define vformat_exact_cached(sink, reserve, push_char, push_bytes, fmt, ...)                       \
+  ({                                                                                               \
+    const char *__fmt = (fmt);                                                                     \
+    vformat_exact_func((sink),                                                                     \
+                       (reserve),                                                                  \
+                       (push_char),                                                                \
+                       (push_bytes),                                                               \
+                       FMT_CACHE_LOOKUP(fmt),                                                      \
+                       __fmt,                                                                      \
+                       ARGS_COUNT(__VA_ARGS__)                                                     \
+                         __VA_OPT__(, ) EXPAND_ALL(TYPE_INFO, __VA_ARGS__));                       \
+  })
+
+/*
+ * ===================================================================
+ * 8. 参数数组形式
+ * ===================================================================
+ *
+ * 可变参数只能在调用栈内被读取一次。需要把参数保存下来
+ * (例如延迟格式化的日志) 时, 先用 fmt_args_from_va 收集成
+ * FmtArg 数组, 之后随时用 vformat_args 格式化。
+ */
+
+/**
+ * @brief 一个带 TYPE_* 标记的参数值。
+ *
+ * 窄类型已被提升: 有符号整数存入 i, 无符号整数存入 u,
+ * TYPE_FLOAT 和 TYPE_DOUBLE 都存入 f。
+ */
+typedef struct FmtArg
+{
+  int type;
+  union
+  {
+    i64 i;
+    u64 u;
+    f64 f;
+    char c;
+    const char *s;
+    vstr v;
+    const void *p;
+  } as;
+} FmtArg;
+
+/**
+ * @brief 从 va_list 中读取 count 个 (TYPE_ID, value) 对。
+ *
+ * 未知类型记为 TYPE_NONE。args 本身不会被消耗 (内部使用 va_copy)。
+ */
+void fmt_args_from_va(FmtArg *out, int count, va_list args);
+
+/**
+ * @brief 用 FmtArg 数组格式化 (compiled 可为 NULL)。
+ */
+void vformat_args(void *sink,
+                  sink_char_fn push_char,
+                  sink_bytes_fn push_bytes,
+                  const FmtCompiled *compiled,
+                  const char *fmt,
+                  int count,
+                  const FmtArg *args);
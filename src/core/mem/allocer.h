@@ -101,3 +101,33 @@
  * @brief (Trait API) 静态分发到 PREFIX_GET_ALLOCATED
  */
 #define ALLOC_GET_ALLOCATED(Prefix, self_ptr) __ALLOC_CONCAT(Prefix, _GET_ALLOCATED)((self_ptr))
+
+/*
+ * ===================================================================
+ * 3. 类型擦除的释放函数
+ * ===================================================================
+ *
+ * 需要稍后 (在另一个上下文中) 释放内存的模块 (如 epoch 回收)
+ * 只保存 (release, alloc) 这一对, 不依赖具体的分配器类型。
+ */
+
+/**
+ * @brief 类型擦除的释放函数: alloc 是分配器实例, 其余参数与 PREFIX_RELEASE 相同。
+ */
+typedef void (*AllocReleaseFn)(void *alloc, anyptr ptr, Layout layout);
+
+/**
+ * @brief 为分配器生成释放函数 `alloc_release_##Prefix` (每个翻译单元每个前缀一次)。
+ */
+#define DEFINE_ALLOC_RELEASER(AllocType, Prefix)                                                   \
+  static void alloc_release_##Prefix(void *alloc, anyptr ptr, Layout layout)                       \
+  {                                                                                                \
+    (void)alloc; /* SYSTEM 等无状态分配器不使用 alloc 和 layout */                                 \
+    (void)layout;                                                                                  \
+    RELEASE(Prefix, (AllocType *)alloc, ptr, layout);                                              \
+  }
+
+/**
+ * @brief 取得 DEFINE_ALLOC_RELEASER 生成的释放函数。
+ */
+#define ALLOC_RELEASER(Prefix) alloc_release_##Prefix
@@ -20,8 +20,8 @@
 #pragma once
 
 #include <core/color.h>
-#include <core/fmt/tofile.h>
-#include <stdio.h> // 依赖 stderr
+#include <core/fmt/tofd.h> // format_to_fd (一次 write 写出整条消息)
+#include <unistd.h>        // STDERR_FILENO
 
 /**
  * @brief (内部) 定义 dbg 宏使用的默认颜色。
@@ -34,7 +34,7 @@
  * @brief (公共 API) 打印带有上下文的调试格式化消息。
  *
  * 这是一个 `println` 风格的调试宏, 它会自动:
- * 1. 打印到 `stderr`。
+ * 1. 打印到 `stderr` (整条消息缓冲后用一次 write 写出)。
  * 2. [升级] 自动将整行输出着色 (使用 DBG_COLOR)。
  * 3. [升级] 自动在末尾重置颜色。
  * 4. 添加 `[DEBUG]` 标签。
@@ -59,13 +59,11 @@
 #define dbg(fmt, ...)                                                                              \
   do                                                                                               \
   {                                                                                                \
-    format_to_file(stderr, /* [升级] 1. 添加颜色 {占位符} 和 重置                      \
-                      {占位符} */                                                               \
-                   "{}[DEBUG] ({}:{}) " fmt "{}\n",                                                \
-                                                                                                   \
-                   /* [升级] 2. 传入 fg() 和 reset() 作为参数 */                                   \
-                   fg(DBG_COLOR),                                                                  \
-                   __FILE__,                                                                       \
-                   __LINE__ __VA_OPT__(, ) __VA_ARGS__,                                            \
-                   reset());                                                                       \
+    /* [升级] 添加颜色 {占位符} 和 重置 {占位符}, 传入 fg() 和 reset() 作为参数 */                 \
+    (void)format_to_fd(STDERR_FILENO,                                                              \
+                       "{}[DEBUG] ({}:{}) " fmt "{}\n",                                            \
+                       fg(DBG_COLOR),                                                              \
+                       __FILE__,                                                                   \
+                       __LINE__ __VA_OPT__(, ) __VA_ARGS__,                                        \
+                       reset());                                                                   \
   } while (0)
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/core/msg/panic.c */
+
+#include <core/msg/panic.h>
+#include <stdatomic.h>
+
+static _Atomic(panic_hook_fn) g_flush_hook = NULL;
+
+panic_hook_fn
+panic_set_flush_hook(panic_hook_fn hook)
+{
+  return atomic_exchange(&g_flush_hook, hook);
+}
+
+void
+panic_run_flush_hook(void)
+{
+  /* 先摘下钩子: 钩子内部再次 panic 时不会递归 */
+  panic_hook_fn hook = atomic_exchange(&g_flush_hook, NULL);
+  if (hook != NULL)
+  {
+    hook();
+  }
+}
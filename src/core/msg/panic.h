@@ -19,10 +19,10 @@
 
 #pragma once
 
-#include <core/color.h> // 依赖颜色库
-#include <core/fmt/tofile.h>
-#include <stdio.h>  // 依赖 stderr
-#include <stdlib.h> // 依赖 abort()
+#include <core/color.h>    // 依赖颜色库
+#include <core/fmt/tofd.h> // format_to_fd (一次 write 写出整条消息)
+#include <stdlib.h>        // 依赖 abort()
+#include <unistd.h>        // STDERR_FILENO
 
 /**
  * @brief (内部) 定义 panic 宏使用的默认颜色。
@@ -31,11 +31,28 @@
  */
 #define PANIC_COLOR rgb(255, 80, 80)
 
+/** @brief panic 终止程序前调用的钩子类型。 */
+typedef void (*panic_hook_fn)(void);
+
+/**
+ * @brief 注册一个在 panic 输出消息前调用的钩子 (例如冲刷异步日志)。
+ *
+ * 同一时刻只有一个钩子; 传入 NULL 表示取消注册。
+ * @return 之前注册的钩子 (可能为 NULL)。
+ */
+panic_hook_fn panic_set_flush_hook(panic_hook_fn hook);
+
+/**
+ * @brief (内部) 调用并摘下当前的钩子, 由 panic 宏使用。
+ */
+void panic_run_flush_hook(void);
+
 /**
  * @brief (公共 API) 打印带有上下文的 panic 消息并终止程序。
  *
  * 这是一个 `println` 风格的 panic 宏, 它会自动:
- * 1. 打印到 `stderr`。
+ * 0. 调用 panic_set_flush_hook 注册的钩子, 让之前缓冲的日志先写出。
+ * 1. 打印到 `stderr` (整条消息缓冲后用一次 write 写出)。
  * 2. 自动将整行输出着色 (使用 PANIC_COLOR)。
  * 3. 自动在末尾重置颜色。
  * 4. 添加 `[PANIC]` 标签。
@@ -59,12 +76,12 @@
 #define panic(fmt, ...)                                                                            \
   do                                                                                               \
   {                                                                                                \
-    format_to_file(stderr,                                                                         \
-                   "{}[PANIC] ({}:{}) " fmt "{}\n",                                                \
-                                                                                                   \
-                   fg(PANIC_COLOR),                                                                \
-                   __FILE__,                                                                       \
-                   __LINE__ __VA_OPT__(, ) __VA_ARGS__,                                            \
-                   reset());                                                                       \
+    panic_run_flush_hook();                                                                        \
+    (void)format_to_fd(STDERR_FILENO,                                                              \
+                       "{}[PANIC] ({}:{}) " fmt "{}\n",                                            \
+                       fg(PANIC_COLOR),                                                            \
+                       __FILE__,                                                                   \
+                       __LINE__ __VA_OPT__(, ) __VA_ARGS__,                                        \
+                       reset());                                                                   \
     abort(); /* 终止程序 */                                                                        \
   } while (0)
@@ -0,0 +1,408 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/async/runtime.h>
+
+#include <core/msg/asrt.h>  // asrt_msg
+#include <core/msg/panic.h> // panic
+#include <errno.h>
+#include <fcntl.h>           // openat, AT_FDCWD
+#include <std/async/uring.h> // AsyncUring
+#include <string.h>          // memset
+#include <threads.h>         // thrd_t, mtx_t, cnd_t
+#include <unistd.h>          // pread, pwrite, close
+
+/* 侵入式 FIFO 链表 (通过 AsyncTask::next) */
+typedef struct TaskList
+{
+  AsyncTask *head;
+  AsyncTask *tail;
+} TaskList;
+
+struct AsyncRt
+{
+  AsyncBackend backend;
+  TaskList ready;   /* 等待执行 */
+  TaskList blocked; /* 等待空闲的 I/O 槽位 */
+  usize live;       /* 已 spawn 但还没结束的任务 */
+  usize in_flight;  /* 已交给后端但还没完成的 I/O */
+  usize capacity;   /* in_flight 的上限 */
+
+  AsyncUring *uring;
+
+  /* 线程后端 */
+  mtx_t lock;
+  cnd_t job_ready; /* jobs 非空 / stop */
+  cnd_t job_done;  /* done 非空 */
+  TaskList jobs;
+  TaskList done;
+  bool stop;
+  thrd_t *threads;
+  usize nthreads;
+
+  SystemAlloc *backing_alloc;
+};
+
+/*
+ * ===================================================================
+ * 1. 链表
+ * ===================================================================
+ */
+
+static void
+list_push(TaskList *list, AsyncTask *task)
+{
+  task->next = NULL;
+  if (list->tail == NULL)
+    list->head = task;
+  else
+    list->tail->next = task;
+  list->tail = task;
+}
+
+static AsyncTask *
+list_pop(TaskList *list)
+{
+  AsyncTask *task = list->head;
+  if (task != NULL)
+  {
+    list->head = task->next;
+    if (list->head == NULL)
+      list->tail = NULL;
+  }
+  return task;
+}
+
+/* 把 other 整个接到 list 后面, other 随后为空 */
+static void
+list_append(TaskList *list, TaskList *other)
+{
+  if (other->head == NULL)
+    return;
+  if (list->tail == NULL)
+    list->head = other->head;
+  else
+    list->tail->next = other->head;
+  list->tail = other->tail;
+  *other = (TaskList){0};
+}
+
+/*
+ * ===================================================================
+ * 2. 线程后端
+ * ===================================================================
+ */
+
+/* 执行一个阻塞的 I/O 请求, 返回结果或 -errno */
+static i64
+io_blocking(const AsyncIo *io)
+{
+  i64 ret;
+  switch (io->op)
+  {
+  case ASYNC_OP_OPEN:
+    ret = openat(AT_FDCWD, (const char *)io->buf, io->flags, (mode_t)io->mode);
+    break;
+  case ASYNC_OP_READ:
+    ret = pread(io->fd, io->buf, io->len, (off_t)io->off);
+    break;
+  case ASYNC_OP_WRITE:
+    ret = pwrite(io->fd, io->buf, io->len, (off_t)io->off);
+    break;
+  case ASYNC_OP_CLOSE:
+    ret = close(io->fd);
+    break;
+  default:
+    panic("async: invalid op {}", (i32)io->op);
+  }
+  return ret < 0 ? -(i64)errno : ret;
+}
+
+static int
+io_thread_main(void *arg)
+{
+  AsyncRt *rt = (AsyncRt *)arg;
+  mtx_lock(&rt->lock);
+  for (;;)
+  {
+    while (rt->jobs.head == NULL && !rt->stop)
+    {
+      cnd_wait(&rt->job_ready, &rt->lock);
+    }
+    if (rt->stop)
+      break;
+    AsyncTask *task = list_pop(&rt->jobs);
+    mtx_unlock(&rt->lock);
+
+    task->io_result = io_blocking(&task->io);
+
+    mtx_lock(&rt->lock);
+    bool was_empty = rt->done.head == NULL;
+    list_push(&rt->done, task);
+    if (was_empty)
+      cnd_signal(&rt->job_done);
+  }
+  mtx_unlock(&rt->lock);
+  return 0;
+}
+
+static void
+threads_stop(AsyncRt *self, usize started)
+{
+  mtx_lock(&self->lock);
+  self->stop = true;
+  cnd_broadcast(&self->job_ready);
+  mtx_unlock(&self->lock);
+  for (usize i = 0; i < started; i++)
+  {
+    thrd_join(self->threads[i], NULL);
+  }
+}
+
+static bool
+threads_start(AsyncRt *self, usize nthreads)
+{
+  self->threads = ALLOC(SYSTEM, self->backing_alloc, LAYOUT_OF_ARRAY(thrd_t, nthreads));
+  self->nthreads = nthreads;
+  for (usize i = 0; i < nthreads; i++)
+  {
+    if (thrd_create(&self->threads[i], io_thread_main, self) != thrd_success)
+    {
+      threads_stop(self, i);
+      RELEASE(SYSTEM, self->backing_alloc, self->threads, LAYOUT_OF_ARRAY(thrd_t, nthreads));
+      self->threads = NULL;
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * ===================================================================
+ * 3. 提交与完成
+ * ===================================================================
+ */
+
+/* 把请求交给后端 (调用者保证 in_flight < capacity) */
+static void
+backend_push(AsyncRt *self, AsyncTask *task)
+{
+  self->in_flight++;
+  if (self->uring != NULL)
+  {
+    async_uring_push(self->uring, task);
+    if (async_uring_unsubmitted(self->uring) >= ASYNC_SUBMIT_BATCH)
+      async_uring_enter(self->uring, false);
+    return;
+  }
+  mtx_lock(&self->lock);
+  list_push(&self->jobs, task);
+  cnd_signal(&self->job_ready);
+  mtx_unlock(&self->lock);
+}
+
+void
+async_submit(AsyncTask *task)
+{
+  AsyncRt *self = task->rt;
+  if (self->in_flight < self->capacity)
+    backend_push(self, task);
+  else
+    list_push(&self->blocked, task);
+}
+
+/* 收集已完成的 I/O 放回就绪队列; wait 为 true 时至少等到一个 */
+static void
+backend_collect(AsyncRt *self, bool wait)
+{
+  TaskList finished = {0};
+  usize count = 0;
+  if (self->uring != NULL)
+  {
+    async_uring_enter(self->uring, wait);
+    finished.head = async_uring_reap(self->uring, &count);
+    for (AsyncTask *t = finished.head; t != NULL; t = t->next)
+    {
+      finished.tail = t;
+    }
+  }
+  else
+  {
+    mtx_lock(&self->lock);
+    while (wait && self->done.head == NULL)
+    {
+      cnd_wait(&self->job_done, &self->lock);
+    }
+    finished = self->done;
+    self->done = (TaskList){0};
+    mtx_unlock(&self->lock);
+    for (AsyncTask *t = finished.head; t != NULL; t = t->next)
+    {
+      count++;
+    }
+  }
+
+  self->in_flight -= count;
+  list_append(&self->ready, &finished);
+  /* 空出的槽位交给等待中的请求 */
+  while (self->in_flight < self->capacity && self->blocked.head != NULL)
+  {
+    backend_push(self, list_pop(&self->blocked));
+  }
+}
+
+/*
+ * ===================================================================
+ * 4. 任务与运行
+ * ===================================================================
+ */
+
+void
+async_task_init(AsyncTask *task, AsyncFn fn, AllocReleaseFn release, void *alloc, Layout layout)
+{
+  *task = (AsyncTask){
+    .fn = fn,
+    .release = release,
+    .alloc = alloc,
+    .layout = layout,
+  };
+}
+
+void
+async_spawn(AsyncRt *self, AsyncTask *task)
+{
+  task->rt = self;
+  self->live++;
+  list_push(&self->ready, task);
+}
+
+void
+async_requeue(AsyncTask *task)
+{
+  list_push(&task->rt->ready, task);
+}
+
+void
+async_rt_run(AsyncRt *self)
+{
+  while (self->live != 0)
+  {
+    /* 只执行本轮开始时已就绪的任务, 让出的任务排到下一轮 */
+    AsyncTask *last = self->ready.tail;
+    AsyncTask *task = NULL;
+    while (task != last && (task = list_pop(&self->ready)) != NULL)
+    {
+      if (task->fn(task) == ASYNC_READY)
+      {
+        self->live--;
+        if (task->release != NULL)
+          task->release(task->alloc, task, task->layout);
+      }
+    }
+    if (self->live == 0)
+      break;
+    asrt_msg(self->ready.head != NULL || self->in_flight != 0,
+             "async_rt_run: {} task(s) pending but none is ready or waiting for I/O",
+             self->live);
+    /* 还有就绪任务时只收割, 不等待 */
+    backend_collect(self, self->ready.head == NULL);
+  }
+}
+
+/*
+ * ===================================================================
+ * 5. 创建与销毁
+ * ===================================================================
+ */
+
+Option_AsyncRtPtr
+async_rt_new(SystemAlloc *backing_alloc, const AsyncConfig *config)
+{
+  AsyncConfig cfg = config != NULL ? *config : (AsyncConfig){0};
+  if (cfg.entries == 0)
+    cfg.entries = ASYNC_DEFAULT_ENTRIES;
+  if (cfg.io_threads == 0)
+    cfg.io_threads = ASYNC_DEFAULT_IO_THREADS;
+
+  Layout layout = LAYOUT_OF(AsyncRt);
+  Option_anyptr mem = sys_aligned_alloc(layout.align, layout.size);
+  if (ois_none(mem))
+  {
+    return None(AsyncRtPtr);
+  }
+  AsyncRt *self = (AsyncRt *)mem.value.some;
+  memset(self, 0, layout.size);
+  self->backing_alloc = backing_alloc;
+  mtx_init(&self->lock, mtx_plain);
+  cnd_init(&self->job_ready);
+  cnd_init(&self->job_done);
+
+  if (cfg.backend != ASYNC_BACKEND_THREADS)
+  {
+    Option_AsyncUringPtr uring = async_uring_new(backing_alloc, cfg.entries);
+    if (ois_some(uring))
+    {
+      self->uring = uring.value.some;
+      self->backend = ASYNC_BACKEND_URING;
+      self->capacity = async_uring_capacity(self->uring);
+      return Some(AsyncRtPtr, self);
+    }
+  }
+  if (cfg.backend != ASYNC_BACKEND_URING && threads_start(self, cfg.io_threads))
+  {
+    self->backend = ASYNC_BACKEND_THREADS;
+    self->capacity = cfg.entries;
+    return Some(AsyncRtPtr, self);
+  }
+
+  cnd_destroy(&self->job_done);
+  cnd_destroy(&self->job_ready);
+  mtx_destroy(&self->lock);
+  RELEASE(SYSTEM, backing_alloc, self, LAYOUT_OF(AsyncRt));
+  return None(AsyncRtPtr);
+}
+
+void
+async_rt_free(AsyncRt *self)
+{
+  if (self == NULL)
+  {
+    return;
+  }
+  asrt_msg(self->live == 0, "async_rt_free: {} task(s) still pending", self->live);
+  if (self->uring != NULL)
+  {
+    async_uring_free(self->uring);
+  }
+  if (self->threads != NULL)
+  {
+    threads_stop(self, self->nthreads);
+    RELEASE(SYSTEM, self->backing_alloc, self->threads, LAYOUT_OF_ARRAY(thrd_t, self->nthreads));
+  }
+  cnd_destroy(&self->job_done);
+  cnd_destroy(&self->job_ready);
+  mtx_destroy(&self->lock);
+  RELEASE(SYSTEM, self->backing_alloc, self, LAYOUT_OF(AsyncRt));
+}
+
+AsyncBackend
+async_rt_backend(const AsyncRt *self)
+{
+  return self->backend;
+}
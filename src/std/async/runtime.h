@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Impl) 单线程异步运行时: 无栈协程 + io_uring (或 I/O 线程) 文件读写。
+ *
+ * 每个异步任务是一个协程帧: 结构体的第一个字段是 AsyncTask, 其余字段保存
+ * 跨越 await 的局部变量。协程体是一个普通函数, 用 ASYNC_BEGIN / ASYNC_END 包住,
+ * 在 ASYNC_AWAIT_* 处提交 I/O 并返回; I/O 完成后运行时再次调用它,
+ * 从 await 之后继续执行 (switch + __LINE__ 实现的状态机, 不需要独立的栈)。
+ *
+ * 所有协程都在调用 async_rt_run 的线程上执行, CPU 工作与内核 (或 I/O 线程)
+ * 中进行的 I/O 重叠。后端:
+ * - io_uring (Linux 5.7+): 提交和收割都通过共享的环形缓冲区, 批量进入内核;
+ * - 线程: io_uring 不可用 (或显式要求) 时, 由固定数量的线程执行阻塞的
+ *   openat / pread / pwrite / close。
+ *
+ * 协程帧通过分配器 Trait 分配 (ASYNC_NEW), 协程结束后由运行时用同一个分配器释放。
+ *
+ * 限制: 一行只能写一个 ASYNC_AWAIT_* / ASYNC_YIELD (以行号区分恢复点);
+ * 协程体中不能再嵌套 switch 跨越 await; 局部变量在 await 之后失效。
+ *
+ * @example
+ * typedef struct Load { AsyncTask task; const char *path; i32 fd; char buf[4096]; } Load;
+ * DEFINE_ALLOC_RELEASER(SystemAlloc, SYSTEM)
+ *
+ * static AsyncPoll load(AsyncTask *t) {
+ *   Load *l = (Load *)t;
+ *   ASYNC_BEGIN(t);
+ *   ASYNC_AWAIT_OPEN(t, l->path, O_RDONLY, 0);
+ *   if (t->io_result < 0) ASYNC_RETURN(t);
+ *   l->fd = (i32)t->io_result;
+ *   ASYNC_AWAIT_READ(t, l->fd, l->buf, sizeof(l->buf), 0);
+ *   consume(l->buf, t->io_result);                // 与其他任务的 I/O 重叠
+ *   ASYNC_AWAIT_CLOSE(t, l->fd);
+ *   ASYNC_END(t);
+ * }
+ *
+ * Load *l = ASYNC_NEW(SYSTEM, &sys, Load, load);
+ * l->path = "data.txt";
+ * async_spawn(rt, &l->task);
+ * async_rt_run(rt);
+ */
+
+#include <core/mem/allocer.h> // ZALLOC, AllocReleaseFn
+#include <core/mem/layout.h>  // Layout, LAYOUT_OF
+#include <core/mem/sysalc.h>  // SystemAlloc
+#include <core/option.h>      // Option
+#include <core/type.h>        // usize, i32, i64, u64, anyptr
+
+/** @brief io_uring 提交队列的默认长度, 也是同时进行中的 I/O 数的上限。 */
+#define ASYNC_DEFAULT_ENTRIES 256
+
+/** @brief 线程后端的默认 I/O 线程数。 */
+#define ASYNC_DEFAULT_IO_THREADS 4
+
+/** @brief 积攒这么多个提交就立即进入内核, 不等本轮的就绪任务全部执行完。 */
+#define ASYNC_SUBMIT_BATCH 32
+
+/**
+ * @brief I/O 后端。
+ */
+typedef enum AsyncBackend
+{
+  ASYNC_BACKEND_AUTO,    /* 优先 io_uring, 不可用时用线程 */
+  ASYNC_BACKEND_URING,   /* 只用 io_uring, 不可用时 async_rt_new 失败 */
+  ASYNC_BACKEND_THREADS, /* 只用 I/O 线程 */
+} AsyncBackend;
+
+/**
+ * @brief async_rt_new 的参数 (字段为 0 时取默认值)。
+ */
+typedef struct AsyncConfig
+{
+  AsyncBackend backend;
+  usize entries;    /* 同时进行中的 I/O 数上限 (io_uring 会取整到 2 的幂) */
+  usize io_threads; /* 线程后端的线程数 */
+} AsyncConfig;
+
+/** @brief 协程一次执行的结果。 */
+typedef enum AsyncPoll
+{
+  ASYNC_PENDING, /* 在等待 I/O (或主动让出), 之后会被再次调用 */
+  ASYNC_READY,   /* 已结束, 帧随后被释放 */
+} AsyncPoll;
+
+/** @brief (内部) I/O 操作类型。 */
+typedef enum AsyncOp
+{
+  ASYNC_OP_NONE,
+  ASYNC_OP_OPEN,
+  ASYNC_OP_READ,
+  ASYNC_OP_WRITE,
+  ASYNC_OP_CLOSE,
+} AsyncOp;
+
+/** @brief (内部) 等待中的 I/O 请求。 */
+typedef struct AsyncIo
+{
+  AsyncOp op;
+  i32 fd;
+  i32 flags;  /* open */
+  u32 mode;   /* open */
+  anyptr buf; /* read / write 的缓冲区, open 的路径 */
+  usize len;
+  u64 off;
+} AsyncIo;
+
+typedef struct AsyncRt AsyncRt;
+typedef struct AsyncTask AsyncTask;
+
+/** @brief 协程体。 */
+typedef AsyncPoll (*AsyncFn)(AsyncTask *task);
+
+/**
+ * @brief 协程帧的头部 (必须是帧结构体的第一个字段)。
+ */
+struct AsyncTask
+{
+  AsyncFn fn;
+  u32 resume;    /* 恢复点 (行号), 0 表示从头开始 */
+  i64 io_result; /* 最近一次 await 的结果: 字节数 / fd / 0, 失败时为 -errno */
+
+  AsyncIo io;
+  AsyncRt *rt;
+  AsyncTask *next; /* 运行时内部的链表 */
+
+  AllocReleaseFn release; /* 为 NULL 时帧由调用者管理 */
+  void *alloc;
+  Layout layout;
+};
+
+DEFINE_OPTION(AsyncRtPtr, AsyncRt *);
+
+/*
+ * ===================================================================
+ * 1. 运行时
+ * ===================================================================
+ */
+
+/**
+ * @brief 创建运行时。
+ * @param config 可以为 NULL (全部取默认值)。
+ * @return Some(AsyncRt*) 成功; None 失败 (OOM, 无法创建线程, 或要求 io_uring 而它不可用)。
+ */
+Option_AsyncRtPtr async_rt_new(SystemAlloc *backing_alloc, const AsyncConfig *config);
+
+/**
+ * @brief 释放运行时。调用时不能有未完成的任务。
+ */
+void async_rt_free(AsyncRt *self);
+
+/**
+ * @brief 实际使用的后端 (ASYNC_BACKEND_URING 或 ASYNC_BACKEND_THREADS)。
+ */
+AsyncBackend async_rt_backend(const AsyncRt *self);
+
+/**
+ * @brief 执行所有任务 (包括执行期间新 spawn 的), 直到全部结束。
+ */
+void async_rt_run(AsyncRt *self);
+
+/*
+ * ===================================================================
+ * 2. 任务
+ * ===================================================================
+ */
+
+/**
+ * @brief 初始化协程帧的头部 (ASYNC_NEW 会调用它; 帧自行管理时手动调用, release 传 NULL)。
+ */
+void async_task_init(
+  AsyncTask *task, AsyncFn fn, AllocReleaseFn release, void *alloc, Layout layout);
+
+/**
+ * @brief 把任务放入就绪队列。可以在 async_rt_run 之前或协程内部调用。
+ */
+void async_spawn(AsyncRt *self, AsyncTask *task);
+
+/**
+ * @brief (内部) 提交 task->io 描述的 I/O, 完成后任务重新就绪。
+ */
+void async_submit(AsyncTask *task);
+
+/**
+ * @brief (内部) 把任务重新放回就绪队列的末尾。
+ */
+void async_requeue(AsyncTask *task);
+
+/*
+ * ===================================================================
+ * 3. 协程宏
+ * ===================================================================
+ */
+
+/** @brief 协程体的开头。 */
+#define ASYNC_BEGIN(t)                                                                             \
+  switch ((t)->resume)                                                                             \
+  {                                                                                                \
+  case 0:
+
+/** @brief 协程体的结尾: 任务结束。 */
+#define ASYNC_END(t)                                                                               \
+  }                                                                                                \
+  return ASYNC_READY
+
+/** @brief 提前结束任务。 */
+#define ASYNC_RETURN(t) return ASYNC_READY
+
+/** @brief (内部) 把 t->io 设为 (AsyncIo){...}, 提交并挂起; 恢复后从这里继续。 */
+#define ASYNC_AWAIT_IO_(t, ...)                                                                    \
+  do                                                                                               \
+  {                                                                                                \
+    (t)->io = (AsyncIo){__VA_ARGS__};                                                              \
+    (t)->resume = __LINE__;                                                                        \
+    async_submit(t);                                                                               \
+    return ASYNC_PENDING;                                                                          \
+  case __LINE__:;                                                                                  \
+  } while (0)
+
+/** @brief 让出: 排到就绪队列末尾, 让其他任务先执行。 */
+#define ASYNC_YIELD(t)                                                                             \
+  do                                                                                               \
+  {                                                                                                \
+    (t)->resume = __LINE__;                                                                        \
+    async_requeue(t);                                                                              \
+    return ASYNC_PENDING;                                                                          \
+  case __LINE__:;                                                                                  \
+  } while (0)
+
+/** @brief 异步 openat(AT_FDCWD, path, flags, mode); io_result 为 fd 或 -errno。 */
+#define ASYNC_AWAIT_OPEN(t, path, open_flags, open_mode)                                           \
+  ASYNC_AWAIT_IO_(                                                                                 \
+    t, .op = ASYNC_OP_OPEN, .buf = (anyptr)(path), .flags = (open_flags), .mode = (open_mode))
+
+/** @brief 异步 pread; io_result 为读到的字节数 (0 表示文件结束, 可能少于 n) 或 -errno。 */
+#define ASYNC_AWAIT_READ(t, file, dst, n, offset)                                                  \
+  ASYNC_AWAIT_IO_(t, .op = ASYNC_OP_READ, .fd = (file), .buf = (dst), .len = (n), .off = (offset))
+
+/** @brief 异步 pwrite; io_result 为写入的字节数 (可能少于 n) 或 -errno。 */
+#define ASYNC_AWAIT_WRITE(t, file, src, n, offset)                                                 \
+  ASYNC_AWAIT_IO_(                                                                                 \
+    t, .op = ASYNC_OP_WRITE, .fd = (file), .buf = (anyptr)(src), .len = (n), .off = (offset))
+
+/** @brief 异步 close; io_result 为 0 或 -errno。 */
+#define ASYNC_AWAIT_CLOSE(t, file) ASYNC_AWAIT_IO_(t, .op = ASYNC_OP_CLOSE, .fd = (file))
+
+/*
+ * ===================================================================
+ * 4. 分配器集成
+ * ===================================================================
+ */
+
+/**
+ * @brief 从分配器中分配一个清零的 Frame, 以 fn 为协程体初始化它 (还未 spawn)。
+ * 任务结束后帧用同一个分配器释放 (需要先 DEFINE_ALLOC_RELEASER 同一个前缀)。
+ */
+#define ASYNC_NEW(AllocPrefix, alloc, Frame, fn)                                                   \
+  ({                                                                                               \
+    Frame *__async_frame = (Frame *)ZALLOC(AllocPrefix, (alloc), LAYOUT_OF(Frame));                \
+    async_task_init(                                                                               \
+      &__async_frame->task, (fn), ALLOC_RELEASER(AllocPrefix), (alloc), LAYOUT_OF(Frame));         \
+    __async_frame;                                                                                 \
+  })
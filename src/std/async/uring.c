@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/async/uring.h>
+
+#ifdef __linux__
+
+#include <core/mem/allocer.h> // ZALLOC, RELEASE
+#include <core/mem/layout.h>  // LAYOUT_OF
+#include <core/msg/panic.h>   // panic
+#include <errno.h>
+#include <fcntl.h> // AT_FDCWD
+#include <linux/io_uring.h>
+#include <stdatomic.h>
+#include <sys/mman.h>    // mmap
+#include <sys/syscall.h> // __NR_io_uring_*
+#include <unistd.h>      // syscall, close
+
+/** @brief 单次读写的最大长度 (与 Linux 的 MAX_RW_COUNT 相同)。 */
+#define URING_MAX_RW 0x7ffff000u
+
+struct AsyncUring
+{
+  i32 fd;
+
+  /* 提交队列 (内核读 head, 我们写 tail) */
+  _Atomic u32 *sq_head;
+  _Atomic u32 *sq_tail;
+  u32 sq_mask;
+  u32 *sq_array;
+  struct io_uring_sqe *sqes;
+  u32 sq_entries;
+  u32 sq_local_tail; /* 已填写的末尾; sq_tail 只在 enter 前发布 */
+
+  /* 完成队列 (内核写 tail, 我们写 head) */
+  _Atomic u32 *cq_head;
+  _Atomic u32 *cq_tail;
+  u32 cq_mask;
+  struct io_uring_cqe *cqes;
+
+  void *ring_ptr;
+  usize ring_len;
+  usize sqes_len;
+  SystemAlloc *backing_alloc;
+};
+
+static i32
+uring_setup(u32 entries, struct io_uring_params *params)
+{
+  return (i32)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static i32
+uring_enter(i32 fd, u32 to_submit, u32 min_complete, u32 flags)
+{
+  return (i32)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+Option_AsyncUringPtr
+async_uring_new(SystemAlloc *backing_alloc, usize entries)
+{
+  struct io_uring_params params = {0};
+  i32 fd = uring_setup((u32)entries, &params);
+  if (fd < 0)
+  {
+    return None(AsyncUringPtr);
+  }
+  /* 需要 IORING_OP_READ / WRITE / OPENAT / CLOSE (5.6) 与单次 mmap; FAST_POLL 表示 5.7+ */
+  u32 required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_FAST_POLL;
+  if ((params.features & required) != required)
+  {
+    close(fd);
+    return None(AsyncUringPtr);
+  }
+
+  usize sq_len = params.sq_off.array + params.sq_entries * sizeof(u32);
+  usize cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  usize ring_len = sq_len > cq_len ? sq_len : cq_len;
+  void *ring = mmap(
+    NULL, ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (ring == MAP_FAILED)
+  {
+    close(fd);
+    return None(AsyncUringPtr);
+  }
+  usize sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+  void *sqes =
+    mmap(NULL, sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED)
+  {
+    munmap(ring, ring_len);
+    close(fd);
+    return None(AsyncUringPtr);
+  }
+
+  AsyncUring *self = ZALLOC(SYSTEM, backing_alloc, LAYOUT_OF(AsyncUring));
+  u8 *base = (u8 *)ring;
+  self->fd = fd;
+  self->sq_head = (_Atomic u32 *)(base + params.sq_off.head);
+  self->sq_tail = (_Atomic u32 *)(base + params.sq_off.tail);
+  self->sq_mask = *(u32 *)(base + params.sq_off.ring_mask);
+  self->sq_array = (u32 *)(base + params.sq_off.array);
+  self->sqes = (struct io_uring_sqe *)sqes;
+  self->sq_entries = params.sq_entries;
+  self->sq_local_tail = atomic_load_explicit(self->sq_tail, memory_order_relaxed);
+  self->cq_head = (_Atomic u32 *)(base + params.cq_off.head);
+  self->cq_tail = (_Atomic u32 *)(base + params.cq_off.tail);
+  self->cq_mask = *(u32 *)(base + params.cq_off.ring_mask);
+  self->cqes = (struct io_uring_cqe *)(base + params.cq_off.cqes);
+  self->ring_ptr = ring;
+  self->ring_len = ring_len;
+  self->sqes_len = sqes_len;
+  self->backing_alloc = backing_alloc;
+  return Some(AsyncUringPtr, self);
+}
+
+void
+async_uring_free(AsyncUring *self)
+{
+  if (self == NULL)
+  {
+    return;
+  }
+  munmap(self->sqes, self->sqes_len);
+  munmap(self->ring_ptr, self->ring_len);
+  close(self->fd);
+  RELEASE(SYSTEM, self->backing_alloc, self, LAYOUT_OF(AsyncUring));
+}
+
+usize
+async_uring_capacity(const AsyncUring *self)
+{
+  return self->sq_entries;
+}
+
+void
+async_uring_push(AsyncUring *self, AsyncTask *task)
+{
+  u32 tail = self->sq_local_tail;
+  u32 index = tail & self->sq_mask;
+  struct io_uring_sqe *sqe = &self->sqes[index];
+  const AsyncIo *io = &task->io;
+
+  *sqe = (struct io_uring_sqe){0};
+  sqe->user_data = (u64)(uintptr_t)task;
+  switch (io->op)
+  {
+  case ASYNC_OP_OPEN:
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (u64)(uintptr_t)io->buf;
+    sqe->len = io->mode;
+    sqe->open_flags = (u32)io->flags;
+    break;
+  case ASYNC_OP_READ:
+  case ASYNC_OP_WRITE:
+    sqe->opcode = io->op == ASYNC_OP_READ ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->fd = io->fd;
+    sqe->addr = (u64)(uintptr_t)io->buf;
+    sqe->len = io->len > URING_MAX_RW ? URING_MAX_RW : (u32)io->len;
+    sqe->off = io->off;
+    break;
+  case ASYNC_OP_CLOSE:
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = io->fd;
+    break;
+  default:
+    panic("async_uring_push: invalid op {}", (i32)io->op);
+  }
+  self->sq_array[index] = index;
+  self->sq_local_tail = tail + 1;
+}
+
+usize
+async_uring_unsubmitted(const AsyncUring *self)
+{
+  /* 内核消费到的位置是 sq_head; 已发布但内核还没取走的也算未提交 */
+  return self->sq_local_tail - atomic_load_explicit(self->sq_head, memory_order_acquire);
+}
+
+void
+async_uring_enter(AsyncUring *self, bool wait)
+{
+  if (async_uring_unsubmitted(self) == 0 && !wait)
+  {
+    return;
+  }
+  /* 发布提交项: 内核读到新 tail 时, sqe 的内容必须已经可见 */
+  atomic_store_explicit(self->sq_tail, self->sq_local_tail, memory_order_release);
+  u32 flags = wait ? IORING_ENTER_GETEVENTS : 0;
+  for (;;)
+  {
+    /* 内核只取走一部分时 (例如内存不足), 剩下的留到下次 enter */
+    u32 to_submit = (u32)async_uring_unsubmitted(self);
+    if (uring_enter(self->fd, to_submit, wait ? 1 : 0, flags) >= 0)
+    {
+      return;
+    }
+    if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+    {
+      panic("io_uring_enter failed (errno {})", errno);
+    }
+  }
+}
+
+AsyncTask *
+async_uring_reap(AsyncUring *self, usize *count)
+{
+  u32 head = atomic_load_explicit(self->cq_head, memory_order_relaxed);
+  u32 tail = atomic_load_explicit(self->cq_tail, memory_order_acquire);
+  AsyncTask *first = NULL;
+  AsyncTask **link = &first;
+  *count = tail - head;
+  for (; head != tail; head++)
+  {
+    const struct io_uring_cqe *cqe = &self->cqes[head & self->cq_mask];
+    AsyncTask *task = (AsyncTask *)(uintptr_t)cqe->user_data;
+    task->io_result = cqe->res;
+    *link = task;
+    link = &task->next;
+  }
+  *link = NULL;
+  atomic_store_explicit(self->cq_head, tail, memory_order_release);
+  return first;
+}
+
+#else /* !__linux__ */
+
+Option_AsyncUringPtr
+async_uring_new(SystemAlloc *backing_alloc, usize entries)
+{
+  (void)backing_alloc;
+  (void)entries;
+  return None(AsyncUringPtr);
+}
+
+void
+async_uring_free(AsyncUring *self)
+{
+  (void)self;
+}
+
+usize
+async_uring_capacity(const AsyncUring *self)
+{
+  (void)self;
+  return 0;
+}
+
+void
+async_uring_push(AsyncUring *self, AsyncTask *task)
+{
+  (void)self;
+  (void)task;
+}
+
+usize
+async_uring_unsubmitted(const AsyncUring *self)
+{
+  (void)self;
+  return 0;
+}
+
+void
+async_uring_enter(AsyncUring *self, bool wait)
+{
+  (void)self;
+  (void)wait;
+}
+
+AsyncTask *
+async_uring_reap(AsyncUring *self, usize *count)
+{
+  (void)self;
+  *count = 0;
+  return NULL;
+}
+
+#endif
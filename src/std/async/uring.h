@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (内部) io_uring 的最小封装: 直接使用系统调用和 mmap, 不依赖 liburing。
+ *
+ * 只给 runtime.c 使用, 只在单个线程中访问。调用者负责让进行中的请求数
+ * 不超过 async_uring_capacity (完成队列是提交队列的两倍长, 因此永远不会溢出)。
+ * 非 Linux 平台或内核早于 5.7 时 async_uring_new 返回 None。
+ */
+
+#include <core/mem/sysalc.h>   // SystemAlloc
+#include <core/option.h>       // Option
+#include <core/type.h>         // usize
+#include <std/async/runtime.h> // AsyncTask
+
+typedef struct AsyncUring AsyncUring;
+
+DEFINE_OPTION(AsyncUringPtr, AsyncUring *);
+
+/** @brief 创建至少有 entries 个提交槽的 io_uring; 不可用时返回 None。 */
+Option_AsyncUringPtr async_uring_new(SystemAlloc *backing_alloc, usize entries);
+
+/** @brief 关闭 io_uring 并释放内存。 */
+void async_uring_free(AsyncUring *self);
+
+/** @brief 提交队列的长度。 */
+usize async_uring_capacity(const AsyncUring *self);
+
+/** @brief 按 task->io 填写一个提交项 (还未进入内核)。 */
+void async_uring_push(AsyncUring *self, AsyncTask *task);
+
+/** @brief 已填写但还未提交给内核的请求数。 */
+usize async_uring_unsubmitted(const AsyncUring *self);
+
+/**
+ * @brief 把所有已填写的请求提交给内核; wait 为 true 时至少等到一个请求完成。
+ */
+void async_uring_enter(AsyncUring *self, bool wait);
+
+/**
+ * @brief 收割所有已完成的请求: 写入各任务的 io_result, 按完成顺序串成链表返回。
+ * @param count 输出收割到的个数。
+ */
+AsyncTask *async_uring_reap(AsyncUring *self, usize *count);
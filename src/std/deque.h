@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Template) 基于 2 的幂环形缓冲区的双端队列。
+ *
+ * 用 DEFINE_VECTOR 当 FIFO 时, 要么从头部 memmove, 要么放任它无限增长。
+ * Deque 的两端 push / pop 都是 O(1): 只移动 head 下标, 用 `& (cap - 1)` 回绕。
+ *
+ * - 扩容时把环 "展开" 到新缓冲区的开头, 最多两次 memcpy;
+ * - `_as_slices` 把内容表示为两段连续内存 (第二段可能为空),
+ *   可以直接交给按数组处理的 (向量化) 循环。
+ *
+ * @example
+ * DEFINE_DEQUE(WorkList, Task, SystemAlloc, SYSTEM)
+ * WorkList_push_back(&list, t);
+ * while (WorkList_pop_front(&list, &t)) { ... }
+ */
+
+#include <core/mem/allocer.h> // ALLOC, RELEASE
+#include <core/mem/layout.h>  // LAYOUT_OF_ARRAY
+#include <core/msg/asrt.h>    // asrt_msg
+#include <core/type.h>        // usize
+#include <string.h>           // memcpy
+
+/** @brief 第一次分配时的容量。 */
+#define DEQUE_MIN_CAP 8
+
+/**
+ * @brief (Template) 实例化一个双端队列类型。
+ *
+ * @param TypeName    生成的类型名
+ * @param T           元素类型
+ * @param AllocType   分配器类型 (例如 SystemAlloc, Bump)
+ * @param AllocPrefix 分配器前缀 (例如 SYSTEM, BUMP)
+ */
+#define DEFINE_DEQUE(TypeName, T, AllocType, AllocPrefix)                                          \
+                                                                                                   \
+  /* --- 1. 类型 --- */                                                                            \
+                                                                                                   \
+  typedef struct TypeName                                                                          \
+  {                                                                                                \
+    T *data;                                                                                       \
+    usize head; /* 第一个元素的下标 */                                                             \
+    usize len;                                                                                     \
+    usize cap; /* 0 或 2 的幂 */                                                                   \
+    AllocType *alloc_state;                                                                        \
+  } TypeName;                                                                                      \
+                                                                                                   \
+  /** @brief 队列内容按顺序分成的两段连续内存: [first, first + first_len) 后接 second。 */         \
+  typedef struct TypeName##_Slices                                                                 \
+  {                                                                                                \
+    T *first;                                                                                      \
+    usize first_len;                                                                               \
+    T *second;                                                                                     \
+    usize second_len;                                                                              \
+  } TypeName##_Slices;                                                                             \
+                                                                                                   \
+  /* --- 2. 生命周期 --- */                                                                        \
+                                                                                                   \
+  static inline void TypeName##_init(TypeName *self, AllocType *alloc)                             \
+  {                                                                                                \
+    self->data = NULL;                                                                             \
+    self->head = 0;                                                                                \
+    self->len = 0;                                                                                 \
+    self->cap = 0;                                                                                 \
+    self->alloc_state = alloc;                                                                     \
+  }                                                                                                \
+                                                                                                   \
+  static inline TypeName *TypeName##_new(AllocType *alloc)                                         \
+  {                                                                                                \
+    TypeName *self = (TypeName *)ALLOC(AllocPrefix, alloc, LAYOUT_OF(TypeName));                   \
+    TypeName##_init(self, alloc);                                                                  \
+    return self;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_deinit(TypeName *self)                                             \
+  {                                                                                                \
+    if (self->data)                                                                                \
+    {                                                                                              \
+      RELEASE(AllocPrefix, self->alloc_state, self->data, LAYOUT_OF_ARRAY(T, self->cap));          \
+    }                                                                                              \
+    self->data = NULL;                                                                             \
+    self->head = 0;                                                                                \
+    self->len = 0;                                                                                 \
+    self->cap = 0;                                                                                 \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_destroy(TypeName *self)                                            \
+  {                                                                                                \
+    if (self == NULL)                                                                              \
+      return;                                                                                      \
+    TypeName##_deinit(self);                                                                       \
+    RELEASE(AllocPrefix, self->alloc_state, self, LAYOUT_OF(TypeName));                            \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 3. 容量 --- */                                                                            \
+                                                                                                   \
+  static inline usize TypeName##_len(const TypeName *self)                                         \
+  {                                                                                                \
+    return self->len;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize TypeName##_cap(const TypeName *self)                                         \
+  {                                                                                                \
+    return self->cap;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline bool TypeName##_is_empty(const TypeName *self)                                     \
+  {                                                                                                \
+    return self->len == 0;                                                                         \
+  }                                                                                                \
+                                                                                                   \
+  static inline TypeName##_Slices TypeName##_as_slices(TypeName *self)                             \
+  {                                                                                                \
+    usize tail_room = self->cap - self->head;                                                      \
+    usize first_len = self->len < tail_room ? self->len : tail_room;                               \
+    return (TypeName##_Slices){                                                                    \
+      .first = self->data + self->head,                                                            \
+      .first_len = first_len,                                                                      \
+      .second = self->data,                                                                        \
+      .second_len = self->len - first_len,                                                         \
+    };                                                                                             \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 保证容量至少为 min_cap (向上取整到 2 的幂)。                                           \
+   * 新缓冲区中元素从下标 0 开始: 环的两段各一次 memcpy。                                          \
+   */                                                                                              \
+  static inline void TypeName##_reserve_to(TypeName *self, usize min_cap)                          \
+  {                                                                                                \
+    if (min_cap <= self->cap)                                                                      \
+      return;                                                                                      \
+    usize new_cap = self->cap == 0 ? DEQUE_MIN_CAP : self->cap;                                    \
+    while (new_cap < min_cap)                                                                      \
+    {                                                                                              \
+      new_cap *= 2;                                                                                \
+    }                                                                                              \
+    T *new_data = (T *)ALLOC(AllocPrefix, self->alloc_state, LAYOUT_OF_ARRAY(T, new_cap));         \
+    if (self->data)                                                                                \
+    {                                                                                              \
+      TypeName##_Slices s = TypeName##_as_slices(self);                                            \
+      memcpy(new_data, s.first, s.first_len * sizeof(T));                                          \
+      memcpy(new_data + s.first_len, s.second, s.second_len * sizeof(T));                          \
+      RELEASE(AllocPrefix, self->alloc_state, self->data, LAYOUT_OF_ARRAY(T, self->cap));          \
+    }                                                                                              \
+    self->data = new_data;                                                                         \
+    self->head = 0;                                                                                \
+    self->cap = new_cap;                                                                           \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 4. 两端操作 --- */                                                                        \
+                                                                                                   \
+  static inline void TypeName##_push_back(TypeName *self, T value)                                 \
+  {                                                                                                \
+    if (self->len == self->cap)                                                                    \
+    {                                                                                              \
+      TypeName##_reserve_to(self, self->cap + 1);                                                  \
+    }                                                                                              \
+    self->data[(self->head + self->len) & (self->cap - 1)] = value;                                \
+    self->len++;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_push_front(TypeName *self, T value)                                \
+  {                                                                                                \
+    if (self->len == self->cap)                                                                    \
+    {                                                                                              \
+      TypeName##_reserve_to(self, self->cap + 1);                                                  \
+    }                                                                                              \
+    self->head = (self->head - 1) & (self->cap - 1);                                               \
+    self->data[self->head] = value;                                                                \
+    self->len++;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 取出第一个元素; 队列为空时返回 false。out 可为 NULL。 */                              \
+  static inline bool TypeName##_pop_front(TypeName *self, T *out)                                  \
+  {                                                                                                \
+    if (self->len == 0)                                                                            \
+      return false;                                                                                \
+    if (out != NULL)                                                                               \
+    {                                                                                              \
+      *out = self->data[self->head];                                                               \
+    }                                                                                              \
+    self->head = (self->head + 1) & (self->cap - 1);                                               \
+    self->len--;                                                                                   \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 取出最后一个元素; 队列为空时返回 false。out 可为 NULL。 */                            \
+  static inline bool TypeName##_pop_back(TypeName *self, T *out)                                   \
+  {                                                                                                \
+    if (self->len == 0)                                                                            \
+      return false;                                                                                \
+    self->len--;                                                                                   \
+    if (out != NULL)                                                                               \
+    {                                                                                              \
+      *out = self->data[(self->head + self->len) & (self->cap - 1)];                               \
+    }                                                                                              \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 第一个元素的指针; 队列为空时返回 NULL。 */                                            \
+  static inline T *TypeName##_front(TypeName *self)                                                \
+  {                                                                                                \
+    return self->len == 0 ? NULL : &self->data[self->head];                                        \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 最后一个元素的指针; 队列为空时返回 NULL。 */                                          \
+  static inline T *TypeName##_back(TypeName *self)                                                 \
+  {                                                                                                \
+    return self->len == 0 ? NULL                                                                   \
+                          : &self->data[(self->head + self->len - 1) & (self->cap - 1)];           \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 第 index 个元素 (从队首数起)。 */                                                     \
+  static inline T *TypeName##_get(TypeName *self, usize index)                                     \
+  {                                                                                                \
+    asrt_msg(index < self->len, "deque index {} out of bounds (len {})", index, self->len);        \
+    return &self->data[(self->head + index) & (self->cap - 1)];                                    \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 清空 (保留容量)。 */                                                                  \
+  static inline void TypeName##_clear(TypeName *self)                                              \
+  {                                                                                                \
+    self->head = 0;                                                                                \
+    self->len = 0;                                                                                 \
+  }
@@ -0,0 +1,588 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Template) 基于有序数组的集合 / 映射 (flat set / flat map)。
+ *
+ * 键保存在一个有序的 DEFINE_VECTOR 中, 适合 "一次构建, 大量查询" 的场景:
+ * - 查找用无分支的 lower_bound (比较结果编译为 cmov, 没有分支预测失败);
+ * - 区间查询 [lo, hi) 只需两次 lower_bound, 结果是连续的一段;
+ * - 数组很大时可以调用 `_build_index` 额外建立 Eytzinger (BFS 顺序) 布局,
+ *   查找时预取四层之后的节点, 把每层一次的缓存未命中变成流水线化的预取;
+ * - 集合的并 / 交用 galloping (指数搜索) 跳过不重叠的长段。
+ *
+ * 插入 / 删除是 O(n) 的 (memmove), 并且会丢弃 Eytzinger 索引。
+ *
+ * @example
+ * DEFINE_FLAT_SET(U64Set, u64, cmp_u64, SystemAlloc, SYSTEM)
+ * U64Set_build(&set, items, n);    // 无序输入, 排序并去重
+ * U64Set_build_index(&set);        // 可选
+ * usize first;
+ * usize count = U64Set_range(&set, &lo, &hi, &first);
+ */
+
+/*
+ * ===================================================================
+ * 1. 依赖
+ * ===================================================================
+ */
+
+#include <core/mem/allocer.h> // ALLOC, RELEASE
+#include <core/mem/layout.h>  // Layout
+#include <core/msg/asrt.h>    // asrt_msg
+#include <core/type.h>        // usize
+#include <std/sort.h>         // DEFINE_SORT
+#include <std/vector.h>       // DEFINE_VECTOR
+
+/** @brief Eytzinger 数组按缓存行对齐。 */
+#define FLAT_INDEX_ALIGN 64
+
+/**
+ * @brief (内部) 一个缓存行能放下的最多 2 的幂个元素。
+ *
+ * 节点 k 往下 log2(stride) 层的所有后代是 [k * stride, k * stride + stride),
+ * 在按缓存行对齐的数组中恰好占一行, 一次预取就能覆盖。
+ */
+static inline usize
+flat_prefetch_stride(usize elem_size)
+{
+  usize stride = 1;
+  while (stride * 2 * elem_size <= FLAT_INDEX_ALIGN)
+  {
+    stride *= 2;
+  }
+  return stride;
+}
+
+/*
+ * ===================================================================
+ * 2. (内部) 公共部分: 查找, 索引, 区间
+ * ===================================================================
+ *
+ * 要求 Name 结构体包含字段 keys (有序向量), index, rank, index_len。
+ */
+
+#define __FLAT_COMMON(Name, K, FN_CMP, AllocType, AllocPrefix)                                     \
+                                                                                                   \
+  /** @brief 在有序数组 keys[0, len) 中找第一个 >= *key 的位置 (无分支)。 */                      \
+  static inline usize Name##_lower_bound_in(const K *keys, usize len, const K *key)                \
+  {                                                                                                \
+    if (len == 0)                                                                                  \
+      return 0;                                                                                    \
+    const K *base = keys;                                                                          \
+    while (len > 1)                                                                                \
+    {                                                                                              \
+      usize half = len / 2;                                                                        \
+      base = Name##_ksort_less(&base[half], key) ? base + half : base;                             \
+      len -= half;                                                                                 \
+    }                                                                                              \
+    return (usize)(base - keys) + Name##_ksort_less(base, key);                                    \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 在有序数组 keys[0, len) 中找第一个 > *key 的位置 (无分支)。 */                        \
+  static inline usize Name##_upper_bound_in(const K *keys, usize len, const K *key)                \
+  {                                                                                                \
+    if (len == 0)                                                                                  \
+      return 0;                                                                                    \
+    const K *base = keys;                                                                          \
+    while (len > 1)                                                                                \
+    {                                                                                              \
+      usize half = len / 2;                                                                        \
+      base = !Name##_ksort_less(key, &base[half]) ? base + half : base;                            \
+      len -= half;                                                                                 \
+    }                                                                                              \
+    return (usize)(base - keys) + !Name##_ksort_less(key, base);                                   \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 与 lower_bound_in 结果相同, 但从头开始指数搜索:                                        \
+   * 答案为 r 时只需 O(log r) 次比较 (归并时答案通常很靠前)。                                     \
+   */                                                                                              \
+  static inline usize Name##_gallop_in(const K *keys, usize len, const K *key)                     \
+  {                                                                                                \
+    usize hi = 1;                                                                                  \
+    while (hi < len && Name##_ksort_less(&keys[hi], key))                                          \
+    {                                                                                              \
+      hi *= 2;                                                                                     \
+    }                                                                                              \
+    usize lo = hi / 2;                                                                             \
+    hi = hi < len ? hi : len;                                                                      \
+    return lo + Name##_lower_bound_in(keys + lo, hi - lo, key);                                    \
+  }                                                                                                \
+                                                                                                   \
+  /* --- Eytzinger 索引 --- */                                                                     \
+                                                                                                   \
+  /** @brief 释放 Eytzinger 索引 (之后的查找回到有序数组上的二分)。 */                             \
+  static inline void Name##_drop_index(Name *self)                                                 \
+  {                                                                                                \
+    if (self->index != NULL)                                                                       \
+    {                                                                                              \
+      usize bytes = (self->index_len + 1) * sizeof(K);                                             \
+      bytes = (bytes + FLAT_INDEX_ALIGN - 1) & ~(usize)(FLAT_INDEX_ALIGN - 1);                     \
+      RELEASE(AllocPrefix,                                                                         \
+              self->keys.alloc_state,                                                              \
+              self->index,                                                                         \
+              layout_from_size_align(bytes, FLAT_INDEX_ALIGN));                                    \
+      RELEASE(AllocPrefix,                                                                         \
+              self->keys.alloc_state,                                                              \
+              self->rank,                                                                          \
+              LAYOUT_OF_ARRAY(usize, self->index_len + 1));                                        \
+    }                                                                                              \
+    self->index = NULL;                                                                            \
+    self->rank = NULL;                                                                             \
+    self->index_len = 0;                                                                           \
+  }                                                                                                \
+                                                                                                   \
+  /* (内部) 中序遍历隐式树, 依次填入有序的键; 返回下一个有序下标 */                                \
+  static usize Name##_fill_index(Name *self, usize i, usize k)                                     \
+  {                                                                                                \
+    if (k <= self->index_len)                                                                      \
+    {                                                                                              \
+      i = Name##_fill_index(self, i, 2 * k);                                                       \
+      self->index[k] = self->keys.data[i];                                                         \
+      self->rank[k] = i;                                                                           \
+      i = Name##_fill_index(self, i + 1, 2 * k + 1);                                               \
+    }                                                                                              \
+    return i;                                                                                      \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 建立 (或重建) Eytzinger 索引: 节点 k 的子节点是 2k 和 2k + 1 (下标从 1 开始)。         \
+   * 额外占用 len 个键和 len 个 usize。                                                            \
+   */                                                                                              \
+  static inline void Name##_build_index(Name *self)                                                \
+  {                                                                                                \
+    Name##_drop_index(self);                                                                       \
+    usize n = self->keys.len;                                                                      \
+    if (n == 0)                                                                                    \
+      return;                                                                                      \
+    usize bytes = (n + 1) * sizeof(K);                                                             \
+    bytes = (bytes + FLAT_INDEX_ALIGN - 1) & ~(usize)(FLAT_INDEX_ALIGN - 1);                       \
+    self->index = (K *)ALLOC(                                                                      \
+      AllocPrefix, self->keys.alloc_state, layout_from_size_align(bytes, FLAT_INDEX_ALIGN));       \
+    self->rank =                                                                                   \
+      (usize *)ALLOC(AllocPrefix, self->keys.alloc_state, LAYOUT_OF_ARRAY(usize, n + 1));          \
+    self->index_len = n;                                                                           \
+    Name##_fill_index(self, 0, 1);                                                                 \
+  }                                                                                                \
+                                                                                                   \
+  /* (内部) 在 Eytzinger 索引上求 lower_bound, 返回有序数组中的下标 */                             \
+  static inline usize Name##_index_lower_bound(const Name *self, const K *key)                     \
+  {                                                                                                \
+    const K *tree = self->index;                                                                   \
+    usize n = self->index_len;                                                                     \
+    usize stride = flat_prefetch_stride(sizeof(K));                                                \
+    usize k = 1;                                                                                   \
+    while (k <= n)                                                                                 \
+    {                                                                                              \
+      __builtin_prefetch((const char *)tree + k * stride * sizeof(K));                             \
+      k = 2 * k + Name##_ksort_less(&tree[k], key);                                                \
+    }                                                                                              \
+    /* 去掉末尾 "向右走" 的 1 以及最后一次向左走: 回到最后一个 >= key 的节点 */                    \
+    k >>= __builtin_ctzll(~(unsigned long long)k) + 1;                                             \
+    return k == 0 ? n : self->rank[k];                                                             \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 查询 --- */                                                                               \
+                                                                                                   \
+  static inline usize Name##_len(const Name *self)                                                 \
+  {                                                                                                \
+    return self->keys.len;                                                                         \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 第一个 >= *key 的键的下标 (没有时为 len)。有索引时走索引。 */                         \
+  static inline usize Name##_lower_bound(const Name *self, const K *key)                           \
+  {                                                                                                \
+    if (self->index != NULL)                                                                       \
+      return Name##_index_lower_bound(self, key);                                                  \
+    return Name##_lower_bound_in(self->keys.data, self->keys.len, key);                            \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 第一个 > *key 的键的下标 (没有时为 len)。 */                                          \
+  static inline usize Name##_upper_bound(const Name *self, const K *key)                           \
+  {                                                                                                \
+    return Name##_upper_bound_in(self->keys.data, self->keys.len, key);                            \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 键的下标; 不存在时返回 len。 */                                                       \
+  static inline usize Name##_index_of(const Name *self, const K *key)                              \
+  {                                                                                                \
+    usize i = Name##_lower_bound(self, key);                                                       \
+    if (i < self->keys.len && !Name##_ksort_less(key, &self->keys.data[i]))                        \
+      return i;                                                                                    \
+    return self->keys.len;                                                                         \
+  }                                                                                                \
+                                                                                                   \
+  static inline bool Name##_contains(const Name *self, const K *key)                               \
+  {                                                                                                \
+    return Name##_index_of(self, key) != self->keys.len;                                           \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 区间查询: 落在 [*lo, *hi) 中的键是 keys.data[*first, *first + 返回值)。               \
+   * 上界从下界处 galloping, 代价只与区间内的键数有关。                                            \
+   */                                                                                              \
+  static inline usize Name##_range(const Name *self, const K *lo, const K *hi, usize *first)       \
+  {                                                                                                \
+    usize begin = Name##_lower_bound(self, lo);                                                    \
+    usize end = begin;                                                                             \
+    if (begin < self->keys.len && Name##_ksort_less(&self->keys.data[begin], hi))                  \
+    {                                                                                              \
+      end = begin + Name##_gallop_in(self->keys.data + begin, self->keys.len - begin, hi);         \
+    }                                                                                              \
+    if (first != NULL)                                                                             \
+    {                                                                                              \
+      *first = begin;                                                                              \
+    }                                                                                              \
+    return end - begin;                                                                            \
+  }
+
+/*
+ * ===================================================================
+ * 3. DEFINE_FLAT_SET
+ * ===================================================================
+ */
+
+/**
+ * @brief (Template) 有序数组上的集合。
+ *
+ * @param Name        生成的类型名
+ * @param K           键类型
+ * @param FN_CMP      签名为 `Ordering (*)(const K *, const K *)` 的比较函数
+ * @param AllocType   分配器类型 (例如 SystemAlloc, Bump)
+ * @param AllocPrefix 分配器前缀 (例如 SYSTEM, BUMP)
+ */
+#define DEFINE_FLAT_SET(Name, K, FN_CMP, AllocType, AllocPrefix)                                   \
+                                                                                                   \
+  DEFINE_VECTOR(Name##_Keys, K, AllocType, AllocPrefix)                                            \
+  DEFINE_SORT(Name##_ksort, K, FN_CMP)                                                             \
+                                                                                                   \
+  typedef struct Name                                                                              \
+  {                                                                                                \
+    Name##_Keys keys; /* 有序, 无重复 */                                                           \
+    K *index;         /* 可选的 Eytzinger 布局 (下标从 1 开始) */                                  \
+    usize *rank;      /* index[k] 在 keys 中的下标 */                                              \
+    usize index_len;                                                                               \
+  } Name;                                                                                          \
+                                                                                                   \
+  static inline void Name##_init(Name *self, AllocType *alloc)                                     \
+  {                                                                                                \
+    Name##_Keys_init(&self->keys, alloc);                                                          \
+    self->index = NULL;                                                                            \
+    self->rank = NULL;                                                                             \
+    self->index_len = 0;                                                                           \
+  }                                                                                                \
+                                                                                                   \
+  static inline Name *Name##_new(AllocType *alloc)                                                 \
+  {                                                                                                \
+    Name *self = (Name *)ALLOC(AllocPrefix, alloc, LAYOUT_OF(Name));                               \
+    Name##_init(self, alloc);                                                                      \
+    return self;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  __FLAT_COMMON(Name, K, FN_CMP, AllocType, AllocPrefix)                                           \
+                                                                                                   \
+  static inline void Name##_deinit(Name *self)                                                     \
+  {                                                                                                \
+    Name##_drop_index(self);                                                                       \
+    Name##_Keys_deinit(&self->keys);                                                               \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_destroy(Name *self)                                                    \
+  {                                                                                                \
+    if (self == NULL)                                                                              \
+      return;                                                                                      \
+    Name##_deinit(self);                                                                           \
+    RELEASE(AllocPrefix, self->keys.alloc_state, self, LAYOUT_OF(Name));                           \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_clear(Name *self)                                                      \
+  {                                                                                                \
+    Name##_drop_index(self);                                                                       \
+    Name##_Keys_clear(&self->keys);                                                                \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 用无序 (可重复) 的输入重建集合: 一次拷贝, 一次排序, 一次去重。 */                     \
+  static inline void Name##_build(Name *self, const K *items, usize count)                         \
+  {                                                                                                \
+    Name##_clear(self);                                                                            \
+    Name##_Keys_extend_from_slice(&self->keys, items, count);                                      \
+    K *data = self->keys.data;                                                                     \
+    Name##_ksort_sort(data, count);                                                                \
+    usize out = 0;                                                                                 \
+    for (usize i = 0; i < count; i++)                                                              \
+    {                                                                                              \
+      if (out == 0 || Name##_ksort_less(&data[out - 1], &data[i]))                                 \
+      {                                                                                            \
+        data[out++] = data[i];                                                                     \
+      }                                                                                            \
+    }                                                                                              \
+    self->keys.len = out;                                                                          \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 插入一个键 (O(n)); 已存在时返回 false。会丢弃索引。 */                                \
+  static inline bool Name##_insert(Name *self, K key)                                              \
+  {                                                                                                \
+    usize i = Name##_lower_bound_in(self->keys.data, self->keys.len, &key);                        \
+    if (i < self->keys.len && !Name##_ksort_less(&key, &self->keys.data[i]))                       \
+      return false;                                                                                \
+    Name##_drop_index(self);                                                                       \
+    Name##_Keys_insert_range(&self->keys, i, &key, 1);                                             \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 删除一个键 (O(n)); 不存在时返回 false。会丢弃索引。 */                                \
+  static inline bool Name##_remove(Name *self, const K *key)                                       \
+  {                                                                                                \
+    usize i = Name##_index_of(self, key);                                                          \
+    if (i == self->keys.len)                                                                       \
+      return false;                                                                                \
+    Name##_drop_index(self);                                                                       \
+    Name##_Keys_remove_range(&self->keys, i, i + 1);                                               \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief out = a ∪ b。a 中小于 b 当前元素的整段用 galloping 找到后一次拷贝。                    \
+   * @note out 不能是 a 或 b。                                                                     \
+   */                                                                                              \
+  static inline void Name##_union(Name *out, const Name *a, const Name *b)                         \
+  {                                                                                                \
+    asrt_msg(out != a && out != b, "union output must not alias an input");                        \
+    Name##_clear(out);                                                                             \
+    Name##_Keys_reserve_to(&out->keys, a->keys.len + b->keys.len);                                 \
+    const K *x = a->keys.data, *y = b->keys.data;                                                  \
+    usize i = 0, j = 0, m = a->keys.len, l = b->keys.len;                                          \
+    while (i < m && j < l)                                                                         \
+    {                                                                                              \
+      Ordering ord = FN_CMP(&x[i], &y[j]);                                                         \
+      if (ord == LESS)                                                                             \
+      {                                                                                            \
+        usize run = Name##_gallop_in(x + i, m - i, &y[j]);                                         \
+        Name##_Keys_extend_from_slice(&out->keys, x + i, run);                                     \
+        i += run;                                                                                  \
+      }                                                                                            \
+      else if (ord == GREATER)                                                                     \
+      {                                                                                            \
+        usize run = Name##_gallop_in(y + j, l - j, &x[i]);                                         \
+        Name##_Keys_extend_from_slice(&out->keys, y + j, run);                                     \
+        j += run;                                                                                  \
+      }                                                                                            \
+      else                                                                                         \
+      {                                                                                            \
+        Name##_Keys_push(&out->keys, x[i]);                                                        \
+        i++;                                                                                       \
+        j++;                                                                                       \
+      }                                                                                            \
+    }                                                                                              \
+    Name##_Keys_extend_from_slice(&out->keys, x + i, m - i);                                       \
+    Name##_Keys_extend_from_slice(&out->keys, y + j, l - j);                                       \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief out = a ∩ b。两边大小悬殊时, galloping 让代价接近 O(小 * log(大 / 小))。               \
+   * @note out 不能是 a 或 b。                                                                     \
+   */                                                                                              \
+  static inline void Name##_intersect(Name *out, const Name *a, const Name *b)                     \
+  {                                                                                                \
+    asrt_msg(out != a && out != b, "intersect output must not alias an input");                    \
+    Name##_clear(out);                                                                             \
+    const K *x = a->keys.data, *y = b->keys.data;                                                  \
+    usize i = 0, j = 0, m = a->keys.len, l = b->keys.len;                                          \
+    while (i < m && j < l)                                                                         \
+    {                                                                                              \
+      Ordering ord = FN_CMP(&x[i], &y[j]);                                                         \
+      if (ord == LESS)                                                                             \
+      {                                                                                            \
+        i += Name##_gallop_in(x + i, m - i, &y[j]);                                                \
+      }                                                                                            \
+      else if (ord == GREATER)                                                                     \
+      {                                                                                            \
+        j += Name##_gallop_in(y + j, l - j, &x[i]);                                                \
+      }                                                                                            \
+      else                                                                                         \
+      {                                                                                            \
+        Name##_Keys_push(&out->keys, x[i]);                                                        \
+        i++;                                                                                       \
+        j++;                                                                                       \
+      }                                                                                            \
+    }                                                                                              \
+  }
+
+/*
+ * ===================================================================
+ * 4. DEFINE_FLAT_MAP
+ * ===================================================================
+ */
+
+/**
+ * @brief (Template) 有序数组上的映射: 键和值分别存放在两个向量中,
+ * 查找只扫描紧凑的键数组。
+ *
+ * @param Name        生成的类型名
+ * @param K           键类型
+ * @param V           值类型
+ * @param FN_CMP      签名为 `Ordering (*)(const K *, const K *)` 的比较函数
+ * @param AllocType   分配器类型
+ * @param AllocPrefix 分配器前缀
+ */
+#define DEFINE_FLAT_MAP(Name, K, V, FN_CMP, AllocType, AllocPrefix)                                \
+                                                                                                   \
+  DEFINE_VECTOR(Name##_Keys, K, AllocType, AllocPrefix)                                            \
+  DEFINE_VECTOR(Name##_Values, V, AllocType, AllocPrefix)                                          \
+  DEFINE_SORT(Name##_ksort, K, FN_CMP)                                                             \
+                                                                                                   \
+  /* (内部) 构建时使用的键值对; seq 让相同的键中后出现的胜出 */                                    \
+  typedef struct Name##_Entry                                                                      \
+  {                                                                                                \
+    K key;                                                                                         \
+    V value;                                                                                       \
+    usize seq;                                                                                     \
+  } Name##_Entry;                                                                                  \
+                                                                                                   \
+  static inline Ordering Name##_entry_cmp(const Name##_Entry *a, const Name##_Entry *b)            \
+  {                                                                                                \
+    Ordering ord = FN_CMP(&a->key, &b->key);                                                       \
+    if (ord != EQUAL)                                                                              \
+      return ord;                                                                                  \
+    return a->seq < b->seq ? LESS : (a->seq > b->seq ? GREATER : EQUAL);                           \
+  }                                                                                                \
+                                                                                                   \
+  DEFINE_SORT(Name##_esort, Name##_Entry, Name##_entry_cmp)                                        \
+                                                                                                   \
+  typedef struct Name                                                                              \
+  {                                                                                                \
+    Name##_Keys keys;     /* 有序, 无重复 */                                                       \
+    Name##_Values values; /* values.data[i] 对应 keys.data[i] */                                   \
+    K *index;                                                                                      \
+    usize *rank;                                                                                   \
+    usize index_len;                                                                               \
+  } Name;                                                                                          \
+                                                                                                   \
+  static inline void Name##_init(Name *self, AllocType *alloc)                                     \
+  {                                                                                                \
+    Name##_Keys_init(&self->keys, alloc);                                                          \
+    Name##_Values_init(&self->values, alloc);                                                      \
+    self->index = NULL;                                                                            \
+    self->rank = NULL;                                                                             \
+    self->index_len = 0;                                                                           \
+  }                                                                                                \
+                                                                                                   \
+  static inline Name *Name##_new(AllocType *alloc)                                                 \
+  {                                                                                                \
+    Name *self = (Name *)ALLOC(AllocPrefix, alloc, LAYOUT_OF(Name));                               \
+    Name##_init(self, alloc);                                                                      \
+    return self;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  __FLAT_COMMON(Name, K, FN_CMP, AllocType, AllocPrefix)                                           \
+                                                                                                   \
+  static inline void Name##_deinit(Name *self)                                                     \
+  {                                                                                                \
+    Name##_drop_index(self);                                                                       \
+    Name##_Keys_deinit(&self->keys);                                                               \
+    Name##_Values_deinit(&self->values);                                                           \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_destroy(Name *self)                                                    \
+  {                                                                                                \
+    if (self == NULL)                                                                              \
+      return;                                                                                      \
+    Name##_deinit(self);                                                                           \
+    RELEASE(AllocPrefix, self->keys.alloc_state, self, LAYOUT_OF(Name));                           \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_clear(Name *self)                                                      \
+  {                                                                                                \
+    Name##_drop_index(self);                                                                       \
+    Name##_Keys_clear(&self->keys);                                                                \
+    Name##_Values_clear(&self->values);                                                            \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 用无序的键值对重建映射; 重复的键以最后出现的值为准。                                   \
+   */                                                                                              \
+  static inline void Name##_build(Name *self, const K *keys, const V *values, usize count)         \
+  {                                                                                                \
+    Name##_clear(self);                                                                            \
+    if (count == 0)                                                                                \
+      return;                                                                                      \
+    Layout layout = LAYOUT_OF_ARRAY(Name##_Entry, count);                                          \
+    Name##_Entry *entries =                                                                        \
+      (Name##_Entry *)ALLOC(AllocPrefix, self->keys.alloc_state, layout);                          \
+    for (usize i = 0; i < count; i++)                                                              \
+    {                                                                                              \
+      entries[i] = (Name##_Entry){.key = keys[i], .value = values[i], .seq = i};                   \
+    }                                                                                              \
+    Name##_esort_sort(entries, count);                                                             \
+                                                                                                   \
+    Name##_Keys_reserve_to(&self->keys, count);                                                    \
+    Name##_Values_reserve_to(&self->values, count);                                                \
+    for (usize i = 0; i < count; i++)                                                              \
+    {                                                                                              \
+      bool last_of_run =                                                                           \
+        i + 1 == count || Name##_ksort_less(&entries[i].key, &entries[i + 1].key);                 \
+      if (last_of_run)                                                                             \
+      {                                                                                            \
+        Name##_Keys_push(&self->keys, entries[i].key);                                             \
+        Name##_Values_push(&self->values, entries[i].value);                                       \
+      }                                                                                            \
+    }                                                                                              \
+    RELEASE(AllocPrefix, self->keys.alloc_state, entries, layout);                                 \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 取值的指针; 键不存在时返回 NULL。 */                                                  \
+  static inline V *Name##_get(Name *self, const K *key)                                            \
+  {                                                                                                \
+    usize i = Name##_index_of(self, key);                                                          \
+    return i == self->keys.len ? NULL : &self->values.data[i];                                     \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 插入或覆盖 (O(n))。                                                                    \
+   * @return 新插入时返回 true, 覆盖已有的值时返回 false (此时不丢弃索引)。                        \
+   */                                                                                              \
+  static inline bool Name##_insert(Name *self, K key, V value)                                     \
+  {                                                                                                \
+    usize i = Name##_lower_bound_in(self->keys.data, self->keys.len, &key);                        \
+    if (i < self->keys.len && !Name##_ksort_less(&key, &self->keys.data[i]))                       \
+    {                                                                                              \
+      self->values.data[i] = value;                                                                \
+      return false;                                                                                \
+    }                                                                                              \
+    Name##_drop_index(self);                                                                       \
+    Name##_Keys_insert_range(&self->keys, i, &key, 1);                                             \
+    Name##_Values_insert_range(&self->values, i, &value, 1);                                       \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 删除一个键 (O(n)); 不存在时返回 false。 */                                            \
+  static inline bool Name##_remove(Name *self, const K *key)                                       \
+  {                                                                                                \
+    usize i = Name##_index_of(self, key);                                                          \
+    if (i == self->keys.len)                                                                       \
+      return false;                                                                                \
+    Name##_drop_index(self);                                                                       \
+    Name##_Keys_remove_range(&self->keys, i, i + 1);                                               \
+    Name##_Values_remove_range(&self->values, i, i + 1);                                           \
+    return true;                                                                                   \
+  }
@@ -293,7 +293,7 @@ cmp_fn_str(const str *a, const str *b)
     }                                                                                              \
     /* 1. 释放 entries 数组 */                                                                     \
     /* <<< FIX: 使用 LAYOUT_OF_ARRAY 代替 layout_array */                                          \
-    Layout layout = LAYOUT_OF_ARRAY(sizeof(T_Name##_Entry), self->capacity);                       \
+    Layout layout = LAYOUT_OF_ARRAY(T_Name##_Entry, self->capacity);                               \
     (void)layout;                                                                                  \
     RELEASE(A_Prefix, self->allocer, self->entries, layout);                                       \
                                                                                                    \
@@ -344,7 +344,7 @@ cmp_fn_str(const str *a, const str *b)
     usize new_capacity = (old_capacity == 0) ? T_Name##_DEFAULT_CAPACITY : old_capacity * 2;       \
                                                                                                    \
     /* <<< FIX: 使用 LAYOUT_OF_ARRAY 代替 layout_array */                                          \
-    Layout new_layout = LAYOUT_OF_ARRAY(sizeof(T_Name##_Entry), new_capacity);                     \
+    Layout new_layout = LAYOUT_OF_ARRAY(T_Name##_Entry, new_capacity);                             \
     /* <<< FIX: 使用 ALLOC Trait 代替 _alloc */                                                    \
     T_Name##_Entry *new_entries = (T_Name##_Entry *)ALLOC(A_Prefix, self->allocer, new_layout);    \
     if (new_entries == NULL)                                                                       \
@@ -376,7 +376,7 @@ cmp_fn_str(const str *a, const str *b)
     }                                                                                              \
                                                                                                    \
     /* 释放旧表 (注意: 你的原代码这里是正确的!) */                                                 \
-    Layout old_layout = LAYOUT_OF_ARRAY(sizeof(T_Name##_Entry), old_capacity);                     \
+    Layout old_layout = LAYOUT_OF_ARRAY(T_Name##_Entry, old_capacity);                             \
     (void)old_layout;                                                                              \
     RELEASE(A_Prefix, self->allocer, old_entries, old_layout);                                     \
     return true;                                                                                   \
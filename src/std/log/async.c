@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/log/async.h>
+
+#include <core/fmt/tofd.h>  // FdSink, fd_writev_all
+#include <core/msg/panic.h> // panic_set_flush_hook
+#include <std/log/ring.h>   // LogRing, LogRingRegistry
+#include <stdatomic.h>
+#include <string.h>  // memcpy
+#include <threads.h> // thrd_t, mtx_t, cnd_t
+
+static_assert((ASYNC_LOG_RING_SIZE & (ASYNC_LOG_RING_SIZE - 1)) == 0,
+              "ASYNC_LOG_RING_SIZE must be a power of two");
+
+#define RING_MASK ((u64)ASYNC_LOG_RING_SIZE - 1)
+
+/* 一批 writev 最多覆盖的环数 (每个环最多两段) */
+#define BATCH_RINGS 32
+
+/* panic 钩子抢锁的最大尝试次数 */
+#define PANIC_LOCK_TRIES 1000
+
+/*
+ * ===================================================================
+ * 1. 全局状态
+ * ===================================================================
+ */
+
+/*
+ * 所有线程的环。消息直接按字节写入 data, 不需要记录头:
+ * 回绕处的两段正好对应 writev 的两个 iovec。
+ */
+static LogRingRegistry g_registry = LOG_RING_REGISTRY_INIT(ASYNC_LOG_RING_SIZE);
+
+static thread_local LogRing *t_ring = NULL;
+
+static once_flag g_once = ONCE_FLAG_INIT;
+static mtx_t g_drain_lock; /* 串行化所有写出 */
+static mtx_t g_wake_lock;  /* 配合 g_wake 使用 */
+static cnd_t g_wake;       /* 唤醒写线程 */
+
+/* 后台写线程 */
+static thrd_t g_writer;
+static _Atomic bool g_running = false;
+static _Atomic bool g_stop = false;
+static _Atomic int g_fd = STDERR_FILENO;
+static u32 g_latency_ms = 0;
+
+/*
+ * ===================================================================
+ * 2. 线程注册
+ * ===================================================================
+ */
+
+static void
+async_log_global_init(void)
+{
+  log_ring_registry_init(&g_registry);
+  mtx_init(&g_drain_lock, mtx_plain);
+  mtx_init(&g_wake_lock, mtx_plain);
+  cnd_init(&g_wake);
+}
+
+/* 取得 (或创建) 当前线程的环 (只在 async_log_start 之后调用) */
+static LogRing *
+thread_ring(void)
+{
+  if (t_ring == NULL)
+  {
+    t_ring = log_ring_acquire(&g_registry);
+  }
+  return t_ring;
+}
+
+/*
+ * ===================================================================
+ * 3. 消费者: 批量 writev
+ * ===================================================================
+ */
+
+/* 把一批环中已提交的字节用一次 writev 写出, 然后归还空间 */
+static bool
+write_batch(int fd, LogRing **rings, u64 *heads, int n)
+{
+  struct iovec iov[BATCH_RINGS * 2];
+  int count = 0;
+  for (int i = 0; i < n; i++)
+  {
+    u64 tail = atomic_load_explicit(&rings[i]->tail, memory_order_relaxed);
+    usize pos = (usize)(tail & RING_MASK);
+    usize len = (usize)(heads[i] - tail);
+    usize first = ASYNC_LOG_RING_SIZE - pos < len ? ASYNC_LOG_RING_SIZE - pos : len;
+    iov[count++] = (struct iovec){.iov_base = rings[i]->data + pos, .iov_len = first};
+    if (first < len)
+    {
+      iov[count++] = (struct iovec){.iov_base = rings[i]->data, .iov_len = len - first};
+    }
+  }
+
+  bool ok = fd_writev_all(fd, iov, count);
+
+  /* 写失败也归还空间, 否则生产者会一直冲刷同一批数据 */
+  for (int i = 0; i < n; i++)
+  {
+    atomic_store_explicit(&rings[i]->tail, heads[i], memory_order_release);
+  }
+  return ok;
+}
+
+/* 写出所有环 (调用者持有 g_drain_lock) */
+static bool
+drain_locked(void)
+{
+  int fd = atomic_load_explicit(&g_fd, memory_order_relaxed);
+  LogRing *rings[BATCH_RINGS];
+  u64 heads[BATCH_RINGS];
+  int n = 0;
+  bool ok = true;
+
+  for (LogRing *ring = log_ring_first(&g_registry); ring != NULL; ring = ring->next)
+  {
+    u64 head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (head == atomic_load_explicit(&ring->tail, memory_order_relaxed))
+    {
+      continue;
+    }
+    rings[n] = ring;
+    heads[n] = head;
+    if (++n == BATCH_RINGS)
+    {
+      ok &= write_batch(fd, rings, heads, n);
+      n = 0;
+    }
+  }
+  if (n != 0)
+  {
+    ok &= write_batch(fd, rings, heads, n);
+  }
+  return ok;
+}
+
+bool
+async_log_flush(void)
+{
+  call_once(&g_once, async_log_global_init);
+
+  mtx_lock(&g_drain_lock);
+  bool ok = drain_locked();
+  mtx_unlock(&g_drain_lock);
+  return ok;
+}
+
+/*
+ * panic 钩子: 锁可能正被 (panic 的) 当前线程持有,
+ * 所以只做有限次尝试, 拿不到锁就放弃, 绝不死锁。
+ */
+static void
+flush_before_panic(void)
+{
+  for (int i = 0; i < PANIC_LOCK_TRIES; i++)
+  {
+    if (mtx_trylock(&g_drain_lock) == thrd_success)
+    {
+      drain_locked();
+      mtx_unlock(&g_drain_lock);
+      return;
+    }
+    thrd_yield();
+  }
+}
+
+/*
+ * ===================================================================
+ * 4. 生产者
+ * ===================================================================
+ */
+
+/**
+ * @brief (内部) 直接写入环的 Sink; 空间不够时只记录溢出, 不写半条消息。
+ */
+typedef struct RingSink
+{
+  LogRing *ring;
+  u64 head;  /* 本条消息写到的位置 (尚未发布) */
+  u64 limit; /* tail + 环大小 */
+  bool overflow;
+} RingSink;
+
+static void
+ring_sink_push_bytes(void *sink, const char *bytes, usize len)
+{
+  RingSink *self = (RingSink *)sink;
+  if (self->overflow || len > self->limit - self->head)
+  {
+    self->overflow = true;
+    return;
+  }
+  usize pos = (usize)(self->head & RING_MASK);
+  usize first = ASYNC_LOG_RING_SIZE - pos < len ? ASYNC_LOG_RING_SIZE - pos : len;
+  memcpy(self->ring->data + pos, bytes, first);
+  memcpy(self->ring->data, bytes + first, len - first);
+  self->head += len;
+}
+
+static void
+ring_sink_push_char(void *sink, char c)
+{
+  ring_sink_push_bytes(sink, &c, 1);
+}
+
+/* 同步写出一条消息 (未启动时, 或消息比整个环还大时) */
+static bool
+write_direct(const FmtCompiled *compiled, const char *fmt, int count, const FmtArg *args)
+{
+  FdSink sink;
+  fd_sink_init(&sink, atomic_load_explicit(&g_fd, memory_order_relaxed));
+  vformat_args(
+    &sink, fd_sink_push_char_adapter, fd_sink_push_bytes_adapter, compiled, fmt, count, args);
+  return fd_sink_flush(&sink);
+}
+
+bool
+async_log_write_func(const FmtCompiled *compiled, const char *fmt, int count, ...)
+{
+  if (count > FMT_MAX_ARGS)
+  {
+    count = FMT_MAX_ARGS;
+  }
+
+  FmtArg args[FMT_MAX_ARGS];
+  va_list ap;
+  va_start(ap, count);
+  fmt_args_from_va(args, count, ap);
+  va_end(ap);
+
+  if (!atomic_load_explicit(&g_running, memory_order_acquire))
+  {
+    return write_direct(compiled, fmt, count, args);
+  }
+
+  LogRing *ring = thread_ring();
+  for (int attempt = 0; attempt < 2; attempt++)
+  {
+    u64 tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    RingSink sink = {
+      .ring = ring,
+      .head = atomic_load_explicit(&ring->head, memory_order_relaxed),
+      .limit = tail + ASYNC_LOG_RING_SIZE,
+      .overflow = false,
+    };
+    vformat_args(&sink, ring_sink_push_char, ring_sink_push_bytes, compiled, fmt, count, args);
+
+    if (!sink.overflow)
+    {
+      /* 发布: 写线程看到新的 head 时, 消息内容一定已经可见 */
+      atomic_store_explicit(&ring->head, sink.head, memory_order_release);
+      if (sink.head - tail > ASYNC_LOG_RING_SIZE / 2)
+      {
+        /*
+         * 故意不持有 g_wake_lock: 写线程不在等待时 (例如正在写出), 这次唤醒会丢失,
+         * 但它的 cnd_timedwait 最多 g_latency_ms 后也会返回, 环真正写满时生产者
+         * 会自己写出 (见下方), 所以丢失唤醒只会推迟写出, 不会丢消息或卡住。
+         */
+        cnd_signal(&g_wake);
+      }
+      return true;
+    }
+
+    /* 放不下: 自己把所有缓冲区写出, 腾出空间后重试 */
+    async_log_flush();
+  }
+
+  /* 比整个环还大: 自己的环已经清空, 直接写出仍然保持线程内顺序 */
+  mtx_lock(&g_drain_lock);
+  bool ok = write_direct(compiled, fmt, count, args);
+  mtx_unlock(&g_drain_lock);
+  return ok;
+}
+
+/*
+ * ===================================================================
+ * 5. 后台写线程
+ * ===================================================================
+ */
+
+static int
+writer_main(void *arg)
+{
+  (void)arg;
+  while (!atomic_load_explicit(&g_stop, memory_order_acquire))
+  {
+    /* 等到下一个刷新周期, 或被写满一半的生产者提前唤醒 */
+    struct timespec deadline;
+    timespec_get(&deadline, TIME_UTC);
+    deadline.tv_sec += g_latency_ms / 1000;
+    deadline.tv_nsec += (long)(g_latency_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    mtx_lock(&g_wake_lock);
+    if (!atomic_load_explicit(&g_stop, memory_order_acquire))
+    {
+      cnd_timedwait(&g_wake, &g_wake_lock, &deadline);
+    }
+    mtx_unlock(&g_wake_lock);
+
+    async_log_flush();
+  }
+  return 0;
+}
+
+bool
+async_log_start(int fd, u32 flush_latency_ms)
+{
+  call_once(&g_once, async_log_global_init);
+
+  bool expected = false;
+  if (!atomic_compare_exchange_strong(&g_running, &expected, true))
+  {
+    return false;
+  }
+
+  atomic_store(&g_fd, fd);
+  g_latency_ms = flush_latency_ms == 0 ? 1 : flush_latency_ms;
+  atomic_store(&g_stop, false);
+  if (thrd_create(&g_writer, writer_main, NULL) != thrd_success)
+  {
+    atomic_store(&g_running, false);
+    return false;
+  }
+  panic_set_flush_hook(flush_before_panic);
+  return true;
+}
+
+void
+async_log_stop(void)
+{
+  if (!atomic_load(&g_running))
+  {
+    return;
+  }
+
+  mtx_lock(&g_wake_lock);
+  atomic_store_explicit(&g_stop, true, memory_order_release);
+  cnd_signal(&g_wake);
+  mtx_unlock(&g_wake_lock);
+  thrd_join(g_writer, NULL);
+
+  panic_set_flush_hook(NULL);
+  atomic_store(&g_running, false);
+  async_log_flush();
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Impl) 异步批量写出的日志 Sink。
+ *
+ * `format_to_file(stderr, ...)` 在多线程下会争抢 FILE 锁, 并且每次调用
+ * 都是一次系统调用。`format_to_async(fmt, ...)` 在调用线程中直接把消息
+ * 格式化进该线程私有的字节环形缓冲区 (无锁, 单生产者 / 单消费者),
+ * 后台写线程每隔 flush_latency_ms 毫秒把所有线程的缓冲区
+ * 用一次 (批量) writev 写出。
+ *
+ * - 同一线程的消息保持顺序, 不同线程之间不保证顺序。
+ * - 缓冲区写满时, 生产者自己冲刷所有缓冲区 (不丢消息)。
+ * - async_log_start 会注册 panic 钩子: panic 终止程序前先写出缓冲的消息。
+ * - 未启动 (或已停止) 时, 消息直接同步写入 fd (默认 stderr)。
+ *
+ * @example
+ * async_log_start(STDERR_FILENO, 5);
+ * format_to_async("[{}] handled {} bytes\n", name, n);
+ * async_log_stop();
+ */
+
+#include <core/fmt/vformat.h> // FmtCache, FmtCompiled
+#include <core/type.h>        // u32
+
+/** @brief 每个线程的环形缓冲区大小 (字节, 必须是 2 的幂)。 */
+#ifndef ASYNC_LOG_RING_SIZE
+#define ASYNC_LOG_RING_SIZE (64 * 1024)
+#endif
+
+/**
+ * @brief (内部) 把一条消息格式化进当前线程的缓冲区。
+ * @return 格式化 (或同步写出) 成功时返回 true。
+ */
+bool async_log_write_func(const FmtCompiled *compiled, const char *fmt, int count, ...);
+
+/**
+ * @brief (公共 API) 异步格式化输出, 用法与 format_to_file 相同 (不追加换行)。
+ * @return (bool) 消息已被接收时返回 true。
+ */
+#define format_to_async(fmt, ...)                                                                  \
+  ({                                                                                               \
+    const char *__fmt = (fmt);                                                                     \
+    async_log_write_func(FMT_CACHE_LOOKUP(fmt),                                                    \
+                         __fmt,                                                                    \
+                         ARGS_COUNT(__VA_ARGS__)                                                   \
+                           __VA_OPT__(, ) EXPAND_ALL(TYPE_INFO, __VA_ARGS__));                     \
+  })
+
+/**
+ * @brief 启动后台写线程, 之后的消息都写入 fd。
+ *
+ * @param flush_latency_ms 两次批量写出之间的最长间隔 (毫秒, 0 视为 1)。
+ *        某个线程的缓冲区超过一半时会提前唤醒写线程。
+ * @return 成功启动时返回 true; 已经在运行或创建线程失败时返回 false。
+ */
+bool async_log_start(int fd, u32 flush_latency_ms);
+
+/**
+ * @brief 停止后台写线程, 并写出所有剩余的消息。
+ *
+ * @note 调用前应确保其他线程不再写日志。
+ */
+void async_log_stop(void);
+
+/**
+ * @brief 立即把所有线程的缓冲区写出 (在调用线程中完成)。
+ * @return 所有写入都成功时返回 true。
+ */
+bool async_log_flush(void);
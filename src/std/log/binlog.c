@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/log/binlog.h>
+
+#include <core/fmt/tofd.h> // FdSink
+#include <std/log/ring.h>   // LogRing, LogRingRegistry
+#include <stdatomic.h>
+#include <string.h>  // memcpy
+#include <threads.h> // thrd_t, mtx_t
+
+static_assert((BINLOG_RING_SIZE & (BINLOG_RING_SIZE - 1)) == 0,
+              "BINLOG_RING_SIZE must be a power of two");
+
+#define RING_MASK ((u64)BINLOG_RING_SIZE - 1)
+
+/* 记录头中 count 的特殊值: 这是一段填充, 消费者直接跳过 */
+#define RECORD_PAD UINT32_MAX
+
+/* 消费者侧格式串缓存的槽数 (必须是 2 的幂) */
+#define DRAIN_CACHE_SLOTS 64
+
+/*
+ * ===================================================================
+ * 1. 数据结构
+ * ===================================================================
+ */
+
+/**
+ * @brief (内部) 环形缓冲区中的一条记录。
+ *
+ * 布局: [头部][count 个类型字节, 补齐到 8 字节][值字...]。
+ * 每个参数占一个 u64 值字, 只有 vstr 占两个 (ptr, len)。
+ */
+typedef struct Record
+{
+  u32 size;  /* 整条记录的字节数 */
+  u32 count; /* 参数个数, RECORD_PAD 表示填充 */
+  const char *fmt;
+  u8 types[];
+} Record;
+
+/* 所有线程的环 */
+static LogRingRegistry g_registry = LOG_RING_REGISTRY_INIT(BINLOG_RING_SIZE);
+static _Atomic u64 g_dropped_total = 0;
+
+static thread_local LogRing *t_ring = NULL;
+
+static once_flag g_once = ONCE_FLAG_INIT;
+static mtx_t g_drain_lock; /* 串行化多个消费者 */
+
+/* 消费者侧的格式串缓存, 按 fmt 指针直接映射 (由 g_drain_lock 保护) */
+static FmtCompiled g_compiled[DRAIN_CACHE_SLOTS];
+
+/* 后台线程 */
+static thrd_t g_worker;
+static _Atomic bool g_running = false;
+static _Atomic bool g_stop = false;
+static int g_worker_fd = -1;
+static u32 g_worker_interval_ms = 0;
+
+/*
+ * ===================================================================
+ * 2. 线程注册
+ * ===================================================================
+ */
+
+static void
+binlog_global_init(void)
+{
+  log_ring_registry_init(&g_registry);
+  mtx_init(&g_drain_lock, mtx_plain);
+}
+
+/* 取得 (或创建) 当前线程的环 */
+static LogRing *
+thread_ring(void)
+{
+  if (t_ring == NULL)
+  {
+    call_once(&g_once, binlog_global_init);
+    t_ring = log_ring_acquire(&g_registry);
+  }
+  return t_ring;
+}
+
+/*
+ * ===================================================================
+ * 3. 生产者
+ * ===================================================================
+ */
+
+static inline usize
+align8(usize n)
+{
+  return (n + 7) & ~(usize)7;
+}
+
+void
+binlog_write_func(const char *fmt, int count, ...)
+{
+  LogRing *ring = thread_ring();
+
+  if (count > FMT_MAX_ARGS)
+  {
+    count = FMT_MAX_ARGS;
+  }
+
+  /* 按最坏情况 (全是 vstr) 申请空间, 写完后再按实际大小发布 */
+  usize max_size = sizeof(Record) + align8((usize)count) + (usize)count * 2 * sizeof(u64);
+
+  /* 申请空间: 放不下到缓冲区末尾时, 先写一段填充再回绕 */
+  u64 head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  u64 tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  usize pos = (usize)(head & RING_MASK);
+  usize to_end = BINLOG_RING_SIZE - pos;
+  usize pad = to_end < max_size ? to_end : 0;
+
+  if (max_size + pad > BINLOG_RING_SIZE - (usize)(head - tail))
+  {
+    atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_dropped_total, 1, memory_order_relaxed);
+    return;
+  }
+
+  if (pad != 0)
+  {
+    Record *filler = (Record *)(ring->data + pos);
+    filler->size = (u32)pad;
+    filler->count = RECORD_PAD;
+    head += pad;
+    pos = 0;
+  }
+
+  /* 写入记录: 只拷贝原始的参数字, 不解码 */
+  Record *rec = (Record *)(ring->data + pos);
+  rec->count = (u32)count;
+  rec->fmt = fmt;
+  u64 *words = (u64 *)(rec->types + align8((usize)count));
+  usize nwords = 0;
+
+  va_list ap;
+  va_start(ap, count);
+  for (int i = 0; i < count; i++)
+  {
+    int type = va_arg(ap, int);
+    rec->types[i] = (u8)type;
+    switch (type)
+    {
+    case TYPE_CHAR:
+    case TYPE_I8:
+    case TYPE_I16:
+    case TYPE_I32:
+      words[nwords++] = (u64)(i64)va_arg(ap, int);
+      break;
+    case TYPE_I64:
+      words[nwords++] = (u64)va_arg(ap, i64);
+      break;
+    case TYPE_U8:
+    case TYPE_U16:
+    case TYPE_U32:
+      words[nwords++] = va_arg(ap, unsigned int);
+      break;
+    case TYPE_U64:
+      words[nwords++] = va_arg(ap, u64);
+      break;
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+    {
+      f64 f = va_arg(ap, double);
+      memcpy(&words[nwords++], &f, sizeof(f));
+      break;
+    }
+    case TYPE_STR:
+    case TYPE_MUT_STR:
+    case TYPE_ANY:
+      words[nwords++] = (u64)(uintptr_t)va_arg(ap, const void *);
+      break;
+    case TYPE_VSTR:
+    {
+      vstr v = va_arg(ap, vstr);
+      words[nwords++] = (u64)(uintptr_t)v.ptr;
+      words[nwords++] = (u64)v.len;
+      break;
+    }
+    default:
+      /* 未知类型: 与 vformat 一样按指针大小跳过 */
+      (void)va_arg(ap, void *);
+      rec->types[i] = TYPE_NONE;
+      break;
+    }
+  }
+  va_end(ap);
+
+  usize size = (usize)((char *)(words + nwords) - (char *)rec);
+  rec->size = (u32)size;
+
+  /* 发布: 消费者看到新的 head 时, 记录内容一定已经可见 */
+  atomic_store_explicit(&ring->head, head + size, memory_order_release);
+}
+
+/*
+ * ===================================================================
+ * 4. 消费者
+ * ===================================================================
+ */
+
+/* 取得 fmt 的段表 (调用者持有 g_drain_lock); 编译失败时返回 NULL */
+static const FmtCompiled *
+drain_compiled(const char *fmt)
+{
+  /* fmt 都是字面量: 同一地址的内容不会变, 比较指针即可 */
+  FmtCompiled *slot = &g_compiled[((uintptr_t)fmt >> 3) & (DRAIN_CACHE_SLOTS - 1)];
+  if (slot->fmt == fmt)
+  {
+    return slot;
+  }
+  if (!fmt_compile(slot, fmt))
+  {
+    slot->fmt = NULL;
+    return NULL;
+  }
+  return slot;
+}
+
+/* 把一条记录的原始参数字还原成 FmtArg 数组 */
+static void
+decode_args(const Record *rec, FmtArg *args)
+{
+  const u64 *words = (const u64 *)(rec->types + align8(rec->count));
+  for (u32 i = 0; i < rec->count; i++)
+  {
+    FmtArg *arg = &args[i];
+    arg->type = rec->types[i];
+    switch (arg->type)
+    {
+    case TYPE_CHAR:
+      arg->as.c = (char)*words++;
+      break;
+    case TYPE_I8:
+    case TYPE_I16:
+    case TYPE_I32:
+    case TYPE_I64:
+      arg->as.i = (i64)*words++;
+      break;
+    case TYPE_U8:
+    case TYPE_U16:
+    case TYPE_U32:
+    case TYPE_U64:
+      arg->as.u = *words++;
+      break;
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+      memcpy(&arg->as.f, words++, sizeof(arg->as.f));
+      break;
+    case TYPE_STR:
+    case TYPE_MUT_STR:
+      arg->as.s = (const char *)(uintptr_t)*words++;
+      break;
+    case TYPE_ANY:
+      arg->as.p = (const void *)(uintptr_t)*words++;
+      break;
+    case TYPE_VSTR:
+      arg->as.v.ptr = (const char *)(uintptr_t)words[0];
+      arg->as.v.len = (usize)words[1];
+      words += 2;
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+/* 解码一个环中已提交的全部记录 (调用者持有 g_drain_lock) */
+static usize
+drain_ring(LogRing *ring, void *sink, sink_char_fn push_char, sink_bytes_fn push_bytes)
+{
+  usize n = 0;
+  u64 tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  u64 head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+  while (tail != head)
+  {
+    const Record *rec = (const Record *)(ring->data + (tail & RING_MASK));
+    if (rec->count != RECORD_PAD)
+    {
+      FmtArg args[FMT_MAX_ARGS];
+      decode_args(rec, args);
+      vformat_args(sink,
+                   push_char,
+                   push_bytes,
+                   drain_compiled(rec->fmt),
+                   rec->fmt,
+                   (int)rec->count,
+                   args);
+      push_bytes(sink, "\n", 1);
+      n++;
+    }
+    tail += rec->size;
+  }
+
+  /* 归还空间 */
+  atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+  u64 dropped = atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+  if (dropped != 0)
+  {
+    vformat_cached(sink, push_char, push_bytes, "[binlog] {} records dropped\n", dropped);
+  }
+  return n;
+}
+
+usize
+binlog_drain(void *sink, sink_char_fn push_char, sink_bytes_fn push_bytes)
+{
+  call_once(&g_once, binlog_global_init);
+
+  usize n = 0;
+  mtx_lock(&g_drain_lock);
+  for (LogRing *ring = log_ring_first(&g_registry); ring != NULL; ring = ring->next)
+  {
+    n += drain_ring(ring, sink, push_char, push_bytes);
+  }
+  mtx_unlock(&g_drain_lock);
+  return n;
+}
+
+usize
+binlog_drain_to_fd(int fd)
+{
+  FdSink sink;
+  fd_sink_init(&sink, fd);
+  usize n = binlog_drain(&sink, fd_sink_push_char_adapter, fd_sink_push_bytes_adapter);
+  fd_sink_flush(&sink);
+  return n;
+}
+
+u64
+binlog_dropped(void)
+{
+  return atomic_load_explicit(&g_dropped_total, memory_order_relaxed);
+}
+
+/*
+ * ===================================================================
+ * 5. 后台线程
+ * ===================================================================
+ */
+
+static int
+worker_main(void *arg)
+{
+  (void)arg;
+  struct timespec interval = {
+    .tv_sec = g_worker_interval_ms / 1000,
+    .tv_nsec = (long)(g_worker_interval_ms % 1000) * 1000000L,
+  };
+
+  while (!atomic_load_explicit(&g_stop, memory_order_acquire))
+  {
+    if (binlog_drain_to_fd(g_worker_fd) == 0)
+    {
+      thrd_sleep(&interval, NULL);
+    }
+  }
+  return 0;
+}
+
+bool
+binlog_start(int fd, u32 flush_interval_ms)
+{
+  call_once(&g_once, binlog_global_init);
+
+  bool expected = false;
+  if (!atomic_compare_exchange_strong(&g_running, &expected, true))
+  {
+    return false;
+  }
+
+  g_worker_fd = fd;
+  g_worker_interval_ms = flush_interval_ms == 0 ? 1 : flush_interval_ms;
+  atomic_store(&g_stop, false);
+  if (thrd_create(&g_worker, worker_main, NULL) != thrd_success)
+  {
+    atomic_store(&g_running, false);
+    return false;
+  }
+  return true;
+}
+
+void
+binlog_stop(void)
+{
+  if (!atomic_load(&g_running))
+  {
+    return;
+  }
+  atomic_store_explicit(&g_stop, true, memory_order_release);
+  thrd_join(g_worker, NULL);
+  binlog_drain_to_fd(g_worker_fd);
+  atomic_store(&g_running, false);
+}
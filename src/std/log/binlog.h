@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Impl) 延迟格式化的二进制日志。
+ *
+ * `binlog(fmt, ...)` 在热路径上不做任何格式化, 也不查格式串缓存:
+ * 它只把格式串指针、每个参数的 TYPE_ID 和原始的 8 字节值
+ * 写进当前线程私有的无锁环形缓冲区 (单生产者 / 单消费者)。
+ *
+ * 解码 (包括编译格式串) 全部由消费者完成:
+ * - binlog_drain: 在任意线程中手动解码并输出到一个 Sink;
+ * - binlog_start: 启动后台线程, 定期解码并写入文件描述符。
+ *
+ * 环形缓冲区写满时, 新记录会被丢弃并计数, 生产者永远不会阻塞。
+ *
+ * @note fmt 必须是字符串字面量 (编译期检查)。
+ * @note 字符串参数 (str / vstr) 只记录指针, 不拷贝内容,
+ *       它们必须在解码之前保持有效 (例如字面量或静态字符串)。
+ * @note 只保证同一线程内的顺序, 不同线程的记录按线程分组输出。
+ */
+
+#include <core/fmt/vformat.h> // TYPE_INFO, sink_*_fn
+#include <core/type.h>        // usize, u64
+
+/** @brief 每个线程的环形缓冲区大小 (字节, 必须是 2 的幂)。 */
+#ifndef BINLOG_RING_SIZE
+#define BINLOG_RING_SIZE (64 * 1024)
+#endif
+
+/*
+ * ===================================================================
+ * 1. 生产者
+ * ===================================================================
+ */
+
+/**
+ * @brief (内部) 把一条记录写入当前线程的环形缓冲区。
+ *
+ * 第一次调用时为当前线程注册一个环形缓冲区。
+ */
+void binlog_write_func(const char *fmt, int count, ...);
+
+/**
+ * @brief (公共 API) 记录一条日志, 解码时会自动追加换行符。
+ *
+ * @example
+ * binlog("request {} took {} ms", req_id, elapsed);
+ */
+#define binlog(fmt, ...)                                                                           \
+  do                                                                                               \
+  {                                                                                                \
+    static_assert(__builtin_constant_p(fmt), "binlog: fmt must be a string literal");              \
+    binlog_write_func((fmt),                                                                       \
+                      ARGS_COUNT(__VA_ARGS__) __VA_OPT__(, ) EXPAND_ALL(TYPE_INFO, __VA_ARGS__));  \
+  } while (0)
+
+/*
+ * ===================================================================
+ * 2. 消费者
+ * ===================================================================
+ */
+
+/**
+ * @brief 解码所有线程中已提交的记录, 逐条格式化到 sink。
+ *
+ * 如果有记录因缓冲区写满而被丢弃, 会额外输出一行提示。
+ * 可以与生产者并发调用; 多个消费者之间由内部锁串行化。
+ *
+ * @return 输出的记录条数。
+ */
+usize binlog_drain(void *sink, sink_char_fn push_char, sink_bytes_fn push_bytes);
+
+/**
+ * @brief 把所有已提交的记录解码并写入文件描述符。
+ * @return 输出的记录条数。
+ */
+usize binlog_drain_to_fd(int fd);
+
+/**
+ * @brief 启动后台解码线程。
+ *
+ * 后台线程每隔 flush_interval_ms 毫秒 (有数据时立即继续) 解码一次并写入 fd。
+ * @return 成功启动时返回 true; 已经在运行或创建线程失败时返回 false。
+ */
+bool binlog_start(int fd, u32 flush_interval_ms);
+
+/**
+ * @brief 停止后台线程, 并把剩余的记录全部写出。
+ */
+void binlog_stop(void);
+
+/**
+ * @brief 到目前为止因缓冲区写满而被丢弃的记录总数。
+ */
+u64 binlog_dropped(void);
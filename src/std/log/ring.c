@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/log/ring.h>
+
+#include <core/mem/allocer.h> // ALLOC
+#include <core/mem/layout.h>  // layout_from_size_align
+#include <core/mem/sysalc.h>  // SystemAlloc
+
+/* 环的后备分配器 (SYSTEM_ALLOC 不读取实例本身) */
+[[maybe_unused]] static SystemAlloc g_sys;
+
+static void
+ring_release(void *ring)
+{
+  atomic_store_explicit(&((LogRing *)ring)->in_use, false, memory_order_release);
+}
+
+void
+log_ring_registry_init(LogRingRegistry *reg)
+{
+  tss_create(&reg->key, ring_release);
+}
+
+LogRing *
+log_ring_acquire(LogRingRegistry *reg)
+{
+  /* 先尝试复用已退出线程留下的环 */
+  LogRing *ring = log_ring_first(reg);
+  for (; ring != NULL; ring = ring->next)
+  {
+    bool expected = false;
+    if (atomic_compare_exchange_strong_explicit(
+          &ring->in_use, &expected, true, memory_order_acquire, memory_order_relaxed))
+    {
+      break;
+    }
+  }
+
+  if (ring == NULL)
+  {
+    Layout layout = layout_from_size_align(sizeof(LogRing) + reg->data_size, alignof(LogRing));
+    ring = (LogRing *)ALLOC(SYSTEM, &g_sys, layout);
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->dropped, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->in_use, true);
+
+    LogRing *old = atomic_load_explicit(&reg->rings, memory_order_relaxed);
+    do
+    {
+      ring->next = old;
+    } while (!atomic_compare_exchange_weak_explicit(
+      &reg->rings, &old, ring, memory_order_release, memory_order_relaxed));
+  }
+
+  tss_set(reg->key, ring);
+  return ring;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (内部) 日志模块共用的每线程环形缓冲区注册表。
+ *
+ * binlog 和 async 都给每个写日志的线程分配一个私有的 SPSC 环:
+ * head 只由所属线程写, tail 只由消费者写。所有环挂在一个
+ * 只增不减的无锁单链表上, 消费者沿着链表逐个读取。
+ * 线程退出时 (通过 tss 析构函数) 只释放环的所有权,
+ * 之后新线程会优先复用这些环, 因此环一旦创建就不再释放。
+ *
+ * 环的数据区 data 的含义 (记录还是原始字节) 由各模块自己决定。
+ */
+
+#include <core/type.h> // usize, u64
+#include <stdalign.h>  // alignas
+#include <stdatomic.h>
+#include <threads.h> // tss_t
+
+/**
+ * @brief (内部) 每个线程一个的 SPSC 环形缓冲区。
+ *
+ * head 和 tail 放在不同的缓存行, 数据区按缓存行对齐。
+ */
+typedef struct LogRing
+{
+  alignas(64) _Atomic u64 head; /* 只由所属线程写 */
+  _Atomic u64 dropped;          /* 自上次消费以来丢弃的记录数 (不丢记录的模块不使用) */
+
+  alignas(64) _Atomic u64 tail; /* 只由消费者写 */
+
+  alignas(64) struct LogRing *next; /* 注册表链表 (只增不减) */
+  _Atomic bool in_use;              /* 是否有线程正在使用 */
+
+  alignas(64) char data[]; /* data_size 字节 */
+} LogRing;
+
+/**
+ * @brief (内部) 一组同样大小的环。每个日志模块有一个静态实例。
+ */
+typedef struct LogRingRegistry
+{
+  _Atomic(LogRing *) rings;
+  usize data_size; /* 每个环的数据区大小 (字节) */
+  tss_t key;       /* 线程退出时释放环的所有权 */
+} LogRingRegistry;
+
+/** @brief 静态初始化一个注册表, size 为每个环的数据区大小。 */
+#define LOG_RING_REGISTRY_INIT(size) {.rings = NULL, .data_size = (size)}
+
+/**
+ * @brief 创建注册表的 tss 键。
+ *
+ * @note 只能调用一次, 且必须在第一次 log_ring_acquire 之前
+ *       (各模块在自己的 call_once 初始化函数中调用)。
+ */
+void log_ring_registry_init(LogRingRegistry *reg);
+
+/**
+ * @brief 为当前线程取得一个环: 优先复用已退出线程留下的环, 否则新建一个。
+ *
+ * 调用者应把结果缓存在自己的 thread_local 变量中,
+ * 同一线程重复调用会再取得一个环。
+ */
+LogRing *log_ring_acquire(LogRingRegistry *reg);
+
+/**
+ * @brief 链表中的第一个环, 用 ring->next 遍历其余的环。
+ */
+static inline LogRing *
+log_ring_first(LogRingRegistry *reg)
+{
+  return atomic_load_explicit(&reg->rings, memory_order_acquire);
+}
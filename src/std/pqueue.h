@@ -0,0 +1,508 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Template) d 叉堆优先队列。
+ *
+ * 堆存放在一个 DEFINE_VECTOR 中, 比较函数返回 LESS 的元素先出队 (最小堆)。
+ * 默认是 4 叉堆: 树高只有二叉堆的一半, 同一父节点的 4 个子节点相邻,
+ * 下沉时一次比较的几个候选通常落在同一条缓存行里。
+ *
+ * - `DEFINE_PRIORITY_QUEUE`: push / pop / peek, 以及 O(n) 的 `_heapify_from`;
+ * - `DEFINE_INDEXED_PRIORITY_QUEUE`: 元素带一个 usize id, 用位置表 (id -> 堆下标)
+ *   支持 `_decrease_key` / `_update` / `_remove`, 适用于 Dijkstra 这类算法。
+ *
+ * 两者都有 `_ARITY` 版本, 可以指定分叉数 (例如 2 得到二叉堆)。
+ *
+ * @example
+ * DEFINE_PRIORITY_QUEUE(Timers, Timer, cmp_deadline, SystemAlloc, SYSTEM)
+ * Timers_push(&q, t);
+ * while (Timers_pop(&q, &t)) { ... }
+ */
+
+/*
+ * ===================================================================
+ * 1. 依赖
+ * ===================================================================
+ */
+
+#include <core/math/ordering.h> // Ordering
+#include <core/mem/allocer.h>   // ALLOC, RELEASE
+#include <core/mem/layout.h>    // LAYOUT_OF
+#include <core/msg/asrt.h>      // asrt_msg
+#include <core/type.h>          // usize
+#include <std/vector.h>         // DEFINE_VECTOR
+
+/** @brief 默认分叉数。 */
+#define PQUEUE_ARITY 4
+
+/** @brief 位置表中 "不在队列里" 的标记。 */
+#define PQUEUE_ABSENT ((usize)-1)
+
+/*
+ * ===================================================================
+ * 2. DEFINE_PRIORITY_QUEUE
+ * ===================================================================
+ */
+
+/**
+ * @brief (Template) 分叉数为 D 的堆优先队列。
+ *
+ * @param Name        生成的类型名
+ * @param T           元素类型
+ * @param FN_CMP      签名为 `Ordering (*)(const T *, const T *)` 的比较函数
+ * @param D           分叉数 (>= 2)
+ * @param AllocType   分配器类型 (例如 SystemAlloc, Bump)
+ * @param AllocPrefix 分配器前缀 (例如 SYSTEM, BUMP)
+ */
+#define DEFINE_PRIORITY_QUEUE_ARITY(Name, T, FN_CMP, D, AllocType, AllocPrefix)                    \
+                                                                                                   \
+  DEFINE_VECTOR(Name##_Items, T, AllocType, AllocPrefix)                                           \
+                                                                                                   \
+  typedef struct Name                                                                              \
+  {                                                                                                \
+    Name##_Items items; /* 堆序: items[i] 不排在父节点 items[(i - 1) / D] 之前 */                  \
+  } Name;                                                                                          \
+                                                                                                   \
+  static inline bool Name##_before(const T *a, const T *b)                                         \
+  {                                                                                                \
+    return FN_CMP(a, b) == LESS;                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 生命周期 --- */                                                                           \
+                                                                                                   \
+  static inline void Name##_init(Name *self, AllocType *alloc)                                     \
+  {                                                                                                \
+    Name##_Items_init(&self->items, alloc);                                                        \
+  }                                                                                                \
+                                                                                                   \
+  static inline Name *Name##_new(AllocType *alloc)                                                 \
+  {                                                                                                \
+    Name *self = (Name *)ALLOC(AllocPrefix, alloc, LAYOUT_OF(Name));                               \
+    Name##_init(self, alloc);                                                                      \
+    return self;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_deinit(Name *self)                                                     \
+  {                                                                                                \
+    Name##_Items_deinit(&self->items);                                                             \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_destroy(Name *self)                                                    \
+  {                                                                                                \
+    if (self == NULL)                                                                              \
+      return;                                                                                      \
+    Name##_deinit(self);                                                                           \
+    RELEASE(AllocPrefix, self->items.alloc_state, self, LAYOUT_OF(Name));                          \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize Name##_len(const Name *self)                                                 \
+  {                                                                                                \
+    return self->items.len;                                                                        \
+  }                                                                                                \
+                                                                                                   \
+  static inline bool Name##_is_empty(const Name *self)                                             \
+  {                                                                                                \
+    return self->items.len == 0;                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_clear(Name *self)                                                      \
+  {                                                                                                \
+    Name##_Items_clear(&self->items);                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /* --- (内部) 上浮 / 下沉: 先挖空位, 最后只写一次 --- */                                         \
+                                                                                                   \
+  static inline void Name##_sift_up(T *data, usize i)                                              \
+  {                                                                                                \
+    T value = data[i];                                                                             \
+    while (i > 0)                                                                                  \
+    {                                                                                              \
+      usize parent = (i - 1) / (D);                                                                \
+      if (!Name##_before(&value, &data[parent]))                                                   \
+        break;                                                                                     \
+      data[i] = data[parent];                                                                      \
+      i = parent;                                                                                  \
+    }                                                                                              \
+    data[i] = value;                                                                               \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_sift_down(T *data, usize len, usize i)                                 \
+  {                                                                                                \
+    T value = data[i];                                                                             \
+    for (;;)                                                                                       \
+    {                                                                                              \
+      usize first = (D) * i + 1;                                                                   \
+      if (first >= len)                                                                            \
+        break;                                                                                     \
+      usize end = len - first > (D) ? first + (D) : len;                                           \
+      usize best = first;                                                                          \
+      for (usize c = first + 1; c < end; c++)                                                      \
+      {                                                                                            \
+        best = Name##_before(&data[c], &data[best]) ? c : best;                                    \
+      }                                                                                            \
+      if (!Name##_before(&data[best], &value))                                                     \
+        break;                                                                                     \
+      data[i] = data[best];                                                                        \
+      i = best;                                                                                    \
+    }                                                                                              \
+    data[i] = value;                                                                               \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 操作 --- */                                                                               \
+                                                                                                   \
+  static inline void Name##_push(Name *self, T value)                                              \
+  {                                                                                                \
+    Name##_Items_push(&self->items, value);                                                        \
+    Name##_sift_up(self->items.data, self->items.len - 1);                                         \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 队首 (最先出队) 元素的指针; 队列为空时返回 NULL。 */                                  \
+  static inline const T *Name##_peek(const Name *self)                                             \
+  {                                                                                                \
+    return self->items.len == 0 ? NULL : &self->items.data[0];                                     \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 取出队首元素; 队列为空时返回 false。out 可为 NULL。 */                                \
+  static inline bool Name##_pop(Name *self, T *out)                                                \
+  {                                                                                                \
+    if (self->items.len == 0)                                                                      \
+      return false;                                                                                \
+    T *data = self->items.data;                                                                    \
+    if (out != NULL)                                                                               \
+    {                                                                                              \
+      *out = data[0];                                                                              \
+    }                                                                                              \
+    usize len = --self->items.len;                                                                 \
+    if (len > 0)                                                                                   \
+    {                                                                                              \
+      data[0] = data[len];                                                                         \
+      Name##_sift_down(data, len, 0);                                                              \
+    }                                                                                              \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 先 push 再 pop, 但只做一次下沉 (value 不晚于队首时直接返回 value)。 */                \
+  static inline T Name##_push_pop(Name *self, T value)                                             \
+  {                                                                                                \
+    if (self->items.len == 0 || !Name##_before(&self->items.data[0], &value))                      \
+      return value;                                                                                \
+    T top = self->items.data[0];                                                                   \
+    self->items.data[0] = value;                                                                   \
+    Name##_sift_down(self->items.data, self->items.len, 0);                                        \
+    return top;                                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 在原地把 items 重新整理成堆: 自底向上下沉, O(n)。 */                                  \
+  static inline void Name##_heapify(Name *self)                                                    \
+  {                                                                                                \
+    usize len = self->items.len;                                                                   \
+    if (len < 2)                                                                                   \
+      return;                                                                                      \
+    for (usize i = (len - 2) / (D) + 1; i-- > 0;)                                                  \
+    {                                                                                              \
+      Name##_sift_down(self->items.data, len, i);                                                  \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 用 items[0, count) 替换队列内容: 一次拷贝 + O(n) 建堆。 */                            \
+  static inline void Name##_heapify_from(Name *self, const T *items, usize count)                  \
+  {                                                                                                \
+    Name##_Items_clear(&self->items);                                                              \
+    Name##_Items_extend_from_slice(&self->items, items, count);                                    \
+    Name##_heapify(self);                                                                          \
+  }
+
+/** @brief (Template) 4 叉堆优先队列, 参数见 DEFINE_PRIORITY_QUEUE_ARITY。 */
+#define DEFINE_PRIORITY_QUEUE(Name, T, FN_CMP, AllocType, AllocPrefix)                             \
+  DEFINE_PRIORITY_QUEUE_ARITY(Name, T, FN_CMP, PQUEUE_ARITY, AllocType, AllocPrefix)
+
+/*
+ * ===================================================================
+ * 3. DEFINE_INDEXED_PRIORITY_QUEUE
+ * ===================================================================
+ */
+
+/**
+ * @brief (Template) 带位置表的 d 叉堆: 每个元素有一个 usize id, 同一 id 至多出现一次。
+ *
+ * 堆中直接存 {优先级, id}, 比较时不需要间接访问; 位置表 pos[id] 记录堆下标,
+ * 随 id 的最大值增长 (id 应当是稠密的, 例如图的节点编号)。
+ *
+ * @param Name        生成的类型名
+ * @param T           优先级类型
+ * @param FN_CMP      签名为 `Ordering (*)(const T *, const T *)` 的比较函数
+ * @param D           分叉数 (>= 2)
+ * @param AllocType   分配器类型
+ * @param AllocPrefix 分配器前缀
+ */
+#define DEFINE_INDEXED_PRIORITY_QUEUE_ARITY(Name, T, FN_CMP, D, AllocType, AllocPrefix)            \
+                                                                                                   \
+  typedef struct Name##_Entry                                                                      \
+  {                                                                                                \
+    T prio;                                                                                        \
+    usize id;                                                                                      \
+  } Name##_Entry;                                                                                  \
+                                                                                                   \
+  DEFINE_VECTOR(Name##_Heap, Name##_Entry, AllocType, AllocPrefix)                                 \
+  DEFINE_VECTOR(Name##_Pos, usize, AllocType, AllocPrefix)                                         \
+                                                                                                   \
+  typedef struct Name                                                                              \
+  {                                                                                                \
+    Name##_Heap heap;                                                                              \
+    Name##_Pos pos; /* id -> 堆下标, 不在队列中为 PQUEUE_ABSENT */                                 \
+  } Name;                                                                                          \
+                                                                                                   \
+  static inline bool Name##_before(const T *a, const T *b)                                         \
+  {                                                                                                \
+    return FN_CMP(a, b) == LESS;                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 生命周期 --- */                                                                           \
+                                                                                                   \
+  static inline void Name##_init(Name *self, AllocType *alloc)                                     \
+  {                                                                                                \
+    Name##_Heap_init(&self->heap, alloc);                                                          \
+    Name##_Pos_init(&self->pos, alloc);                                                            \
+  }                                                                                                \
+                                                                                                   \
+  static inline Name *Name##_new(AllocType *alloc)                                                 \
+  {                                                                                                \
+    Name *self = (Name *)ALLOC(AllocPrefix, alloc, LAYOUT_OF(Name));                               \
+    Name##_init(self, alloc);                                                                      \
+    return self;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_deinit(Name *self)                                                     \
+  {                                                                                                \
+    Name##_Heap_deinit(&self->heap);                                                               \
+    Name##_Pos_deinit(&self->pos);                                                                 \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_destroy(Name *self)                                                    \
+  {                                                                                                \
+    if (self == NULL)                                                                              \
+      return;                                                                                      \
+    Name##_deinit(self);                                                                           \
+    RELEASE(AllocPrefix, self->heap.alloc_state, self, LAYOUT_OF(Name));                           \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize Name##_len(const Name *self)                                                 \
+  {                                                                                                \
+    return self->heap.len;                                                                         \
+  }                                                                                                \
+                                                                                                   \
+  static inline bool Name##_is_empty(const Name *self)                                             \
+  {                                                                                                \
+    return self->heap.len == 0;                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 清空队列; 只重置队列中元素的位置, 代价与 len 成正比。 */                              \
+  static inline void Name##_clear(Name *self)                                                      \
+  {                                                                                                \
+    for (usize i = 0; i < self->heap.len; i++)                                                     \
+    {                                                                                              \
+      self->pos.data[self->heap.data[i].id] = PQUEUE_ABSENT;                                       \
+    }                                                                                              \
+    Name##_Heap_clear(&self->heap);                                                                \
+  }                                                                                                \
+                                                                                                   \
+  static inline bool Name##_contains(const Name *self, usize id)                                   \
+  {                                                                                                \
+    return id < self->pos.len && self->pos.data[id] != PQUEUE_ABSENT;                              \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief id 当前的优先级; 不在队列中时返回 NULL。 */                                           \
+  static inline const T *Name##_get(const Name *self, usize id)                                    \
+  {                                                                                                \
+    if (!Name##_contains(self, id))                                                                \
+      return NULL;                                                                                 \
+    return &self->heap.data[self->pos.data[id]].prio;                                              \
+  }                                                                                                \
+                                                                                                   \
+  /* --- (内部) 上浮 / 下沉, 同时维护位置表 --- */                                                 \
+                                                                                                   \
+  static inline void Name##_sift_up(Name *self, usize i)                                           \
+  {                                                                                                \
+    Name##_Entry *data = self->heap.data;                                                          \
+    usize *pos = self->pos.data;                                                                   \
+    Name##_Entry entry = data[i];                                                                  \
+    while (i > 0)                                                                                  \
+    {                                                                                              \
+      usize parent = (i - 1) / (D);                                                                \
+      if (!Name##_before(&entry.prio, &data[parent].prio))                                         \
+        break;                                                                                     \
+      data[i] = data[parent];                                                                      \
+      pos[data[i].id] = i;                                                                         \
+      i = parent;                                                                                  \
+    }                                                                                              \
+    data[i] = entry;                                                                               \
+    pos[entry.id] = i;                                                                             \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_sift_down(Name *self, usize i)                                         \
+  {                                                                                                \
+    Name##_Entry *data = self->heap.data;                                                          \
+    usize *pos = self->pos.data;                                                                   \
+    usize len = self->heap.len;                                                                    \
+    Name##_Entry entry = data[i];                                                                  \
+    for (;;)                                                                                       \
+    {                                                                                              \
+      usize first = (D) * i + 1;                                                                   \
+      if (first >= len)                                                                            \
+        break;                                                                                     \
+      usize end = len - first > (D) ? first + (D) : len;                                           \
+      usize best = first;                                                                          \
+      for (usize c = first + 1; c < end; c++)                                                      \
+      {                                                                                            \
+        best = Name##_before(&data[c].prio, &data[best].prio) ? c : best;                          \
+      }                                                                                            \
+      if (!Name##_before(&data[best].prio, &entry.prio))                                           \
+        break;                                                                                     \
+      data[i] = data[best];                                                                        \
+      pos[data[i].id] = i;                                                                         \
+      i = best;                                                                                    \
+    }                                                                                              \
+    data[i] = entry;                                                                               \
+    pos[entry.id] = i;                                                                             \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 操作 --- */                                                                               \
+                                                                                                   \
+  /** @brief 插入 id; id 不能已在队列中。 */                                                       \
+  static inline void Name##_push(Name *self, usize id, T prio)                                     \
+  {                                                                                                \
+    asrt_msg(!Name##_contains(self, id), "priority queue already contains id {}", id);             \
+    if (id >= self->pos.len)                                                                       \
+    {                                                                                              \
+      Name##_Pos_resize_with(&self->pos, id + 1, PQUEUE_ABSENT);                                   \
+    }                                                                                              \
+    Name##_Heap_push(&self->heap, (Name##_Entry){.prio = prio, .id = id});                         \
+    Name##_sift_up(self, self->heap.len - 1);                                                      \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 把 id 的优先级提前为 prio; prio 不能排在当前优先级之后。 */                           \
+  static inline void Name##_decrease_key(Name *self, usize id, T prio)                             \
+  {                                                                                                \
+    asrt_msg(Name##_contains(self, id), "priority queue does not contain id {}", id);              \
+    usize i = self->pos.data[id];                                                                  \
+    asrt_msg(!Name##_before(&self->heap.data[i].prio, &prio),                                      \
+             "decrease_key would move id {} later",                                                \
+             id);                                                                                  \
+    self->heap.data[i].prio = prio;                                                                \
+    Name##_sift_up(self, i);                                                                       \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 把 id 的优先级改为 prio (任意方向)。 */                                               \
+  static inline void Name##_update(Name *self, usize id, T prio)                                   \
+  {                                                                                                \
+    asrt_msg(Name##_contains(self, id), "priority queue does not contain id {}", id);              \
+    usize i = self->pos.data[id];                                                                  \
+    bool earlier = Name##_before(&prio, &self->heap.data[i].prio);                                 \
+    self->heap.data[i].prio = prio;                                                                \
+    if (earlier)                                                                                   \
+      Name##_sift_up(self, i);                                                                     \
+    else                                                                                           \
+      Name##_sift_down(self, i);                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief "松弛": id 不在队列中时插入; 在队列中且 prio 更早时提前。                              \
+   * @return 队列是否发生了变化。                                                                  \
+   */                                                                                              \
+  static inline bool Name##_push_or_decrease(Name *self, usize id, T prio)                         \
+  {                                                                                                \
+    if (!Name##_contains(self, id))                                                                \
+    {                                                                                              \
+      Name##_push(self, id, prio);                                                                 \
+      return true;                                                                                 \
+    }                                                                                              \
+    usize i = self->pos.data[id];                                                                  \
+    if (!Name##_before(&prio, &self->heap.data[i].prio))                                           \
+      return false;                                                                                \
+    self->heap.data[i].prio = prio;                                                                \
+    Name##_sift_up(self, i);                                                                       \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 队首的优先级 (id 写入 *id, 可为 NULL); 队列为空时返回 NULL。 */                       \
+  static inline const T *Name##_peek(const Name *self, usize *id)                                  \
+  {                                                                                                \
+    if (self->heap.len == 0)                                                                       \
+      return NULL;                                                                                 \
+    if (id != NULL)                                                                                \
+    {                                                                                              \
+      *id = self->heap.data[0].id;                                                                 \
+    }                                                                                              \
+    return &self->heap.data[0].prio;                                                               \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief (内部) 删除堆下标 i 处的元素。 */                                                     \
+  static inline void Name##_remove_at(Name *self, usize i)                                         \
+  {                                                                                                \
+    Name##_Entry *data = self->heap.data;                                                          \
+    self->pos.data[data[i].id] = PQUEUE_ABSENT;                                                    \
+    usize last = --self->heap.len;                                                                 \
+    if (i == last)                                                                                 \
+      return;                                                                                      \
+    bool earlier = Name##_before(&data[last].prio, &data[i].prio);                                 \
+    data[i] = data[last];                                                                          \
+    if (earlier)                                                                                   \
+      Name##_sift_up(self, i);                                                                     \
+    else                                                                                           \
+      Name##_sift_down(self, i);                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 取出队首; 队列为空时返回 false。id / prio 可为 NULL。 */                              \
+  static inline bool Name##_pop(Name *self, usize *id, T *prio)                                    \
+  {                                                                                                \
+    if (self->heap.len == 0)                                                                       \
+      return false;                                                                                \
+    if (id != NULL)                                                                                \
+    {                                                                                              \
+      *id = self->heap.data[0].id;                                                                 \
+    }                                                                                              \
+    if (prio != NULL)                                                                              \
+    {                                                                                              \
+      *prio = self->heap.data[0].prio;                                                             \
+    }                                                                                              \
+    Name##_remove_at(self, 0);                                                                     \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 删除 id; 不在队列中时返回 false。prio 可为 NULL。 */                                  \
+  static inline bool Name##_remove(Name *self, usize id, T *prio)                                  \
+  {                                                                                                \
+    if (!Name##_contains(self, id))                                                                \
+      return false;                                                                                \
+    usize i = self->pos.data[id];                                                                  \
+    if (prio != NULL)                                                                              \
+    {                                                                                              \
+      *prio = self->heap.data[i].prio;                                                             \
+    }                                                                                              \
+    Name##_remove_at(self, i);                                                                     \
+    return true;                                                                                   \
+  }
+
+/** @brief (Template) 4 叉索引堆, 参数见 DEFINE_INDEXED_PRIORITY_QUEUE_ARITY。 */
+#define DEFINE_INDEXED_PRIORITY_QUEUE(Name, T, FN_CMP, AllocType, AllocPrefix)                     \
+  DEFINE_INDEXED_PRIORITY_QUEUE_ARITY(Name, T, FN_CMP, PQUEUE_ARITY, AllocType, AllocPrefix)
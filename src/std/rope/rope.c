@@ -0,0 +1,509 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/rope/rope.h>
+
+#include <core/mem/allocer.h> // ALLOC
+#include <core/mem/layout.h>  // LAYOUT_OF
+#include <core/msg/asrt.h>    // asrt, asrt_msg
+#include <errno.h>            // EINTR
+#include <string.h>           // memcpy
+#include <sys/uio.h>          // writev, struct iovec
+
+/* 一次 writev 调用最多提交的切片数量 */
+#define ROPE_IOV_BATCH 64
+
+/*
+ * ===================================================================
+ * 1. 节点构造 (Internal)
+ * ===================================================================
+ */
+
+static inline u32
+node_height(const RopeNode *n)
+{
+  return n ? n->height : 0;
+}
+
+static inline usize
+node_len(const RopeNode *n)
+{
+  return n ? n->len : 0;
+}
+
+static RopeNode *
+new_leaf(Bump *arena, const char *data, usize len)
+{
+  RopeNode *n = ALLOC(BUMP, arena, LAYOUT_OF(RopeNode));
+  n->left = NULL;
+  n->right = NULL;
+  n->data = data;
+  n->len = len;
+  n->height = 1;
+  return n;
+}
+
+static RopeNode *
+new_concat(Bump *arena, RopeNode *l, RopeNode *r)
+{
+  RopeNode *n = ALLOC(BUMP, arena, LAYOUT_OF(RopeNode));
+  u32 hl = node_height(l);
+  u32 hr = node_height(r);
+  n->left = l;
+  n->right = r;
+  n->data = NULL;
+  n->len = l->len + r->len;
+  n->height = (hl > hr ? hl : hr) + 1;
+  return n;
+}
+
+/*
+ * ===================================================================
+ * 2. AVL 平衡 (Internal)
+ * ===================================================================
+ *
+ * 节点不可变, 旋转总是生成新节点, 旧子树保持原样 (可被共享)。
+ */
+
+static RopeNode *
+rotate_right(Bump *arena, RopeNode *n)
+{
+  RopeNode *l = n->left;
+  return new_concat(arena, l->left, new_concat(arena, l->right, n->right));
+}
+
+static RopeNode *
+rotate_left(Bump *arena, RopeNode *n)
+{
+  RopeNode *r = n->right;
+  return new_concat(arena, new_concat(arena, n->left, r->left), r->right);
+}
+
+/**
+ * @brief 用 l 和 r 构造内部节点, 并在高度差为 2 时做单/双旋转。
+ */
+static RopeNode *
+make_balanced(Bump *arena, RopeNode *l, RopeNode *r)
+{
+  u32 hl = node_height(l);
+  u32 hr = node_height(r);
+
+  if (hl > hr + 1)
+  {
+    if (node_height(l->left) < node_height(l->right))
+    {
+      l = rotate_left(arena, l);
+    }
+    return rotate_right(arena, new_concat(arena, l, r));
+  }
+  if (hr > hl + 1)
+  {
+    if (node_height(r->right) < node_height(r->left))
+    {
+      r = rotate_right(arena, r);
+    }
+    return rotate_left(arena, new_concat(arena, l, r));
+  }
+  return new_concat(arena, l, r);
+}
+
+/**
+ * @brief 拼接两棵 AVL 树, 耗时 O(|h(l) - h(r)|)。
+ */
+static RopeNode *
+join(Bump *arena, RopeNode *l, RopeNode *r)
+{
+  if (l == NULL)
+  {
+    return r;
+  }
+  if (r == NULL)
+  {
+    return l;
+  }
+
+  if (l->height > r->height + 1)
+  {
+    return make_balanced(arena, l->left, join(arena, l->right, r));
+  }
+  if (r->height > l->height + 1)
+  {
+    return make_balanced(arena, join(arena, l, r->left), r->right);
+  }
+  return new_concat(arena, l, r);
+}
+
+/**
+ * @brief 把树 n 在位置 i 处拆成 [0, i) 和 [i, len) 两棵树。
+ */
+static void
+split(Bump *arena, RopeNode *n, usize i, RopeNode **out_l, RopeNode **out_r)
+{
+  if (n == NULL || i == 0)
+  {
+    *out_l = NULL;
+    *out_r = n;
+    return;
+  }
+  if (i >= n->len)
+  {
+    *out_l = n;
+    *out_r = NULL;
+    return;
+  }
+
+  if (n->left == NULL)
+  {
+    /* 叶子: 两半仍然指向同一段字节 */
+    *out_l = new_leaf(arena, n->data, i);
+    *out_r = new_leaf(arena, n->data + i, n->len - i);
+    return;
+  }
+
+  RopeNode *a;
+  RopeNode *b;
+  if (i <= n->left->len)
+  {
+    split(arena, n->left, i, &a, &b);
+    *out_l = a;
+    *out_r = join(arena, b, n->right);
+  }
+  else
+  {
+    split(arena, n->right, i - n->left->len, &a, &b);
+    *out_l = join(arena, n->left, a);
+    *out_r = b;
+  }
+}
+
+/*
+ * ===================================================================
+ * 3. 尾部缓冲区 (Internal)
+ * ===================================================================
+ */
+
+/**
+ * @brief 把尾部缓冲区中尚未提交的文本作为叶子挂到树上。
+ *
+ * 缓冲区剩余的空间继续用于后续追加, 已提交的叶子只是它前半部分的视图。
+ */
+static void
+flush_tail(Rope *self)
+{
+  if (self->tail_len == 0)
+  {
+    return;
+  }
+  RopeNode *leaf = new_leaf(self->arena, self->tail, self->tail_len);
+  self->root = join(self->arena, self->root, leaf);
+  self->tail += self->tail_len;
+  self->tail_cap -= self->tail_len;
+  self->tail_len = 0;
+}
+
+/*
+ * ===================================================================
+ * 4. 公共 API 实现
+ * ===================================================================
+ */
+
+void
+rope_init(Rope *self, Bump *arena)
+{
+  asrt_msg(self != NULL && arena != NULL, "rope_init: NULL argument");
+  self->root = NULL;
+  self->tail = NULL;
+  self->tail_len = 0;
+  self->tail_cap = 0;
+  self->arena = arena;
+}
+
+usize
+rope_len(const Rope *self)
+{
+  return node_len(self->root) + self->tail_len;
+}
+
+char
+rope_char_at(const Rope *self, usize index)
+{
+  asrt_msg(index < rope_len(self), "rope_char_at: index out of bounds");
+
+  usize root_len = node_len(self->root);
+  if (index >= root_len)
+  {
+    return self->tail[index - root_len];
+  }
+
+  const RopeNode *n = self->root;
+  while (n->left != NULL)
+  {
+    if (index < n->left->len)
+    {
+      n = n->left;
+    }
+    else
+    {
+      index -= n->left->len;
+      n = n->right;
+    }
+  }
+  return n->data[index];
+}
+
+void
+rope_push_bytes(Rope *self, const char *bytes, usize len)
+{
+  if (len == 0)
+  {
+    return;
+  }
+
+  if (self->tail_len + len <= self->tail_cap)
+  {
+    memcpy(self->tail + self->tail_len, bytes, len);
+    self->tail_len += len;
+    return;
+  }
+
+  flush_tail(self);
+
+  if (len >= ROPE_CHUNK_SIZE)
+  {
+    /* 大块数据直接成为一个叶子 */
+    char *copy = ALLOC(BUMP, self->arena, layout_from_size_align(len, 1));
+    memcpy(copy, bytes, len);
+    self->root = join(self->arena, self->root, new_leaf(self->arena, copy, len));
+    return;
+  }
+
+  self->tail = ALLOC(BUMP, self->arena, layout_from_size_align(ROPE_CHUNK_SIZE, 1));
+  self->tail_cap = ROPE_CHUNK_SIZE;
+  memcpy(self->tail, bytes, len);
+  self->tail_len = len;
+}
+
+void
+rope_push_str(Rope *self, str s)
+{
+  rope_push_bytes(self, s, str_len(s));
+}
+
+void
+rope_push(Rope *self, char c)
+{
+  rope_push_bytes(self, &c, 1);
+}
+
+void
+rope_concat(Rope *self, Rope *other)
+{
+  flush_tail(self);
+  flush_tail(other);
+  self->root = join(self->arena, self->root, other->root);
+}
+
+void
+rope_insert(Rope *self, usize pos, const char *bytes, usize len)
+{
+  asrt_msg(pos <= rope_len(self), "rope_insert: position out of bounds");
+  if (len == 0)
+  {
+    return;
+  }
+  if (pos == rope_len(self))
+  {
+    rope_push_bytes(self, bytes, len);
+    return;
+  }
+
+  flush_tail(self);
+
+  char *copy = ALLOC(BUMP, self->arena, layout_from_size_align(len, 1));
+  memcpy(copy, bytes, len);
+
+  RopeNode *l;
+  RopeNode *r;
+  split(self->arena, self->root, pos, &l, &r);
+  l = join(self->arena, l, new_leaf(self->arena, copy, len));
+  self->root = join(self->arena, l, r);
+}
+
+void
+rope_remove(Rope *self, usize start, usize end)
+{
+  asrt_msg(start <= end && end <= rope_len(self), "rope_remove: invalid range");
+  if (start == end)
+  {
+    return;
+  }
+  flush_tail(self);
+
+  RopeNode *l;
+  RopeNode *mid_r;
+  RopeNode *mid;
+  RopeNode *r;
+  split(self->arena, self->root, start, &l, &mid_r);
+  split(self->arena, mid_r, end - start, &mid, &r);
+  self->root = join(self->arena, l, r);
+}
+
+Rope
+rope_substr(Rope *self, usize start, usize end)
+{
+  asrt_msg(start <= end && end <= rope_len(self), "rope_substr: invalid range");
+  flush_tail(self);
+
+  RopeNode *l;
+  RopeNode *mid_r;
+  RopeNode *mid;
+  RopeNode *r;
+  split(self->arena, self->root, start, &l, &mid_r);
+  split(self->arena, mid_r, end - start, &mid, &r);
+
+  Rope sub;
+  rope_init(&sub, self->arena);
+  sub.root = mid;
+  return sub;
+}
+
+/* --- 遍历 --- */
+
+/** (内部) 把 n 及其左脊压栈 */
+static void
+iter_push_left(RopeIter *it, RopeNode *n)
+{
+  while (n != NULL)
+  {
+    asrt_msg(it->depth < ROPE_MAX_DEPTH, "Rope is too deep to iterate");
+    it->stack[it->depth++] = n;
+    n = n->left;
+  }
+}
+
+RopeIter
+rope_iter(const Rope *self)
+{
+  RopeIter it;
+  it.depth = 0;
+  it.tail = (vstr){.ptr = self->tail, .len = self->tail_len};
+  iter_push_left(&it, self->root);
+  return it;
+}
+
+bool
+rope_iter_next(RopeIter *it, vstr *out)
+{
+  while (it->depth > 0)
+  {
+    RopeNode *n = it->stack[--it->depth];
+    if (n->left == NULL)
+    {
+      if (n->len == 0)
+      {
+        continue;
+      }
+      *out = (vstr){.ptr = n->data, .len = n->len};
+      return true;
+    }
+    /* 内部节点: 左子树已经在栈中被处理, 接下来处理右子树 */
+    iter_push_left(it, n->right);
+  }
+
+  if (it->tail.len > 0)
+  {
+    *out = it->tail;
+    it->tail.len = 0;
+    return true;
+  }
+  return false;
+}
+
+str
+rope_flatten(const Rope *self)
+{
+  usize len = rope_len(self);
+  char *buf = ALLOC(BUMP, self->arena, layout_from_size_align(len + 1, 1));
+  usize pos = 0;
+
+  for_rope_slices(piece, self)
+  {
+    memcpy(buf + pos, piece.ptr, piece.len);
+    pos += piece.len;
+  }
+  buf[pos] = '\0';
+  return buf;
+}
+
+/**
+ * @brief (内部) 写出 iov[0..count) 的全部内容, 处理部分写入和 EINTR。
+ */
+static bool
+write_all_iov(int fd, struct iovec *iov, int count)
+{
+  while (count > 0)
+  {
+    ssize_t written = writev(fd, iov, count);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+
+    usize remaining = (usize)written;
+    while (count > 0 && remaining >= iov->iov_len)
+    {
+      remaining -= iov->iov_len;
+      iov++;
+      count--;
+    }
+    if (count > 0)
+    {
+      iov->iov_base = (char *)iov->iov_base + remaining;
+      iov->iov_len -= remaining;
+    }
+  }
+  return true;
+}
+
+bool
+rope_write_fd(const Rope *self, int fd)
+{
+  struct iovec iov[ROPE_IOV_BATCH];
+  int count = 0;
+
+  for_rope_slices(piece, self)
+  {
+    iov[count].iov_base = (void *)piece.ptr;
+    iov[count].iov_len = piece.len;
+    count++;
+    if (count == ROPE_IOV_BATCH)
+    {
+      if (!write_all_iov(fd, iov, count))
+      {
+        return false;
+      }
+      count = 0;
+    }
+  }
+  return write_all_iov(fd, iov, count);
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Impl) Rope: 面向大文本增量构建的字符串。
+ *
+ * `sstring_push_str` 每次扩容都会复制整个缓冲区, 也无法在中间
+ * 插入。Rope 把文本存成一棵 AVL 平衡的拼接树:
+ * - 叶子: 指向 Arena 中一段字节的 (ptr, len) 视图
+ * - 内部节点: 左右子树的拼接, 缓存总长度和高度
+ *
+ * 所有节点都分配在 Bump (Arena) 中且不可变, 因此 concat,
+ * insert, remove 和 substr 都是 O(log n), 并且多个 Rope
+ * 可以安全地共享子树。
+ *
+ * 小块追加先写入一个 "尾部缓冲区" (tail), 写满 ROPE_CHUNK_SIZE
+ * 之后才作为叶子挂入树中, 所以逐字符追加也不会产生大量节点。
+ */
+
+#include <core/fmt/vformat.h> // sink_char_fn, sink_bytes_fn
+#include <core/type.h>        // usize, vstr
+#include <std/alloc/bump.h>   // Bump
+
+/*
+ * ===================================================================
+ * 1. 核心类型
+ * ===================================================================
+ */
+
+/** @brief 尾部缓冲区每次从 Arena 申请的大小 (字节)。 */
+#define ROPE_CHUNK_SIZE 4096
+
+/** @brief 迭代器栈的最大深度 (AVL 高度 <= 1.44 log2(n))。 */
+#define ROPE_MAX_DEPTH 96
+
+/**
+ * @brief (内部) 拼接树节点。
+ *
+ * left == NULL 表示叶子, 此时 data 有效。
+ */
+typedef struct RopeNode RopeNode;
+struct RopeNode
+{
+  RopeNode *left;
+  RopeNode *right;
+  const char *data;
+  usize len;
+  u32 height; /* 叶子为 1 */
+};
+
+/**
+ * @brief Rope 本身 (可以放在栈上)。
+ */
+typedef struct Rope
+{
+  RopeNode *root; /* 已提交的文本, 空 Rope 时为 NULL */
+  char *tail;     /* 尾部缓冲区中尚未提交的文本 */
+  usize tail_len;
+  usize tail_cap;
+  Bump *arena; /* 节点和文本字节都分配在这里 */
+} Rope;
+
+/**
+ * @brief 按顺序遍历 Rope 中每一段连续字节的迭代器。
+ */
+typedef struct RopeIter
+{
+  RopeNode *stack[ROPE_MAX_DEPTH];
+  usize depth;
+  vstr tail; /* 最后产出的尾部缓冲区 */
+} RopeIter;
+
+/*
+ * ===================================================================
+ * 2. 生命周期与查询
+ * ===================================================================
+ */
+
+/**
+ * @brief 初始化一个空 Rope。
+ * @param arena 用于分配节点和文本的 Arena。Rope 的生命周期不能超过它。
+ */
+void rope_init(Rope *self, Bump *arena);
+
+/** @brief Rope 的总字节数。 */
+usize rope_len(const Rope *self);
+
+/**
+ * @brief 返回位置 index 处的字节。
+ * @panic 如果 index 越界。
+ */
+char rope_char_at(const Rope *self, usize index);
+
+/*
+ * ===================================================================
+ * 3. 修改
+ * ===================================================================
+ */
+
+/** @brief 在末尾追加一段字节 (摊销 O(1))。 */
+void rope_push_bytes(Rope *self, const char *bytes, usize len);
+
+/** @brief 在末尾追加一个 C 字符串。 */
+void rope_push_str(Rope *self, str s);
+
+/** @brief 在末尾追加一个字节。 */
+void rope_push(Rope *self, char c);
+
+/**
+ * @brief 把 other 的内容拼接到 self 末尾 (O(log n))。
+ *
+ * other 本身保持不变, 两者共享子树。
+ * @note 两个 Rope 必须使用同一个 Arena (或 other 的 Arena 活得更久)。
+ */
+void rope_concat(Rope *self, Rope *other);
+
+/**
+ * @brief 在位置 pos 插入一段字节 (O(log n))。
+ * @panic 如果 pos > rope_len(self)。
+ */
+void rope_insert(Rope *self, usize pos, const char *bytes, usize len);
+
+/**
+ * @brief 删除区间 [start, end) 内的字节 (O(log n))。
+ * @panic 如果 start > end 或 end > rope_len(self)。
+ */
+void rope_remove(Rope *self, usize start, usize end);
+
+/**
+ * @brief 返回区间 [start, end) 的子串, 与 self 共享节点 (O(log n))。
+ * @panic 如果 start > end 或 end > rope_len(self)。
+ */
+Rope rope_substr(Rope *self, usize start, usize end);
+
+/*
+ * ===================================================================
+ * 4. 遍历与输出
+ * ===================================================================
+ */
+
+/** @brief 创建一个从头开始的切片迭代器。 */
+RopeIter rope_iter(const Rope *self);
+
+/**
+ * @brief 产出下一段连续字节。
+ * @return 还有数据时返回 true 并写入 *out, 遍历结束时返回 false。
+ */
+bool rope_iter_next(RopeIter *it, vstr *out);
+
+/**
+ * @brief 把整个 Rope 拍平成一个以 '\0' 结尾的字符串 (分配在 Arena 中)。
+ */
+str rope_flatten(const Rope *self);
+
+/**
+ * @brief 把 Rope 通过批量 writev 写入文件描述符。
+ * @return 全部写入时返回 true, 遇到写错误时返回 false。
+ */
+bool rope_write_fd(const Rope *self, int fd);
+
+/*
+ * ===================================================================
+ * 5. 格式化 Sink 适配器
+ * ===================================================================
+ */
+
+static inline void
+rope_push_char_adapter(void *sink, char c)
+{
+  rope_push((Rope *)sink, c);
+}
+static inline void
+rope_push_bytes_adapter(void *sink, const char *bytes, usize len)
+{
+  rope_push_bytes((Rope *)sink, bytes, len);
+}
+
+/**
+ * @brief 格式化内容并追加到 Rope 末尾。
+ *
+ * @example
+ * rope_format(&r, "fn {}();\n", name);
+ */
+#define rope_format(rope, fmt, ...)                                                                \
+  vformat_cached((void *)(rope),                                                                   \
+                 rope_push_char_adapter,                                                           \
+                 rope_push_bytes_adapter,                                                          \
+                 (fmt)__VA_OPT__(, ) __VA_ARGS__)
+
+/**
+ * @brief (宏) 遍历 Rope 中的每一段连续字节。
+ *
+ * @example
+ * for_rope_slices(piece, &r) {
+ * fwrite(piece.ptr, 1, piece.len, out);
+ * }
+ */
+#define for_rope_slices(var, rope_ptr)                                                             \
+  for (RopeIter __rope_it = rope_iter(rope_ptr); __rope_it.depth != (usize)-1;                     \
+       __rope_it.depth = (usize)-1)                                                                \
+    for (vstr var; rope_iter_next(&__rope_it, &var);)
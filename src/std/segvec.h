@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/*
+ * ===================================================================
+ * 1. 依赖 (全都是 Core)
+ * ===================================================================
+ */
+
+#include <core/mem/allocer.h> // L1 Trait (ALLOC, RELEASE)
+#include <core/mem/layout.h>  // L1 Layout
+#include <core/msg/asrt.h>    // L3 asrt_msg
+#include <core/type.h>        // L0 Types (usize, ...)
+
+/*
+ * ===================================================================
+ * 2. 分段布局 (与元素类型无关)
+ * ===================================================================
+ *
+ * `DEFINE_VECTOR` 扩容时 realloc 并搬动所有元素:
+ * 既不能持有指向元素的指针, 每次翻倍还要 O(n) 拷贝。
+ *
+ * 分段向量把元素放在一串容量翻倍的段里, 段一旦分配就不再移动:
+ *
+ *   段 k 的容量 = SEGVEC_FIRST << k
+ *   段 0..k-1 的总容量 = SEGVEC_FIRST * (2^k - 1)
+ *
+ * 因此下标 i 所在的段和段内偏移只需一次 clz:
+ *
+ *   j = i + SEGVEC_FIRST
+ *   k = floor(log2(j)) - SEGVEC_FIRST_SHIFT
+ *   offset = j - (SEGVEC_FIRST << k)
+ */
+
+/** @brief 第一个段的容量 (以 2 为底的对数)。 */
+#ifndef SEGVEC_FIRST_SHIFT
+#define SEGVEC_FIRST_SHIFT 3
+#endif
+
+/** @brief 第一个段的容量 (元素个数)。 */
+#define SEGVEC_FIRST ((usize)1 << SEGVEC_FIRST_SHIFT)
+
+/** @brief 段数上限: 足以覆盖整个 usize 下标空间。 */
+#define SEGVEC_MAX_SEGS (sizeof(usize) * 8 - SEGVEC_FIRST_SHIFT)
+
+/** @brief (内部) 下标 i 所在的段。 */
+static inline usize
+segvec_seg_of(usize i)
+{
+  usize j = i + SEGVEC_FIRST;
+  return (usize)(63 - __builtin_clzll((unsigned long long)j)) - SEGVEC_FIRST_SHIFT;
+}
+
+/** @brief (内部) 下标 i 在段 k 中的偏移。 */
+static inline usize
+segvec_offset_in(usize i, usize k)
+{
+  return i + SEGVEC_FIRST - (SEGVEC_FIRST << k);
+}
+
+/** @brief (内部) 段 k 的容量。 */
+static inline usize
+segvec_seg_cap(usize k)
+{
+  return SEGVEC_FIRST << k;
+}
+
+/** @brief (内部) 前 nseg 个段的总容量。 */
+static inline usize
+segvec_total_cap(usize nseg)
+{
+  return SEGVEC_FIRST * (((usize)1 << nseg) - 1);
+}
+
+/*
+ * ===================================================================
+ * 3. 核心模板：DEFINE_SEGVEC
+ * ===================================================================
+ *
+ * 生成一个元素地址稳定的分段向量:
+ * - `_push` 返回新元素的指针, 之后的增长不会使它失效;
+ * - 增长只分配新段, 从不拷贝已有元素 (可直接使用 Bump);
+ * - `_push` 只在段用完时才计算段号, 平时只是 *tail++ = x;
+ * - `_get` 是 O(1) 的 (一次 clz + 两次加减);
+ * - `for_segvec_slices` 按段遍历连续的元素块。
+ *
+ * 生成的 API:
+ * _init, _new, _deinit, _destroy, _reserve_to, _len, _cap,
+ * _push, _get, _pop, _clear, _iter, _iter_next。
+ *
+ * @param TypeName    要生成的类型名 (例如: NodeList)
+ * @param T           元素类型
+ * @param AllocType   分配器类型 (例如: SystemAlloc, Bump)
+ * @param AllocPrefix 静态分发前缀 (例如: SYSTEM, BUMP)
+ */
+#define DEFINE_SEGVEC(TypeName, T, AllocType, AllocPrefix)                                         \
+                                                                                                   \
+  typedef struct TypeName                                                                          \
+  {                                                                                                \
+    T *segs[SEGVEC_MAX_SEGS];                                                                      \
+    T *tail;     /* 下一个空位 (len 所在的位置); 段用完时为 NULL */                                \
+    T *tail_end; /* tail 所在段的末尾 */                                                           \
+    usize len;                                                                                     \
+    usize nseg; /* 已分配的段数 */                                                                 \
+    AllocType *alloc_state;                                                                        \
+  } TypeName;                                                                                      \
+                                                                                                   \
+  /** @brief 一段连续的元素 (for_segvec_slices 的产出)。 */                                        \
+  typedef struct TypeName##Slice                                                                   \
+  {                                                                                                \
+    T *ptr;                                                                                        \
+    usize len;                                                                                     \
+  } TypeName##Slice;                                                                               \
+                                                                                                   \
+  typedef struct TypeName##Iter                                                                    \
+  {                                                                                                \
+    const TypeName *vec;                                                                           \
+    usize seg;                                                                                     \
+  } TypeName##Iter;                                                                                \
+                                                                                                   \
+  /* --- 1. 生命周期 --- */                                                                        \
+                                                                                                   \
+  static inline void TypeName##_init(TypeName *self, AllocType *alloc)                             \
+  {                                                                                                \
+    self->tail = NULL;                                                                             \
+    self->tail_end = NULL;                                                                         \
+    self->len = 0;                                                                                 \
+    self->nseg = 0;                                                                                \
+    self->alloc_state = alloc;                                                                     \
+  }                                                                                                \
+                                                                                                   \
+  static inline TypeName *TypeName##_new(AllocType *alloc)                                         \
+  {                                                                                                \
+    TypeName *self = (TypeName *)ALLOC(AllocPrefix, alloc, LAYOUT_OF(TypeName));                   \
+    TypeName##_init(self, alloc);                                                                  \
+    return self;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 释放所有段 (不释放 self 结构体本身)。 */                                              \
+  static inline void TypeName##_deinit(TypeName *self)                                             \
+  {                                                                                                \
+    for (usize k = 0; k < self->nseg; k++)                                                         \
+    {                                                                                              \
+      RELEASE(                                                                                     \
+        AllocPrefix, self->alloc_state, self->segs[k], LAYOUT_OF_ARRAY(T, segvec_seg_cap(k)));     \
+    }                                                                                              \
+    TypeName##_init(self, self->alloc_state);                                                      \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_destroy(TypeName *self)                                            \
+  {                                                                                                \
+    if (self == NULL)                                                                              \
+      return;                                                                                      \
+    TypeName##_deinit(self);                                                                       \
+    RELEASE(AllocPrefix, self->alloc_state, self, LAYOUT_OF(TypeName));                            \
+  }                                                                                                \
+                                                                                                   \
+  /** (内部) 按 len 重新定位 tail / tail_end。 */                                                  \
+  static inline void TypeName##_seek_tail(TypeName *self)                                          \
+  {                                                                                                \
+    usize k = segvec_seg_of(self->len);                                                            \
+    if (k >= self->nseg)                                                                           \
+    {                                                                                              \
+      self->tail = NULL;                                                                           \
+      self->tail_end = NULL;                                                                       \
+      return;                                                                                      \
+    }                                                                                              \
+    self->tail = &self->segs[k][segvec_offset_in(self->len, k)];                                   \
+    self->tail_end = self->segs[k] + segvec_seg_cap(k);                                            \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 2. 容量 --- */                                                                            \
+                                                                                                   \
+  static inline usize TypeName##_len(const TypeName *self)                                         \
+  {                                                                                                \
+    return self->len;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize TypeName##_cap(const TypeName *self)                                         \
+  {                                                                                                \
+    return segvec_total_cap(self->nseg);                                                           \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 分配新段, 直到至少能容纳 new_cap 个元素 (已有元素不动)。 */                          \
+  static inline void TypeName##_reserve_to(TypeName *self, usize new_cap)                          \
+  {                                                                                                \
+    while (segvec_total_cap(self->nseg) < new_cap)                                                 \
+    {                                                                                              \
+      asrt_msg(self->nseg < SEGVEC_MAX_SEGS, "segmented vector capacity overflow");                \
+      usize k = self->nseg;                                                                        \
+      self->segs[k] =                                                                              \
+        (T *)ALLOC(AllocPrefix, self->alloc_state, LAYOUT_OF_ARRAY(T, segvec_seg_cap(k)));         \
+      self->nseg++;                                                                                \
+    }                                                                                              \
+    if (self->tail == NULL)                                                                        \
+    {                                                                                              \
+      TypeName##_seek_tail(self);                                                                  \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 3. 访问 --- */                                                                            \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 在末尾追加一个元素。                                                                   \
+   * @return 新元素的地址, 在元素被 _pop/_clear/_deinit 移除之前一直有效。                         \
+   */                                                                                              \
+  static inline T *TypeName##_push(TypeName *self, T element)                                     \
+  {                                                                                                \
+    if (self->tail == self->tail_end)                                                              \
+    {                                                                                              \
+      /* 当前段已满: 定位到下一段 (必要时先分配) */                                                \
+      TypeName##_reserve_to(self, self->len + 1);                                                  \
+      TypeName##_seek_tail(self);                                                                  \
+    }                                                                                              \
+    T *slot = self->tail++;                                                                        \
+    *slot = element;                                                                               \
+    self->len++;                                                                                   \
+    return slot;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 下标访问 (越界时 panic)。 */                                                          \
+  static inline T *TypeName##_get(const TypeName *self, usize index)                               \
+  {                                                                                                \
+    asrt_msg(index < self->len, "index {} out of bounds (len {})", index, self->len);              \
+    usize k = segvec_seg_of(index);                                                                \
+    return &self->segs[k][segvec_offset_in(index, k)];                                             \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 移除并取出最后一个元素 (不释放段)。                                                    \
+   * @return 向量为空时返回 false。                                                                \
+   */                                                                                              \
+  static inline bool TypeName##_pop(TypeName *self, T *out)                                        \
+  {                                                                                                \
+    if (self->len == 0)                                                                            \
+      return false;                                                                                \
+    self->len--;                                                                                   \
+    TypeName##_seek_tail(self);                                                                    \
+    if (out != NULL)                                                                               \
+    {                                                                                              \
+      *out = *self->tail;                                                                          \
+    }                                                                                              \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 清空元素, 但保留已分配的段。 */                                                       \
+  static inline void TypeName##_clear(TypeName *self)                                              \
+  {                                                                                                \
+    self->len = 0;                                                                                 \
+    TypeName##_seek_tail(self);                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 4. 按段遍历 --- */                                                                        \
+                                                                                                   \
+  static inline TypeName##Iter TypeName##_iter(const TypeName *self)                               \
+  {                                                                                                \
+    return (TypeName##Iter){self, 0};                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 产出下一段非空的连续元素; 遍历结束时返回 false。 */                                   \
+  static inline bool TypeName##_iter_next(TypeName##Iter *it, TypeName##Slice *out)                \
+  {                                                                                                \
+    usize start = segvec_total_cap(it->seg);                                                       \
+    if (start >= it->vec->len)                                                                     \
+      return false;                                                                                \
+    usize remaining = it->vec->len - start;                                                        \
+    usize cap = segvec_seg_cap(it->seg);                                                           \
+    out->ptr = it->vec->segs[it->seg];                                                             \
+    out->len = remaining < cap ? remaining : cap;                                                  \
+    it->seg++;                                                                                     \
+    return true;                                                                                   \
+  }
+
+/**
+ * @brief (宏) 按段遍历分段向量中的元素, 每次产出一个 TypeName##Slice。
+ *
+ * @example
+ * for_segvec_slices(NodeList, s, &nodes) {
+ *   for (usize i = 0; i < s.len; i++) visit(&s.ptr[i]);
+ * }
+ */
+#define for_segvec_slices(TypeName, var, vec_ptr)                                                  \
+  for (TypeName##Iter __segvec_it = TypeName##_iter(vec_ptr); __segvec_it.vec != NULL;             \
+       __segvec_it.vec = NULL)                                                                     \
+    for (TypeName##Slice var; TypeName##_iter_next(&__segvec_it, &var);)
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/*
+ * ===================================================================
+ * 1. 依赖 (全都是 Core)
+ * ===================================================================
+ */
+
+#include <core/mem/allocer.h> // L1 Trait (ALLOC, REALLOC, ...)
+#include <core/mem/layout.h>  // L1 Layout
+#include <core/msg/panic.h>   // L3 Panic
+#include <core/type.h>        // L0 Types (usize, byte, ...)
+#include <string.h>           // memcpy
+
+/*
+ * ===================================================================
+ * 2. 核心模板：DEFINE_SMALLVEC
+ * ===================================================================
+ *
+ * `DEFINE_VECTOR` 从 data = NULL 开始, 第一次 `_push` 就要分配。
+ * 大多数只有 1~4 个元素的小列表因此都要付出一次分配和一次指针跳转。
+ *
+ * `DEFINE_SMALLVEC` 生成的类型把最多 N 个元素直接存放在结构体内部,
+ * 超过之后才通过分配器前缀 (AllocPrefix) 溢出到堆上。
+ * 与 SSO 字符串一样, 溢出之后不会再搬回内联缓冲区。
+ *
+ * 布局:
+ * - repr: 内联数组 T[N] 或堆指针 (union)
+ * - len:  元素个数
+ * - cap:  容量; cap == N 表示数据在内联缓冲区中 (堆容量总是大于 N)
+ * - alloc_state: 分配器指针
+ *
+ * @note 内联模式下 `_as_ptr` 返回的指针指向结构体自身,
+ * 移动 (memcpy) 结构体之后旧指针失效。
+ *
+ * 生成的 API 与 DEFINE_VECTOR 保持一致:
+ * _init, _new, _deinit, _destroy, _reserve_to, _reserve_more,
+ * _push, _clear, _len, _cap, _as_ptr, _as_const_ptr, 以及 _is_inline。
+ *
+ * @param TypeName    要生成的类型名 (例如: Operands)
+ * @param T           元素类型 (例如: u32)
+ * @param N           内联容量 (至少为 1)
+ * @param AllocType   分配器类型 (例如: SystemAlloc, Bump)
+ * @param AllocPrefix 静态分发前缀 (例如: SYSTEM, BUMP)
+ */
+#define DEFINE_SMALLVEC(TypeName, T, N, AllocType, AllocPrefix)                                    \
+                                                                                                   \
+  _Static_assert((N) > 0, #TypeName ": inline capacity must be at least 1");                       \
+                                                                                                   \
+  typedef struct TypeName                                                                          \
+  {                                                                                                \
+    union {                                                                                        \
+      T *heap;                                                                                     \
+      T buf[N];                                                                                    \
+    } repr;                                                                                        \
+    usize len;                                                                                     \
+    usize cap;                                                                                     \
+    AllocType *alloc_state;                                                                        \
+  } TypeName;                                                                                      \
+                                                                                                   \
+  /* --- 1. 内部辅助 --- */                                                                        \
+                                                                                                   \
+  static inline bool TypeName##_is_inline(const TypeName *self)                                    \
+  {                                                                                                \
+    return self->cap == (N);                                                                       \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize TypeName##_len(const TypeName *self)                                         \
+  {                                                                                                \
+    return self->len;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize TypeName##_cap(const TypeName *self)                                         \
+  {                                                                                                \
+    return self->cap;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline T *TypeName##_as_ptr(TypeName *self)                                               \
+  {                                                                                                \
+    return TypeName##_is_inline(self) ? self->repr.buf : self->repr.heap;                          \
+  }                                                                                                \
+                                                                                                   \
+  static inline const T *TypeName##_as_const_ptr(const TypeName *self)                             \
+  {                                                                                                \
+    return TypeName##_is_inline(self) ? self->repr.buf : self->repr.heap;                          \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 2. 生命周期 --- */                                                                        \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 初始化一个 *已存在* 的 SmallVec (不分配)。                                             \
+   */                                                                                              \
+  static inline void TypeName##_init(TypeName *self, AllocType *alloc)                             \
+  {                                                                                                \
+    self->len = 0;                                                                                 \
+    self->cap = (N);                                                                               \
+    self->alloc_state = alloc;                                                                     \
+  }                                                                                                \
+                                                                                                   \
+  static inline TypeName *TypeName##_new(AllocType *alloc)                                         \
+  {                                                                                                \
+    TypeName *self = (TypeName *)ALLOC(AllocPrefix, alloc, LAYOUT_OF(TypeName));                   \
+    TypeName##_init(self, alloc);                                                                  \
+    return self;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 释放堆上的数据 (如果有), 并回到空的内联状态。                                          \
+   */                                                                                              \
+  static inline void TypeName##_deinit(TypeName *self)                                             \
+  {                                                                                                \
+    if (!TypeName##_is_inline(self))                                                               \
+    {                                                                                              \
+      RELEASE(                                                                                     \
+        AllocPrefix, self->alloc_state, self->repr.heap, LAYOUT_OF_ARRAY(T, self->cap));           \
+    }                                                                                              \
+    TypeName##_init(self, self->alloc_state);                                                      \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_destroy(TypeName *self)                                            \
+  {                                                                                                \
+    if (self == NULL)                                                                              \
+      return;                                                                                      \
+    TypeName##_deinit(self);                                                                       \
+    RELEASE(AllocPrefix, self->alloc_state, self, LAYOUT_OF(TypeName));                            \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 3. 容量 --- */                                                                            \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 确保至少能容纳 new_cap 个元素。                                                        \
+   * 第一次超过 N 时, 元素从内联缓冲区搬到堆上。                                                   \
+   */                                                                                              \
+  static inline void TypeName##_reserve_to(TypeName *self, usize new_cap)                          \
+  {                                                                                                \
+    if (new_cap <= self->cap)                                                                      \
+      return;                                                                                      \
+    Layout new_layout = LAYOUT_OF_ARRAY(T, new_cap);                                               \
+    if (TypeName##_is_inline(self))                                                                \
+    {                                                                                              \
+      T *ptr = (T *)ALLOC(AllocPrefix, self->alloc_state, new_layout);                             \
+      memcpy(ptr, self->repr.buf, self->len * sizeof(T));                                          \
+      self->repr.heap = ptr;                                                                       \
+    }                                                                                              \
+    else                                                                                           \
+    {                                                                                              \
+      Layout old_layout = LAYOUT_OF_ARRAY(T, self->cap);                                           \
+      (void)old_layout;                                                                            \
+      self->repr.heap =                                                                            \
+        (T *)REALLOC(AllocPrefix, self->alloc_state, self->repr.heap, old_layout, new_layout);     \
+    }                                                                                              \
+    self->cap = new_cap;                                                                           \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_reserve_more(TypeName *self, usize additional)                     \
+  {                                                                                                \
+    if (self->len + additional <= self->cap)                                                       \
+      return;                                                                                      \
+    usize required_cap = self->len + additional;                                                   \
+    usize new_cap = self->cap * 2;                                                                 \
+    if (new_cap < required_cap)                                                                    \
+    {                                                                                              \
+      new_cap = required_cap;                                                                      \
+    }                                                                                              \
+    TypeName##_reserve_to(self, new_cap);                                                          \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 4. 访问 --- */                                                                            \
+                                                                                                   \
+  static inline void TypeName##_push(TypeName *self, T element)                                    \
+  {                                                                                                \
+    if (self->len == self->cap)                                                                    \
+    {                                                                                              \
+      TypeName##_reserve_more(self, 1);                                                            \
+    }                                                                                              \
+    TypeName##_as_ptr(self)[self->len] = element;                                                  \
+    self->len++;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 清空元素, 但保留已分配的堆容量。 */                                                   \
+  static inline void TypeName##_clear(TypeName *self)                                              \
+  {                                                                                                \
+    self->len = 0;                                                                                 \
+  }
@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/*
+ * ===================================================================
+ * 1. 依赖 (全都是 Core)
+ * ===================================================================
+ */
+
+#include <core/mem/allocer.h> // L1 Trait (ALLOC, RELEASE)
+#include <core/mem/layout.h>  // L1 Layout
+#include <core/msg/asrt.h>    // L3 asrt_msg
+#include <core/type.h>        // L0 Types (usize, byte, ...)
+#include <string.h>           // memcpy
+
+/*
+ * ===================================================================
+ * 2. 布局辅助 (与字段类型无关)
+ * ===================================================================
+ */
+
+/** @brief 每个字段数组起点的对齐 (字节, 2 的幂)。 */
+#ifndef SOA_ALIGN
+#define SOA_ALIGN 64
+#endif
+
+/** @brief (内部) 向上对齐到 SOA_ALIGN。 */
+static inline usize
+soa_align_up(usize n)
+{
+  return (n + SOA_ALIGN - 1) & ~(usize)(SOA_ALIGN - 1);
+}
+
+/* --- (内部) 字段列表的展开方式 --- */
+
+#define __SOA_ROW_FIELD(ctx, T, name) T name;
+#define __SOA_PTR_FIELD(ctx, T, name) T *name;
+/* ctx = 容量: 累加每个数组 (对齐后) 的大小到 __size */
+#define __SOA_ADD_SIZE(cap, T, name) __size = soa_align_up(__size) + sizeof(T) * (cap);
+/* ctx = self: 在新块中为字段找位置, 搬运旧数据 */
+#define __SOA_MOVE_FIELD(self, T, name)                                                            \
+  __offset = soa_align_up(__offset);                                                               \
+  memcpy(__block + __offset, (self)->name, (self)->len * sizeof(T));                               \
+  (self)->name = (T *)(__block + __offset);                                                        \
+  __offset += sizeof(T) * __new_cap;
+#define __SOA_STORE_FIELD(self, T, name) (self)->name[__index] = __row.name;
+#define __SOA_LOAD_FIELD(self, T, name) __row.name = (self)->name[__index];
+#define __SOA_SWAP_FIELD(self, T, name) (self)->name[__index] = (self)->name[(self)->len];
+#define __SOA_NULL_FIELD(self, T, name) (self)->name = NULL;
+#define __SOA_ACCESSOR(TypeName, T, name)                                                          \
+  static inline T *TypeName##_##name##_ptr(TypeName *self)                                         \
+  {                                                                                                \
+    return self->name;                                                                             \
+  }
+
+/*
+ * ===================================================================
+ * 3. 核心模板：DEFINE_SOA_VECTOR
+ * ===================================================================
+ *
+ * 热循环往往只读大结构体中的一两个字段; 用 DEFINE_VECTOR 存结构体 (AoS)
+ * 时, 其余字段也跟着占用缓存带宽。
+ *
+ * `DEFINE_SOA_VECTOR` 按 "结构体数组" 的反方向 (SoA) 存放:
+ * 每个字段一个数组, 共享同一个 len / cap, 并且全部放在 *一次* 分配的
+ * 内存块中。每个数组的起点按 SOA_ALIGN 对齐, 便于向量化。
+ *
+ * 字段列表是一个 X-Macro (与 HASHER_DISPATCH_LIST 相同的思路):
+ *
+ *   #define PARTICLE_FIELDS(X, ctx)                                                               \
+ *     X(ctx, f32, x)                                                                              \
+ *     X(ctx, f32, y)                                                                              \
+ *     X(ctx, u32, id)
+ *
+ *   DEFINE_SOA_VECTOR(Particles, PARTICLE_FIELDS, SystemAlloc, SYSTEM)
+ *
+ * 生成:
+ * - `Particles_Row`: 一行的值类型 { f32 x; f32 y; u32 id; }
+ * - `Particles`: { f32 *x; f32 *y; u32 *id; usize len, cap; ... }
+ * - _init, _new, _deinit, _destroy, _reserve_to, _reserve_more,
+ *   _len, _cap, _clear, _push, _get, _set, _swap_remove
+ * - 每个字段的数组指针: Particles_x_ptr(&p), Particles_id_ptr(&p), ...
+ *
+ * @note 扩容时按新的容量重新排布整个块 (每个字段一次 memcpy),
+ * 之前取得的字段指针随之失效。
+ * @note 字段名不能与 block / len / cap / alloc_state 重名。
+ *
+ * @param TypeName    要生成的类型名
+ * @param FIELDS      字段列表宏, 形如 FIELDS(X, ctx) -> X(ctx, T, name) ...
+ * @param AllocType   分配器类型 (例如: SystemAlloc, Bump)
+ * @param AllocPrefix 静态分发前缀 (例如: SYSTEM, BUMP)
+ */
+#define DEFINE_SOA_VECTOR(TypeName, FIELDS, AllocType, AllocPrefix)                                \
+                                                                                                   \
+  typedef struct TypeName##_Row                                                                    \
+  {                                                                                                \
+    FIELDS(__SOA_ROW_FIELD, _)                                                                     \
+  } TypeName##_Row;                                                                                \
+                                                                                                   \
+  typedef struct TypeName                                                                          \
+  {                                                                                                \
+    FIELDS(__SOA_PTR_FIELD, _)                                                                     \
+    void *block; /* 所有字段数组所在的内存块 */                                                    \
+    usize len;                                                                                     \
+    usize cap;                                                                                     \
+    AllocType *alloc_state;                                                                        \
+  } TypeName;                                                                                      \
+                                                                                                   \
+  /* --- 1. 生命周期 --- */                                                                        \
+                                                                                                   \
+  /** (内部) 容量为 cap 时整个内存块的大小。 */                                                    \
+  static inline usize TypeName##_block_size(usize cap)                                             \
+  {                                                                                                \
+    usize __size = 0;                                                                              \
+    FIELDS(__SOA_ADD_SIZE, cap)                                                                    \
+    return soa_align_up(__size);                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_init(TypeName *self, AllocType *alloc)                             \
+  {                                                                                                \
+    FIELDS(__SOA_NULL_FIELD, self)                                                                 \
+    self->block = NULL;                                                                            \
+    self->len = 0;                                                                                 \
+    self->cap = 0;                                                                                 \
+    self->alloc_state = alloc;                                                                     \
+  }                                                                                                \
+                                                                                                   \
+  static inline TypeName *TypeName##_new(AllocType *alloc)                                         \
+  {                                                                                                \
+    TypeName *self = (TypeName *)ALLOC(AllocPrefix, alloc, LAYOUT_OF(TypeName));                   \
+    TypeName##_init(self, alloc);                                                                  \
+    return self;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 释放内存块 (不释放 self 结构体本身)。 */                                              \
+  static inline void TypeName##_deinit(TypeName *self)                                             \
+  {                                                                                                \
+    if (self->block != NULL)                                                                       \
+    {                                                                                              \
+      RELEASE(AllocPrefix,                                                                         \
+              self->alloc_state,                                                                   \
+              self->block,                                                                         \
+              layout_from_size_align(TypeName##_block_size(self->cap), SOA_ALIGN));                \
+    }                                                                                              \
+    TypeName##_init(self, self->alloc_state);                                                      \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_destroy(TypeName *self)                                            \
+  {                                                                                                \
+    if (self == NULL)                                                                              \
+      return;                                                                                      \
+    TypeName##_deinit(self);                                                                       \
+    RELEASE(AllocPrefix, self->alloc_state, self, LAYOUT_OF(TypeName));                            \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 2. 容量 --- */                                                                            \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 确保至少能容纳 new_cap 行。                                                            \
+   * 分配一个新块, 每个字段整段 memcpy 到新位置, 再释放旧块。                                      \
+   */                                                                                              \
+  static inline void TypeName##_reserve_to(TypeName *self, usize new_cap)                          \
+  {                                                                                                \
+    if (new_cap <= self->cap)                                                                      \
+      return;                                                                                      \
+    usize __new_cap = new_cap;                                                                     \
+    byte *__block = (byte *)ALLOC(                                                                 \
+      AllocPrefix,                                                                                 \
+      self->alloc_state,                                                                           \
+      layout_from_size_align(TypeName##_block_size(__new_cap), SOA_ALIGN));                        \
+    usize __offset = 0;                                                                            \
+    FIELDS(__SOA_MOVE_FIELD, self)                                                                 \
+    if (self->block != NULL)                                                                       \
+    {                                                                                              \
+      RELEASE(AllocPrefix,                                                                         \
+              self->alloc_state,                                                                   \
+              self->block,                                                                         \
+              layout_from_size_align(TypeName##_block_size(self->cap), SOA_ALIGN));                \
+    }                                                                                              \
+    self->block = __block;                                                                         \
+    self->cap = __new_cap;                                                                         \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_reserve_more(TypeName *self, usize additional)                     \
+  {                                                                                                \
+    if (self->len + additional <= self->cap)                                                       \
+      return;                                                                                      \
+    usize required_cap = self->len + additional;                                                   \
+    usize new_cap = (self->cap == 0) ? 8 : (self->cap * 2);                                        \
+    if (new_cap < required_cap)                                                                    \
+    {                                                                                              \
+      new_cap = required_cap;                                                                      \
+    }                                                                                              \
+    TypeName##_reserve_to(self, new_cap);                                                          \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize TypeName##_len(const TypeName *self)                                         \
+  {                                                                                                \
+    return self->len;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize TypeName##_cap(const TypeName *self)                                         \
+  {                                                                                                \
+    return self->cap;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_clear(TypeName *self)                                              \
+  {                                                                                                \
+    self->len = 0;                                                                                 \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 3. 按行访问 --- */                                                                        \
+                                                                                                   \
+  /** @brief 追加一行: 每个字段写入各自的数组。 */                                                 \
+  static inline void TypeName##_push(TypeName *self, TypeName##_Row __row)                         \
+  {                                                                                                \
+    TypeName##_reserve_more(self, 1);                                                              \
+    usize __index = self->len;                                                                     \
+    FIELDS(__SOA_STORE_FIELD, self)                                                                \
+    self->len++;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 把第 index 行的各个字段收集成一个 Row (越界时 panic)。 */                             \
+  static inline TypeName##_Row TypeName##_get(const TypeName *self, usize __index)                 \
+  {                                                                                                \
+    asrt_msg(__index < self->len, "index {} out of bounds (len {})", __index, self->len);          \
+    TypeName##_Row __row;                                                                          \
+    FIELDS(__SOA_LOAD_FIELD, self)                                                                 \
+    return __row;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 覆盖第 index 行 (越界时 panic)。 */                                                   \
+  static inline void TypeName##_set(TypeName *self, usize __index, TypeName##_Row __row)           \
+  {                                                                                                \
+    asrt_msg(__index < self->len, "index {} out of bounds (len {})", __index, self->len);          \
+    FIELDS(__SOA_STORE_FIELD, self)                                                                \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief O(1) 移除第 index 行: 用最后一行填补空位 (不保持顺序)。 */                            \
+  static inline void TypeName##_swap_remove(TypeName *self, usize __index)                         \
+  {                                                                                                \
+    asrt_msg(__index < self->len, "index {} out of bounds (len {})", __index, self->len);          \
+    self->len--;                                                                                   \
+    FIELDS(__SOA_SWAP_FIELD, self)                                                                 \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 4. 按字段访问 --- */                                                                      \
+                                                                                                   \
+  FIELDS(__SOA_ACCESSOR, TypeName)
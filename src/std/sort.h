@@ -0,0 +1,553 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Template) 按类型特化的排序。
+ *
+ * `qsort` 每次比较都要经过一次函数指针调用, 并且按字节搬运元素。
+ * 这里的排序都是宏模板, 比较函数和元素类型在实例化时确定, 编译器可以内联:
+ *
+ * - `DEFINE_SORT`: 模式击败快排 (pdqsort), 不稳定, O(n log n) 最坏情况
+ *   (坏划分过多时退化为堆排序), 对已排序 / 逆序 / 大量重复的输入是线性的。
+ * - `DEFINE_RADIX_SORT`: LSD 基数排序 (每趟 8 位), 稳定, O(n * 键字节数),
+ *   适用于整数 / 浮点键, 以及可以提取出这类键的结构体。
+ *
+ * @example
+ * static inline Ordering cmp_u32(const u32 *a, const u32 *b) { ... }
+ * DEFINE_SORT(u32s, u32, cmp_u32)
+ * u32s_sort(vec.data, vec.len);
+ *
+ * radix_sort_u64(keys, n, scratch); // scratch: 调用者提供的 n 个元素的缓冲区
+ */
+
+/*
+ * ===================================================================
+ * 1. 依赖 (全都是 Core)
+ * ===================================================================
+ */
+
+#include <core/math/ordering.h> // L0 Ordering
+#include <core/type.h>          // L0 Types (usize, u32, ...)
+#include <string.h>             // memcpy, memset
+
+/*
+ * ===================================================================
+ * 2. 模式击败快排：DEFINE_SORT
+ * ===================================================================
+ */
+
+/** @brief 小于此长度的区间用插入排序。 */
+#define PDQ_INSERTION_THRESHOLD 24
+
+/** @brief 大于此长度的区间用 "九数取中" 选枢轴。 */
+#define PDQ_NINTHER_THRESHOLD 128
+
+/** @brief 乐观插入排序放弃前允许移动的元素个数。 */
+#define PDQ_PARTIAL_INSERTION_LIMIT 8
+
+/** @brief (内部) floor(log2(n)), n > 0。 */
+static inline usize
+sort_log2(usize n)
+{
+  return (usize)(63 - __builtin_clzll((unsigned long long)n));
+}
+
+/**
+ * @brief (Template) 为元素类型 T 生成一个内联比较的 pdqsort。
+ *
+ * 生成的 API:
+ * - `void Name_sort(T *data, usize len)`: 原地升序排序 (不稳定)。
+ * - `bool Name_is_sorted(const T *data, usize len)`
+ *
+ * @param Name   生成的函数名前缀
+ * @param T      元素类型
+ * @param FN_CMP 签名为 `Ordering (*)(const T *, const T *)` 的比较函数
+ *               (建议是 static inline 函数, 以便内联)
+ */
+#define DEFINE_SORT(Name, T, FN_CMP)                                                               \
+                                                                                                   \
+  /* (内部) *a < *b */                                                                             \
+  static inline bool Name##_less(const T *a, const T *b)                                           \
+  {                                                                                                \
+    return FN_CMP(a, b) == LESS;                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_swap(T *a, T *b)                                                       \
+  {                                                                                                \
+    T tmp = *a;                                                                                    \
+    *a = *b;                                                                                       \
+    *b = tmp;                                                                                      \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_sort2(T *a, T *b)                                                      \
+  {                                                                                                \
+    if (Name##_less(b, a))                                                                         \
+    {                                                                                              \
+      Name##_swap(a, b);                                                                           \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_sort3(T *a, T *b, T *c)                                                \
+  {                                                                                                \
+    Name##_sort2(a, b);                                                                            \
+    Name##_sort2(b, c);                                                                            \
+    Name##_sort2(a, b);                                                                            \
+  }                                                                                                \
+                                                                                                   \
+  /* (内部) [begin, end) 的插入排序 */                                                             \
+  static inline void Name##_insertion_sort(T *begin, T *end)                                       \
+  {                                                                                                \
+    if (begin == end)                                                                              \
+      return;                                                                                      \
+    for (T *cur = begin + 1; cur != end; cur++)                                                    \
+    {                                                                                              \
+      T *sift = cur;                                                                               \
+      T *sift_1 = cur - 1;                                                                         \
+      if (Name##_less(sift, sift_1))                                                               \
+      {                                                                                            \
+        T tmp = *sift;                                                                             \
+        do                                                                                         \
+        {                                                                                          \
+          *sift-- = *sift_1;                                                                       \
+        } while (sift != begin && Name##_less(&tmp, --sift_1));                                    \
+        *sift = tmp;                                                                               \
+      }                                                                                            \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /* (内部) 同上, 但要求 begin[-1] 不大于区间内任何元素 (省去边界检查) */                          \
+  static inline void Name##_unguarded_insertion_sort(T *begin, T *end)                             \
+  {                                                                                                \
+    if (begin == end)                                                                              \
+      return;                                                                                      \
+    for (T *cur = begin + 1; cur != end; cur++)                                                    \
+    {                                                                                              \
+      T *sift = cur;                                                                               \
+      T *sift_1 = cur - 1;                                                                         \
+      if (Name##_less(sift, sift_1))                                                               \
+      {                                                                                            \
+        T tmp = *sift;                                                                             \
+        do                                                                                         \
+        {                                                                                          \
+          *sift-- = *sift_1;                                                                       \
+        } while (Name##_less(&tmp, --sift_1));                                                     \
+        *sift = tmp;                                                                               \
+      }                                                                                            \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /* (内部) 乐观的插入排序: 移动超过 PDQ_PARTIAL_INSERTION_LIMIT 个元素就放弃 */                   \
+  static inline bool Name##_partial_insertion_sort(T *begin, T *end)                               \
+  {                                                                                                \
+    if (begin == end)                                                                              \
+      return true;                                                                                 \
+    usize limit = 0;                                                                               \
+    for (T *cur = begin + 1; cur != end; cur++)                                                    \
+    {                                                                                              \
+      T *sift = cur;                                                                               \
+      T *sift_1 = cur - 1;                                                                         \
+      if (Name##_less(sift, sift_1))                                                               \
+      {                                                                                            \
+        T tmp = *sift;                                                                             \
+        do                                                                                         \
+        {                                                                                          \
+          *sift-- = *sift_1;                                                                       \
+        } while (sift != begin && Name##_less(&tmp, --sift_1));                                    \
+        *sift = tmp;                                                                               \
+        limit += (usize)(cur - sift);                                                              \
+      }                                                                                            \
+      if (limit > PDQ_PARTIAL_INSERTION_LIMIT)                                                     \
+        return false;                                                                              \
+    }                                                                                              \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /* (内部) 堆排序: 坏划分太多时的保底, 保证 O(n log n) */                                         \
+  static inline void Name##_sift_down(T *data, usize root, usize len)                              \
+  {                                                                                                \
+    for (;;)                                                                                       \
+    {                                                                                              \
+      usize child = 2 * root + 1;                                                                  \
+      if (child >= len)                                                                            \
+        return;                                                                                    \
+      if (child + 1 < len && Name##_less(&data[child], &data[child + 1]))                          \
+      {                                                                                            \
+        child++;                                                                                   \
+      }                                                                                            \
+      if (!Name##_less(&data[root], &data[child]))                                                 \
+        return;                                                                                    \
+      Name##_swap(&data[root], &data[child]);                                                      \
+      root = child;                                                                                \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_heap_sort(T *begin, T *end)                                            \
+  {                                                                                                \
+    usize len = (usize)(end - begin);                                                              \
+    for (usize i = len / 2; i-- > 0;)                                                              \
+    {                                                                                              \
+      Name##_sift_down(begin, i, len);                                                             \
+    }                                                                                              \
+    for (usize i = len; i-- > 1;)                                                                  \
+    {                                                                                              \
+      Name##_swap(&begin[0], &begin[i]);                                                           \
+      Name##_sift_down(begin, 0, i);                                                               \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /*                                                                                               \
+   * (内部) 以 *begin 为枢轴划分: 左边 < 枢轴, 右边 >= 枢轴。                                      \
+   * 返回枢轴的最终位置; 输入本来就已划分好时 *already_partitioned = true。                        \
+   */                                                                                              \
+  static inline T *Name##_partition_right(T *begin, T *end, bool *already_partitioned)             \
+  {                                                                                                \
+    T pivot = *begin;                                                                              \
+    T *first = begin;                                                                              \
+    T *last = end;                                                                                 \
+    /* 三数取中保证了 first 不会越过 end (至少有一个元素 >= 枢轴) */                               \
+    while (Name##_less(++first, &pivot))                                                           \
+      ;                                                                                            \
+    if (first - 1 == begin)                                                                        \
+    {                                                                                              \
+      while (first < last && !Name##_less(--last, &pivot))                                         \
+        ;                                                                                          \
+    }                                                                                              \
+    else                                                                                           \
+    {                                                                                              \
+      while (!Name##_less(--last, &pivot))                                                         \
+        ;                                                                                          \
+    }                                                                                              \
+    *already_partitioned = first >= last;                                                          \
+    while (first < last)                                                                           \
+    {                                                                                              \
+      Name##_swap(first, last);                                                                    \
+      while (Name##_less(++first, &pivot))                                                         \
+        ;                                                                                          \
+      while (!Name##_less(--last, &pivot))                                                         \
+        ;                                                                                          \
+    }                                                                                              \
+    T *pivot_pos = first - 1;                                                                      \
+    *begin = *pivot_pos;                                                                           \
+    *pivot_pos = pivot;                                                                            \
+    return pivot_pos;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /*                                                                                               \
+   * (内部) 与 partition_right 相反: 等于枢轴的元素都放到左边。                                    \
+   * 用于大量重复的键: 这些元素之后不再参与排序。                                                  \
+   */                                                                                              \
+  static inline T *Name##_partition_left(T *begin, T *end)                                         \
+  {                                                                                                \
+    T pivot = *begin;                                                                              \
+    T *first = begin;                                                                              \
+    T *last = end;                                                                                 \
+    while (Name##_less(&pivot, --last))                                                            \
+      ;                                                                                            \
+    if (last + 1 == end)                                                                           \
+    {                                                                                              \
+      while (first < last && !Name##_less(&pivot, ++first))                                        \
+        ;                                                                                          \
+    }                                                                                              \
+    else                                                                                           \
+    {                                                                                              \
+      while (!Name##_less(&pivot, ++first))                                                        \
+        ;                                                                                          \
+    }                                                                                              \
+    while (first < last)                                                                           \
+    {                                                                                              \
+      Name##_swap(first, last);                                                                    \
+      while (Name##_less(&pivot, --last))                                                          \
+        ;                                                                                          \
+      while (!Name##_less(&pivot, ++first))                                                        \
+        ;                                                                                          \
+    }                                                                                              \
+    T *pivot_pos = last;                                                                           \
+    *begin = *pivot_pos;                                                                           \
+    *pivot_pos = pivot;                                                                            \
+    return pivot_pos;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static void Name##_pdq_loop(T *begin, T *end, usize bad_allowed, bool leftmost)                  \
+  {                                                                                                \
+    for (;;)                                                                                       \
+    {                                                                                              \
+      usize size = (usize)(end - begin);                                                           \
+      if (size < PDQ_INSERTION_THRESHOLD)                                                          \
+      {                                                                                            \
+        if (leftmost)                                                                              \
+          Name##_insertion_sort(begin, end);                                                       \
+        else                                                                                       \
+          Name##_unguarded_insertion_sort(begin, end);                                             \
+        return;                                                                                    \
+      }                                                                                            \
+                                                                                                   \
+      /* 选枢轴并放到 *begin */                                                                    \
+      usize s2 = size / 2;                                                                         \
+      if (size > PDQ_NINTHER_THRESHOLD)                                                            \
+      {                                                                                            \
+        Name##_sort3(begin, begin + s2, end - 1);                                                  \
+        Name##_sort3(begin + 1, begin + (s2 - 1), end - 2);                                        \
+        Name##_sort3(begin + 2, begin + (s2 + 1), end - 3);                                        \
+        Name##_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1));                              \
+        Name##_swap(begin, begin + s2);                                                            \
+      }                                                                                            \
+      else                                                                                         \
+      {                                                                                            \
+        Name##_sort3(begin + s2, begin, end - 1);                                                  \
+      }                                                                                            \
+                                                                                                   \
+      /* 枢轴等于左边界外的元素: 区间里有大量与之相等的键 */                                       \
+      if (!leftmost && !Name##_less(begin - 1, begin))                                             \
+      {                                                                                            \
+        begin = Name##_partition_left(begin, end) + 1;                                             \
+        continue;                                                                                  \
+      }                                                                                            \
+                                                                                                   \
+      bool already_partitioned = false;                                                            \
+      T *pivot_pos = Name##_partition_right(begin, end, &already_partitioned);                     \
+      usize l_size = (usize)(pivot_pos - begin);                                                   \
+      usize r_size = (usize)(end - (pivot_pos + 1));                                               \
+                                                                                                   \
+      if (l_size < size / 8 || r_size < size / 8)                                                  \
+      {                                                                                            \
+        /* 划分极不均衡: 次数用完就改用堆排序, 否则打乱一些元素破坏模式 */                         \
+        if (--bad_allowed == 0)                                                                    \
+        {                                                                                          \
+          Name##_heap_sort(begin, end);                                                            \
+          return;                                                                                  \
+        }                                                                                          \
+        if (l_size >= PDQ_INSERTION_THRESHOLD)                                                     \
+        {                                                                                          \
+          Name##_swap(begin, begin + l_size / 4);                                                  \
+          Name##_swap(pivot_pos - 1, pivot_pos - l_size / 4);                                      \
+          if (l_size > PDQ_NINTHER_THRESHOLD)                                                      \
+          {                                                                                        \
+            Name##_swap(begin + 1, begin + (l_size / 4 + 1));                                      \
+            Name##_swap(begin + 2, begin + (l_size / 4 + 2));                                      \
+            Name##_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));                              \
+            Name##_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));                              \
+          }                                                                                        \
+        }                                                                                          \
+        if (r_size >= PDQ_INSERTION_THRESHOLD)                                                     \
+        {                                                                                          \
+          Name##_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));                                \
+          Name##_swap(end - 1, end - r_size / 4);                                                  \
+          if (r_size > PDQ_NINTHER_THRESHOLD)                                                      \
+          {                                                                                        \
+            Name##_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));                              \
+            Name##_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));                              \
+            Name##_swap(end - 2, end - (1 + r_size / 4));                                          \
+            Name##_swap(end - 3, end - (2 + r_size / 4));                                          \
+          }                                                                                        \
+        }                                                                                          \
+      }                                                                                            \
+      else if (already_partitioned && Name##_partial_insertion_sort(begin, pivot_pos) &&           \
+               Name##_partial_insertion_sort(pivot_pos + 1, end))                                  \
+      {                                                                                            \
+        /* 划分均衡且几乎无需交换: 很可能已经有序, 乐观地用插入排序收尾 */                         \
+        return;                                                                                    \
+      }                                                                                            \
+                                                                                                   \
+      /* 递归处理左半边, 循环处理右半边 */                                                         \
+      Name##_pdq_loop(begin, pivot_pos, bad_allowed, leftmost);                                    \
+      begin = pivot_pos + 1;                                                                       \
+      leftmost = false;                                                                            \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 原地升序排序 (不稳定)。 */                                                            \
+  static inline void Name##_sort(T *data, usize len)                                               \
+  {                                                                                                \
+    if (len < 2)                                                                                   \
+      return;                                                                                      \
+    Name##_pdq_loop(data, data + len, sort_log2(len), true);                                       \
+  }                                                                                                \
+                                                                                                   \
+  static inline bool Name##_is_sorted(const T *data, usize len)                                    \
+  {                                                                                                \
+    for (usize i = 1; i < len; i++)                                                                \
+    {                                                                                              \
+      if (Name##_less(&data[i], &data[i - 1]))                                                     \
+        return false;                                                                              \
+    }                                                                                              \
+    return true;                                                                                   \
+  }
+
+/*
+ * ===================================================================
+ * 3. LSD 基数排序：DEFINE_RADIX_SORT
+ * ===================================================================
+ *
+ * 键先被映射成无符号整数, 使无符号的大小顺序与原始顺序一致:
+ * - 有符号整数: 翻转符号位;
+ * - 浮点数: 负数翻转所有位, 非负数只翻转符号位 (-0.0 排在 +0.0 之前,
+ *   NaN 按符号排在两端)。
+ *
+ * 每趟处理 8 位。所有趟的直方图在第一遍扫描时一次算好;
+ * 某一趟中所有键的该字节都相同时直接跳过这一趟。
+ */
+
+/** @brief (键映射) 有符号整数 -> 保序的无符号整数。 */
+static inline u32
+radix_key_i32(i32 v)
+{
+  return (u32)v ^ 0x80000000u;
+}
+
+static inline u64
+radix_key_i64(i64 v)
+{
+  return (u64)v ^ 0x8000000000000000ull;
+}
+
+/** @brief (键映射) 浮点数 -> 保序的无符号整数。 */
+static inline u32
+radix_key_f32(f32 v)
+{
+  u32 bits;
+  memcpy(&bits, &v, sizeof(bits));
+  return bits ^ ((u32)((i32)bits >> 31) | 0x80000000u);
+}
+
+static inline u64
+radix_key_f64(f64 v)
+{
+  u64 bits;
+  memcpy(&bits, &v, sizeof(bits));
+  return bits ^ ((u64)((i64)bits >> 63) | 0x8000000000000000ull);
+}
+
+/**
+ * @brief (Template) 生成一个按提取出的无符号键做 LSD 基数排序的函数。
+ *
+ * 生成的 API:
+ * - `void Name(T *data, usize len, T *scratch)`: 稳定的升序排序。
+ *   scratch 是调用者提供的、至少 len 个元素的缓冲区 (内容会被覆盖)。
+ *
+ * @param Name    生成的函数名
+ * @param T       元素类型
+ * @param KeyType 键类型 (u32 或 u64)
+ * @param FN_KEY  签名为 `KeyType (*)(const T *)` 的保序键提取函数
+ */
+#define DEFINE_RADIX_SORT(Name, T, KeyType, FN_KEY)                                                \
+                                                                                                   \
+  static inline void Name(T *data, usize len, T *scratch)                                          \
+  {                                                                                                \
+    enum                                                                                           \
+    {                                                                                              \
+      PASSES = sizeof(KeyType)                                                                     \
+    };                                                                                             \
+    if (len < 2)                                                                                   \
+      return;                                                                                      \
+                                                                                                   \
+    /* 一遍扫描算出每一趟的直方图 */                                                               \
+    usize counts[PASSES][256];                                                                     \
+    memset(counts, 0, sizeof(counts));                                                             \
+    for (usize i = 0; i < len; i++)                                                                \
+    {                                                                                              \
+      KeyType key = FN_KEY(&data[i]);                                                              \
+      for (usize p = 0; p < PASSES; p++)                                                           \
+      {                                                                                            \
+        counts[p][(key >> (p * 8)) & 0xFF]++;                                                      \
+      }                                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    T *src = data;                                                                                 \
+    T *dst = scratch;                                                                              \
+    for (usize p = 0; p < PASSES; p++)                                                             \
+    {                                                                                              \
+      usize *count = counts[p];                                                                    \
+      /* 所有键的这个字节都相同: 这一趟不改变顺序 */                                               \
+      if (count[(FN_KEY(&src[0]) >> (p * 8)) & 0xFF] == len)                                       \
+        continue;                                                                                  \
+                                                                                                   \
+      usize offset = 0;                                                                            \
+      for (usize b = 0; b < 256; b++)                                                              \
+      {                                                                                            \
+        usize c = count[b];                                                                        \
+        count[b] = offset;                                                                         \
+        offset += c;                                                                               \
+      }                                                                                            \
+      for (usize i = 0; i < len; i++)                                                              \
+      {                                                                                            \
+        dst[count[(FN_KEY(&src[i]) >> (p * 8)) & 0xFF]++] = src[i];                                \
+      }                                                                                            \
+      T *tmp = src;                                                                                \
+      src = dst;                                                                                   \
+      dst = tmp;                                                                                   \
+    }                                                                                              \
+                                                                                                   \
+    if (src != data)                                                                               \
+    {                                                                                              \
+      memcpy(data, src, len * sizeof(T));                                                          \
+    }                                                                                              \
+  }
+
+/*
+ * ===================================================================
+ * 4. 常用实例
+ * ===================================================================
+ */
+
+/* (内部) 基本类型的键提取 */
+static inline u32
+radix_key_of_u32(const u32 *v)
+{
+  return *v;
+}
+
+static inline u64
+radix_key_of_u64(const u64 *v)
+{
+  return *v;
+}
+
+static inline u32
+radix_key_of_i32(const i32 *v)
+{
+  return radix_key_i32(*v);
+}
+
+static inline u64
+radix_key_of_i64(const i64 *v)
+{
+  return radix_key_i64(*v);
+}
+
+static inline u32
+radix_key_of_f32(const f32 *v)
+{
+  return radix_key_f32(*v);
+}
+
+static inline u64
+radix_key_of_f64(const f64 *v)
+{
+  return radix_key_f64(*v);
+}
+
+DEFINE_RADIX_SORT(radix_sort_u32, u32, u32, radix_key_of_u32)
+DEFINE_RADIX_SORT(radix_sort_u64, u64, u64, radix_key_of_u64)
+DEFINE_RADIX_SORT(radix_sort_i32, i32, u32, radix_key_of_i32)
+DEFINE_RADIX_SORT(radix_sort_i64, i64, u64, radix_key_of_i64)
+DEFINE_RADIX_SORT(radix_sort_f32, f32, u32, radix_key_of_f32)
+DEFINE_RADIX_SORT(radix_sort_f64, f64, u64, radix_key_of_f64)
@@ -161,8 +161,8 @@ DEFINE_STRING_API(bstring, Bump)
 static inline void
 sstring_push_char_adapter(void *sink, char c)
 {
-  /* * 静态分发：调用 sstring_push (来自 DEFINE_VECTOR) */
-  sstring_push((sstring *)sink, c);
+  /* * 走 push_bytes 以保持 '\0' 结尾 (sstring_push 不写 '\0') */
+  sstring_push_bytes((sstring *)sink, &c, 1);
 }
 static inline void
 sstring_push_bytes_adapter(void *sink, const char *bytes, usize len)
@@ -176,8 +176,8 @@ sstring_push_bytes_adapter(void *sink, const char *bytes, usize len)
 static inline void
 bstring_push_char_adapter(void *sink, char c)
 {
-  /* * 静态分发：调用 bstring_push (来自 DEFINE_VECTOR) */
-  bstring_push((bstring *)sink, c);
+  /* * 走 push_bytes 以保持 '\0' 结尾 (bstring_push 不写 '\0') */
+  bstring_push_bytes((bstring *)sink, &c, 1);
 }
 static inline void
 bstring_push_bytes_adapter(void *sink, const char *bytes, usize len)
@@ -187,22 +187,38 @@ bstring_push_bytes_adapter(void *sink, const char *bytes, usize len)
   bstring_push_bytes((bstring *)sink, bytes, len);
 }
 
+/* --- reserve Adapters (s_format_exact 使用) --- */
+static inline void
+sstring_reserve_adapter(void *sink, usize additional)
+{
+  sstring *self = (sstring *)sink;
+  sstring_reserve_to(self, self->len + additional + 1); /* +1: '\0' */
+}
+static inline void
+bstring_reserve_adapter(void *sink, usize additional)
+{
+  bstring *self = (bstring *)sink;
+  bstring_reserve_to(self, self->len + additional + 1); /* +1: '\0' */
+}
+
 /*
  * ===================================================================
  * 4. 统一的泛型宏 (Generic Macros)
  * ===================================================================
  *
- * (此部分保持不变)
- *
  * 使用 C11 _Generic 在编译时选择正确的实现。
- * 这为 `sstring` 和 `bstring` 提供了统一的 API。
+ * 这为 `sstring`, `bstring` 以及 SSO 变体 (见第 6 节) 提供了统一的 API。
  */
 
 /**
  * @brief (泛型) 在字符串末尾追加一个 C 字符串 (str)。
  */
 #define s_push_str(self, s)                                                                        \
-  _Generic((self), sstring *: sstring_push_str, bstring *: bstring_push_str)(self, s)
+  _Generic((self),                                                                                 \
+    sstring *: sstring_push_str,                                                                   \
+    bstring *: bstring_push_str,                                                                   \
+    sso_sstring *: sso_sstring_push_str,                                                           \
+    sso_bstring *: sso_bstring_push_str)(self, s)
 
 /**
  * @brief (泛型) 将字符串作为 C 字符串 (str) 查看。
@@ -212,7 +228,11 @@ bstring_push_bytes_adapter(void *sink, const char *bytes, usize len)
     sstring *: sstring_as_str,                                                                     \
     const sstring *: sstring_as_str,                                                               \
     bstring *: bstring_as_str,                                                                     \
-    const bstring *: bstring_as_str)(self)
+    const bstring *: bstring_as_str,                                                               \
+    sso_sstring *: sso_sstring_as_str,                                                             \
+    const sso_sstring *: sso_sstring_as_str,                                                       \
+    sso_bstring *: sso_bstring_as_str,                                                             \
+    const sso_bstring *: sso_bstring_as_str)(self)
 
 /**
  * @brief (泛型) 从一个 C 字符串 (str)
@@ -222,24 +242,344 @@ bstring_push_bytes_adapter(void *sink, const char *bytes, usize len)
   _Generic((alloc), SystemAlloc *: sstring_new_from_str, Bump *: bstring_new_from_str)(alloc, s)
 
 /**
- * @brief (泛型) 格式化内容并追加到 sstring 或 bstring。
+ * @brief (泛型) 格式化内容并追加到 sstring, bstring 或 SSO 字符串。
  *
  * @example
  * sstring *s = sstring_new(...);
  * s_format(s, "Hello, {str}!", "world");
  */
 #define s_format(sink, fmt, ...)                                                                   \
-  vformat_func(                                                                                    \
+  vformat_cached(                                                                                  \
     (void *)(sink),                                                                                \
                                                                                                    \
     /* 2. 静态选择 "push_char" 适配器 */                                                           \
-    _Generic((sink), sstring *: sstring_push_char_adapter, bstring *: bstring_push_char_adapter),  \
+    _Generic((sink),                                                                               \
+      sstring *: sstring_push_char_adapter,                                                        \
+      bstring *: bstring_push_char_adapter,                                                        \
+      sso_sstring *: sso_sstring_push_char_adapter,                                                \
+      sso_bstring *: sso_bstring_push_char_adapter),                                               \
                                                                                                    \
     /* 3. 静态选择 "push_bytes" 适配器 */                                                          \
     _Generic((sink),                                                                               \
       sstring *: sstring_push_bytes_adapter,                                                       \
-      bstring *: bstring_push_bytes_adapter),                                                      \
+      bstring *: bstring_push_bytes_adapter,                                                       \
+      sso_sstring *: sso_sstring_push_bytes_adapter,                                               \
+      sso_bstring *: sso_bstring_push_bytes_adapter),                                              \
+                                                                                                   \
+    /* 4. 格式化字符串和其余参数 (来自 vformat.h, 每个调用点缓存编译结果) */                       \
+    (fmt)__VA_OPT__(, ) __VA_ARGS__)
+
+/**
+ * @brief (泛型) 与 s_format 相同, 但先计算精确长度, 只扩容一次。
+ *
+ * 适合一次写入较长消息的场景: s_format 逐段追加时,
+ * 一条消息可能触发多次 _reserve_to。参数只求值一次。
+ *
+ * @example
+ * s_format_exact(s, "{} items in {} ms", count, elapsed);
+ */
+#define s_format_exact(sink, fmt, ...)                                                             \
+  vformat_exact_cached((void *)(sink),                                                             \
+                       _Generic((sink),                                                            \
+                         sstring *: sstring_reserve_adapter,                                       \
+                         bstring *: bstring_reserve_adapter,                                       \
+                         sso_sstring *: sso_sstring_reserve_adapter,                               \
+                         sso_bstring *: sso_bstring_reserve_adapter),                              \
+                       _Generic((sink),                                                            \
+                         sstring *: sstring_push_char_adapter,                                     \
+                         bstring *: bstring_push_char_adapter,                                     \
+                         sso_sstring *: sso_sstring_push_char_adapter,                             \
+                         sso_bstring *: sso_bstring_push_char_adapter),                            \
+                       _Generic((sink),                                                            \
+                         sstring *: sstring_push_bytes_adapter,                                    \
+                         bstring *: bstring_push_bytes_adapter,                                    \
+                         sso_sstring *: sso_sstring_push_bytes_adapter,                            \
+                         sso_bstring *: sso_bstring_push_bytes_adapter),                           \
+                       (fmt)__VA_OPT__(, ) __VA_ARGS__)
+
+/*
+ * ===================================================================
+ * 6. SSO 字符串 (Small-String Optimization)
+ * ===================================================================
+ *
+ * `sstring`/`bstring` 即使只存 5 个字节, 也要付出一次分配和
+ * 一个 32 字节的 Vector 头。
+ *
+ * `DEFINE_SSO_STRING` 生成的类型把最多 SSO_INLINE_CAP (23)
+ * 个字节直接存放在结构体内部; 超过之后才通过分配器前缀
+ * (AllocPrefix) 溢出到堆上。
+ *
+ * 布局 (64 位, 共 32 字节, 与 sstring 的 Vector 头一样大):
+ * - repr:        24 字节的 union, 内联缓冲区或 { ptr, len, cap_tag }
+ * - alloc_state: 分配器指针
+ *
+ * repr 的最后一个字节 (buf[SSO_INLINE_CAP]) 是标记字节:
+ * - 内联模式下保存剩余空间 SSO_INLINE_CAP - len (0..23), 最高位为 0。
+ *   存满 23 个字节时它恰好是 0, 同时充当结尾的 '\0'。
+ * - 堆模式下最高位为 1 (SSO_HEAP_TAG), 其余位与 cap 共用 heap.cap_tag。
+ *
+ * @note 内联模式下 `_as_str` 返回的指针指向结构体自身,
+ * 移动 (memcpy) 结构体之后旧指针失效。
+ */
+
+/** @brief 内联缓冲区可容纳的最大字节数 (不含 '\0'), 64 位下为 23。 */
+#define SSO_INLINE_CAP (sizeof(char *) + 2 * sizeof(usize) - 1)
+
+/** @brief (内部) 标记字节的最高位: 数据位于堆上。 */
+#define SSO_HEAP_TAG 0x80
+
+/*
+ * (内部) 堆模式下 cap 的编码。标记字节是 heap.cap_tag 在内存中的
+ * 最后一个字节: 小端下是最高字节, 大端下是最低字节。
+ */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define SSO_CAP_ENCODE(cap) (((usize)(cap) << 8) | SSO_HEAP_TAG)
+#define SSO_CAP_DECODE(word) ((word) >> 8)
+#else
+#define SSO_CAP_ENCODE(cap) ((usize)(cap) | ((usize)SSO_HEAP_TAG << (sizeof(usize) * 8 - 8)))
+#define SSO_CAP_DECODE(word) ((word) & (~(usize)0 >> 8))
+#endif
+
+/**
+ * @brief (Template) 定义一个 SSO 字符串 "类"。
+ *
+ * 生成的 API 与 DEFINE_VECTOR + DEFINE_STRING_API 保持一致:
+ * _init, _new, _deinit, _destroy, _reserve_to, _reserve_more,
+ * _push, _clear, _len, _cap, _as_ptr, _as_const_ptr,
+ * _new_from_str, _push_str, _push_bytes, _as_str。
+ *
+ * @param TypeName    要生成的类型名 (例如: sso_sstring)
+ * @param AllocType   分配器类型 (例如: SystemAlloc, Bump)
+ * @param AllocPrefix 静态分发前缀 (例如: SYSTEM, BUMP)
+ */
+#define DEFINE_SSO_STRING(TypeName, AllocType, AllocPrefix)                                        \
                                                                                                    \
-    /* 4. 格式化字符串和其余参数 (来自 vformat.h) */                                               \
-    (fmt),                                                                                         \
-    ARGS_COUNT(__VA_ARGS__) __VA_OPT__(, ) EXPAND_ALL(TYPE_INFO, __VA_ARGS__))
+  typedef struct TypeName                                                                          \
+  {                                                                                                \
+    union {                                                                                        \
+      struct                                                                                       \
+      {                                                                                            \
+        char *ptr;                                                                                 \
+        usize len;                                                                                 \
+        usize cap_tag; /* SSO_CAP_ENCODE(可用容量, 不含 '\0') */                                   \
+      } heap;                                                                                      \
+      char buf[SSO_INLINE_CAP + 1];                                                                \
+    } repr;                                                                                        \
+    AllocType *alloc_state;                                                                        \
+  } TypeName;                                                                                      \
+                                                                                                   \
+  /* --- 1. 内部辅助 --- */                                                                        \
+                                                                                                   \
+  static inline bool TypeName##_is_inline(const TypeName *self)                                    \
+  {                                                                                                \
+    return ((u8)self->repr.buf[SSO_INLINE_CAP] & SSO_HEAP_TAG) == 0;                               \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize TypeName##_len(const TypeName *self)                                         \
+  {                                                                                                \
+    return TypeName##_is_inline(self) ? SSO_INLINE_CAP - (u8)self->repr.buf[SSO_INLINE_CAP]        \
+                                      : self->repr.heap.len;                                       \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize TypeName##_cap(const TypeName *self)                                         \
+  {                                                                                                \
+    return TypeName##_is_inline(self) ? SSO_INLINE_CAP : SSO_CAP_DECODE(self->repr.heap.cap_tag);  \
+  }                                                                                                \
+                                                                                                   \
+  static inline char *TypeName##_as_ptr(TypeName *self)                                            \
+  {                                                                                                \
+    return TypeName##_is_inline(self) ? self->repr.buf : self->repr.heap.ptr;                      \
+  }                                                                                                \
+                                                                                                   \
+  static inline const char *TypeName##_as_const_ptr(const TypeName *self)                          \
+  {                                                                                                \
+    return TypeName##_is_inline(self) ? self->repr.buf : self->repr.heap.ptr;                      \
+  }                                                                                                \
+                                                                                                   \
+  /** (内部) 更新长度并写入 '\0', 保留堆标记。 */                                                  \
+  static inline void TypeName##_set_len(TypeName *self, usize len)                                 \
+  {                                                                                                \
+    if (TypeName##_is_inline(self))                                                                \
+    {                                                                                              \
+      /* len == SSO_INLINE_CAP 时两次写入的是同一个字节, 都是 0 */                                 \
+      self->repr.buf[len] = '\0';                                                                  \
+      self->repr.buf[SSO_INLINE_CAP] = (char)(SSO_INLINE_CAP - len);                               \
+    }                                                                                              \
+    else                                                                                           \
+    {                                                                                              \
+      self->repr.heap.len = len;                                                                   \
+      self->repr.heap.ptr[len] = '\0';                                                             \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 2. 生命周期 --- */                                                                        \
+                                                                                                   \
+  static inline void TypeName##_init(TypeName *self, AllocType *alloc)                             \
+  {                                                                                                \
+    self->repr.buf[0] = '\0';                                                                      \
+    self->repr.buf[SSO_INLINE_CAP] = (char)SSO_INLINE_CAP;                                         \
+    self->alloc_state = alloc;                                                                     \
+  }                                                                                                \
+                                                                                                   \
+  static inline TypeName *TypeName##_new(AllocType *alloc)                                         \
+  {                                                                                                \
+    TypeName *self = (TypeName *)ALLOC(AllocPrefix, alloc, LAYOUT_OF(TypeName));                   \
+    TypeName##_init(self, alloc);                                                                  \
+    return self;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 释放堆上的数据 (如果有), 并回到空的内联状态。                                          \
+   */                                                                                              \
+  static inline void TypeName##_deinit(TypeName *self)                                             \
+  {                                                                                                \
+    if (!TypeName##_is_inline(self))                                                               \
+    {                                                                                              \
+      RELEASE(AllocPrefix,                                                                         \
+              self->alloc_state,                                                                   \
+              self->repr.heap.ptr,                                                                 \
+              LAYOUT_OF_ARRAY(char, TypeName##_cap(self) + 1));                                    \
+    }                                                                                              \
+    TypeName##_init(self, self->alloc_state);                                                      \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_destroy(TypeName *self)                                            \
+  {                                                                                                \
+    if (self == NULL)                                                                              \
+      return;                                                                                      \
+    TypeName##_deinit(self);                                                                       \
+    RELEASE(AllocPrefix, self->alloc_state, self, LAYOUT_OF(TypeName));                            \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 3. 容量 --- */                                                                            \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 确保至少能容纳 new_cap 个字节 (不含 '\0')。                                            \
+   * 第一次超过 SSO_INLINE_CAP 时, 数据从内联缓冲区搬到堆上。                                      \
+   */                                                                                              \
+  static inline void TypeName##_reserve_to(TypeName *self, usize new_cap)                          \
+  {                                                                                                \
+    if (new_cap <= TypeName##_cap(self))                                                           \
+      return;                                                                                      \
+    usize len = TypeName##_len(self);                                                              \
+    Layout new_layout = LAYOUT_OF_ARRAY(char, new_cap + 1);                                        \
+    if (TypeName##_is_inline(self))                                                                \
+    {                                                                                              \
+      char *ptr = (char *)ALLOC(AllocPrefix, self->alloc_state, new_layout);                       \
+      memcpy(ptr, self->repr.buf, len + 1);                                                        \
+      self->repr.heap.ptr = ptr;                                                                   \
+      self->repr.heap.len = len;                                                                   \
+    }                                                                                              \
+    else                                                                                           \
+    {                                                                                              \
+      Layout old_layout = LAYOUT_OF_ARRAY(char, TypeName##_cap(self) + 1);                         \
+      (void)old_layout;                                                                            \
+      self->repr.heap.ptr = (char *)REALLOC(                                                       \
+        AllocPrefix, self->alloc_state, self->repr.heap.ptr, old_layout, new_layout);              \
+    }                                                                                              \
+    self->repr.heap.cap_tag = SSO_CAP_ENCODE(new_cap);                                             \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_reserve_more(TypeName *self, usize additional)                     \
+  {                                                                                                \
+    usize len = TypeName##_len(self);                                                              \
+    usize cap = TypeName##_cap(self);                                                              \
+    if (len + additional <= cap)                                                                   \
+      return;                                                                                      \
+    usize required_cap = len + additional;                                                         \
+    usize new_cap = cap * 2;                                                                       \
+    if (new_cap < required_cap)                                                                    \
+    {                                                                                              \
+      new_cap = required_cap;                                                                      \
+    }                                                                                              \
+    TypeName##_reserve_to(self, new_cap);                                                          \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 4. 访问与追加 --- */                                                                      \
+                                                                                                   \
+  static inline void TypeName##_push(TypeName *self, char c)                                       \
+  {                                                                                                \
+    TypeName##_reserve_more(self, 1);                                                              \
+    usize len = TypeName##_len(self);                                                              \
+    TypeName##_as_ptr(self)[len] = c;                                                              \
+    TypeName##_set_len(self, len + 1);                                                             \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 清空内容, 但保留已分配的堆容量。 */                                                   \
+  static inline void TypeName##_clear(TypeName *self)                                              \
+  {                                                                                                \
+    TypeName##_set_len(self, 0);                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_push_bytes(TypeName *self, const char *bytes, usize len)           \
+  {                                                                                                \
+    if (len == 0)                                                                                  \
+      return;                                                                                      \
+    TypeName##_reserve_more(self, len);                                                            \
+    usize old_len = TypeName##_len(self);                                                          \
+    memcpy(TypeName##_as_ptr(self) + old_len, bytes, len);                                         \
+    TypeName##_set_len(self, old_len + len);                                                       \
+  }                                                                                                \
+                                                                                                   \
+  static inline void TypeName##_push_str(TypeName *self, str s)                                    \
+  {                                                                                                \
+    TypeName##_push_bytes(self, s, str_len(s));                                                    \
+  }                                                                                                \
+                                                                                                   \
+  static inline str TypeName##_as_str(const TypeName *self)                                        \
+  {                                                                                                \
+    return TypeName##_as_const_ptr(self);                                                          \
+  }                                                                                                \
+                                                                                                   \
+  static inline TypeName *TypeName##_new_from_str(AllocType *alloc, str s)                         \
+  {                                                                                                \
+    TypeName *self = TypeName##_new(alloc);                                                        \
+    TypeName##_push_str(self, s);                                                                  \
+    return self;                                                                                   \
+  }
+
+/**
+ * @brief (实例 3) "sso_sstring" (SystemAlloc SSO String)
+ */
+DEFINE_SSO_STRING(sso_sstring, SystemAlloc, SYSTEM)
+
+/**
+ * @brief (实例 4) "sso_bstring" (BumpAlloc SSO String)
+ */
+DEFINE_SSO_STRING(sso_bstring, Bump, BUMP)
+
+/* --- sso_sstring Adapters --- */
+static inline void
+sso_sstring_push_char_adapter(void *sink, char c)
+{
+  sso_sstring_push((sso_sstring *)sink, c);
+}
+static inline void
+sso_sstring_push_bytes_adapter(void *sink, const char *bytes, usize len)
+{
+  sso_sstring_push_bytes((sso_sstring *)sink, bytes, len);
+}
+
+/* --- sso_bstring Adapters --- */
+static inline void
+sso_bstring_push_char_adapter(void *sink, char c)
+{
+  sso_bstring_push((sso_bstring *)sink, c);
+}
+static inline void
+sso_bstring_push_bytes_adapter(void *sink, const char *bytes, usize len)
+{
+  sso_bstring_push_bytes((sso_bstring *)sink, bytes, len);
+}
+static inline void
+sso_sstring_reserve_adapter(void *sink, usize additional)
+{
+  sso_sstring *self = (sso_sstring *)sink;
+  sso_sstring_reserve_to(self, sso_sstring_len(self) + additional);
+}
+static inline void
+sso_bstring_reserve_adapter(void *sink, usize additional)
+{
+  sso_bstring *self = (sso_bstring *)sink;
+  sso_bstring_reserve_to(self, sso_bstring_len(self) + additional);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* src/std/test/bench.h */
+#pragma once
+
+/**
+ * @file
+ * @brief 极简的基准测试工具 (供 benches/ 使用)。
+ *
+ * @example
+ * BENCH("s_format", 1000000, {
+ * sstring_clear(s);
+ * s_format(s, "{} {}", i, x);
+ * });
+ */
+
+#include <core/fmt/tofile.h> // format_to_file
+#include <core/type.h>       // u64, f64, str
+#include <stdio.h>           // stdout
+#include <time.h>            // clock_gettime, timespec_get
+
+/**
+ * @brief 单调时钟的纳秒时间戳 (不受 NTP 调整墙上时间的影响)。
+ *
+ * 优先用 POSIX 的 CLOCK_MONOTONIC, 其次是 C23 的 TIME_MONOTONIC;
+ * 两者都没有时才退回墙上时间 TIME_UTC。
+ */
+static inline u64
+bench_now_ns(void)
+{
+  struct timespec ts;
+#if defined(CLOCK_MONOTONIC)
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#elif defined(TIME_MONOTONIC)
+  timespec_get(&ts, TIME_MONOTONIC);
+#else
+  timespec_get(&ts, TIME_UTC);
+#endif
+  return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+/** @brief 阻止编译器把 ptr 指向的计算当作死代码消除。 */
+static inline void
+bench_clobber(const void *ptr)
+{
+  __asm__ volatile("" : : "r"(ptr) : "memory");
+}
+
+/** @brief 打印一行结果: 名字, 每次耗时, 每秒次数。 */
+static inline void
+bench_report(str name, u64 iters, u64 elapsed_ns)
+{
+  f64 ns_per_op = (f64)elapsed_ns / (f64)iters;
+  f64 mops = ns_per_op > 0 ? 1000.0 / ns_per_op : 0;
+  /* 保留两位小数, 最短表示会去掉多余的 0 */
+  ns_per_op = (f64)(u64)(ns_per_op * 100 + 0.5) / 100;
+  mops = (f64)(u64)(mops * 100 + 0.5) / 100;
+  format_to_file(stdout, "  {}: {} ns/op, {} Mops/s\n", name, ns_per_op, mops);
+}
+
+/**
+ * @brief (宏) 把 body 重复执行 iters 次并打印耗时。
+ */
+#define BENCH(name, iters, ...)                                                                    \
+  do                                                                                               \
+  {                                                                                                \
+    u64 __bench_iters = (iters);                                                                   \
+    u64 __bench_t0 = bench_now_ns();                                                               \
+    for (u64 __bench_i = 0; __bench_i < __bench_iters; __bench_i++)                                \
+    {                                                                                              \
+      __VA_ARGS__                                                                                  \
+    }                                                                                              \
+    bench_report((name), __bench_iters, bench_now_ns() - __bench_t0);                              \
+  } while (0)
+
+/** @brief 打印一个基准分组的标题。 */
+#define BENCH_GROUP(name) format_to_file(stdout, "\n--- Bench: {} ---\n", (str)(name))
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/thread/epoch.h>
+
+#include <core/msg/asrt.h> // asrt_msg
+#include <string.h>        // memset
+#include <threads.h>       // mtx_t
+
+struct EpochDomain
+{
+  alignas(64) _Atomic u64 epoch;
+  alignas(64) _Atomic(EpochHandle *) handles; /* 只增不减的链表 */
+
+  mtx_t orphan_lock;
+  EpochBag orphans; /* 已注销线程留下的对象 */
+
+  SystemAlloc *backing_alloc;
+};
+
+/*
+ * ===================================================================
+ * 1. epoch 推进
+ * ===================================================================
+ */
+
+/* 所有已 pin 的参与者都看到了当前 epoch 时, 把它加一 */
+static void
+epoch_try_advance(EpochDomain *d)
+{
+  u64 e = atomic_load_explicit(&d->epoch, memory_order_relaxed);
+  /* 与 epoch_pin 中的交换配对: 要么看到对方已 pin, 要么对方之后读到的是新 epoch */
+  atomic_thread_fence(memory_order_seq_cst);
+
+  EpochHandle *h = atomic_load_explicit(&d->handles, memory_order_acquire);
+  for (; h != NULL; h = h->next)
+  {
+    u64 local = atomic_load_explicit(&h->local, memory_order_relaxed);
+    if ((local & 1) != 0 && (local >> 1) != e)
+      return;
+  }
+  atomic_thread_fence(memory_order_acquire);
+  atomic_compare_exchange_strong_explicit(
+    &d->epoch, &e, e + 1, memory_order_release, memory_order_relaxed);
+}
+
+/* 释放 bag 中所有在 epoch + 2 <= now 时退休的对象 */
+static usize
+bag_release_safe(EpochBag *bag, u64 now)
+{
+  usize freed = 0;
+  EpochRetired *front = EpochBag_front(bag);
+  while (front != NULL && front->epoch + 2 <= now)
+  {
+    EpochRetired r = *front;
+    EpochBag_pop_front(bag, NULL);
+    r.release(r.alloc, r.ptr, r.layout);
+    freed++;
+    front = EpochBag_front(bag);
+  }
+  return freed;
+}
+
+/*
+ * 与 bag_release_safe 相同, 但扫描整个 bag。孤儿来自不同的句柄, 按注销顺序追加,
+ * 不按 epoch 有序: 在第一个还不安全的对象处停下, 会把排在它后面的更旧的对象一直留到
+ * epoch_domain_free。
+ */
+static usize
+bag_release_safe_unordered(EpochBag *bag, u64 now)
+{
+  usize freed = 0;
+  for (usize n = EpochBag_len(bag); n > 0; n--)
+  {
+    EpochRetired r;
+    EpochBag_pop_front(bag, &r);
+    if (r.epoch + 2 <= now)
+    {
+      r.release(r.alloc, r.ptr, r.layout);
+      freed++;
+    }
+    else
+    {
+      EpochBag_push_back(bag, r);
+    }
+  }
+  return freed;
+}
+
+static void
+bag_release_all(EpochBag *bag)
+{
+  EpochRetired r;
+  while (EpochBag_pop_front(bag, &r))
+  {
+    r.release(r.alloc, r.ptr, r.layout);
+  }
+}
+
+/*
+ * ===================================================================
+ * 2. 退休与回收
+ * ===================================================================
+ */
+
+usize
+epoch_collect(EpochHandle *h)
+{
+  EpochDomain *d = h->domain;
+  epoch_try_advance(d);
+  u64 now = atomic_load_explicit(&d->epoch, memory_order_acquire);
+
+  usize freed = bag_release_safe(&h->bag, now);
+  h->next_collect = EpochBag_len(&h->bag) + EPOCH_COLLECT_THRESHOLD;
+
+  /* 顺带处理已注销线程留下的对象; 别人正在处理时跳过 */
+  if (mtx_trylock(&d->orphan_lock) == thrd_success)
+  {
+    freed += bag_release_safe_unordered(&d->orphans, now);
+    mtx_unlock(&d->orphan_lock);
+  }
+  return freed;
+}
+
+void
+epoch_retire(EpochHandle *h, anyptr ptr, Layout layout, AllocReleaseFn release, void *alloc)
+{
+  /* 对象在此之前已被摘下; 屏障保证读到的 epoch 不早于摘下的时刻 */
+  atomic_thread_fence(memory_order_seq_cst);
+  u64 e = atomic_load_explicit(&h->domain->epoch, memory_order_relaxed);
+  EpochBag_push_back(&h->bag,
+                     (EpochRetired){
+                       .ptr = ptr,
+                       .layout = layout,
+                       .release = release,
+                       .alloc = alloc,
+                       .epoch = e,
+                     });
+  if (EpochBag_len(&h->bag) >= h->next_collect)
+  {
+    epoch_collect(h);
+  }
+}
+
+usize
+epoch_pending(const EpochHandle *h)
+{
+  return EpochBag_len(&h->bag);
+}
+
+u64
+epoch_current(const EpochDomain *self)
+{
+  return atomic_load_explicit(&self->epoch, memory_order_relaxed);
+}
+
+/*
+ * ===================================================================
+ * 3. 参与者
+ * ===================================================================
+ */
+
+EpochHandle *
+epoch_register(EpochDomain *self)
+{
+  /* 先尝试复用已注销的句柄 */
+  EpochHandle *h = atomic_load_explicit(&self->handles, memory_order_acquire);
+  for (; h != NULL; h = h->next)
+  {
+    bool expected = false;
+    if (!atomic_load_explicit(&h->in_use, memory_order_relaxed) &&
+        atomic_compare_exchange_strong(&h->in_use, &expected, true))
+    {
+      return h;
+    }
+  }
+
+  h = (EpochHandle *)ALLOC(SYSTEM, self->backing_alloc, LAYOUT_OF(EpochHandle));
+  atomic_init(&h->local, 0);
+  h->global = &self->epoch;
+  h->nest = 0;
+  EpochBag_init(&h->bag, self->backing_alloc);
+  h->next_collect = EPOCH_COLLECT_THRESHOLD;
+  h->domain = self;
+  atomic_init(&h->in_use, true);
+
+  EpochHandle *head = atomic_load_explicit(&self->handles, memory_order_relaxed);
+  do
+  {
+    h->next = head;
+  } while (!atomic_compare_exchange_weak_explicit(
+    &self->handles, &head, h, memory_order_release, memory_order_relaxed));
+  return h;
+}
+
+void
+epoch_unregister(EpochHandle *h)
+{
+  asrt_msg(h->nest == 0, "epoch_unregister called while pinned");
+  epoch_collect(h);
+
+  if (EpochBag_len(&h->bag) != 0)
+  {
+    EpochDomain *d = h->domain;
+    mtx_lock(&d->orphan_lock);
+    EpochRetired r;
+    while (EpochBag_pop_front(&h->bag, &r))
+    {
+      EpochBag_push_back(&d->orphans, r);
+    }
+    mtx_unlock(&d->orphan_lock);
+  }
+  h->next_collect = EPOCH_COLLECT_THRESHOLD;
+  atomic_store_explicit(&h->in_use, false, memory_order_release);
+}
+
+/*
+ * ===================================================================
+ * 4. 创建与销毁
+ * ===================================================================
+ */
+
+Option_EpochDomainPtr
+epoch_domain_new(SystemAlloc *backing_alloc)
+{
+  Layout layout = LAYOUT_OF(EpochDomain);
+  Option_anyptr mem = sys_aligned_alloc(layout.align, layout.size);
+  if (ois_none(mem))
+  {
+    return None(EpochDomainPtr);
+  }
+  EpochDomain *self = (EpochDomain *)mem.value.some;
+  memset(self, 0, layout.size);
+  self->backing_alloc = backing_alloc;
+  atomic_init(&self->epoch, 0);
+  atomic_init(&self->handles, NULL);
+  mtx_init(&self->orphan_lock, mtx_plain);
+  EpochBag_init(&self->orphans, backing_alloc);
+  return Some(EpochDomainPtr, self);
+}
+
+void
+epoch_domain_free(EpochDomain *self)
+{
+  if (self == NULL)
+  {
+    return;
+  }
+  EpochHandle *h = atomic_load_explicit(&self->handles, memory_order_acquire);
+  while (h != NULL)
+  {
+    asrt_msg(h->nest == 0, "epoch_domain_free called while a handle is pinned");
+    EpochHandle *next = h->next;
+    bag_release_all(&h->bag);
+    EpochBag_deinit(&h->bag);
+    RELEASE(SYSTEM, self->backing_alloc, h, LAYOUT_OF(EpochHandle));
+    h = next;
+  }
+  bag_release_all(&self->orphans);
+  EpochBag_deinit(&self->orphans);
+  mtx_destroy(&self->orphan_lock);
+  RELEASE(SYSTEM, self->backing_alloc, self, LAYOUT_OF(EpochDomain));
+}
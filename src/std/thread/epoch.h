@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Impl) 基于 epoch 的延迟回收 (EBR)。
+ *
+ * 无锁结构把节点摘下之后, 别的线程可能还持有指向它的指针, 不能立即释放。
+ * EBR 的做法:
+ *
+ * - 读者在访问共享结构前 epoch_pin, 结束后 epoch_unpin (pin 时记下全局 epoch);
+ * - 写者摘下节点后 epoch_retire, 节点连同当时的全局 epoch 一起放进本线程的回收袋;
+ * - 只有当所有处于 pin 状态的线程都已看到当前 epoch 时, 全局 epoch 才能前进;
+ *   在 epoch e 退休的节点, 等全局 epoch 到达 e + 2 时就不可能再被任何读者引用,
+ *   此时按批调用它的释放函数。
+ *
+ * pin / unpin 是内联的: 一次原子交换和一次 release 存储, 不写任何共享的缓存行。
+ *
+ * 每个线程通过 epoch_register 取得自己的 EpochHandle, 句柄不能跨线程使用。
+ *
+ * @example
+ * EpochHandle *h = epoch_register(domain);
+ * epoch_pin(h);
+ * Node *n = atomic_load(&stack->head);     // 读者可以安全地解引用 n
+ * ...
+ * epoch_unpin(h);
+ *
+ * DEFINE_ALLOC_RELEASER(SystemAlloc, SYSTEM)
+ * EPOCH_RETIRE(h, SYSTEM, &sys, old, LAYOUT_OF(Node)); // 摘下之后
+ */
+
+#include <core/mem/allocer.h> // AllocReleaseFn, ALLOC_RELEASER
+#include <core/mem/layout.h>  // Layout
+#include <core/mem/sysalc.h>  // SystemAlloc
+#include <core/option.h>      // Option
+#include <core/type.h>        // usize, u64, anyptr
+#include <std/deque.h>        // DEFINE_DEQUE
+#include <stdatomic.h>
+
+/** @brief 回收袋中的对象数每增长这么多, 就尝试推进 epoch 并释放一次。 */
+#define EPOCH_COLLECT_THRESHOLD 64
+
+/**
+ * @brief (内部) 一个等待释放的对象。
+ */
+typedef struct EpochRetired
+{
+  anyptr ptr;
+  Layout layout;
+  AllocReleaseFn release;
+  void *alloc;
+  u64 epoch; /* 退休时的全局 epoch */
+} EpochRetired;
+
+DEFINE_DEQUE(EpochBag, EpochRetired, SystemAlloc, SYSTEM)
+
+/**
+ * @brief 回收域 (不透明类型): 全局 epoch 与所有参与线程。
+ */
+typedef struct EpochDomain EpochDomain;
+
+DEFINE_OPTION(EpochDomainPtr, EpochDomain *);
+
+/**
+ * @brief 每线程的参与者句柄。字段仅供内联的 pin / unpin 使用。
+ */
+typedef struct EpochHandle
+{
+  alignas(64) _Atomic u64 local; /* (epoch << 1) | 1 表示已 pin, 0 表示未 pin */
+  _Atomic u64 *global;           /* 所属域的全局 epoch */
+  usize nest;                    /* pin 的嵌套层数 */
+  EpochBag bag;                  /* 按 epoch 递增排列 */
+  usize next_collect;            /* bag 长度到达此值时自动回收 */
+  EpochDomain *domain;
+  _Atomic bool in_use;
+  struct EpochHandle *next; /* 域内句柄链表 (发布后不再修改) */
+} EpochHandle;
+
+/*
+ * ===================================================================
+ * 1. 域与参与者
+ * ===================================================================
+ */
+
+/**
+ * @brief 创建回收域。
+ * @return Some(EpochDomain*) 成功, None 失败 (OOM)。
+ */
+Option_EpochDomainPtr epoch_domain_new(SystemAlloc *backing_alloc);
+
+/**
+ * @brief 立即释放所有尚未释放的对象, 然后释放回收域与所有句柄。
+ * @note 调用时不能有线程处于 pin 状态, 之后所有句柄失效。
+ */
+void epoch_domain_free(EpochDomain *self);
+
+/**
+ * @brief 为当前线程注册一个参与者 (优先复用已注销的句柄)。
+ */
+EpochHandle *epoch_register(EpochDomain *self);
+
+/**
+ * @brief 注销参与者: 尽量释放回收袋, 剩下的对象交给域, 由其他线程日后释放。
+ * @note 调用时不能处于 pin 状态。
+ */
+void epoch_unregister(EpochHandle *h);
+
+/**
+ * @brief 当前的全局 epoch。
+ */
+u64 epoch_current(const EpochDomain *self);
+
+/*
+ * ===================================================================
+ * 2. 读路径
+ * ===================================================================
+ */
+
+/**
+ * @brief 进入临界区 (可以嵌套)。在 epoch_unpin 之前读到的共享指针不会被释放。
+ */
+static inline void
+epoch_pin(EpochHandle *h)
+{
+  if (h->nest++ != 0)
+    return;
+  u64 e = atomic_load_explicit(h->global, memory_order_relaxed);
+  /* 交换自带全屏障: 之后对共享结构的读取不会被提前到 pin 之前 */
+  atomic_exchange_explicit(&h->local, (e << 1) | 1, memory_order_seq_cst);
+}
+
+/**
+ * @brief 离开临界区。
+ */
+static inline void
+epoch_unpin(EpochHandle *h)
+{
+  if (--h->nest == 0)
+  {
+    atomic_store_explicit(&h->local, 0, memory_order_release);
+  }
+}
+
+/** @brief 当前是否处于 pin 状态。 */
+static inline bool
+epoch_is_pinned(const EpochHandle *h)
+{
+  return h->nest != 0;
+}
+
+/*
+ * ===================================================================
+ * 3. 退休与回收
+ * ===================================================================
+ */
+
+/**
+ * @brief 登记一个已从共享结构中摘下的对象; 安全后调用 release(alloc, ptr, layout)。
+ *
+ * 回收袋每增长 EPOCH_COLLECT_THRESHOLD 个对象, 自动调用一次 epoch_collect。
+ */
+void epoch_retire(EpochHandle *h, anyptr ptr, Layout layout, AllocReleaseFn release, void *alloc);
+
+/**
+ * @brief 尝试推进全局 epoch, 然后释放本线程 (以及已注销线程) 中所有已安全的对象。
+ * @return 本次释放的对象数。
+ */
+usize epoch_collect(EpochHandle *h);
+
+/**
+ * @brief 本线程回收袋中尚未释放的对象数。
+ */
+usize epoch_pending(const EpochHandle *h);
+
+/**
+ * @brief 通过分配器 Trait 延迟释放 ptr (需要先 DEFINE_ALLOC_RELEASER 同一个前缀)。
+ */
+#define EPOCH_RETIRE(h, AllocPrefix, alloc, ptr, layout)                                           \
+  epoch_retire((h), (ptr), (layout), ALLOC_RELEASER(AllocPrefix), (alloc))
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/thread/parallel.h>
+
+typedef struct ForJob
+{
+  Range r;
+  usize grain;
+  RangeBodyFn body;
+  void *ctx;
+} ForJob;
+
+static void
+for_task(void *arg)
+{
+  ForJob *job = (ForJob *)arg;
+  Range r = job->r;
+  if (r.end - r.start <= job->grain)
+  {
+    job->body(job->ctx, r);
+    return;
+  }
+  usize mid = r.start + (r.end - r.start) / 2;
+  ForJob left = *job;
+  ForJob right = *job;
+  left.r = range(r.start, mid);
+  right.r = range(mid, r.end);
+  StealTask *task = steal_spawn(for_task, &left);
+  for_task(&right);
+  steal_join(task);
+}
+
+void
+parallel_for_range(StealPool *pool, Range r, usize grain, RangeBodyFn body, void *ctx)
+{
+  if (r.start >= r.end)
+  {
+    return;
+  }
+  usize len = r.end - r.start;
+  grain = parallel_grain(pool, len, grain);
+  if (len <= grain || steal_pool_threads(pool) == 1)
+  {
+    /* 顺序执行时不必二分, 直接按 grain 切块 */
+    for (usize start = r.start; start < r.end; start += grain)
+    {
+      usize end = r.end - start > grain ? start + grain : r.end;
+      body(ctx, range(start, end));
+    }
+    return;
+  }
+  ForJob job = {.r = r, .grain = grain, .body = body, .ctx = ctx};
+  steal_pool_run(pool, for_task, &job);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief 在 StealPool 上并行遍历 Range。
+ *
+ * for_range_in 的并行版本: 把 Range 递归二分, 直到子区间不超过 grain,
+ * 左半 spawn 出去, 右半就地处理。空闲线程窃取到的总是最大的未处理区间,
+ * 所以不均匀的负载也能自动平衡。
+ *
+ * - `parallel_for_range`: 对每个子区间调用 body(ctx, sub_range);
+ * - `DEFINE_PARALLEL_REDUCE`: 每个子区间折叠出一个值, 再按区间顺序两两合并。
+ *
+ * grain 为 0 时自动选择: 大约每个线程 PARALLEL_CHUNKS_PER_THREAD 块,
+ * 但不小于 PARALLEL_MIN_GRAIN 个元素 (每个元素很重时请显式传入 grain)。
+ *
+ * @example
+ * // 原来: for_range_in(i, range(0, vec.len)) { vec.data[i] *= 2; }
+ * static void scale(void *ctx, Range r) { Vec *v = ctx; for_range_in(i, r) { v->data[i] *= 2; } }
+ * parallel_for_range(pool, range(0, vec.len), 0, scale, &vec);
+ */
+
+#include <core/math/range.h>  // Range
+#include <core/type.h>        // usize
+#include <std/thread/steal.h> // StealPool, steal_spawn, steal_join
+
+/** @brief 自动 grain: 每个线程期望分到的块数 (多于 1, 留出负载均衡的余地)。 */
+#define PARALLEL_CHUNKS_PER_THREAD 8
+
+/** @brief 自动 grain 的下限: 更小的块 spawn / join 的开销会超过工作本身。 */
+#define PARALLEL_MIN_GRAIN 256
+
+/**
+ * @brief 子区间处理函数: 处理 r 中的每个下标。
+ */
+typedef void (*RangeBodyFn)(void *ctx, Range r);
+
+/**
+ * @brief 实际使用的 grain (grain 为 0 时按长度和线程数自动选择, 结果至少为 1)。
+ */
+static inline usize
+parallel_grain(const StealPool *pool, usize len, usize grain)
+{
+  if (grain != 0)
+    return grain;
+  usize chunks = steal_pool_threads(pool) * PARALLEL_CHUNKS_PER_THREAD;
+  usize g = len / chunks;
+  return g < PARALLEL_MIN_GRAIN ? PARALLEL_MIN_GRAIN : g;
+}
+
+/**
+ * @brief 并行处理 r: 递归二分直到子区间长度不超过 grain, 对每个子区间调用 body。
+ *
+ * 子区间两两不相交, 长度都不超过 grain, 并且恰好覆盖 r。pool 为 NULL 或只有一个线程时,
+ * 在调用线程中按顺序处理各块, 不经过任务调度。可以在 StealPool 的任务中嵌套调用。
+ *
+ * @param grain 子区间的最大长度; 0 表示自动选择。
+ */
+void parallel_for_range(StealPool *pool, Range r, usize grain, RangeBodyFn body, void *ctx);
+
+/**
+ * @brief (Template) 生成一个并行归约函数:
+ * `T Name(StealPool *pool, Range r, usize grain, T identity, void *ctx)`。
+ *
+ * 每个子区间的结果是 FN_BODY(ctx, sub_range, identity), 相邻子区间的结果
+ * 按区间顺序用 FN_COMBINE(left, right) 合并, 所以 FN_COMBINE 只需满足结合律。
+ * 划分只取决于 r 和 grain: 显式给出 grain 时, 结果 (包括浮点求和的舍入)
+ * 与线程数无关。
+ *
+ * @param Name       生成的函数名
+ * @param T          结果类型
+ * @param FN_BODY    签名为 `T (*)(void *ctx, Range r, T acc)`: 把 r 中的元素折叠进 acc
+ * @param FN_COMBINE 签名为 `T (*)(T left, T right)`
+ */
+#define DEFINE_PARALLEL_REDUCE(Name, T, FN_BODY, FN_COMBINE)                                       \
+                                                                                                   \
+  typedef struct Name##_Job                                                                        \
+  {                                                                                                \
+    Range r;                                                                                       \
+    usize grain;                                                                                   \
+    void *ctx;                                                                                     \
+    T identity;                                                                                    \
+    T result;                                                                                      \
+  } Name##_Job;                                                                                    \
+                                                                                                   \
+  static void Name##_task(void *arg)                                                               \
+  {                                                                                                \
+    Name##_Job *job = (Name##_Job *)arg;                                                           \
+    Range r = job->r;                                                                              \
+    if (r.end - r.start <= job->grain)                                                             \
+    {                                                                                              \
+      job->result = FN_BODY(job->ctx, r, job->identity);                                           \
+      return;                                                                                      \
+    }                                                                                              \
+    usize mid = r.start + (r.end - r.start) / 2;                                                   \
+    Name##_Job left = *job;                                                                        \
+    Name##_Job right = *job;                                                                       \
+    left.r = range(r.start, mid);                                                                  \
+    right.r = range(mid, r.end);                                                                   \
+    StealTask *task = steal_spawn(Name##_task, &left);                                             \
+    Name##_task(&right);                                                                           \
+    steal_join(task);                                                                              \
+    job->result = FN_COMBINE(left.result, right.result);                                           \
+  }                                                                                                \
+                                                                                                   \
+  static inline T Name(StealPool *pool, Range r, usize grain, T identity, void *ctx)               \
+  {                                                                                                \
+    if (r.start >= r.end)                                                                          \
+      return identity;                                                                             \
+    Name##_Job job = {                                                                             \
+      .r = r,                                                                                      \
+      .grain = parallel_grain(pool, r.end - r.start, grain),                                       \
+      .ctx = ctx,                                                                                  \
+      .identity = identity,                                                                        \
+      .result = identity,                                                                          \
+    };                                                                                             \
+    steal_pool_run(pool, Name##_task, &job);                                                       \
+    return job.result;                                                                             \
+  }
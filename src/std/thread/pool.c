@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/thread/pool.h>
+
+#include <core/mem/allocer.h> // RELEASE
+#include <core/mem/layout.h>  // LAYOUT_OF
+#include <stdatomic.h>
+#include <string.h>  // memset
+#include <threads.h> // thrd_t, mtx_t, cnd_t
+#include <unistd.h>  // sysconf
+
+/*
+ * ===================================================================
+ * 1. 数据结构
+ * ===================================================================
+ */
+
+struct ThreadPool
+{
+  /* 当前的任务批次 (在 lock 保护下发布) */
+  PoolTaskFn fn;
+  void *ctx;
+  usize n_tasks;
+  alignas(64) _Atomic usize next; /* 下一个待领取的任务下标 */
+
+  alignas(64) mtx_t lock;
+  cnd_t wake;    /* 新批次 / 停止 */
+  cnd_t idle;    /* active 归零 */
+  u64 epoch;     /* 每发布一批加一 */
+  usize active;  /* 正在处理当前批次的工作线程数 */
+  bool stop;
+
+  mtx_t run_lock; /* 串行化并发的 pool_run */
+
+  usize nthreads; /* 包括调用者 */
+  thrd_t *workers;
+  SystemAlloc *backing_alloc;
+};
+
+/* 当前线程是否正在执行某个池的任务 (嵌套的 pool_run 顺序执行) */
+static thread_local bool t_in_task = false;
+
+/*
+ * ===================================================================
+ * 2. 执行
+ * ===================================================================
+ */
+
+/* 领取并执行任务, 直到当前批次被领完 */
+static void
+pool_drain(ThreadPool *self, PoolTaskFn fn, void *ctx, usize n_tasks)
+{
+  t_in_task = true;
+  for (;;)
+  {
+    usize i = atomic_fetch_add_explicit(&self->next, 1, memory_order_relaxed);
+    if (i >= n_tasks)
+    {
+      break;
+    }
+    fn(ctx, i);
+  }
+  t_in_task = false;
+}
+
+static int
+worker_main(void *arg)
+{
+  ThreadPool *self = (ThreadPool *)arg;
+  u64 seen = 0;
+
+  mtx_lock(&self->lock);
+  for (;;)
+  {
+    while (!self->stop && self->epoch == seen)
+    {
+      cnd_wait(&self->wake, &self->lock);
+    }
+    if (self->stop)
+    {
+      break;
+    }
+
+    /* 在锁内登记: 发布者在 active 归零前不会重置 next */
+    seen = self->epoch;
+    PoolTaskFn fn = self->fn;
+    void *ctx = self->ctx;
+    usize n_tasks = self->n_tasks;
+    self->active++;
+    mtx_unlock(&self->lock);
+
+    pool_drain(self, fn, ctx, n_tasks);
+
+    mtx_lock(&self->lock);
+    if (--self->active == 0)
+    {
+      cnd_signal(&self->idle);
+    }
+  }
+  mtx_unlock(&self->lock);
+  return 0;
+}
+
+void
+pool_run(ThreadPool *self, usize n_tasks, PoolTaskFn fn, void *ctx)
+{
+  if (self == NULL || self->nthreads == 1 || n_tasks <= 1 || t_in_task)
+  {
+    for (usize i = 0; i < n_tasks; i++)
+    {
+      fn(ctx, i);
+    }
+    return;
+  }
+
+  mtx_lock(&self->run_lock);
+
+  /*
+   * 上一批次返回后仍可能有迟到的工作线程在锁内登记并拷走旧的 fn/ctx/n_tasks;
+   * 必须等它们全部离开再重置 next, 否则它们会把旧批次的 fn 用在新批次的下标上。
+   */
+  mtx_lock(&self->lock);
+  while (self->active != 0)
+  {
+    cnd_wait(&self->idle, &self->lock);
+  }
+  self->fn = fn;
+  self->ctx = ctx;
+  self->n_tasks = n_tasks;
+  atomic_store_explicit(&self->next, 0, memory_order_relaxed);
+  self->epoch++;
+  cnd_broadcast(&self->wake);
+  mtx_unlock(&self->lock);
+
+  pool_drain(self, fn, ctx, n_tasks);
+
+  /* 所有下标都已被领取; 被工作线程领走的任务在它们离开 (active 归零) 前完成 */
+  mtx_lock(&self->lock);
+  while (self->active != 0)
+  {
+    cnd_wait(&self->idle, &self->lock);
+  }
+  mtx_unlock(&self->lock);
+
+  mtx_unlock(&self->run_lock);
+}
+
+/*
+ * ===================================================================
+ * 3. 创建与销毁
+ * ===================================================================
+ */
+
+usize
+pool_hardware_threads(void)
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (usize)n : 1;
+}
+
+usize
+pool_threads(const ThreadPool *self)
+{
+  return self == NULL ? 1 : self->nthreads;
+}
+
+/* 停止并回收前 count 个工作线程 */
+static void
+pool_join_workers(ThreadPool *self, usize count)
+{
+  mtx_lock(&self->lock);
+  self->stop = true;
+  cnd_broadcast(&self->wake);
+  mtx_unlock(&self->lock);
+
+  for (usize i = 0; i < count; i++)
+  {
+    thrd_join(self->workers[i], NULL);
+  }
+}
+
+static void
+pool_release(ThreadPool *self)
+{
+  if (self->workers != NULL)
+  {
+    RELEASE(SYSTEM, self->backing_alloc, self->workers, LAYOUT_OF_ARRAY(thrd_t, self->nthreads));
+  }
+  mtx_destroy(&self->run_lock);
+  cnd_destroy(&self->idle);
+  cnd_destroy(&self->wake);
+  mtx_destroy(&self->lock);
+  RELEASE(SYSTEM, self->backing_alloc, self, LAYOUT_OF(ThreadPool));
+}
+
+Option_ThreadPoolPtr
+pool_new(SystemAlloc *backing_alloc, usize nthreads)
+{
+  /* 直接用 sys_aligned_alloc: SYSTEM_ALLOC 在 OOM 时 panic, 这里要返回 None */
+  Layout layout = LAYOUT_OF(ThreadPool);
+  Option_anyptr mem = sys_aligned_alloc(layout.align, layout.size);
+  if (ois_none(mem))
+  {
+    return None(ThreadPoolPtr);
+  }
+  ThreadPool *self = (ThreadPool *)mem.value.some;
+  memset(self, 0, layout.size);
+
+  self->backing_alloc = backing_alloc;
+  self->nthreads = nthreads == 0 ? pool_hardware_threads() : nthreads;
+  atomic_init(&self->next, 0);
+  mtx_init(&self->lock, mtx_plain);
+  cnd_init(&self->wake);
+  cnd_init(&self->idle);
+  mtx_init(&self->run_lock, mtx_plain);
+
+  Layout workers_layout = LAYOUT_OF_ARRAY(thrd_t, self->nthreads);
+  Option_anyptr workers = sys_aligned_alloc(workers_layout.align, workers_layout.size);
+  if (ois_none(workers))
+  {
+    pool_release(self);
+    return None(ThreadPoolPtr);
+  }
+  self->workers = (thrd_t *)workers.value.some;
+
+  for (usize i = 0; i + 1 < self->nthreads; i++)
+  {
+    if (thrd_create(&self->workers[i], worker_main, self) != thrd_success)
+    {
+      pool_join_workers(self, i);
+      pool_release(self);
+      return None(ThreadPoolPtr);
+    }
+  }
+  return Some(ThreadPoolPtr, self);
+}
+
+void
+pool_free(ThreadPool *self)
+{
+  if (self == NULL)
+  {
+    return;
+  }
+  pool_join_workers(self, self->nthreads - 1);
+  pool_release(self);
+}
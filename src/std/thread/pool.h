@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Impl) 固定大小的线程池。
+ *
+ * `pool_run(pool, n, fn, ctx)` 把 fn(ctx, 0) ... fn(ctx, n - 1) 分给池中的
+ * 线程执行, 调用线程也参与, 全部完成后才返回 (fork-join)。
+ * 任务下标通过一个原子计数器领取, 所以任务粒度不必相同。
+ *
+ * - 同一时刻只有一个 pool_run 在执行, 并发的调用会依次排队。
+ * - 在任务内部再次调用 pool_run 时, 直接在当前线程顺序执行 (不会死锁)。
+ *
+ * @example
+ * ThreadPool *pool = oexpect(pool_new(&sys, 0), "Failed to create pool");
+ * pool_run(pool, n_chunks, sort_chunk, &job);
+ * pool_free(pool);
+ */
+
+#include <core/mem/sysalc.h> // SystemAlloc
+#include <core/option.h>     // Option
+#include <core/type.h>       // usize
+
+/**
+ * @brief 线程池 (不透明类型)。
+ */
+typedef struct ThreadPool ThreadPool;
+
+DEFINE_OPTION(ThreadPoolPtr, ThreadPool *);
+
+/**
+ * @brief 任务函数: index 是 [0, n) 中的任务下标。
+ */
+typedef void (*PoolTaskFn)(void *ctx, usize index);
+
+/**
+ * @brief 创建线程池。
+ *
+ * @param backing_alloc 用于池本身的分配器。
+ * @param nthreads 参与执行的线程总数 (包括调用 pool_run 的线程,
+ *        所以会创建 nthreads - 1 个工作线程); 0 表示使用在线的 CPU 数。
+ * @return Some(ThreadPool*) 成功, None 失败 (OOM 或无法创建线程)。
+ */
+Option_ThreadPoolPtr pool_new(SystemAlloc *backing_alloc, usize nthreads);
+
+/**
+ * @brief 停止并回收所有工作线程, 然后释放线程池。
+ */
+void pool_free(ThreadPool *self);
+
+/**
+ * @brief 参与执行的线程总数 (包括调用者)。
+ */
+usize pool_threads(const ThreadPool *self);
+
+/**
+ * @brief 在线的 CPU 数 (至少为 1)。
+ */
+usize pool_hardware_threads(void);
+
+/**
+ * @brief 并行执行 fn(ctx, 0) ... fn(ctx, n_tasks - 1), 全部完成后返回。
+ *
+ * self 为 NULL 时在调用线程中顺序执行。
+ */
+void pool_run(ThreadPool *self, usize n_tasks, PoolTaskFn fn, void *ctx);
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Template) 基于线程池的并行归并排序。
+ *
+ * 1. 把数组切成 P 块 (P = 线程数), 每块用 DEFINE_SORT 生成的 pdqsort 并行排序;
+ * 2. 逐轮两两归并, 直到只剩一个有序段。每一轮的输出被等分成 P 份,
+ *    每份的起点通过二分 (merge path) 定位到对应的两个输入段中,
+ *    所以即使最后一轮只有一对段要归并, 也是 P 个线程一起做。
+ *
+ * 归并在 data 与一块同样大小的临时缓冲区之间来回进行,
+ * 缓冲区通过分配器 trait 申请, 排序结束即释放。
+ *
+ * @example
+ * DEFINE_SORT(u32s, u32, cmp_u32)
+ * DEFINE_PARALLEL_SORT(u32s, u32, SystemAlloc, SYSTEM)
+ * u32s_par_sort(pool, &sys, vec.data, vec.len);
+ */
+
+#include <core/mem/allocer.h> // ALLOC, RELEASE
+#include <core/mem/layout.h>  // LAYOUT_OF_ARRAY
+#include <std/sort.h>         // DEFINE_SORT
+#include <std/thread/pool.h>  // ThreadPool, pool_run
+#include <string.h>           // memcpy
+
+/** @brief 短于此长度时直接顺序排序。 */
+#define PSORT_SEQUENTIAL_THRESHOLD (1u << 14)
+
+/**
+ * @brief (Template) 为已经用 DEFINE_SORT(Name, T, ...) 实例化过的类型生成并行排序。
+ *
+ * 生成的 API:
+ * - `void Name_par_sort(ThreadPool *pool, AllocType *alloc, T *data, usize len)`:
+ *   原地升序排序 (不稳定)。pool 为 NULL 或只有一个线程时等价于 Name_sort。
+ *
+ * @param Name        与 DEFINE_SORT 相同的前缀
+ * @param T           元素类型
+ * @param AllocType   临时缓冲区的分配器类型
+ * @param AllocPrefix 分配器前缀 (例如 SYSTEM)
+ */
+#define DEFINE_PARALLEL_SORT(Name, T, AllocType, AllocPrefix)                                      \
+                                                                                                   \
+  /* (内部) 一次 pool_run 的共享参数 */                                                            \
+  typedef struct Name##_ParSortJob                                                                 \
+  {                                                                                                \
+    T *src;                                                                                        \
+    T *dst;                                                                                        \
+    usize len;                                                                                     \
+    usize width; /* 本轮每个有序段的长度 */                                                        \
+    usize parts; /* 本轮的任务数 */                                                                \
+  } Name##_ParSortJob;                                                                             \
+                                                                                                   \
+  /* (内部) 第一步: 排序第 t 块 */                                                                 \
+  static void Name##_par_sort_chunk(void *ctx, usize t)                                            \
+  {                                                                                                \
+    Name##_ParSortJob *job = (Name##_ParSortJob *)ctx;                                             \
+    usize begin = t * job->width;                                                                  \
+    usize end = begin + job->width < job->len ? begin + job->width : job->len;                     \
+    if (begin < end)                                                                               \
+    {                                                                                              \
+      Name##_sort(job->src + begin, end - begin);                                                  \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /*                                                                                               \
+   * (内部) 归并 a[0, m) 与 b[0, l) 时, 输出前 k 个元素中来自 a 的个数。                           \
+   * 相等时 a 优先, 与 merge 的取法一致。                                                          \
+   */                                                                                              \
+  static inline usize Name##_co_rank(usize k, const T *a, usize m, const T *b, usize l)            \
+  {                                                                                                \
+    usize lo = k > l ? k - l : 0;                                                                  \
+    usize hi = k < m ? k : m;                                                                      \
+    while (lo < hi)                                                                                \
+    {                                                                                              \
+      usize i = lo + (hi - lo) / 2;                                                                \
+      usize j = k - i;                                                                             \
+      if (j > 0 && !Name##_less(&b[j - 1], &a[i]))                                                 \
+        lo = i + 1;                                                                                \
+      else                                                                                         \
+        hi = i;                                                                                    \
+    }                                                                                              \
+    return lo;                                                                                     \
+  }                                                                                                \
+                                                                                                   \
+  /* (内部) 第二步: 产出本轮输出中的第 t 份 (可能跨越多对段) */                                    \
+  static void Name##_par_sort_merge(void *ctx, usize t)                                            \
+  {                                                                                                \
+    Name##_ParSortJob *job = (Name##_ParSortJob *)ctx;                                             \
+    usize len = job->len;                                                                          \
+    usize w = job->width;                                                                          \
+    usize begin = len / job->parts * t + (t < len % job->parts ? t : len % job->parts);            \
+    usize end = begin + len / job->parts + (t < len % job->parts ? 1 : 0);                         \
+                                                                                                   \
+    while (begin < end)                                                                            \
+    {                                                                                              \
+      usize lo = begin / (2 * w) * (2 * w);                                                        \
+      usize mid = lo + w < len ? lo + w : len;                                                     \
+      usize hi = mid + w < len ? mid + w : len;                                                    \
+      usize stop = end < hi ? end : hi;                                                            \
+                                                                                                   \
+      const T *a = job->src + lo;                                                                  \
+      const T *b = job->src + mid;                                                                 \
+      usize m = mid - lo;                                                                          \
+      usize l = hi - mid;                                                                          \
+      usize i = Name##_co_rank(begin - lo, a, m, b, l);                                            \
+      usize j = begin - lo - i;                                                                    \
+                                                                                                   \
+      T *out = job->dst + begin;                                                                   \
+      for (usize n = stop - begin; n > 0; n--)                                                     \
+      {                                                                                            \
+        if (j < l && (i == m || Name##_less(&b[j], &a[i])))                                        \
+          *out++ = b[j++];                                                                         \
+        else                                                                                       \
+          *out++ = a[i++];                                                                         \
+      }                                                                                            \
+      begin = stop;                                                                                \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /* (内部) 结果落在临时缓冲区时, 并行拷回 */                                                      \
+  static void Name##_par_sort_copy(void *ctx, usize t)                                             \
+  {                                                                                                \
+    Name##_ParSortJob *job = (Name##_ParSortJob *)ctx;                                             \
+    usize begin = job->len / job->parts * t;                                                       \
+    usize end = t + 1 == job->parts ? job->len : begin + job->len / job->parts;                    \
+    memcpy(job->dst + begin, job->src + begin, (end - begin) * sizeof(T));                         \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_par_sort(ThreadPool *pool, AllocType *alloc, T *data, usize len)       \
+  {                                                                                                \
+    (void)alloc; /* 无状态分配器 (如 SYSTEM) 不使用 */                                             \
+    usize parts = pool_threads(pool);                                                              \
+    if (parts == 1 || len < PSORT_SEQUENTIAL_THRESHOLD)                                            \
+    {                                                                                              \
+      Name##_sort(data, len);                                                                      \
+      return;                                                                                      \
+    }                                                                                              \
+                                                                                                   \
+    T *scratch = (T *)ALLOC(AllocPrefix, alloc, LAYOUT_OF_ARRAY(T, len));                          \
+    Name##_ParSortJob job = {                                                                      \
+      .src = data,                                                                                 \
+      .dst = scratch,                                                                              \
+      .len = len,                                                                                  \
+      .width = (len + parts - 1) / parts,                                                          \
+      .parts = parts,                                                                              \
+    };                                                                                             \
+    pool_run(pool, parts, Name##_par_sort_chunk, &job);                                            \
+                                                                                                   \
+    for (; job.width < len; job.width *= 2)                                                        \
+    {                                                                                              \
+      pool_run(pool, parts, Name##_par_sort_merge, &job);                                          \
+      T *tmp = job.src;                                                                            \
+      job.src = job.dst;                                                                           \
+      job.dst = tmp;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    if (job.src != data)                                                                           \
+    {                                                                                              \
+      job.dst = data;                                                                              \
+      pool_run(pool, parts, Name##_par_sort_copy, &job);                                           \
+    }                                                                                              \
+    RELEASE(AllocPrefix, alloc, scratch, LAYOUT_OF_ARRAY(T, len));                                 \
+  }
@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Template) 有界无锁队列。
+ *
+ * - `DEFINE_SPSC_QUEUE`: 单生产者 / 单消费者环形缓冲区。head 和 tail
+ *   各占一个缓存行, 每一端还缓存对端的位置, 只有缓存的值显示 "满 / 空" 时
+ *   才去读对端的缓存行。支持批量 push / pop (一次发布整批)。
+ * - `DEFINE_MPMC_QUEUE`: 多生产者 / 多消费者 (Vyukov 有界队列)。每个槽位
+ *   带一个序号, 生产者 / 消费者各自用一次 CAS 抢位置, 之后只写自己的槽。
+ *
+ * 两者都不阻塞: 满时 push 返回 false, 空时 pop 返回 false, 由调用者决定
+ * 重试、让出 CPU 还是等待。容量向上取整到 2 的幂, 槽位数组通过分配器 trait 申请。
+ *
+ * @example
+ * DEFINE_SPSC_QUEUE(JobRing, Job, SystemAlloc, SYSTEM)
+ * JobRing ring;
+ * JobRing_init(&ring, &sys, 1024);
+ * while (!JobRing_push(&ring, job)) thrd_yield();
+ */
+
+#include <core/mem/allocer.h> // ALLOC, RELEASE
+#include <core/mem/layout.h>  // LAYOUT_OF_ARRAY
+#include <core/msg/asrt.h>    // asrt_msg
+#include <core/type.h>        // usize
+#include <stdatomic.h>
+
+/** @brief 假定的缓存行大小, 用于隔开被不同线程写的字段。 */
+#define QUEUE_CACHE_LINE 64
+
+/** @brief (内部) 不小于 n 的最小 2 的幂 (n >= 1)。 */
+static inline usize
+queue_round_pow2(usize n)
+{
+  usize cap = 1;
+  while (cap < n)
+  {
+    cap *= 2;
+  }
+  return cap;
+}
+
+/*
+ * ===================================================================
+ * 1. DEFINE_SPSC_QUEUE
+ * ===================================================================
+ */
+
+/**
+ * @brief (Template) 单生产者 / 单消费者有界环形队列。
+ *
+ * push 系列只能由同一个线程调用, pop 系列只能由 (另一个) 同一个线程调用。
+ *
+ * @param Name        生成的类型名
+ * @param T           元素类型
+ * @param AllocType   分配器类型
+ * @param AllocPrefix 分配器前缀
+ */
+#define DEFINE_SPSC_QUEUE(Name, T, AllocType, AllocPrefix)                                         \
+                                                                                                   \
+  typedef struct Name                                                                              \
+  {                                                                                                \
+    /* 生产者独占的缓存行 */                                                                       \
+    alignas(QUEUE_CACHE_LINE) _Atomic usize head; /* 下一个写入位置 */                             \
+    usize cached_tail;                                                                             \
+                                                                                                   \
+    /* 消费者独占的缓存行 */                                                                       \
+    alignas(QUEUE_CACHE_LINE) _Atomic usize tail; /* 下一个读取位置 */                             \
+    usize cached_head;                                                                             \
+                                                                                                   \
+    /* 只读 */                                                                                     \
+    alignas(QUEUE_CACHE_LINE) T *buf;                                                              \
+    usize mask;                                                                                    \
+    AllocType *alloc_state;                                                                        \
+  } Name;                                                                                          \
+                                                                                                   \
+  /** @brief 初始化, 容量向上取整到 2 的幂。 */                                                    \
+  static inline void Name##_init(Name *self, AllocType *alloc, usize capacity)                     \
+  {                                                                                                \
+    asrt_msg(capacity > 0, "queue capacity must be positive");                                     \
+    usize cap = queue_round_pow2(capacity);                                                        \
+    self->buf = (T *)ALLOC(AllocPrefix, alloc, LAYOUT_OF_ARRAY(T, cap));                           \
+    self->mask = cap - 1;                                                                          \
+    self->alloc_state = alloc;                                                                     \
+    atomic_init(&self->head, 0);                                                                   \
+    atomic_init(&self->tail, 0);                                                                   \
+    self->cached_tail = 0;                                                                         \
+    self->cached_head = 0;                                                                         \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_deinit(Name *self)                                                     \
+  {                                                                                                \
+    if (self->buf != NULL)                                                                         \
+    {                                                                                              \
+      RELEASE(AllocPrefix, self->alloc_state, self->buf, LAYOUT_OF_ARRAY(T, self->mask + 1));      \
+    }                                                                                              \
+    self->buf = NULL;                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize Name##_capacity(const Name *self)                                            \
+  {                                                                                                \
+    return self->mask + 1;                                                                         \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 当前元素个数 (并发时只是一个近似值)。 */                                              \
+  static inline usize Name##_len(Name *self)                                                       \
+  {                                                                                                \
+    usize tail = atomic_load_explicit(&self->tail, memory_order_acquire);                          \
+    usize head = atomic_load_explicit(&self->head, memory_order_acquire);                          \
+    return head - tail;                                                                            \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief (生产者) 入队一个元素; 队列满时返回 false。 */                                        \
+  static inline bool Name##_push(Name *self, T value)                                              \
+  {                                                                                                \
+    usize head = atomic_load_explicit(&self->head, memory_order_relaxed);                          \
+    if (head - self->cached_tail > self->mask)                                                     \
+    {                                                                                              \
+      self->cached_tail = atomic_load_explicit(&self->tail, memory_order_acquire);                 \
+      if (head - self->cached_tail > self->mask)                                                   \
+        return false;                                                                              \
+    }                                                                                              \
+    self->buf[head & self->mask] = value;                                                          \
+    atomic_store_explicit(&self->head, head + 1, memory_order_release);                            \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief (生产者) 批量入队, 整批只发布一次。                                                    \
+   * @return 实际入队的个数 (空间不足时可能少于 count)。                                           \
+   */                                                                                              \
+  static inline usize Name##_push_n(Name *self, const T *items, usize count)                       \
+  {                                                                                                \
+    usize head = atomic_load_explicit(&self->head, memory_order_relaxed);                          \
+    usize space = self->mask + 1 - (head - self->cached_tail);                                     \
+    if (space < count)                                                                             \
+    {                                                                                              \
+      self->cached_tail = atomic_load_explicit(&self->tail, memory_order_acquire);                 \
+      space = self->mask + 1 - (head - self->cached_tail);                                         \
+    }                                                                                              \
+    usize n = count < space ? count : space;                                                       \
+    for (usize i = 0; i < n; i++)                                                                  \
+    {                                                                                              \
+      self->buf[(head + i) & self->mask] = items[i];                                               \
+    }                                                                                              \
+    atomic_store_explicit(&self->head, head + n, memory_order_release);                            \
+    return n;                                                                                      \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief (消费者) 出队一个元素; 队列空时返回 false。 */                                        \
+  static inline bool Name##_pop(Name *self, T *out)                                                \
+  {                                                                                                \
+    usize tail = atomic_load_explicit(&self->tail, memory_order_relaxed);                          \
+    if (tail == self->cached_head)                                                                 \
+    {                                                                                              \
+      self->cached_head = atomic_load_explicit(&self->head, memory_order_acquire);                 \
+      if (tail == self->cached_head)                                                               \
+        return false;                                                                              \
+    }                                                                                              \
+    *out = self->buf[tail & self->mask];                                                           \
+    atomic_store_explicit(&self->tail, tail + 1, memory_order_release);                            \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief (消费者) 批量出队最多 max 个元素, 整批只归还一次空间。                                 \
+   * @return 实际出队的个数。                                                                      \
+   */                                                                                              \
+  static inline usize Name##_pop_n(Name *self, T *out, usize max)                                  \
+  {                                                                                                \
+    usize tail = atomic_load_explicit(&self->tail, memory_order_relaxed);                          \
+    usize avail = self->cached_head - tail;                                                        \
+    if (avail < max)                                                                               \
+    {                                                                                              \
+      self->cached_head = atomic_load_explicit(&self->head, memory_order_acquire);                 \
+      avail = self->cached_head - tail;                                                            \
+    }                                                                                              \
+    usize n = max < avail ? max : avail;                                                           \
+    for (usize i = 0; i < n; i++)                                                                  \
+    {                                                                                              \
+      out[i] = self->buf[(tail + i) & self->mask];                                                 \
+    }                                                                                              \
+    atomic_store_explicit(&self->tail, tail + n, memory_order_release);                            \
+    return n;                                                                                      \
+  }
+
+/*
+ * ===================================================================
+ * 2. DEFINE_MPMC_QUEUE
+ * ===================================================================
+ */
+
+/**
+ * @brief (Template) 多生产者 / 多消费者有界队列 (Vyukov)。
+ *
+ * 槽位 i 的序号 seq:
+ * - seq == pos: 空闲, 等待位置 pos 的生产者;
+ * - seq == pos + 1: 已写入, 等待位置 pos 的消费者;
+ * - 消费者读完后把 seq 设为 pos + 容量, 留给下一圈的生产者。
+ *
+ * @param Name        生成的类型名
+ * @param T           元素类型
+ * @param AllocType   分配器类型
+ * @param AllocPrefix 分配器前缀
+ */
+#define DEFINE_MPMC_QUEUE(Name, T, AllocType, AllocPrefix)                                         \
+                                                                                                   \
+  typedef struct Name##_Cell                                                                       \
+  {                                                                                                \
+    _Atomic usize seq;                                                                             \
+    T value;                                                                                       \
+  } Name##_Cell;                                                                                   \
+                                                                                                   \
+  typedef struct Name                                                                              \
+  {                                                                                                \
+    alignas(QUEUE_CACHE_LINE) _Atomic usize enqueue_pos;                                           \
+    alignas(QUEUE_CACHE_LINE) _Atomic usize dequeue_pos;                                           \
+    alignas(QUEUE_CACHE_LINE) Name##_Cell *cells;                                                  \
+    usize mask;                                                                                    \
+    AllocType *alloc_state;                                                                        \
+  } Name;                                                                                          \
+                                                                                                   \
+  /** @brief 初始化, 容量向上取整到 2 的幂 (至少为 2)。 */                                         \
+  static inline void Name##_init(Name *self, AllocType *alloc, usize capacity)                     \
+  {                                                                                                \
+    asrt_msg(capacity > 0, "queue capacity must be positive");                                     \
+    usize cap = queue_round_pow2(capacity < 2 ? 2 : capacity);                                     \
+    self->cells = (Name##_Cell *)ALLOC(AllocPrefix, alloc, LAYOUT_OF_ARRAY(Name##_Cell, cap));     \
+    for (usize i = 0; i < cap; i++)                                                                \
+    {                                                                                              \
+      atomic_init(&self->cells[i].seq, i);                                                         \
+    }                                                                                              \
+    self->mask = cap - 1;                                                                          \
+    self->alloc_state = alloc;                                                                     \
+    atomic_init(&self->enqueue_pos, 0);                                                            \
+    atomic_init(&self->dequeue_pos, 0);                                                            \
+  }                                                                                                \
+                                                                                                   \
+  static inline void Name##_deinit(Name *self)                                                     \
+  {                                                                                                \
+    if (self->cells != NULL)                                                                       \
+    {                                                                                              \
+      RELEASE(AllocPrefix,                                                                         \
+              self->alloc_state,                                                                   \
+              self->cells,                                                                         \
+              LAYOUT_OF_ARRAY(Name##_Cell, self->mask + 1));                                       \
+    }                                                                                              \
+    self->cells = NULL;                                                                            \
+  }                                                                                                \
+                                                                                                   \
+  static inline usize Name##_capacity(const Name *self)                                            \
+  {                                                                                                \
+    return self->mask + 1;                                                                         \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 入队; 队列满时返回 false。可由任意多个线程并发调用。 */                               \
+  static inline bool Name##_push(Name *self, T value)                                              \
+  {                                                                                                \
+    Name##_Cell *cell;                                                                             \
+    usize pos = atomic_load_explicit(&self->enqueue_pos, memory_order_relaxed);                    \
+    for (;;)                                                                                       \
+    {                                                                                              \
+      cell = &self->cells[pos & self->mask];                                                       \
+      usize seq = atomic_load_explicit(&cell->seq, memory_order_acquire);                          \
+      i64 diff = (i64)(seq - pos);                                                                 \
+      if (diff == 0)                                                                               \
+      {                                                                                            \
+        if (atomic_compare_exchange_weak_explicit(                                                 \
+              &self->enqueue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))      \
+          break;                                                                                   \
+      }                                                                                            \
+      else if (diff < 0)                                                                           \
+      {                                                                                            \
+        return false; /* 满: 槽位还没被上一圈的消费者读走 */                                       \
+      }                                                                                            \
+      else                                                                                         \
+      {                                                                                            \
+        pos = atomic_load_explicit(&self->enqueue_pos, memory_order_relaxed);                      \
+      }                                                                                            \
+    }                                                                                              \
+    cell->value = value;                                                                           \
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);                              \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 出队; 队列空时返回 false。可由任意多个线程并发调用。 */                               \
+  static inline bool Name##_pop(Name *self, T *out)                                                \
+  {                                                                                                \
+    Name##_Cell *cell;                                                                             \
+    usize pos = atomic_load_explicit(&self->dequeue_pos, memory_order_relaxed);                    \
+    for (;;)                                                                                       \
+    {                                                                                              \
+      cell = &self->cells[pos & self->mask];                                                       \
+      usize seq = atomic_load_explicit(&cell->seq, memory_order_acquire);                          \
+      i64 diff = (i64)(seq - (pos + 1));                                                           \
+      if (diff == 0)                                                                               \
+      {                                                                                            \
+        if (atomic_compare_exchange_weak_explicit(                                                 \
+              &self->dequeue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))      \
+          break;                                                                                   \
+      }                                                                                            \
+      else if (diff < 0)                                                                           \
+      {                                                                                            \
+        return false; /* 空: 槽位还没被生产者写入 */                                               \
+      }                                                                                            \
+      else                                                                                         \
+      {                                                                                            \
+        pos = atomic_load_explicit(&self->dequeue_pos, memory_order_relaxed);                      \
+      }                                                                                            \
+    }                                                                                              \
+    *out = cell->value;                                                                            \
+    atomic_store_explicit(&cell->seq, pos + self->mask + 1, memory_order_release);                 \
+    return true;                                                                                   \
+  }
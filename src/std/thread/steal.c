@@ -0,0 +1,512 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/thread/steal.h>
+
+#include <core/mem/allocer.h> // RELEASE
+#include <core/mem/layout.h>  // LAYOUT_OF
+#include <core/msg/asrt.h>    // asrt_msg
+#include <std/alloc/bump.h>   // Bump
+#include <std/thread/pool.h>  // pool_hardware_threads
+#include <stdatomic.h>
+#include <string.h>  // memset
+#include <threads.h> // thrd_t, mtx_t, cnd_t
+
+/** @brief 每个工作队列的初始容量 (2 的幂)。 */
+#define STEAL_INITIAL_CAP 256
+
+/** @brief 找不到任务时, 工作线程在睡眠前让出 CPU 的轮数。 */
+#define STEAL_SPIN_ROUNDS 64
+
+/*
+ * ===================================================================
+ * 1. 数据结构
+ * ===================================================================
+ */
+
+struct StealTask
+{
+  StealFn fn;
+  void *ctx;
+  _Atomic bool done;
+  struct StealWorker *owner; /* spawn 它的工作线程 (只有它能 join) */
+  StealTask *next_free;
+};
+
+/* Chase-Lev 队列的环形数组; 扩容后旧数组留在 arena 中, 正在窃取的线程仍可读它 */
+typedef struct StealRing
+{
+  i64 mask;
+  _Atomic(StealTask *) slots[];
+} StealRing;
+
+typedef struct StealWorker
+{
+  alignas(64) _Atomic i64 top; /* 窃取端 */
+  alignas(64) _Atomic i64 bottom; /* 所有者端 */
+  _Atomic(StealRing *) ring;
+
+  Bump arena; /* 任务与环形数组; 只有所有者线程使用 */
+  StealTask *free_list;
+  u64 rng;
+  usize index;
+  StealPool *pool;
+} StealWorker;
+
+struct StealPool
+{
+  usize nthreads; /* 包括调用者 */
+  StealWorker *workers;
+  thrd_t *threads;
+
+  alignas(64) _Atomic usize sleepers; /* 正在 (或准备) 睡眠的工作线程数 */
+  mtx_t lock;
+  cnd_t wake;
+  bool stop;
+
+  mtx_t run_lock; /* 串行化并发的 steal_pool_run */
+  SystemAlloc *backing_alloc;
+};
+
+/* 当前线程所扮演的工作线程 (不在池中时为 NULL) */
+static thread_local StealWorker *t_worker = NULL;
+
+/* 不在池中时 steal_spawn 返回的 "已完成" 任务 */
+static StealTask g_inline_task = {.done = true};
+
+/*
+ * ===================================================================
+ * 2. Chase-Lev 双端队列 (Lê, Pop, Cohen, Zappa Nardelli 2013 的 C11 版本)
+ * ===================================================================
+ */
+
+static StealRing *
+ring_new(StealWorker *w, i64 cap)
+{
+  usize bytes = sizeof(StealRing) + (usize)cap * sizeof(_Atomic(StealTask *));
+  StealRing *ring =
+    (StealRing *)BUMP_ALLOC(&w->arena, layout_from_size_align(bytes, alignof(StealRing)));
+  ring->mask = cap - 1;
+  return ring;
+}
+
+/* 把 [t, b) 拷到两倍大的新数组 (只由所有者调用) */
+static StealRing *
+ring_grow(StealWorker *w, StealRing *old, i64 t, i64 b)
+{
+  StealRing *ring = ring_new(w, 2 * (old->mask + 1));
+  for (i64 i = t; i < b; i++)
+  {
+    StealTask *task = atomic_load_explicit(&old->slots[i & old->mask], memory_order_relaxed);
+    atomic_store_explicit(&ring->slots[i & ring->mask], task, memory_order_relaxed);
+  }
+  atomic_store_explicit(&w->ring, ring, memory_order_release);
+  return ring;
+}
+
+static void
+deque_push(StealWorker *w, StealTask *task)
+{
+  i64 b = atomic_load_explicit(&w->bottom, memory_order_relaxed);
+  i64 t = atomic_load_explicit(&w->top, memory_order_acquire);
+  StealRing *ring = atomic_load_explicit(&w->ring, memory_order_relaxed);
+  if (b - t > ring->mask)
+  {
+    ring = ring_grow(w, ring, t, b);
+  }
+  atomic_store_explicit(&ring->slots[b & ring->mask], task, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+}
+
+/* 所有者从底部取一个任务; 队列为空时返回 NULL */
+static StealTask *
+deque_take(StealWorker *w)
+{
+  i64 b = atomic_load_explicit(&w->bottom, memory_order_relaxed) - 1;
+  StealRing *ring = atomic_load_explicit(&w->ring, memory_order_relaxed);
+  atomic_store_explicit(&w->bottom, b, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  i64 t = atomic_load_explicit(&w->top, memory_order_relaxed);
+
+  if (t > b)
+  {
+    atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+    return NULL;
+  }
+  StealTask *task = atomic_load_explicit(&ring->slots[b & ring->mask], memory_order_relaxed);
+  if (t == b)
+  {
+    /* 最后一个元素: 与窃取者竞争 */
+    if (!atomic_compare_exchange_strong_explicit(
+          &w->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+    {
+      task = NULL;
+    }
+    atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+  }
+  return task;
+}
+
+/* 其他线程从顶部窃取; 为空或竞争失败时返回 NULL */
+static StealTask *
+deque_steal(StealWorker *w)
+{
+  i64 t = atomic_load_explicit(&w->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  i64 b = atomic_load_explicit(&w->bottom, memory_order_acquire);
+  if (t >= b)
+  {
+    return NULL;
+  }
+  StealRing *ring = atomic_load_explicit(&w->ring, memory_order_acquire);
+  StealTask *task = atomic_load_explicit(&ring->slots[t & ring->mask], memory_order_relaxed);
+  if (!atomic_compare_exchange_strong_explicit(
+        &w->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+  {
+    return NULL;
+  }
+  return task;
+}
+
+static bool
+deque_is_empty(StealWorker *w)
+{
+  i64 t = atomic_load_explicit(&w->top, memory_order_acquire);
+  i64 b = atomic_load_explicit(&w->bottom, memory_order_acquire);
+  return t >= b;
+}
+
+/*
+ * ===================================================================
+ * 3. 调度
+ * ===================================================================
+ */
+
+/* 从一个随机的受害者开始, 依次尝试窃取其他所有工作线程 */
+static StealTask *
+steal_any(StealWorker *w)
+{
+  StealPool *pool = w->pool;
+  usize n = pool->nthreads;
+  w->rng ^= w->rng << 13;
+  w->rng ^= w->rng >> 7;
+  w->rng ^= w->rng << 17;
+  usize start = (usize)(w->rng % n);
+  for (usize k = 0; k < n; k++)
+  {
+    usize victim = start + k < n ? start + k : start + k - n;
+    if (victim == w->index)
+      continue;
+    StealTask *task = deque_steal(&pool->workers[victim]);
+    if (task != NULL)
+      return task;
+  }
+  return NULL;
+}
+
+static void
+run_task(StealTask *task)
+{
+  task->fn(task->ctx);
+  atomic_store_explicit(&task->done, true, memory_order_release);
+}
+
+static bool
+pool_has_work(StealPool *pool)
+{
+  for (usize i = 0; i < pool->nthreads; i++)
+  {
+    if (!deque_is_empty(&pool->workers[i]))
+      return true;
+  }
+  return false;
+}
+
+/* push 之后调用: 有线程在睡眠时唤醒一个 */
+static void
+wake_one(StealPool *pool)
+{
+  /* 与 worker_sleep 中 "先登记 sleepers, 再检查队列" 配对 */
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&pool->sleepers, memory_order_relaxed) == 0)
+    return;
+  mtx_lock(&pool->lock);
+  cnd_signal(&pool->wake);
+  mtx_unlock(&pool->lock);
+}
+
+static void
+worker_sleep(StealPool *pool)
+{
+  mtx_lock(&pool->lock);
+  atomic_fetch_add_explicit(&pool->sleepers, 1, memory_order_seq_cst);
+  if (!pool->stop && !pool_has_work(pool))
+  {
+    cnd_wait(&pool->wake, &pool->lock);
+  }
+  atomic_fetch_sub_explicit(&pool->sleepers, 1, memory_order_relaxed);
+  mtx_unlock(&pool->lock);
+}
+
+static int
+worker_main(void *arg)
+{
+  StealWorker *w = (StealWorker *)arg;
+  StealPool *pool = w->pool;
+  t_worker = w;
+
+  usize idle_rounds = 0;
+  for (;;)
+  {
+    StealTask *task = deque_take(w);
+    if (task == NULL)
+    {
+      task = steal_any(w);
+    }
+    if (task != NULL)
+    {
+      run_task(task);
+      idle_rounds = 0;
+      continue;
+    }
+
+    mtx_lock(&pool->lock);
+    bool stop = pool->stop;
+    mtx_unlock(&pool->lock);
+    if (stop)
+      break;
+
+    if (++idle_rounds < STEAL_SPIN_ROUNDS)
+    {
+      thrd_yield();
+      continue;
+    }
+    worker_sleep(pool);
+    idle_rounds = 0;
+  }
+  t_worker = NULL;
+  return 0;
+}
+
+/*
+ * ===================================================================
+ * 4. spawn / join
+ * ===================================================================
+ */
+
+StealTask *
+steal_spawn(StealFn fn, void *ctx)
+{
+  StealWorker *w = t_worker;
+  if (w == NULL)
+  {
+    fn(ctx);
+    return &g_inline_task;
+  }
+
+  StealTask *task = w->free_list;
+  if (task != NULL)
+  {
+    w->free_list = task->next_free;
+  }
+  else
+  {
+    task = (StealTask *)BUMP_ALLOC(&w->arena, LAYOUT_OF(StealTask));
+  }
+  task->fn = fn;
+  task->ctx = ctx;
+  task->owner = w;
+  atomic_store_explicit(&task->done, false, memory_order_relaxed);
+
+  deque_push(w, task);
+  wake_one(w->pool);
+  return task;
+}
+
+void
+steal_join(StealTask *task)
+{
+  if (task == &g_inline_task)
+    return;
+
+  StealWorker *w = t_worker;
+  asrt_msg(w != NULL && task->owner == w,
+           "steal_join: task must be joined by the worker that spawned it (worker {})",
+           steal_worker_index());
+
+  while (!atomic_load_explicit(&task->done, memory_order_acquire))
+  {
+    /* 没被偷走时, task 就在自己队列的底部, 这里会直接取回并执行 */
+    StealTask *other = deque_take(w);
+    if (other == NULL)
+    {
+      other = steal_any(w);
+    }
+    if (other != NULL)
+    {
+      run_task(other);
+    }
+    else
+    {
+      thrd_yield();
+    }
+  }
+
+  task->next_free = w->free_list;
+  w->free_list = task;
+}
+
+usize
+steal_worker_index(void)
+{
+  return t_worker == NULL ? STEAL_NO_WORKER : t_worker->index;
+}
+
+void
+steal_pool_run(StealPool *self, StealFn fn, void *ctx)
+{
+  if (self == NULL || t_worker != NULL)
+  {
+    fn(ctx);
+    return;
+  }
+
+  mtx_lock(&self->run_lock);
+  t_worker = &self->workers[0];
+  fn(ctx);
+  t_worker = NULL;
+  mtx_unlock(&self->run_lock);
+}
+
+/*
+ * ===================================================================
+ * 5. 创建与销毁
+ * ===================================================================
+ */
+
+usize
+steal_pool_threads(const StealPool *self)
+{
+  return self == NULL ? 1 : self->nthreads;
+}
+
+static void
+pool_join_threads(StealPool *self, usize count)
+{
+  mtx_lock(&self->lock);
+  self->stop = true;
+  cnd_broadcast(&self->wake);
+  mtx_unlock(&self->lock);
+
+  for (usize i = 0; i < count; i++)
+  {
+    thrd_join(self->threads[i], NULL);
+  }
+}
+
+static void
+pool_release(StealPool *self, usize n_workers)
+{
+  for (usize i = 0; i < n_workers; i++)
+  {
+    bump_destroy(&self->workers[i].arena);
+  }
+  if (self->workers != NULL)
+  {
+    RELEASE(
+      SYSTEM, self->backing_alloc, self->workers, LAYOUT_OF_ARRAY(StealWorker, self->nthreads));
+  }
+  if (self->threads != NULL)
+  {
+    RELEASE(SYSTEM, self->backing_alloc, self->threads, LAYOUT_OF_ARRAY(thrd_t, self->nthreads));
+  }
+  mtx_destroy(&self->run_lock);
+  cnd_destroy(&self->wake);
+  mtx_destroy(&self->lock);
+  RELEASE(SYSTEM, self->backing_alloc, self, LAYOUT_OF(StealPool));
+}
+
+Option_StealPoolPtr
+steal_pool_new(SystemAlloc *backing_alloc, usize nthreads)
+{
+  Layout layout = LAYOUT_OF(StealPool);
+  Option_anyptr mem = sys_aligned_alloc(layout.align, layout.size);
+  if (ois_none(mem))
+  {
+    return None(StealPoolPtr);
+  }
+  StealPool *self = (StealPool *)mem.value.some;
+  memset(self, 0, layout.size);
+
+  self->backing_alloc = backing_alloc;
+  self->nthreads = nthreads == 0 ? pool_hardware_threads() : nthreads;
+  atomic_init(&self->sleepers, 0);
+  mtx_init(&self->lock, mtx_plain);
+  cnd_init(&self->wake);
+  mtx_init(&self->run_lock, mtx_plain);
+
+  Layout workers_layout = LAYOUT_OF_ARRAY(StealWorker, self->nthreads);
+  Layout threads_layout = LAYOUT_OF_ARRAY(thrd_t, self->nthreads);
+  Option_anyptr workers = sys_aligned_alloc(workers_layout.align, workers_layout.size);
+  Option_anyptr threads = sys_aligned_alloc(threads_layout.align, threads_layout.size);
+  self->workers = ois_some(workers) ? (StealWorker *)workers.value.some : NULL;
+  self->threads = ois_some(threads) ? (thrd_t *)threads.value.some : NULL;
+  if (self->workers == NULL || self->threads == NULL)
+  {
+    pool_release(self, 0);
+    return None(StealPoolPtr);
+  }
+
+  for (usize i = 0; i < self->nthreads; i++)
+  {
+    StealWorker *w = &self->workers[i];
+    atomic_init(&w->top, 0);
+    atomic_init(&w->bottom, 0);
+    bump_init(&w->arena, backing_alloc);
+    atomic_init(&w->ring, ring_new(w, STEAL_INITIAL_CAP));
+    w->free_list = NULL;
+    w->rng = 0x9e3779b97f4a7c15ull * (i + 1);
+    w->index = i;
+    w->pool = self;
+  }
+
+  /* 0 号工作线程由调用 steal_pool_run 的线程扮演 */
+  for (usize i = 1; i < self->nthreads; i++)
+  {
+    if (thrd_create(&self->threads[i - 1], worker_main, &self->workers[i]) != thrd_success)
+    {
+      pool_join_threads(self, i - 1);
+      pool_release(self, self->nthreads);
+      return None(StealPoolPtr);
+    }
+  }
+  return Some(StealPoolPtr, self);
+}
+
+void
+steal_pool_free(StealPool *self)
+{
+  if (self == NULL)
+  {
+    return;
+  }
+  pool_join_threads(self, self->nthreads - 1);
+  pool_release(self, self->nthreads);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Impl) 工作窃取线程池: 任务可以 spawn 子任务并 join 等待它们。
+ *
+ * `pool_run` 适合 "一批大小已知的任务"; 递归分治 (fib, 快排, 树遍历) 这类
+ * 任务数在运行中才知道的并行则用这里的 StealPool:
+ *
+ * - 每个工作线程有一个 Chase-Lev 双端队列: 自己在底部 push / pop (LIFO, 缓存热),
+ *   空闲的线程从别人的顶部窃取 (FIFO, 偷到的通常是大块任务);
+ * - 任务对象从所属工作线程的 Bump arena 分配, join 之后放回该线程的空闲链表复用;
+ * - join 等待时不阻塞: 先执行自己队列里的任务, 再去窃取别人的。
+ *
+ * 约定 (严格 fork-join):
+ * - steal_spawn 返回的每个任务都必须由 spawn 它的那个任务 join 恰好一次;
+ * - 任务函数返回前必须 join 它 spawn 的所有任务。
+ * 违反约定的 join 会 panic。任务中的 panic 照常终止整个进程。
+ *
+ * @example
+ * static void fib_task(void *ctx) {
+ *   Fib *f = ctx;
+ *   if (f->n < 2) { f->result = f->n; return; }
+ *   Fib a = {f->n - 1}, b = {f->n - 2};
+ *   StealTask *t = steal_spawn(fib_task, &a);
+ *   fib_task(&b);
+ *   steal_join(t);
+ *   f->result = a.result + b.result;
+ * }
+ * steal_pool_run(pool, fib_task, &root);
+ */
+
+#include <core/mem/sysalc.h> // SystemAlloc
+#include <core/option.h>     // Option
+#include <core/type.h>       // usize
+
+/** @brief 当前线程不是任何 StealPool 的工作线程时, steal_worker_index 的返回值。 */
+#define STEAL_NO_WORKER ((usize)-1)
+
+/**
+ * @brief 工作窃取线程池 (不透明类型)。
+ */
+typedef struct StealPool StealPool;
+
+/**
+ * @brief 已 spawn 的任务 (不透明类型), 只能传给 steal_join。
+ */
+typedef struct StealTask StealTask;
+
+DEFINE_OPTION(StealPoolPtr, StealPool *);
+
+/**
+ * @brief 任务函数。
+ */
+typedef void (*StealFn)(void *ctx);
+
+/**
+ * @brief 创建工作窃取线程池。
+ *
+ * @param backing_alloc 用于池本身以及各工作线程 arena 的分配器。
+ * @param nthreads 参与执行的线程总数 (包括调用 steal_pool_run 的线程,
+ *        所以会创建 nthreads - 1 个工作线程); 0 表示使用在线的 CPU 数。
+ * @return Some(StealPool*) 成功, None 失败 (OOM 或无法创建线程)。
+ */
+Option_StealPoolPtr steal_pool_new(SystemAlloc *backing_alloc, usize nthreads);
+
+/**
+ * @brief 停止并回收所有工作线程, 然后释放线程池 (以及所有任务内存)。
+ */
+void steal_pool_free(StealPool *self);
+
+/**
+ * @brief 参与执行的线程总数 (包括调用者)。
+ */
+usize steal_pool_threads(const StealPool *self);
+
+/**
+ * @brief 在池中执行根任务 fn(ctx), 它 (以及它 spawn 的所有任务) 完成后返回。
+ *
+ * 调用线程在此期间充当 0 号工作线程。并发的调用会依次排队;
+ * 在任务内部调用时直接执行 fn(ctx)。self 为 NULL 时在调用线程中顺序执行,
+ * 其中的 steal_spawn 会立即执行任务。
+ */
+void steal_pool_run(StealPool *self, StealFn fn, void *ctx);
+
+/**
+ * @brief 把 fn(ctx) 放入当前工作线程的队列, 它可能被其他线程窃取执行。
+ *
+ * 不在任何池中时立即执行 fn(ctx)。ctx 在对应的 steal_join 返回前必须保持有效。
+ */
+StealTask *steal_spawn(StealFn fn, void *ctx);
+
+/**
+ * @brief 等待 task 完成; 等待期间执行其他任务。之后 task 不再有效。
+ */
+void steal_join(StealTask *task);
+
+/**
+ * @brief 当前线程在所属池中的编号 ([0, nthreads)), 不在池中时为 STEAL_NO_WORKER。
+ *
+ * 可用来索引每线程的累加器, 避免在任务中使用原子操作。
+ */
+usize steal_worker_index(void);
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <std/thread/taskgraph.h>
+
+#include <core/mem/allocer.h> // RELEASE
+#include <core/mem/layout.h>  // LAYOUT_OF
+#include <core/msg/asrt.h>    // asrt_msg
+#include <std/vector.h>       // DEFINE_VECTOR
+#include <stdatomic.h>
+
+typedef struct TaskNode
+{
+  TaskFn fn;
+  void *ctx;
+  usize dep_start; /* 在 deps / inputs 中的起点 */
+  usize ndeps;
+  usize succ_start; /* 在 succ 中的起点 */
+  usize nsucc;
+  _Atomic usize pending; /* 还没完成的依赖数 */
+  TaskResult result;
+} TaskNode;
+
+DEFINE_VECTOR(TaskNodes, TaskNode, SystemAlloc, SYSTEM)
+DEFINE_VECTOR(TaskIds, TaskId, SystemAlloc, SYSTEM)
+DEFINE_VECTOR(TaskInputs, anyptr, SystemAlloc, SYSTEM)
+
+struct TaskGraph
+{
+  TaskNodes nodes;
+  TaskIds deps;      /* 所有任务的依赖, 按任务依次排列 */
+  TaskInputs inputs; /* 与 deps 一一对应, 执行前填入依赖的 Ok 值 */
+  TaskIds succ;      /* 由 deps 反转得到的后继表 */
+  TaskIds sources;   /* 没有依赖的任务 */
+  bool built;        /* succ / sources 与 nodes 一致, 且 results 有效 */
+  bool ran;
+  SystemAlloc *backing_alloc;
+};
+
+/*
+ * ===================================================================
+ * 1. 构建
+ * ===================================================================
+ */
+
+Option_TaskGraphPtr
+task_graph_new(SystemAlloc *backing_alloc)
+{
+  Layout layout = LAYOUT_OF(TaskGraph);
+  Option_anyptr mem = sys_aligned_alloc(layout.align, layout.size);
+  if (ois_none(mem))
+  {
+    return None(TaskGraphPtr);
+  }
+  TaskGraph *self = (TaskGraph *)mem.value.some;
+  TaskNodes_init(&self->nodes, backing_alloc);
+  TaskIds_init(&self->deps, backing_alloc);
+  TaskInputs_init(&self->inputs, backing_alloc);
+  TaskIds_init(&self->succ, backing_alloc);
+  TaskIds_init(&self->sources, backing_alloc);
+  self->built = false;
+  self->ran = false;
+  self->backing_alloc = backing_alloc;
+  return Some(TaskGraphPtr, self);
+}
+
+void
+task_graph_free(TaskGraph *self)
+{
+  if (self == NULL)
+  {
+    return;
+  }
+  TaskNodes_deinit(&self->nodes);
+  TaskIds_deinit(&self->deps);
+  TaskInputs_deinit(&self->inputs);
+  TaskIds_deinit(&self->succ);
+  TaskIds_deinit(&self->sources);
+  RELEASE(SYSTEM, self->backing_alloc, self, LAYOUT_OF(TaskGraph));
+}
+
+TaskId
+task_graph_add(TaskGraph *self, TaskFn fn, void *ctx, const TaskId *deps, usize ndeps)
+{
+  TaskId id = self->nodes.len;
+  for (usize i = 0; i < ndeps; i++)
+  {
+    asrt_msg(deps[i] < id, "task_graph_add: dependency {} does not exist yet", deps[i]);
+  }
+  TaskNode node = {
+    .fn = fn,
+    .ctx = ctx,
+    .dep_start = self->deps.len,
+    .ndeps = ndeps,
+  };
+  TaskNodes_push(&self->nodes, node);
+  TaskIds_extend_from_slice(&self->deps, deps, ndeps);
+  self->built = false;
+  self->ran = false;
+  return id;
+}
+
+usize
+task_graph_len(const TaskGraph *self)
+{
+  return self->nodes.len;
+}
+
+/* 由依赖表反转出后继表 (计数, 前缀和, 填充) */
+static void
+task_graph_build(TaskGraph *self)
+{
+  TaskNode *nodes = self->nodes.data;
+  usize n = self->nodes.len;
+  for (usize i = 0; i < n; i++)
+  {
+    nodes[i].nsucc = 0;
+  }
+  for (usize e = 0; e < self->deps.len; e++)
+  {
+    nodes[self->deps.data[e]].nsucc++;
+  }
+  usize start = 0;
+  TaskIds_clear(&self->sources);
+  for (usize i = 0; i < n; i++)
+  {
+    nodes[i].succ_start = start;
+    start += nodes[i].nsucc;
+    nodes[i].nsucc = 0;
+    if (nodes[i].ndeps == 0)
+    {
+      TaskIds_push(&self->sources, i);
+    }
+  }
+  TaskIds_resize_with(&self->succ, self->deps.len, 0);
+  TaskInputs_resize_with(&self->inputs, self->deps.len, NULL);
+  /* 按任务编号递增填充, 每个后继表因此也是有序的 */
+  for (usize i = 0; i < n; i++)
+  {
+    for (usize k = 0; k < nodes[i].ndeps; k++)
+    {
+      TaskNode *dep = &nodes[self->deps.data[nodes[i].dep_start + k]];
+      self->succ.data[dep->succ_start + dep->nsucc++] = i;
+    }
+  }
+  self->built = true;
+}
+
+/*
+ * ===================================================================
+ * 2. 执行
+ * ===================================================================
+ */
+
+typedef struct TaskBatch
+{
+  TaskGraph *graph;
+  const TaskId *ids;
+  usize len;
+} TaskBatch;
+
+static void task_run_from(TaskGraph *g, TaskId id);
+
+/* 依赖计数减一, 返回任务是否因此就绪 */
+static bool
+task_release(TaskGraph *g, TaskId id)
+{
+  return atomic_fetch_sub_explicit(&g->nodes.data[id].pending, 1, memory_order_acq_rel) == 1;
+}
+
+/* 对 ids 中的每个任务释放一次依赖, 就绪的任务并行执行 (二分: 左半 spawn, 右半就地) */
+static void
+task_batch(void *arg)
+{
+  TaskBatch *b = (TaskBatch *)arg;
+  if (b->len == 1)
+  {
+    if (task_release(b->graph, b->ids[0]))
+      task_run_from(b->graph, b->ids[0]);
+    return;
+  }
+  usize half = b->len / 2;
+  TaskBatch left = {.graph = b->graph, .ids = b->ids, .len = half};
+  TaskBatch right = {.graph = b->graph, .ids = b->ids + half, .len = b->len - half};
+  StealTask *task = steal_spawn(task_batch, &left);
+  task_batch(&right);
+  steal_join(task);
+}
+
+/* 执行任务 id; 只有一个后继时原地继续, 否则交给 task_batch */
+static void
+task_run_from(TaskGraph *g, TaskId id)
+{
+  for (;;)
+  {
+    TaskNode *node = &g->nodes.data[id];
+    const TaskId *deps = g->deps.data + node->dep_start;
+    anyptr *inputs = g->inputs.data + node->dep_start;
+
+    bool ready = true;
+    for (usize k = 0; k < node->ndeps; k++)
+    {
+      const TaskResult *dep = &g->nodes.data[deps[k]].result;
+      if (ris_err(*dep))
+      {
+        /* 依赖失败: 不执行, 原样向下游传递 (origin 不变) */
+        node->result = *dep;
+        ready = false;
+        break;
+      }
+      inputs[k] = dep->value.ok;
+    }
+    if (ready)
+    {
+      node->result = node->fn(node->ctx, inputs, node->ndeps);
+      if (ris_err(node->result))
+        node->result.value.err.origin = id;
+    }
+
+    const TaskId *succ = g->succ.data + node->succ_start;
+    if (node->nsucc == 1)
+    {
+      if (!task_release(g, succ[0]))
+        return;
+      id = succ[0];
+      continue;
+    }
+    if (node->nsucc != 0)
+    {
+      TaskBatch batch = {.graph = g, .ids = succ, .len = node->nsucc};
+      task_batch(&batch);
+    }
+    return;
+  }
+}
+
+bool
+task_graph_run(TaskGraph *self, StealPool *pool)
+{
+  if (!self->built)
+  {
+    task_graph_build(self);
+  }
+  TaskNode *nodes = self->nodes.data;
+  for (usize i = 0; i < self->nodes.len; i++)
+  {
+    /* 源任务多算一个依赖, 由下面的 task_batch 释放 */
+    atomic_store_explicit(
+      &nodes[i].pending, nodes[i].ndeps == 0 ? 1 : nodes[i].ndeps, memory_order_relaxed);
+  }
+  if (self->sources.len != 0)
+  {
+    TaskBatch batch = {.graph = self, .ids = self->sources.data, .len = self->sources.len};
+    steal_pool_run(pool, task_batch, &batch);
+  }
+  self->ran = true;
+
+  for (usize i = 0; i < self->nodes.len; i++)
+  {
+    if (ris_err(nodes[i].result))
+      return false;
+  }
+  return true;
+}
+
+TaskResult
+task_graph_result(const TaskGraph *self, TaskId id)
+{
+  asrt_msg(self->ran, "task_graph_result: graph changed since the last run");
+  asrt_msg(id < self->nodes.len, "task_graph_result: no task {}", id);
+  return self->nodes.data[id].result;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * @file
+ * @brief (Impl) 任务图: 任务的输出是 Result, 依赖在添加任务时声明, 在 StealPool 上执行。
+ *
+ * - 每个任务是 `TaskResult fn(ctx, inputs, ninputs)`, inputs 按声明顺序是各依赖的 Ok 值;
+ * - 依赖只能指向已经添加的任务, 所以图天然无环;
+ * - 任务完成时把后继的未完成依赖数减一, 减到 0 的后继立即 spawn, 不轮询, 也不用条件变量;
+ * - 某个依赖失败时任务本身不执行, 结果直接是那个依赖的 Err (origin 仍是最先失败的任务),
+ *   错误就这样沿边一直传到下游; 与失败无关的分支照常执行。
+ *
+ * 只有一个后继时在原地继续执行 (不递归), 长链不会撑爆栈; 栈深度只随
+ * "有多个后继的任务" 沿路径的层数增长。
+ *
+ * @example
+ * static TaskResult parse(void *ctx, const anyptr *in, usize n) {
+ *   Ast *ast = parse_file(ctx);
+ *   return ast ? TASK_OK(ast) : TASK_FAIL(1, "syntax error");
+ * }
+ * static TaskResult analyze(void *ctx, const anyptr *in, usize n) {
+ *   Ast *ast = in[0]; Symbols *syms = in[1]; ...
+ * }
+ * TaskId p = task_graph_add(g, parse, file, NULL, 0);
+ * TaskId i = task_graph_add(g, intern, NULL, (TaskId[]){p}, 1);
+ * TaskId a = task_graph_add(g, analyze, NULL, (TaskId[]){p, i}, 2);
+ * if (!task_graph_run(g, pool)) {
+ *   TaskError e = rexpect_err(task_graph_result(g, a), "expected a failure");
+ *   // e.origin == p: 解析失败, intern 与 analyze 都没有执行
+ * }
+ */
+
+#include <core/mem/sysalc.h>  // SystemAlloc
+#include <core/option.h>      // Option
+#include <core/result.h>      // DEFINE_RESULT, Ok, Err
+#include <core/type.h>        // usize, i32, str, anyptr
+#include <std/thread/steal.h> // StealPool
+
+/** @brief 任务编号: task_graph_add 按添加顺序返回 0, 1, 2, ... */
+typedef usize TaskId;
+
+/** @brief 不对应任何任务的编号。 */
+#define TASK_NO_ID ((TaskId)-1)
+
+/**
+ * @brief 任务的错误值。
+ */
+typedef struct TaskError
+{
+  i32 code;      /* 由任务自行定义 */
+  str msg;       /* 静态字符串, 可以为 NULL */
+  TaskId origin; /* 最先失败的任务 (由任务图填写) */
+} TaskError;
+
+DEFINE_RESULT(anyptr, TaskError)
+
+/** @brief 任务的输出: Ok 是任意指针 (通常指向 ctx 中的结果), Err 是 TaskError。 */
+typedef Result_anyptr_TaskError TaskResult;
+
+/** @brief 构造成功的任务输出。 */
+#define TASK_OK(ptr) Ok(anyptr, TaskError, (anyptr)(ptr))
+
+/** @brief 构造失败的任务输出 (origin 由任务图填写)。 */
+#define TASK_FAIL(err_code, err_msg)                                                               \
+  Err(anyptr, TaskError, (TaskError){.code = (err_code), .msg = (err_msg), .origin = TASK_NO_ID})
+
+/**
+ * @brief 任务函数。
+ *
+ * @param inputs  各依赖的 Ok 值, 顺序与 task_graph_add 的 deps 相同 (只读)
+ * @param ninputs 依赖个数
+ */
+typedef TaskResult (*TaskFn)(void *ctx, const anyptr *inputs, usize ninputs);
+
+/**
+ * @brief 任务图 (不透明类型)。
+ */
+typedef struct TaskGraph TaskGraph;
+
+DEFINE_OPTION(TaskGraphPtr, TaskGraph *);
+
+/**
+ * @brief 创建空的任务图。
+ * @return Some(TaskGraph*) 成功, None 失败 (OOM)。
+ */
+Option_TaskGraphPtr task_graph_new(SystemAlloc *backing_alloc);
+
+/**
+ * @brief 释放任务图 (不会释放任务输出所指向的内存)。
+ */
+void task_graph_free(TaskGraph *self);
+
+/**
+ * @brief 添加任务 fn(ctx, ...), 它在 deps 中的所有任务成功之后执行。
+ *
+ * deps 中的每个编号都必须已经由 task_graph_add 返回; 同一个依赖可以出现多次。
+ * 不能在 task_graph_run 执行期间调用。
+ *
+ * @return 新任务的编号。
+ */
+TaskId task_graph_add(TaskGraph *self, TaskFn fn, void *ctx, const TaskId *deps, usize ndeps);
+
+/**
+ * @brief 任务个数。
+ */
+usize task_graph_len(const TaskGraph *self);
+
+/**
+ * @brief 执行整张图, 所有任务完成 (或因依赖失败而跳过) 后返回。
+ *
+ * pool 为 NULL 时在调用线程中按依赖顺序执行。同一张图可以多次执行,
+ * 每次都会重新执行所有任务。
+ *
+ * @return 所有任务都成功时为 true。
+ */
+bool task_graph_run(TaskGraph *self, StealPool *pool);
+
+/**
+ * @brief 任务 id 在最近一次 task_graph_run 中的输出。
+ * @note 添加任务之后、再次执行之前调用会 panic。
+ */
+TaskResult task_graph_result(const TaskGraph *self, TaskId id);
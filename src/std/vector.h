@@ -27,8 +27,10 @@
 
 #include <core/mem/allocer.h> // L1 Trait (ALLOC, REALLOC, ...)
 #include <core/mem/layout.h>  // L1 Layout
+#include <core/msg/asrt.h>    // L3 asrt_msg
 #include <core/msg/panic.h>   // L3 Panic
 #include <core/type.h>        // L0 Types (usize, byte, ...)
+#include <string.h>           // memcpy, memmove
 
 /*
  * ===================================================================
@@ -175,4 +177,104 @@
   static inline const T *TypeName##_as_const_ptr(const TypeName *self)                             \
   {                                                                                                \
     return self->data;                                                                             \
+  }                                                                                                \
+                                                                                                   \
+  /* --- 5. 批量操作 --- */                                                                        \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 移除并取出最后一个元素。                                                               \
+   * @param out (可为 NULL) 接收被移除的元素。                                                     \
+   * @return 向量为空时返回 false。                                                                \
+   */                                                                                              \
+  static inline bool TypeName##_pop(TypeName *self, T *out)                                        \
+  {                                                                                                \
+    if (self->len == 0)                                                                            \
+      return false;                                                                                \
+    self->len--;                                                                                   \
+    if (out != NULL)                                                                               \
+    {                                                                                              \
+      *out = self->data[self->len];                                                                \
+    }                                                                                              \
+    return true;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 把长度缩短到 new_len (new_len >= len 时什么也不做, 不释放容量)。 */                   \
+  static inline void TypeName##_truncate(TypeName *self, usize new_len)                            \
+  {                                                                                                \
+    if (new_len < self->len)                                                                       \
+    {                                                                                              \
+      self->len = new_len;                                                                         \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 把长度改为 new_len: 变短时截断, 变长时新位置都填入 value。                             \
+   */                                                                                              \
+  static inline void TypeName##_resize_with(TypeName *self, usize new_len, T value)                \
+  {                                                                                                \
+    if (new_len <= self->len)                                                                      \
+    {                                                                                              \
+      self->len = new_len;                                                                         \
+      return;                                                                                      \
+    }                                                                                              \
+    TypeName##_reserve_more(self, new_len - self->len);                                            \
+    for (usize i = self->len; i < new_len; i++)                                                    \
+    {                                                                                              \
+      self->data[i] = value;                                                                       \
+    }                                                                                              \
+    self->len = new_len;                                                                           \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 在末尾追加 count 个元素: 只扩容一次, 然后整块 memcpy。                                 \
+   * @note items 不能指向本向量自身的存储 (扩容后会失效)。                                         \
+   */                                                                                              \
+  static inline void TypeName##_extend_from_slice(TypeName *self, const T *items, usize count)     \
+  {                                                                                                \
+    if (count == 0)                                                                                \
+      return;                                                                                      \
+    TypeName##_reserve_more(self, count);                                                          \
+    memcpy(self->data + self->len, items, count * sizeof(T));                                      \
+    self->len += count;                                                                            \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief 在 index 处插入 count 个元素, 后面的元素整体后移 (index == len 等价于追加)。           \
+   * @note items 不能指向本向量自身的存储。                                                        \
+   */                                                                                              \
+  static inline void TypeName##_insert_range(                                                      \
+    TypeName *self, usize index, const T *items, usize count)                                      \
+  {                                                                                                \
+    asrt_msg(index <= self->len, "insert index {} out of bounds (len {})", index, self->len);      \
+    if (count == 0)                                                                                \
+      return;                                                                                      \
+    TypeName##_reserve_more(self, count);                                                          \
+    memmove(self->data + index + count, self->data + index, (self->len - index) * sizeof(T));      \
+    memcpy(self->data + index, items, count * sizeof(T));                                          \
+    self->len += count;                                                                            \
+  }                                                                                                \
+                                                                                                   \
+  /** @brief 移除 [start, end) 范围内的元素, 后面的元素整体前移。 */                               \
+  static inline void TypeName##_remove_range(TypeName *self, usize start, usize end)               \
+  {                                                                                                \
+    asrt_msg(start <= end && end <= self->len,                                                     \
+             "remove range [{}, {}) out of bounds (len {})",                                       \
+             start,                                                                                \
+             end,                                                                                  \
+             self->len);                                                                           \
+    memmove(self->data + start, self->data + end, (self->len - end) * sizeof(T));                  \
+    self->len -= end - start;                                                                      \
+  }                                                                                                \
+                                                                                                   \
+  /**                                                                                              \
+   * @brief O(1) 移除 index 处的元素: 用最后一个元素填补空位 (不保持顺序)。                        \
+   * @return 被移除的元素。                                                                        \
+   */                                                                                              \
+  static inline T TypeName##_swap_remove(TypeName *self, usize index)                              \
+  {                                                                                                \
+    asrt_msg(index < self->len, "swap_remove index {} out of bounds (len {})", index, self->len);  \
+    T removed = self->data[index];                                                                 \
+    self->len--;                                                                                   \
+    self->data[index] = self->data[self->len];                                                     \
+    return removed;                                                                                \
   }
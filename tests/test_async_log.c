@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_async_log.c */
+
+#include <core/mem/sysalc.h>
+#include <std/log/async.h>
+#include <std/string.h>
+#include <std/test/test.h>
+#include <fcntl.h>    // open
+#include <stdio.h>    // tmpfile
+#include <sys/wait.h> // waitpid
+#include <threads.h>
+#include <unistd.h> // fork, lseek, read
+
+static SystemAlloc g_sys;
+
+/* 把临时文件的全部内容读进 s */
+static void
+read_back(int fd, sstring *s)
+{
+  char buf[4096];
+  ssize_t n;
+  sstring_clear(s);
+  lseek(fd, 0, SEEK_SET);
+  while ((n = read(fd, buf, sizeof(buf))) > 0)
+  {
+    sstring_push_bytes_adapter(s, buf, (usize)n);
+  }
+}
+
+/*
+ * =========================================
+ * 套件 1: 单线程, 同步回退
+ * =========================================
+ */
+TEST_SUITE(test_async_basic)
+{
+  SUITE_START("Async Log Basic");
+
+  FILE *file = tmpfile();
+  int fd = fileno(file);
+  sstring *s = sstring_new(&g_sys);
+
+  TEST_ASSERT(async_log_start(fd, 1000), "Writer should start");
+  TEST_ASSERT(!async_log_start(fd, 1000), "Second start should fail");
+  TEST_ASSERT(format_to_async("a={} b={}\n", 1, "two"), "Write should be accepted");
+  TEST_ASSERT(format_to_async("c={}\n", 3.5), "Write should be accepted");
+
+  /* 延迟很长: 显式 flush 之前还在缓冲区里 */
+  read_back(fd, s);
+  TEST_ASSERT(sstring_len(s) == 0, "Nothing should be written yet, got: {}", s_as_str(s));
+  TEST_ASSERT(async_log_flush(), "Flush failed");
+  read_back(fd, s);
+  TEST_ASSERT(str_cmp(s_as_str(s), "a=1 b=two\nc=3.5\n") == EQUAL, "Mismatch: {}", s_as_str(s));
+
+  /* 比整个环还大的消息: 直接写出, 且排在之前的消息之后 */
+  static char big[ASYNC_LOG_RING_SIZE + 10];
+  memset(big, 'B', sizeof(big) - 1);
+  format_to_async("before\n");
+  format_to_async("{}\n", (str)big);
+  format_to_async("after\n");
+  async_log_stop();
+  read_back(fd, s);
+  TEST_ASSERT(sstring_len(s) == 16 + 7 + sizeof(big) + 6, "Length mismatch: {}", sstring_len(s));
+  TEST_ASSERT(str_ends_with(s_as_str(s), "BB\nafter\n"), "Big message out of order");
+
+  /* 停止后同步写出 */
+  format_to_async("sync\n");
+  read_back(fd, s);
+  TEST_ASSERT(str_ends_with(s_as_str(s), "after\nsync\n"), "Stopped sink should write directly");
+
+  sstring_destroy(s);
+  fclose(file);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 多线程, 线程内保序
+ * =========================================
+ */
+#define PRODUCERS 4
+#define PER_THREAD 5000
+
+static int
+producer_main(void *arg)
+{
+  int id = (int)(uintptr_t)arg;
+  for (int i = 0; i < PER_THREAD; i++)
+  {
+    format_to_async("{} {}\n", id, i);
+  }
+  return 0;
+}
+
+TEST_SUITE(test_async_threads)
+{
+  SUITE_START("Async Log Threads");
+
+  FILE *file = tmpfile();
+  int fd = fileno(file);
+  sstring *s = sstring_new(&g_sys);
+
+  TEST_ASSERT(async_log_start(fd, 1), "Writer should start");
+  thrd_t threads[PRODUCERS];
+  for (int t = 0; t < PRODUCERS; t++)
+  {
+    thrd_create(&threads[t], producer_main, (void *)(uintptr_t)t);
+  }
+  for (int t = 0; t < PRODUCERS; t++)
+  {
+    thrd_join(threads[t], NULL);
+  }
+  async_log_stop();
+  read_back(fd, s);
+
+  /* 逐行解析: 每一行完整, 每个线程内的序号严格递增 */
+  int next[PRODUCERS] = {0};
+  int lines = 0;
+  bool ordered = true;
+  const char *p = s_as_str(s);
+  while (*p != '\0' && ordered)
+  {
+    int id = 0, seq = 0;
+    while (*p >= '0' && *p <= '9')
+    {
+      id = id * 10 + (*p++ - '0');
+    }
+    ordered = *p++ == ' ';
+    while (*p >= '0' && *p <= '9')
+    {
+      seq = seq * 10 + (*p++ - '0');
+    }
+    ordered = ordered && *p++ == '\n' && id < PRODUCERS && seq == next[id];
+    next[id] = seq + 1;
+    lines++;
+  }
+  TEST_ASSERT(ordered, "Lines must be intact and ordered within a thread (line {})", lines);
+  TEST_ASSERT(lines == PRODUCERS * PER_THREAD,
+              "Expected {} lines, got {}",
+              PRODUCERS * PER_THREAD,
+              lines);
+
+  sstring_destroy(s);
+  fclose(file);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: panic 前写出缓冲的消息
+ * =========================================
+ */
+TEST_SUITE(test_async_panic)
+{
+  SUITE_START("Async Log Panic");
+
+  FILE *file = tmpfile();
+  int fd = fileno(file);
+  sstring *s = sstring_new(&g_sys);
+
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    /* 子进程: 丢掉 panic 自己的输出, 只关心缓冲的日志 */
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDERR_FILENO);
+    async_log_start(fd, 60000);
+    format_to_async("last words {}\n", 42);
+    panic("boom");
+  }
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  TEST_ASSERT(WIFSIGNALED(status), "Child should abort");
+  read_back(fd, s);
+  TEST_ASSERT(str_cmp(s_as_str(s), "last words 42\n") == EQUAL,
+              "Buffered message lost: {}",
+              s_as_str(s));
+
+  sstring_destroy(s);
+  fclose(file);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_async_basic);
+  RUN_SUITE(test_async_threads);
+  RUN_SUITE(test_async_panic);
+
+  TEST_SUMMARY();
+}
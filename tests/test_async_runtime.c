@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_async_runtime.c */
+
+#include <core/fmt/tobuf.h>
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/async/runtime.h>
+#include <std/test/test.h>
+#include <errno.h>  // ENOENT
+#include <fcntl.h>  // O_RDONLY
+#include <unistd.h> // getpid, unlink
+
+static SystemAlloc g_sys;
+
+DEFINE_ALLOC_RELEASER(SystemAlloc, SYSTEM)
+DEFINE_ALLOC_RELEASER(Bump, BUMP)
+
+#define NFILES 64
+#define FILE_BYTES 10000
+#define CHUNK 4096
+
+static char g_paths[NFILES][64];
+
+/* 第 i 个文件的第 k 个字节 */
+static u8
+file_byte(usize i, usize k)
+{
+  return (u8)(i * 31 + k * 7);
+}
+
+/*
+ * ===================================================================
+ * 协程: 写入一个文件, 再分块读回并校验
+ * ===================================================================
+ */
+
+typedef struct RoundTrip
+{
+  AsyncTask task;
+  usize index;
+  i32 fd;
+  usize done;
+  u8 buf[CHUNK];
+  bool *ok;
+} RoundTrip;
+
+static AsyncPoll
+round_trip(AsyncTask *t)
+{
+  RoundTrip *r = (RoundTrip *)t;
+  ASYNC_BEGIN(t);
+
+  ASYNC_AWAIT_OPEN(t, g_paths[r->index], O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (t->io_result < 0)
+    ASYNC_RETURN(t);
+  r->fd = (i32)t->io_result;
+
+  /* 分块写入 (每块写之前在 buf 中生成内容) */
+  for (r->done = 0; r->done < FILE_BYTES; r->done += (usize)t->io_result)
+  {
+    for (usize k = 0; k < CHUNK; k++)
+    {
+      r->buf[k] = file_byte(r->index, r->done + k);
+    }
+    usize n = FILE_BYTES - r->done < CHUNK ? FILE_BYTES - r->done : CHUNK;
+    ASYNC_AWAIT_WRITE(t, r->fd, r->buf, n, r->done);
+    if (t->io_result <= 0)
+      ASYNC_RETURN(t);
+  }
+
+  /* 分块读回并校验 */
+  for (r->done = 0;; r->done += (usize)t->io_result)
+  {
+    ASYNC_AWAIT_READ(t, r->fd, r->buf, CHUNK, r->done);
+    if (t->io_result <= 0)
+      break;
+    for (i64 k = 0; k < t->io_result; k++)
+    {
+      if (r->buf[k] != file_byte(r->index, r->done + (usize)k))
+        ASYNC_RETURN(t);
+    }
+  }
+  if (t->io_result < 0 || r->done != FILE_BYTES)
+    ASYNC_RETURN(t);
+
+  ASYNC_AWAIT_CLOSE(t, r->fd);
+  *r->ok = t->io_result == 0;
+  ASYNC_END(t);
+}
+
+/* 打开不存在的文件 */
+typedef struct Missing
+{
+  AsyncTask task;
+  i64 result;
+} Missing;
+
+static AsyncPoll
+open_missing(AsyncTask *t)
+{
+  Missing *m = (Missing *)t;
+  ASYNC_BEGIN(t);
+  ASYNC_AWAIT_OPEN(t, "/nonexistent/libkx/file", O_RDONLY, 0);
+  m->result = t->io_result;
+  ASYNC_END(t);
+}
+
+/* 让出: 两个任务交替记录自己的编号 */
+typedef struct Yielder
+{
+  AsyncTask task;
+  char id;
+  usize i;
+  char *log;
+  usize *log_len;
+} Yielder;
+
+static AsyncPoll
+yielder(AsyncTask *t)
+{
+  Yielder *y = (Yielder *)t;
+  ASYNC_BEGIN(t);
+  for (y->i = 0; y->i < 3; y->i++)
+  {
+    y->log[(*y->log_len)++] = y->id;
+    ASYNC_YIELD(t);
+  }
+  ASYNC_END(t);
+}
+
+/* 在协程内部 spawn 子任务 */
+typedef struct Parent
+{
+  AsyncTask task;
+  bool *oks;
+} Parent;
+
+static AsyncPoll
+parent(AsyncTask *t)
+{
+  Parent *p = (Parent *)t;
+  for (usize i = 0; i < NFILES; i++)
+  {
+    RoundTrip *r = ASYNC_NEW(SYSTEM, &g_sys, RoundTrip, round_trip);
+    r->index = i;
+    r->ok = &p->oks[i];
+    async_spawn(t->rt, &r->task);
+  }
+  return ASYNC_READY;
+}
+
+static usize g_frames_released;
+
+static void
+count_release(void *alloc, anyptr ptr, Layout layout)
+{
+  (void)alloc;
+  (void)ptr;
+  (void)layout;
+  g_frames_released++;
+}
+
+/*
+ * =========================================
+ * 套件: 对每个后端运行同样的检查
+ * =========================================
+ */
+static void
+check_backend(AsyncRt *rt)
+{
+  /* 1. 许多文件并发地写入并读回 (槽位不够时排队) */
+  bool oks[NFILES] = {0};
+  for (usize i = 0; i < NFILES; i++)
+  {
+    RoundTrip *r = ASYNC_NEW(SYSTEM, &g_sys, RoundTrip, round_trip);
+    r->index = i;
+    r->ok = &oks[i];
+    async_spawn(rt, &r->task);
+  }
+  async_rt_run(rt);
+  bool all = true;
+  for (usize i = 0; i < NFILES; i++)
+  {
+    all = all && oks[i];
+  }
+  TEST_ASSERT(all, "{} files written and read back concurrently", (usize)NFILES);
+
+  /* 2. 错误以 -errno 返回 */
+  Missing missing = {0};
+  async_task_init(&missing.task, open_missing, count_release, NULL, LAYOUT_OF(Missing));
+  g_frames_released = 0;
+  async_spawn(rt, &missing.task);
+  async_rt_run(rt);
+  TEST_ASSERT(missing.result == -ENOENT,
+              "Open of a missing file yields -ENOENT (got {})",
+              missing.result);
+  TEST_ASSERT(g_frames_released == 1, "Finished frame goes to its release function");
+
+  /* 3. 让出按 FIFO 轮转 */
+  char log[8] = {0};
+  usize log_len = 0;
+  Yielder a = {.id = 'a', .log = log, .log_len = &log_len};
+  Yielder b = {.id = 'b', .log = log, .log_len = &log_len};
+  async_task_init(&a.task, yielder, NULL, NULL, LAYOUT_OF(Yielder));
+  async_task_init(&b.task, yielder, NULL, NULL, LAYOUT_OF(Yielder));
+  async_spawn(rt, &a.task);
+  async_spawn(rt, &b.task);
+  async_rt_run(rt);
+  TEST_ASSERT(log_len == 6 && log[0] == 'a' && log[1] == 'b' && log[4] == 'a' && log[5] == 'b',
+              "Yielding tasks interleave ({})",
+              (str)log);
+
+  /* 4. 在协程中 spawn, 帧来自 Bump */
+  Bump arena;
+  bump_init(&arena, &g_sys);
+  bool child_oks[NFILES] = {0};
+  Parent *p = ASYNC_NEW(BUMP, &arena, Parent, parent);
+  p->oks = child_oks;
+  async_spawn(rt, &p->task);
+  async_rt_run(rt);
+  all = true;
+  for (usize i = 0; i < NFILES; i++)
+  {
+    all = all && child_oks[i];
+  }
+  TEST_ASSERT(all, "Tasks spawned from a coroutine run in the same loop");
+  bump_destroy(&arena);
+}
+
+TEST_SUITE(test_async_runtime)
+{
+  SUITE_START("Async Runtime");
+
+  for (usize i = 0; i < NFILES; i++)
+  {
+    format_to_buf(g_paths[i], sizeof(g_paths[i]), "/tmp/libkx_async_{}_{}", (i64)getpid(), i);
+  }
+
+  /* 线程后端: 只有 4 个 I/O 槽位, 强制排队 */
+  AsyncConfig threads = {.backend = ASYNC_BACKEND_THREADS, .entries = 4, .io_threads = 3};
+  AsyncRt *rt = oexpect(async_rt_new(&g_sys, &threads), "Failed to create runtime");
+  TEST_ASSERT(async_rt_backend(rt) == ASYNC_BACKEND_THREADS, "Thread backend selected");
+  check_backend(rt);
+  async_rt_free(rt);
+
+  /* 自动选择: 有 io_uring 时使用它 */
+  AsyncConfig small = {.entries = 4};
+  rt = oexpect(async_rt_new(&g_sys, &small), "Failed to create runtime");
+  check_backend(rt);
+  if (async_rt_backend(rt) == ASYNC_BACKEND_URING)
+  {
+    format_to_file(stdout, "    (io_uring available)\n");
+  }
+  async_rt_free(rt);
+
+  rt = oexpect(async_rt_new(&g_sys, NULL), "Failed to create runtime");
+  check_backend(rt);
+  async_rt_free(rt);
+
+  for (usize i = 0; i < NFILES; i++)
+  {
+    unlink(g_paths[i]);
+  }
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_async_runtime);
+
+  TEST_SUMMARY();
+}
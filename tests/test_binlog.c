@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_binlog.c */
+
+#include <core/mem/sysalc.h>
+#include <std/log/binlog.h>
+#include <std/string.h>
+#include <std/test/test.h>
+#include <threads.h>
+#include <unistd.h> // pipe, read, close
+
+static SystemAlloc g_sys;
+
+static usize
+drain_into(sstring *s)
+{
+  return binlog_drain(s, sstring_push_char_adapter, sstring_push_bytes_adapter);
+}
+
+/*
+ * =========================================
+ * 套件 1: 单线程记录与解码
+ * =========================================
+ */
+TEST_SUITE(test_binlog_basic)
+{
+  SUITE_START("Binlog Basic");
+
+  sstring *s = sstring_new(&g_sys);
+  drain_into(s);
+  sstring_clear(s);
+
+  /* 字符串只记录指针: 解码时读到的是缓冲区当时的内容 */
+  static char name[16] = "parser";
+  binlog("[{}] id={} delta={} t={}{}", (str)name, (u64)42, -7, 0.5, (char)'!');
+  binlog("no args");
+  vstr view = {.ptr = "abcdef", .len = 3};
+  binlog("null={} view={}", (str)NULL, view);
+
+  usize n = drain_into(s);
+  TEST_ASSERT(n == 3, "Expected 3 records, got {}", n);
+  TEST_ASSERT(str_cmp(s_as_str(s),
+                      "[parser] id=42 delta=-7 t=0.5!\n"
+                      "no args\n"
+                      "null=(null) view=abc\n") == EQUAL,
+              "Decoded output mismatch: {}",
+              s_as_str(s));
+
+  sstring_clear(s);
+  TEST_ASSERT(drain_into(s) == 0 && sstring_len(s) == 0, "Second drain should be empty");
+
+  /* 各种整数宽度和符号都按原值还原 */
+  binlog("{} {} {} {} {}", (i8)-128, (u16)65535, (i64)INT64_MIN, (u32)UINT32_MAX, (f32)1.5f);
+  drain_into(s);
+  TEST_ASSERT(str_cmp(s_as_str(s), "-128 65535 -9223372036854775808 4294967295 1.5\n") == EQUAL,
+              "Integer round-trip mismatch: {}",
+              s_as_str(s));
+
+  sstring_destroy(s);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 缓冲区写满时丢弃并计数
+ * =========================================
+ */
+TEST_SUITE(test_binlog_overflow)
+{
+  SUITE_START("Binlog Overflow");
+
+  sstring *s = sstring_new(&g_sys);
+  u64 dropped_before = binlog_dropped();
+
+  /* 每条记录至少 32 字节, 足以写满环形缓冲区 */
+  usize total = BINLOG_RING_SIZE / 16;
+  for (usize i = 0; i < total; i++)
+  {
+    binlog("record {}", i);
+  }
+  u64 dropped = binlog_dropped() - dropped_before;
+  TEST_ASSERT(dropped > 0, "Some records should have been dropped");
+
+  usize n = drain_into(s);
+  TEST_ASSERT(n + dropped == total, "Kept + dropped should equal total: {} + {}", n, dropped);
+  TEST_ASSERT(str_starts_with(s_as_str(s), "record 0\nrecord 1\n"), "Oldest records are kept");
+  TEST_ASSERT(str_ends_with(s_as_str(s), " records dropped\n"), "Drop notice missing");
+
+  /* 消费后空间被归还, 可以继续记录 (同时覆盖回绕) */
+  for (int round = 0; round < 4; round++)
+  {
+    for (usize i = 0; i < 500; i++)
+    {
+      binlog("again {} {}", round, i);
+    }
+    sstring_clear(s);
+    n = drain_into(s);
+    TEST_ASSERT(n == 500, "Round {}: expected 500 records, got {}", round, n);
+  }
+  TEST_ASSERT(binlog_dropped() - dropped_before == dropped, "No more drops after draining");
+
+  sstring_destroy(s);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: 多线程, 线程内保序
+ * =========================================
+ */
+#define PRODUCERS 4
+#define PER_THREAD 200
+
+static int
+producer_main(void *arg)
+{
+  int id = (int)(uintptr_t)arg;
+  for (int i = 0; i < PER_THREAD; i++)
+  {
+    binlog("{} {}", id, i);
+  }
+  return 0;
+}
+
+TEST_SUITE(test_binlog_threads)
+{
+  SUITE_START("Binlog Threads");
+
+  sstring *s = sstring_new(&g_sys);
+  thrd_t threads[PRODUCERS];
+  for (int t = 0; t < PRODUCERS; t++)
+  {
+    thrd_create(&threads[t], producer_main, (void *)(uintptr_t)t);
+  }
+  for (int t = 0; t < PRODUCERS; t++)
+  {
+    thrd_join(threads[t], NULL);
+  }
+
+  usize n = drain_into(s);
+  TEST_ASSERT(
+    n == PRODUCERS * PER_THREAD, "Expected {} records, got {}", PRODUCERS * PER_THREAD, n);
+
+  /* 逐行解析, 检查每个线程内的序号严格递增 */
+  int next[PRODUCERS] = {0};
+  bool ordered = true;
+  const char *p = s_as_str(s);
+  while (*p != '\0')
+  {
+    int id = 0, seq = 0;
+    while (*p != ' ')
+    {
+      id = id * 10 + (*p++ - '0');
+    }
+    p++;
+    while (*p != '\n')
+    {
+      seq = seq * 10 + (*p++ - '0');
+    }
+    p++;
+    ordered = ordered && id < PRODUCERS && seq == next[id];
+    next[id] = seq + 1;
+  }
+  TEST_ASSERT(ordered, "Records must stay in order within a thread");
+
+  /* 已退出线程的环会被新线程复用 */
+  thrd_t again;
+  thrd_create(&again, producer_main, (void *)(uintptr_t)0);
+  thrd_join(again, NULL);
+  sstring_clear(s);
+  TEST_ASSERT(drain_into(s) == PER_THREAD, "Reused ring should be drained");
+
+  sstring_destroy(s);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 4: 后台线程写入 fd
+ * =========================================
+ */
+TEST_SUITE(test_binlog_worker)
+{
+  SUITE_START("Binlog Worker");
+
+  int fds[2];
+  TEST_ASSERT(pipe(fds) == 0, "pipe() failed");
+
+  TEST_ASSERT(binlog_start(fds[1], 1), "Worker should start");
+  TEST_ASSERT(!binlog_start(fds[1], 1), "Second start should fail");
+  for (int i = 0; i < 10; i++)
+  {
+    binlog("line {}", i);
+  }
+  binlog_stop();
+  close(fds[1]);
+
+  char buf[256];
+  usize len = 0;
+  ssize_t r;
+  while ((r = read(fds[0], buf + len, sizeof(buf) - 1 - len)) > 0)
+  {
+    len += (usize)r;
+  }
+  buf[len] = '\0';
+  close(fds[0]);
+
+  TEST_ASSERT(str_starts_with(buf, "line 0\nline 1\n") && str_ends_with(buf, "line 9\n"),
+              "Worker output mismatch: {}",
+              (str)buf);
+  TEST_ASSERT(len == 70, "Expected 70 bytes, got {}", len);
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_binlog_basic);
+  RUN_SUITE(test_binlog_overflow);
+  RUN_SUITE(test_binlog_threads);
+  RUN_SUITE(test_binlog_worker);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_deque.c */
+
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/deque.h>
+#include <std/test/test.h>
+
+static SystemAlloc g_sys;
+
+DEFINE_DEQUE(Deque_i32, i32, SystemAlloc, SYSTEM)
+DEFINE_DEQUE(Deque_bump, u64, Bump, BUMP)
+
+/* 按顺序把队列内容 (经 _as_slices) 与 expected 比较 */
+static bool
+slices_equal(Deque_i32 *d, const i32 *expected, usize len)
+{
+  Deque_i32_Slices s = Deque_i32_as_slices(d);
+  if (s.first_len + s.second_len != len)
+    return false;
+  for (usize i = 0; i < s.first_len; i++)
+  {
+    if (s.first[i] != expected[i])
+      return false;
+  }
+  for (usize i = 0; i < s.second_len; i++)
+  {
+    if (s.second[i] != expected[s.first_len + i])
+      return false;
+  }
+  return true;
+}
+
+/*
+ * =========================================
+ * 套件 1: 两端操作
+ * =========================================
+ */
+TEST_SUITE(test_deque_ends)
+{
+  SUITE_START("Deque Ends");
+
+  Deque_i32 d;
+  Deque_i32_init(&d, &g_sys);
+  TEST_ASSERT(Deque_i32_is_empty(&d) && Deque_i32_cap(&d) == 0, "Empty deque allocates nothing");
+  TEST_ASSERT(!Deque_i32_pop_front(&d, NULL) && !Deque_i32_pop_back(&d, NULL),
+              "Pop on empty deque fails");
+  TEST_ASSERT(Deque_i32_front(&d) == NULL && Deque_i32_back(&d) == NULL, "No front / back");
+
+  Deque_i32_push_back(&d, 2);
+  Deque_i32_push_back(&d, 3);
+  Deque_i32_push_front(&d, 1);
+  Deque_i32_push_front(&d, 0);
+  i32 expect4[] = {0, 1, 2, 3};
+  TEST_ASSERT(slices_equal(&d, expect4, 4), "push_front / push_back order");
+  TEST_ASSERT(*Deque_i32_front(&d) == 0 && *Deque_i32_back(&d) == 3, "Front 0, back 3");
+
+  /* push_front 从下标 0 回绕到缓冲区末尾: 两段 */
+  Deque_i32_Slices s = Deque_i32_as_slices(&d);
+  TEST_ASSERT(s.first_len == 2 && s.second_len == 2, "Contents wrap into two slices");
+  TEST_ASSERT(*Deque_i32_get(&d, 2) == 2, "get(2) == 2");
+
+  i32 v = 0;
+  TEST_ASSERT(Deque_i32_pop_back(&d, &v) && v == 3, "pop_back returns 3");
+  TEST_ASSERT(Deque_i32_pop_front(&d, &v) && v == 0, "pop_front returns 0");
+  TEST_ASSERT(Deque_i32_len(&d) == 2, "Two left");
+
+  Deque_i32_clear(&d);
+  TEST_ASSERT(Deque_i32_is_empty(&d) && Deque_i32_cap(&d) == 8, "Clear keeps capacity");
+  Deque_i32_deinit(&d);
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 回绕状态下扩容, 与参考模型比较
+ * =========================================
+ */
+TEST_SUITE(test_deque_growth)
+{
+  SUITE_START("Deque Growth");
+
+  Deque_i32 d;
+  Deque_i32_init(&d, &g_sys);
+
+  /* 参考模型: 一个足够大的数组, 从中间向两边生长 */
+  static i32 model[20000];
+  usize lo = 10000, hi = 10000;
+  u64 rng = 12345;
+  bool all_ok = true;
+  for (i32 step = 0; step < 8000 && all_ok; step++)
+  {
+    rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+    u32 op = (u32)(rng >> 33) % 5;
+    i32 out = 0;
+    switch (op)
+    {
+    case 0:
+    case 1:
+      Deque_i32_push_back(&d, step);
+      model[hi++] = step;
+      break;
+    case 2:
+      Deque_i32_push_front(&d, step);
+      model[--lo] = step;
+      break;
+    case 3:
+      all_ok = Deque_i32_pop_front(&d, &out) == (lo < hi) && (lo == hi || out == model[lo]);
+      lo += lo < hi;
+      break;
+    default:
+      all_ok = Deque_i32_pop_back(&d, &out) == (lo < hi) && (lo == hi || out == model[hi - 1]);
+      hi -= lo < hi;
+      break;
+    }
+    all_ok = all_ok && Deque_i32_len(&d) == hi - lo;
+    if (step % 97 == 0)
+    {
+      all_ok = all_ok && slices_equal(&d, model + lo, hi - lo);
+    }
+  }
+  TEST_ASSERT(all_ok, "Random push/pop at both ends should match the model");
+  TEST_ASSERT((Deque_i32_cap(&d) & (Deque_i32_cap(&d) - 1)) == 0, "Capacity is a power of two");
+
+  /* 构造一个回绕的满队列, 再扩容: 内容必须保持顺序 */
+  Deque_i32_deinit(&d);
+  Deque_i32_init(&d, &g_sys);
+  for (i32 i = 0; i < 8; i++)
+  {
+    Deque_i32_push_back(&d, i);
+  }
+  for (i32 i = 0; i < 5; i++)
+  {
+    Deque_i32_pop_front(&d, NULL);
+    Deque_i32_push_back(&d, 8 + i);
+  }
+  TEST_ASSERT(d.head == 5 && d.len == 8, "Full and wrapped before growth");
+  Deque_i32_push_back(&d, 13);
+  i32 expect[] = {5, 6, 7, 8, 9, 10, 11, 12, 13};
+  TEST_ASSERT(slices_equal(&d, expect, 9) && d.head == 0 && d.cap == 16,
+              "Growth unrolls the ring to the start of the new buffer");
+  Deque_i32_deinit(&d);
+
+  /* Bump 分配器 */
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+  Deque_bump *bd = Deque_bump_new(arena);
+  for (u64 i = 0; i < 100; i++)
+  {
+    Deque_bump_push_front(bd, i);
+  }
+  u64 last = 0;
+  TEST_ASSERT(Deque_bump_pop_back(bd, &last) && last == 0, "Bump-backed deque");
+  bump_free(arena);
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_deque_ends);
+  RUN_SUITE(test_deque_growth);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_epoch.c */
+
+#include <core/mem/sysalc.h>
+#include <std/test/test.h>
+#include <std/thread/epoch.h>
+#include <threads.h>
+
+static SystemAlloc g_sys;
+
+DEFINE_ALLOC_RELEASER(SystemAlloc, SYSTEM)
+
+/* 只计数的释放函数 */
+static _Atomic usize g_released;
+
+static void
+count_release(void *alloc, anyptr ptr, Layout layout)
+{
+  (void)alloc;
+  (void)ptr;
+  (void)layout;
+  atomic_fetch_add(&g_released, 1);
+}
+
+static u64 g_dummy[64];
+
+/*
+ * =========================================
+ * 套件 1: 单线程语义
+ * =========================================
+ */
+TEST_SUITE(test_epoch_basic)
+{
+  SUITE_START("Epoch Basic");
+
+  EpochDomain *d = oexpect(epoch_domain_new(&g_sys), "Failed to create domain");
+  EpochHandle *a = epoch_register(d);
+  EpochHandle *b = epoch_register(d);
+  TEST_ASSERT(a != b, "Two live handles are distinct");
+
+  atomic_store(&g_released, 0);
+  epoch_pin(b);
+  for (usize i = 0; i < 10; i++)
+  {
+    epoch_retire(a, &g_dummy[i], LAYOUT_OF(u64), count_release, NULL);
+  }
+  TEST_ASSERT(epoch_pending(a) == 10, "Retired objects wait in the bag");
+  for (int i = 0; i < 5; i++)
+  {
+    epoch_collect(a);
+  }
+  TEST_ASSERT(atomic_load(&g_released) == 0 && epoch_current(d) == 1,
+              "A reader pinned in epoch 0 stops the epoch at 1 and blocks frees");
+
+  /* 嵌套 pin: 只有最外层 unpin 生效 */
+  epoch_pin(b);
+  epoch_unpin(b);
+  TEST_ASSERT(epoch_is_pinned(b), "Inner unpin keeps the handle pinned");
+  epoch_unpin(b);
+  epoch_collect(a);
+  TEST_ASSERT(atomic_load(&g_released) == 10 && epoch_pending(a) == 0,
+              "After unpin, objects from epoch 0 are freed at epoch 2");
+
+  /* 自动回收: 没有读者时, bag 不会无限增长 */
+  atomic_store(&g_released, 0);
+  for (usize i = 0; i < 10000; i++)
+  {
+    epoch_retire(a, &g_dummy[i % 64], LAYOUT_OF(u64), count_release, NULL);
+  }
+  TEST_ASSERT(epoch_pending(a) <= 2 * EPOCH_COLLECT_THRESHOLD,
+              "Retire triggers batched collection (pending {})",
+              epoch_pending(a));
+
+  /* 通过分配器 Trait 释放 */
+  u64 *boxed = ALLOC(SYSTEM, &g_sys, LAYOUT_OF(u64));
+  EPOCH_RETIRE(a, SYSTEM, &g_sys, boxed, LAYOUT_OF(u64));
+
+  for (int i = 0; i < 3; i++)
+  {
+    epoch_collect(a);
+  }
+  TEST_ASSERT(epoch_pending(a) == 0, "Collect drains the bag when nobody is pinned");
+
+  /* 注销时剩下的对象交给域 */
+  atomic_store(&g_released, 0);
+  epoch_pin(b);
+  epoch_retire(a, &g_dummy[0], LAYOUT_OF(u64), count_release, NULL);
+  epoch_unregister(a);
+  TEST_ASSERT(atomic_load(&g_released) == 0, "Pinned reader still blocks orphaned objects");
+  EpochHandle *c = epoch_register(d);
+  TEST_ASSERT(c == a, "Unregistered handle is reused");
+  epoch_unpin(b);
+  for (int i = 0; i < 3; i++)
+  {
+    epoch_collect(b);
+  }
+  TEST_ASSERT(atomic_load(&g_released) == 1, "Orphaned objects are freed by another handle");
+
+  epoch_retire(c, &g_dummy[1], LAYOUT_OF(u64), count_release, NULL);
+  epoch_domain_free(d);
+  TEST_ASSERT(atomic_load(&g_released) == 2, "Domain free releases everything still pending");
+
+  /* 孤儿按注销顺序追加: 较新的对象排在较旧的前面时, 旧对象也要能被回收 */
+  d = oexpect(epoch_domain_new(&g_sys), "Failed to create domain");
+  EpochHandle *older = epoch_register(d);
+  EpochHandle *newer = epoch_register(d);
+  EpochHandle *reader = epoch_register(d);
+  EpochHandle *collector = epoch_register(d);
+  atomic_store(&g_released, 0);
+  epoch_retire(older, &g_dummy[0], LAYOUT_OF(u64), count_release, NULL); /* epoch 0 */
+  epoch_pin(reader);
+  epoch_collect(collector);
+  epoch_retire(newer, &g_dummy[1], LAYOUT_OF(u64), count_release, NULL); /* epoch 1 */
+  epoch_unregister(newer);
+  epoch_unregister(older);
+  TEST_ASSERT(atomic_load(&g_released) == 0 && epoch_current(d) == 1,
+              "Both objects are orphaned while the reader holds the epoch at 1");
+  epoch_unpin(reader);
+  epoch_collect(collector);
+  TEST_ASSERT(atomic_load(&g_released) == 1 && epoch_current(d) == 2,
+              "At epoch 2 the epoch-0 orphan is freed even behind the epoch-1 one");
+  epoch_collect(collector);
+  TEST_ASSERT(atomic_load(&g_released) == 2, "The epoch-1 orphan follows at epoch 3");
+  epoch_domain_free(d);
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 多线程压力: 带 EBR 的 Treiber 栈
+ * =========================================
+ */
+
+#define STRESS_THREADS 8
+#define STRESS_OPS 40000
+#define MAGIC_LIVE 0x11FE11FE11FE11FEull
+#define MAGIC_DEAD 0xDEADDEADDEADDEADull
+
+typedef struct Node
+{
+  _Atomic u64 magic;
+  struct Node *next;
+  struct Node *grave_next;
+} Node;
+
+typedef struct Stress
+{
+  EpochDomain *domain;
+  _Atomic(Node *) head;
+  _Atomic(Node *) graveyard; /* 被 "释放" 的节点: 只做标记, 测试结束后才真正释放 */
+  _Atomic usize pushed;
+  _Atomic usize popped;
+  _Atomic usize released;
+  _Atomic usize use_after_free;
+} Stress;
+
+static Stress g_stress;
+
+/* 模拟释放: 标记为已死并放进墓地; 如果读者之后还看到它, 就是 EBR 出错了 */
+static void
+poison_release(void *alloc, anyptr ptr, Layout layout)
+{
+  (void)layout;
+  Stress *s = (Stress *)alloc;
+  Node *n = (Node *)ptr;
+  atomic_store(&n->magic, MAGIC_DEAD);
+  Node *grave = atomic_load(&s->graveyard);
+  do
+  {
+    n->grave_next = grave;
+  } while (!atomic_compare_exchange_weak(&s->graveyard, &grave, n));
+  atomic_fetch_add(&s->released, 1);
+}
+
+static int
+stress_main(void *arg)
+{
+  Stress *s = (Stress *)arg;
+  EpochHandle *h = epoch_register(s->domain);
+  u64 rng = (u64)(uintptr_t)h | 1;
+
+  for (usize op = 0; op < STRESS_OPS; op++)
+  {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+
+    if (rng % 2 == 0)
+    {
+      Node *n = ALLOC(SYSTEM, &g_sys, LAYOUT_OF(Node));
+      atomic_init(&n->magic, MAGIC_LIVE);
+      Node *head = atomic_load(&s->head);
+      do
+      {
+        n->next = head;
+      } while (!atomic_compare_exchange_weak(&s->head, &head, n));
+      atomic_fetch_add(&s->pushed, 1);
+      continue;
+    }
+
+    epoch_pin(h);
+    Node *head = atomic_load(&s->head);
+    /* 读者: 沿链表走几步, 检查节点仍然有效 */
+    Node *cur = head;
+    for (int k = 0; k < 4 && cur != NULL; k++)
+    {
+      if (atomic_load(&cur->magic) != MAGIC_LIVE)
+        atomic_fetch_add(&s->use_after_free, 1);
+      cur = cur->next;
+    }
+    /* 写者: 弹出栈顶 (解引用 head->next 需要 pin 的保护) */
+    while (head != NULL && !atomic_compare_exchange_weak(&s->head, &head, head->next))
+    {
+    }
+    epoch_unpin(h);
+
+    if (head != NULL)
+    {
+      atomic_fetch_add(&s->popped, 1);
+      epoch_retire(h, head, LAYOUT_OF(Node), poison_release, s);
+    }
+  }
+
+  epoch_unregister(h);
+  return 0;
+}
+
+TEST_SUITE(test_epoch_stress)
+{
+  SUITE_START("Epoch Stress");
+
+  Stress *s = &g_stress;
+  s->domain = oexpect(epoch_domain_new(&g_sys), "Failed to create domain");
+
+  thrd_t threads[STRESS_THREADS];
+  for (usize i = 0; i < STRESS_THREADS; i++)
+  {
+    thrd_create(&threads[i], stress_main, s);
+  }
+  for (usize i = 0; i < STRESS_THREADS; i++)
+  {
+    thrd_join(threads[i], NULL);
+  }
+
+  TEST_ASSERT(atomic_load(&s->use_after_free) == 0,
+              "No reader saw a reclaimed node ({} pops)",
+              atomic_load(&s->popped));
+  usize before_free = atomic_load(&s->released);
+  TEST_ASSERT(
+    before_free > 0, "Reclamation made progress while threads ran ({} freed)", before_free);
+
+  epoch_domain_free(s->domain);
+  TEST_ASSERT(atomic_load(&s->released) == atomic_load(&s->popped),
+              "Every popped node is released exactly once");
+
+  usize remaining = 0;
+  for (Node *n = atomic_load(&s->head); n != NULL;)
+  {
+    Node *next = n->next;
+    RELEASE(SYSTEM, &g_sys, n, LAYOUT_OF(Node));
+    remaining++;
+    n = next;
+  }
+  TEST_ASSERT(remaining == atomic_load(&s->pushed) - atomic_load(&s->popped),
+              "Stack holds pushes minus pops");
+  for (Node *n = atomic_load(&s->graveyard); n != NULL;)
+  {
+    Node *next = n->grave_next;
+    RELEASE(SYSTEM, &g_sys, n, LAYOUT_OF(Node));
+    n = next;
+  }
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_epoch_basic);
+  RUN_SUITE(test_epoch_stress);
+
+  TEST_SUMMARY();
+}
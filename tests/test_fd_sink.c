@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_fd_sink.c */
+
+#include <core/fmt/tofd.h>
+#include <std/string.h>
+#include <std/test/test.h>
+#include <unistd.h> // pipe, read, close
+
+#define BIG_LEN 10000
+
+static char g_out[2 * BIG_LEN];
+
+/* 关闭写端并读出管道中的全部内容 (以 '\0' 结尾) */
+static usize
+drain(int fds[2])
+{
+  close(fds[1]);
+  usize got = 0;
+  ssize_t n;
+  while ((n = read(fds[0], g_out + got, sizeof(g_out) - 1 - got)) > 0)
+  {
+    got += (usize)n;
+  }
+  close(fds[0]);
+  g_out[got] = '\0';
+  return got;
+}
+
+/*
+ * =========================================
+ * 套件 1: 字面文本与占位符
+ * =========================================
+ */
+TEST_SUITE(test_fd_sink_literals)
+{
+  SUITE_START("FdSink Literals");
+
+  int fds[2];
+  TEST_ASSERT_FATAL(pipe(fds) == 0, "pipe() failed");
+  TEST_ASSERT(format_to_fd(fds[1], "a{b}c{} {x}", 42), "format_to_fd failed");
+  TEST_ASSERT(format_to_fd(fds[1], "|x={} y={}|", 1), "format_to_fd failed");
+  TEST_ASSERT(format_to_fd(fds[1], "{}{}{", "s", (char)'c'), "format_to_fd failed");
+  drain(fds);
+
+  TEST_ASSERT(str_cmp(g_out, "a{b}c42 {x}|x=1 y={}|sc{") == EQUAL, "Output mismatch: {}", g_out);
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 超过缓冲区大小的消息
+ * =========================================
+ */
+TEST_SUITE(test_fd_sink_large)
+{
+  SUITE_START("FdSink Large");
+
+  static char big[BIG_LEN];
+  memset(big, 'q', sizeof(big));
+  vstr payload = {.ptr = big, .len = sizeof(big)};
+
+  int fds[2];
+  TEST_ASSERT_FATAL(pipe(fds) == 0, "pipe() failed");
+  /* 先填一部分缓冲区, 再推送一个放不下的大块 (走 writev) */
+  TEST_ASSERT(format_to_fd(fds[1], "head:{}:tail", payload), "format_to_fd failed");
+  usize got = drain(fds);
+
+  TEST_ASSERT(got == BIG_LEN + 10, "Length mismatch: {}", got);
+  TEST_ASSERT(memcmp(g_out, "head:", 5) == 0, "Head mismatch");
+  TEST_ASSERT(g_out[5] == 'q' && g_out[4 + BIG_LEN] == 'q', "Payload mismatch");
+  TEST_ASSERT(str_ends_with(g_out, ":tail"), "Tail mismatch");
+
+  /* 逐字符推送跨越缓冲区边界 */
+  TEST_ASSERT_FATAL(pipe(fds) == 0, "pipe() failed");
+  FdSink sink;
+  fd_sink_init(&sink, fds[1]);
+  for (usize i = 0; i < FD_SINK_BUF_SIZE + 10; i++)
+  {
+    fd_sink_push_char_adapter(&sink, (char)('a' + i % 26));
+  }
+  TEST_ASSERT(fd_sink_flush(&sink), "Flush failed");
+  got = drain(fds);
+  TEST_ASSERT(got == FD_SINK_BUF_SIZE + 10, "Char push length mismatch: {}", got);
+  TEST_ASSERT(g_out[FD_SINK_BUF_SIZE] == (char)('a' + FD_SINK_BUF_SIZE % 26), "Char push mismatch");
+
+  /* 写入已关闭的 fd 应报告失败 */
+  TEST_ASSERT(!format_to_fd(-1, "nowhere"), "Writing to an invalid fd should fail");
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_fd_sink_literals);
+  RUN_SUITE(test_fd_sink_large);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_flatmap.c */
+
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/flatmap.h>
+#include <std/test/test.h>
+
+static SystemAlloc g_sys;
+
+static inline Ordering
+cmp_u64(const u64 *a, const u64 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+static inline Ordering
+cmp_u32(const u32 *a, const u32 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+DEFINE_FLAT_SET(U64Set, u64, cmp_u64, SystemAlloc, SYSTEM)
+DEFINE_FLAT_SET(U32SetBump, u32, cmp_u32, Bump, BUMP)
+DEFINE_FLAT_MAP(U64Map, u64, u32, cmp_u64, SystemAlloc, SYSTEM)
+
+static u64 g_rng = 0x9E3779B97F4A7C15ull;
+
+static u64
+next_rand(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+/* 线性扫描的参考实现 */
+static usize
+linear_lower_bound(const u64 *keys, usize len, u64 key)
+{
+  usize i = 0;
+  while (i < len && keys[i] < key)
+  {
+    i++;
+  }
+  return i;
+}
+
+/* 在当前集合上, 用 [0, limit] 中的所有整数检查 lower_bound / upper_bound / gallop */
+static bool
+check_bounds(const U64Set *set, u64 limit)
+{
+  const u64 *keys = set->keys.data;
+  usize len = set->keys.len;
+  for (u64 q = 0; q <= limit; q++)
+  {
+    usize expected = linear_lower_bound(keys, len, q);
+    usize upper = linear_lower_bound(keys, len, q + 1);
+    if (U64Set_lower_bound(set, &q) != expected || U64Set_upper_bound(set, &q) != upper ||
+        U64Set_gallop_in(keys, len, &q) != expected ||
+        U64Set_contains(set, &q) != (expected < len && keys[expected] == q))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * =========================================
+ * 套件 1: 构建与查找 (有 / 无 Eytzinger 索引)
+ * =========================================
+ */
+TEST_SUITE(test_flat_set_search)
+{
+  SUITE_START("Flat Set Search");
+
+  U64Set set;
+  U64Set_init(&set, &g_sys);
+
+  /* 覆盖完全 / 不完全二叉树的所有形状 */
+  bool plain_ok = true, index_ok = true;
+  static u64 items[300];
+  for (usize len = 0; len < 130 && plain_ok && index_ok; len++)
+  {
+    for (usize i = 0; i < len; i++)
+    {
+      items[i] = 2 * (next_rand() % 200) + 1; /* 奇数, 有重复 */
+    }
+    U64Set_build(&set, items, len);
+    plain_ok = U64Set_ksort_is_sorted(set.keys.data, set.keys.len) && check_bounds(&set, 402);
+    U64Set_build_index(&set);
+    index_ok = set.index_len == set.keys.len && check_bounds(&set, 402);
+  }
+  TEST_ASSERT(plain_ok, "Branchless search should match a linear scan");
+  TEST_ASSERT(index_ok, "Eytzinger search should match a linear scan");
+
+  /* 去重 */
+  u64 dup[] = {5, 3, 5, 1, 3, 5};
+  U64Set_build(&set, dup, 6);
+  TEST_ASSERT(U64Set_len(&set) == 3 && set.keys.data[0] == 1 && set.keys.data[2] == 5,
+              "Build should sort and deduplicate");
+
+  /* 插入 / 删除会丢弃索引 */
+  U64Set_build_index(&set);
+  u64 four = 4;
+  TEST_ASSERT(U64Set_insert(&set, 4) && set.index == NULL, "Insert drops the index");
+  TEST_ASSERT(!U64Set_insert(&set, 4), "Duplicate insert is rejected");
+  TEST_ASSERT(U64Set_contains(&set, &four) && U64Set_len(&set) == 4, "Inserted key is found");
+  TEST_ASSERT(U64Set_remove(&set, &four) && !U64Set_remove(&set, &four), "Remove once");
+
+  /* 区间查询 */
+  static u64 evens[1000];
+  for (u64 i = 0; i < 1000; i++)
+  {
+    evens[i] = 2 * i;
+  }
+  U64Set_build(&set, evens, 1000);
+  U64Set_build_index(&set);
+  u64 lo = 101, hi = 201;
+  usize first = 0;
+  usize count = U64Set_range(&set, &lo, &hi, &first);
+  TEST_ASSERT(count == 50 && set.keys.data[first] == 102, "[101, 201) holds 102..200");
+  lo = 5000;
+  hi = 6000;
+  TEST_ASSERT(U64Set_range(&set, &lo, &hi, &first) == 0 && first == 1000, "Range past the end");
+  lo = 10;
+  hi = 5;
+  TEST_ASSERT(U64Set_range(&set, &lo, &hi, NULL) == 0, "Inverted range is empty");
+
+  U64Set_deinit(&set);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 并集 / 交集
+ * =========================================
+ */
+TEST_SUITE(test_flat_set_merge)
+{
+  SUITE_START("Flat Set Merge");
+
+  U64Set a, b, out;
+  U64Set_init(&a, &g_sys);
+  U64Set_init(&b, &g_sys);
+  U64Set_init(&out, &g_sys);
+
+  /* 随机集合, 与位图参考结果比较 */
+  bool union_ok = true, inter_ok = true;
+  static bool in_a[4096], in_b[4096];
+  static u64 items[4096];
+  for (u32 round = 0; round < 50 && union_ok && inter_ok; round++)
+  {
+    memset(in_a, 0, sizeof(in_a));
+    memset(in_b, 0, sizeof(in_b));
+    /* 一边稀疏一边稠密, 触发 galloping */
+    usize na = 1 + next_rand() % 20, nb = 1 + next_rand() % 4000;
+    for (usize i = 0; i < na; i++)
+    {
+      items[i] = next_rand() % 4096;
+      in_a[items[i]] = true;
+    }
+    U64Set_build(&a, items, na);
+    for (usize i = 0; i < nb; i++)
+    {
+      items[i] = next_rand() % 4096;
+      in_b[items[i]] = true;
+    }
+    U64Set_build(&b, items, nb);
+
+    U64Set_union(&out, &a, &b);
+    usize k = 0;
+    for (u64 v = 0; v < 4096 && union_ok; v++)
+    {
+      if (in_a[v] || in_b[v])
+        union_ok = k < out.keys.len && out.keys.data[k++] == v;
+    }
+    union_ok = union_ok && k == out.keys.len;
+
+    U64Set_intersect(&out, &b, &a);
+    k = 0;
+    for (u64 v = 0; v < 4096 && inter_ok; v++)
+    {
+      if (in_a[v] && in_b[v])
+        inter_ok = k < out.keys.len && out.keys.data[k++] == v;
+    }
+    inter_ok = inter_ok && k == out.keys.len;
+  }
+  TEST_ASSERT(union_ok, "Union should match the reference");
+  TEST_ASSERT(inter_ok, "Intersection should match the reference");
+
+  U64Set_clear(&a);
+  U64Set_union(&out, &a, &b);
+  TEST_ASSERT(out.keys.len == b.keys.len, "Union with an empty set is a copy");
+  U64Set_intersect(&out, &a, &b);
+  TEST_ASSERT(out.keys.len == 0, "Intersection with an empty set is empty");
+
+  U64Set_deinit(&a);
+  U64Set_deinit(&b);
+  U64Set_deinit(&out);
+
+  /* Bump 分配器 */
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+  U32SetBump *s = U32SetBump_new(arena);
+  u32 small[] = {9, 7, 5, 3, 1};
+  U32SetBump_build(s, small, 5);
+  U32SetBump_build_index(s);
+  u32 q = 6;
+  TEST_ASSERT(U32SetBump_lower_bound(s, &q) == 3, "Bump-backed set with index");
+  bump_free(arena);
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: 映射
+ * =========================================
+ */
+TEST_SUITE(test_flat_map)
+{
+  SUITE_START("Flat Map");
+
+  U64Map map;
+  U64Map_init(&map, &g_sys);
+
+  u64 keys[] = {30, 10, 20, 10, 30};
+  u32 values[] = {1, 2, 3, 4, 5};
+  U64Map_build(&map, keys, values, 5);
+  TEST_ASSERT(U64Map_len(&map) == 3, "Duplicate keys collapse");
+  u64 k = 10;
+  TEST_ASSERT(*U64Map_get(&map, &k) == 4, "Last duplicate wins (10 -> 4)");
+  k = 30;
+  TEST_ASSERT(*U64Map_get(&map, &k) == 5, "Last duplicate wins (30 -> 5)");
+  k = 15;
+  TEST_ASSERT(U64Map_get(&map, &k) == NULL, "Missing key yields NULL");
+
+  U64Map_build_index(&map);
+  TEST_ASSERT(!U64Map_insert(&map, 20, 99) && map.index != NULL, "Overwrite keeps the index");
+  k = 20;
+  TEST_ASSERT(*U64Map_get(&map, &k) == 99, "Overwritten value");
+  TEST_ASSERT(U64Map_insert(&map, 15, 7) && map.index == NULL, "New key drops the index");
+  TEST_ASSERT(map.keys.data[1] == 15 && map.values.data[1] == 7, "Keys and values stay aligned");
+  k = 10;
+  TEST_ASSERT(U64Map_remove(&map, &k) && map.keys.data[0] == 15 && map.values.data[0] == 7,
+              "Remove shifts both arrays");
+
+  u64 lo = 16, hi = 31;
+  usize first = 0;
+  TEST_ASSERT(U64Map_range(&map, &lo, &hi, &first) == 2 && map.values.data[first] == 99,
+              "Range over a map");
+
+  U64Map_deinit(&map);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_flat_set_search);
+  RUN_SUITE(test_flat_set_merge);
+  RUN_SUITE(test_flat_map);
+
+  TEST_SUMMARY();
+}
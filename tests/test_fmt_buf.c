@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_fmt_buf.c */
+
+#include <core/fmt/tobuf.h>
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/string.h>
+#include <std/test/test.h>
+
+static SystemAlloc g_sys;
+
+/*
+ * =========================================
+ * 套件 1: format_len
+ * =========================================
+ */
+TEST_SUITE(test_format_len)
+{
+  SUITE_START("Format Len");
+
+  TEST_ASSERT(format_len("") == 0, "Empty format should have length 0");
+  TEST_ASSERT(format_len("abc") == 3, "Literal length mismatch");
+  TEST_ASSERT(format_len("id={} x={}", 12345, 0.5) == 14, "Length mismatch");
+  TEST_ASSERT(format_len("{}{}", (char)'c', "str") == 4, "Char + str length mismatch");
+  TEST_ASSERT(format_len("{} {}", (i64)-9223372036854775807 - 1, 1e300) == 27,
+              "Wide number length mismatch: {}",
+              format_len("{} {}", (i64)-9223372036854775807 - 1, 1e300));
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: format_to_buf
+ * =========================================
+ */
+TEST_SUITE(test_format_to_buf)
+{
+  SUITE_START("Format To Buf");
+
+  char buf[16];
+  FmtBufResult r = format_to_buf(buf, sizeof(buf), "x={} y={}", 1, 2);
+  TEST_ASSERT(!r.truncated, "Short output should not be truncated");
+  TEST_ASSERT(r.len == 7 && r.needed == 7, "Length mismatch: {} / {}", r.len, r.needed);
+  TEST_ASSERT(str_cmp(buf, "x=1 y=2") == EQUAL, "Content mismatch: {}", buf);
+
+  r = format_to_buf(buf, sizeof(buf), "value = {} and {}", 123456789, "more text");
+  TEST_ASSERT(r.truncated, "Long output should be truncated");
+  TEST_ASSERT(r.len == sizeof(buf) - 1, "Should fill cap - 1 bytes, got {}", r.len);
+  TEST_ASSERT(r.needed == 31, "Needed length mismatch: {}", r.needed);
+  TEST_ASSERT(str_cmp(buf, "value = 1234567") == EQUAL, "Truncated content mismatch: {}", buf);
+
+  /* 恰好填满: cap - 1 个字节 + '\0' */
+  char exact[6];
+  r = format_to_buf(exact, sizeof(exact), "{}", "hello");
+  TEST_ASSERT(!r.truncated && str_cmp(exact, "hello") == EQUAL, "Exact fit mismatch");
+
+  r = format_to_buf(NULL, 0, "abc{}", 42);
+  TEST_ASSERT(r.len == 0 && r.needed == 5 && r.truncated, "cap == 0 should only count");
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: s_format_exact
+ * =========================================
+ */
+TEST_SUITE(test_s_format_exact)
+{
+  SUITE_START("S Format Exact");
+
+  sstring *s = sstring_new(&g_sys);
+  s_format_exact(s, "[{}] {} items, ratio {}", "scan", 1024, 0.25);
+  TEST_ASSERT(str_cmp(s_as_str(s), "[scan] 1024 items, ratio 0.25") == EQUAL,
+              "Content mismatch: {}",
+              s_as_str(s));
+  TEST_ASSERT(sstring_cap(s) == sstring_len(s) + 1, "Should reserve exactly len + 1");
+
+  /* 参数只求值一次 */
+  int calls = 0;
+  s_format_exact(s, " #{}", ++calls);
+  TEST_ASSERT(calls == 1, "Arguments must be evaluated once");
+  TEST_ASSERT(str_ends_with(s_as_str(s), " #1"), "Append mismatch: {}", s_as_str(s));
+
+  /* 超过栈上暂存区的长消息: 按精确长度第二遍写入 */
+  static char long_arg[2000];
+  memset(long_arg, 'L', sizeof(long_arg) - 1);
+  sstring_clear(s);
+  usize cap_before = sstring_cap(s);
+  s_format_exact(s, "<{}>", (str)long_arg);
+  TEST_ASSERT(sstring_len(s) == sizeof(long_arg) + 1, "Long length mismatch: {}", sstring_len(s));
+  TEST_ASSERT(sstring_cap(s) == sizeof(long_arg) + 2 && sstring_cap(s) > cap_before,
+              "Long message should reserve exactly len + 1");
+  TEST_ASSERT(str_starts_with(s_as_str(s), "<LLL") && str_ends_with(s_as_str(s), "LL>"),
+              "Long content mismatch");
+
+  /* 以 char 结尾也保持 '\0' */
+  sstring_clear(s);
+  s_format(s, "{}{}", "ab", (char)'c');
+  TEST_ASSERT(str_cmp(s_as_str(s), "abc") == EQUAL, "Trailing char mismatch: {}", s_as_str(s));
+  sstring_destroy(s);
+
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+  sso_bstring b;
+  sso_bstring_init(&b, arena);
+  s_format_exact(&b, "{} is a reasonably long line: {}", "this", 3.5f);
+  TEST_ASSERT(sso_bstring_cap(&b) == sso_bstring_len(&b), "SSO should reserve exactly len");
+  TEST_ASSERT(str_cmp(s_as_str(&b), "this is a reasonably long line: 3.5") == EQUAL,
+              "SSO content mismatch: {}",
+              s_as_str(&b));
+  bump_free(arena);
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_format_len);
+  RUN_SUITE(test_format_to_buf);
+  RUN_SUITE(test_s_format_exact);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_fmt_num.c */
+
+#include <core/fmt/num.h>
+#include <core/mem/sysalc.h>
+#include <std/string.h>
+#include <std/test/test.h>
+#include <stdint.h> // INT64_MIN, UINT64_MAX
+#include <stdlib.h> // strtod, strtof
+
+static SystemAlloc g_sys;
+
+/* 把 fmt_* 的输出变成以 '\0' 结尾的字符串 (fmt_f64_fixed 的输出最长) */
+static char g_buf[FMT_FIXED_BUF_SIZE + 1];
+
+#define NUM_STR(call)                                                                              \
+  ({                                                                                               \
+    usize __n = (call);                                                                            \
+    g_buf[__n] = '\0';                                                                             \
+    (str) g_buf;                                                                                   \
+  })
+
+/*
+ * =========================================
+ * 套件 1: 整数
+ * =========================================
+ */
+TEST_SUITE(test_fmt_integers)
+{
+  SUITE_START("Fmt Integers");
+
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_u64(g_buf, 0)), "0") == EQUAL, "0");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_u64(g_buf, 7)), "7") == EQUAL, "7");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_u64(g_buf, 10)), "10") == EQUAL, "10");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_u64(g_buf, 12345)), "12345") == EQUAL, "12345");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_u64(g_buf, UINT64_MAX)), "18446744073709551615") == EQUAL,
+              "UINT64_MAX: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_i64(g_buf, -42)), "-42") == EQUAL, "-42");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_i64(g_buf, INT64_MIN)), "-9223372036854775808") == EQUAL,
+              "INT64_MIN: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_hex_u64(g_buf, 0xdeadbeef)), "deadbeef") == EQUAL, "hex");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_hex_upper_u64(g_buf, 0xdeadbeef)), "DEADBEEF") == EQUAL,
+              "HEX");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_hex_u64(g_buf, 0)), "0") == EQUAL, "hex 0");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_bin_u64(g_buf, 10)), "1010") == EQUAL, "bin");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_bin_u64(g_buf, 0)), "0") == EQUAL, "bin 0");
+  TEST_ASSERT(fmt_bin_u64(g_buf, UINT64_MAX) == 64, "bin UINT64_MAX should have 64 digits");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_ptr(g_buf, (void *)0x1000)), "0x1000") == EQUAL, "ptr");
+
+  /* 每个十的幂附近都与 %llu 对照 */
+  char ref[32];
+  bool all_ok = true;
+  for (u64 p = 1; p != 0 && p <= UINT64_MAX / 10; p *= 10)
+  {
+    u64 probes[] = {p - 1, p, p + 1, p * 9 + 7};
+    for (usize i = 0; i < 4; i++)
+    {
+      snprintf(ref, sizeof(ref), "%llu", (unsigned long long)probes[i]);
+      all_ok = all_ok && str_cmp(NUM_STR(fmt_u64(g_buf, probes[i])), ref) == EQUAL;
+    }
+  }
+  TEST_ASSERT(all_ok, "fmt_u64 should match %llu around powers of ten");
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 浮点数 (最短往返)
+ * =========================================
+ */
+TEST_SUITE(test_fmt_floats)
+{
+  SUITE_START("Fmt Floats");
+
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 0.1)), "0.1") == EQUAL, "0.1: {}", g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 1.0)), "1.0") == EQUAL, "1.0: {}", g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, -2.5)), "-2.5") == EQUAL, "-2.5: {}", g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 123.456)), "123.456") == EQUAL, "123.456");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 0.1 + 0.2)), "0.30000000000000004") == EQUAL,
+              "0.1 + 0.2: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 1e16)), "1e+16") == EQUAL, "1e16: {}", g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 1e15)), "1000000000000000.0") == EQUAL,
+              "1e15: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 0.0001)), "0.0001") == EQUAL, "1e-4: {}", g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 1.5e-5)), "1.5e-05") == EQUAL, "1.5e-5: {}", g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 5e-324)), "5e-324") == EQUAL, "min subnormal");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 1.7976931348623157e308)), "1.7976931348623157e+308") ==
+                EQUAL,
+              "DBL_MAX: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, -0.0)), "-0.0") == EQUAL, "-0.0");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 1.0 / 0.0)), "inf") == EQUAL, "inf");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, -1.0 / 0.0)), "-inf") == EQUAL, "-inf");
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64(g_buf, 0.0 / 0.0)), "nan") == EQUAL, "nan");
+
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f32(g_buf, 0.1f)), "0.1") == EQUAL, "0.1f: {}", g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f32(g_buf, 3.4028235e38f)), "3.4028235e+38") == EQUAL,
+              "FLT_MAX: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f32(g_buf, 1e-45f)), "1e-45") == EQUAL, "FLT_TRUE_MIN");
+
+  /* 伪随机位模式: 输出必须能解析回完全相同的值 */
+  u64 seed = 0x9e3779b97f4a7c15ull;
+  bool f64_ok = true;
+  bool f32_ok = true;
+  for (int i = 0; i < 100000; i++)
+  {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+
+    f64 d;
+    memcpy(&d, &seed, sizeof(d));
+    if (d == d && d - d == 0)
+    {
+      f64 back = strtod(NUM_STR(fmt_f64(g_buf, d)), NULL);
+      f64_ok = f64_ok && memcmp(&back, &d, sizeof(d)) == 0;
+    }
+
+    u32 bits32 = (u32)(seed >> 32);
+    f32 f;
+    memcpy(&f, &bits32, sizeof(f));
+    if (f == f && f - f == 0)
+    {
+      f32 back = strtof(NUM_STR(fmt_f32(g_buf, f)), NULL);
+      f32_ok = f32_ok && memcmp(&back, &f, sizeof(f)) == 0;
+    }
+  }
+  TEST_ASSERT(f64_ok, "fmt_f64 output should round-trip through strtod");
+  TEST_ASSERT(f32_ok, "fmt_f32 output should round-trip through strtof");
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: 定点表示 (固定精度)
+ * =========================================
+ */
+static bool
+fixed_matches_printf(f64 v, u32 precision)
+{
+  char ref[FMT_FIXED_BUF_SIZE + 16];
+  snprintf(ref, sizeof(ref), "%.*f", (int)precision, v);
+  return str_cmp(NUM_STR(fmt_f64_fixed(g_buf, v, precision)), ref) == EQUAL;
+}
+
+TEST_SUITE(test_fmt_fixed)
+{
+  SUITE_START("Fmt Fixed");
+
+  /* 按精确的二进制值舍入, 而不是按十进制字面量 */
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64_fixed(g_buf, 2.675, 2)), "2.67") == EQUAL,
+              "2.675 -> {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64_fixed(g_buf, 0.125, 2)), "0.12") == EQUAL,
+              "Exact ties round to even: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64_fixed(g_buf, 0.375, 2)), "0.38") == EQUAL,
+              "Exact ties round to even: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64_fixed(g_buf, 9.995, 0)), "10") == EQUAL,
+              "Carry into integer part: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64_fixed(g_buf, -0.0001, 3)), "-0.000") == EQUAL,
+              "Negative values keep their sign: {}",
+              g_buf);
+  TEST_ASSERT(str_cmp(NUM_STR(fmt_f64_fixed(g_buf, 1.0 / 0.0, 2)), "inf") == EQUAL, "inf");
+  TEST_ASSERT(fixed_matches_printf(0x1p116, 2), "2^116 mismatch: {}", g_buf);
+  TEST_ASSERT(strlen(NUM_STR(fmt_f64_fixed(g_buf, 1e300, 3))) == 305 &&
+                str_starts_with(g_buf, "1000"),
+              "1e300 should print 301 integer digits: {}",
+              g_buf);
+  TEST_ASSERT(fixed_matches_printf(5e-324, 19), "Denormal mismatch: {}", g_buf);
+
+  /* 各数量级的随机值与 %.*f 对照 */
+  u64 seed = 0x9e3779b97f4a7c15ull;
+  bool all_ok = true;
+  for (int i = 0; i < 20000 && all_ok; i++)
+  {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    f64 mantissa = (f64)(seed >> 11) / (f64)(1ull << 53);
+    f64 v = mantissa * 1e-8;
+    for (int e = (int)(seed & 31); e > 0; e--)
+    {
+      v *= 10.0;
+    }
+    all_ok = fixed_matches_printf((seed & 1) ? -v : v, (u32)((seed >> 5) % 20));
+  }
+  TEST_ASSERT(all_ok, "fmt_f64_fixed should match %.*f, got {}", g_buf);
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 4: vformat 引擎
+ * =========================================
+ */
+TEST_SUITE(test_fmt_engine)
+{
+  SUITE_START("Fmt Engine");
+
+  sstring *s = sstring_new(&g_sys);
+  s_format(s,
+           "{} {} {} {} {} {}",
+           (i8)-8,
+           (u16)65535,
+           (i64)-1234567890123,
+           (u64)18446744073709551615ull,
+           0.5f,
+           2.25);
+  TEST_ASSERT(str_cmp(s_as_str(s), "-8 65535 -1234567890123 18446744073709551615 0.5 2.25") ==
+                EQUAL,
+              "Mixed format mismatch: {}",
+              s_as_str(s));
+
+  sstring_clear(s);
+  s_format(s, "{}", 0.1f);
+  TEST_ASSERT(str_cmp(s_as_str(s), "0.1") == EQUAL, "f32 should use f32 precision: {}", s_as_str(s));
+
+  sstring_destroy(s);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_fmt_integers);
+  RUN_SUITE(test_fmt_floats);
+  RUN_SUITE(test_fmt_fixed);
+  RUN_SUITE(test_fmt_engine);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_parallel.c */
+
+#include <core/mem/sysalc.h>
+#include <std/test/test.h>
+#include <std/thread/parallel.h>
+#include <stdatomic.h>
+
+static SystemAlloc g_sys;
+
+#define N 100000
+
+/*
+ * =========================================
+ * parallel_for_range: 每个下标恰好访问一次
+ * =========================================
+ */
+
+typedef struct Visit
+{
+  _Atomic u32 hits[N];
+  _Atomic usize calls;
+  _Atomic usize max_len;
+} Visit;
+
+static Visit g_visit;
+
+static void
+visit_body(void *ctx, Range r)
+{
+  Visit *v = (Visit *)ctx;
+  atomic_fetch_add(&v->calls, 1);
+  usize len = r.end - r.start;
+  usize seen = atomic_load(&v->max_len);
+  while (len > seen && !atomic_compare_exchange_weak(&v->max_len, &seen, len))
+  {
+  }
+  for_range_in(i, r)
+  {
+    atomic_fetch_add_explicit(&v->hits[i], 1, memory_order_relaxed);
+  }
+}
+
+static void
+visit_reset(void)
+{
+  for (usize i = 0; i < N; i++)
+  {
+    atomic_store(&g_visit.hits[i], 0);
+  }
+  atomic_store(&g_visit.calls, 0);
+  atomic_store(&g_visit.max_len, 0);
+}
+
+static bool
+visit_check(Range r)
+{
+  for (usize i = 0; i < N; i++)
+  {
+    u32 expect = i >= r.start && i < r.end ? 1 : 0;
+    if (atomic_load(&g_visit.hits[i]) != expect)
+      return false;
+  }
+  return true;
+}
+
+/*
+ * =========================================
+ * DEFINE_PARALLEL_REDUCE
+ * =========================================
+ */
+
+static u64
+sum_body(void *ctx, Range r, u64 acc)
+{
+  const u64 *data = (const u64 *)ctx;
+  for_range_in(i, r)
+  {
+    acc += data[i];
+  }
+  return acc;
+}
+
+static u64
+sum_combine(u64 a, u64 b)
+{
+  return a + b;
+}
+
+DEFINE_PARALLEL_REDUCE(par_sum, u64, sum_body, sum_combine)
+
+/* 仿射变换 x -> a * x + b 的复合: 满足结合律, 但不满足交换律 */
+typedef struct Affine
+{
+  u64 a;
+  u64 b;
+} Affine;
+
+static Affine
+affine_then(Affine first, Affine second)
+{
+  return (Affine){.a = second.a * first.a, .b = second.a * first.b + second.b};
+}
+
+static Affine
+affine_body(void *ctx, Range r, Affine acc)
+{
+  (void)ctx;
+  for_range_in(i, r)
+  {
+    acc = affine_then(acc, (Affine){.a = 2 * i + 1, .b = i});
+  }
+  return acc;
+}
+
+DEFINE_PARALLEL_REDUCE(par_affine, Affine, affine_body, affine_then)
+
+static f64
+fsum_body(void *ctx, Range r, f64 acc)
+{
+  (void)ctx;
+  for_range_in(i, r)
+  {
+    acc += 1.0 / (f64)(i + 1);
+  }
+  return acc;
+}
+
+static f64
+fsum_combine(f64 a, f64 b)
+{
+  return a + b;
+}
+
+DEFINE_PARALLEL_REDUCE(par_fsum, f64, fsum_body, fsum_combine)
+
+TEST_SUITE(test_parallel_for)
+{
+  SUITE_START("Parallel For Range");
+
+  static u64 data[N];
+  for (usize i = 0; i < N; i++)
+  {
+    data[i] = i * 7 + 3;
+  }
+  u64 expect_sum = sum_body(data, range(0, N), 0);
+  Affine expect_affine = affine_body(NULL, range(0, N), (Affine){.a = 1, .b = 0});
+  f64 fsum_ref = 0;
+
+  static const usize counts[] = {0, 1, 3, 8}; /* 0 表示 NULL pool */
+  for (usize c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+  {
+    StealPool *pool = NULL;
+    if (counts[c] != 0)
+    {
+      pool = oexpect(steal_pool_new(&g_sys, counts[c]), "Failed to create pool");
+    }
+
+    Range r = range(17, N - 5);
+    visit_reset();
+    parallel_for_range(pool, r, 1000, visit_body, &g_visit);
+    TEST_ASSERT(visit_check(r) && atomic_load(&g_visit.max_len) <= 1000,
+                "Every index once, chunks <= grain ({} threads)",
+                counts[c]);
+
+    visit_reset();
+    parallel_for_range(pool, range(0, N), 0, visit_body, &g_visit);
+    usize threads = steal_pool_threads(pool);
+    TEST_ASSERT(visit_check(range(0, N)) &&
+                  (threads == 1 || atomic_load(&g_visit.calls) >= threads),
+                "Automatic grain splits across {} thread(s)",
+                threads);
+
+    visit_reset();
+    parallel_for_range(pool, range(5, 5), 0, visit_body, &g_visit);
+    TEST_ASSERT(atomic_load(&g_visit.calls) == 0, "Empty range calls nothing");
+
+    TEST_ASSERT(par_sum(pool, range(0, N), 0, 0, data) == expect_sum, "Reduce sum");
+    TEST_ASSERT(par_sum(pool, range(3, 3), 0, 42, data) == 42, "Empty reduce is identity");
+    Affine got = par_affine(pool, range(0, N), 333, (Affine){.a = 1, .b = 0}, NULL);
+    TEST_ASSERT(got.a == expect_affine.a && got.b == expect_affine.b,
+                "Non-commutative combine keeps range order");
+
+    f64 fsum = par_fsum(pool, range(0, N), 500, 0.0, NULL);
+    if (c == 0)
+    {
+      fsum_ref = fsum;
+    }
+    TEST_ASSERT(fsum == fsum_ref, "Float reduce with explicit grain is independent of threads");
+
+    steal_pool_free(pool);
+  }
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_parallel_for);
+
+  TEST_SUMMARY();
+}
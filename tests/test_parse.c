@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_parse.c */
+
+#include <core/fmt/num.h>
+#include <core/fmt/parse.h>
+#include <std/test/test.h>
+#include <stdint.h> // INT64_MIN, UINT64_MAX
+#include <stdlib.h> // strtod
+
+#define VS(s) vstr_from_str(s)
+
+/* 与 strtod 的结果逐位比较 */
+static bool
+same_as_strtod(str s)
+{
+  f64 expected = strtod(s, NULL);
+  Result_f64_ParseError r = vstr_parse_f64(VS(s));
+  return ris_ok(r) && memcmp(&r.value.ok, &expected, sizeof(f64)) == 0;
+}
+
+/*
+ * =========================================
+ * 套件 1: 整数
+ * =========================================
+ */
+TEST_SUITE(test_parse_integers)
+{
+  SUITE_START("Parse Integers");
+
+  TEST_ASSERT(rexpect(vstr_parse_u64(VS("0")), "0") == 0, "0");
+  TEST_ASSERT(rexpect(vstr_parse_u64(VS("+42")), "+42") == 42, "+42");
+  TEST_ASSERT(rexpect(vstr_parse_u64(VS("12345678")), "8 digits") == 12345678, "8 digits");
+  TEST_ASSERT(rexpect(vstr_parse_u64(VS("18446744073709551615")), "max") == UINT64_MAX, "max");
+  TEST_ASSERT(rexpect(vstr_parse_u64(VS("000000000000000000000000007")), "zeros") == 7,
+              "Leading zeros");
+  TEST_ASSERT(rexpect(vstr_parse_i64(VS("-9223372036854775808")), "min") == INT64_MIN, "min");
+  TEST_ASSERT(rexpect(vstr_parse_i64(VS("9223372036854775807")), "max") == INT64_MAX, "max");
+  TEST_ASSERT(rexpect(vstr_parse_i64(VS("-17")), "-17") == -17, "-17");
+
+  /* 不要求 '\0' 结尾: 只看 len 范围内的字节 */
+  vstr slice = {.ptr = "1234567890123456789xyz", .len = 19};
+  TEST_ASSERT(rexpect(vstr_parse_u64(slice), "slice") == 1234567890123456789ull, "Slice");
+
+  TEST_ASSERT(rexpect_err(vstr_parse_u64(VS("")), "empty") == PARSE_EMPTY, "Empty");
+  TEST_ASSERT(rexpect_err(vstr_parse_i64(VS("-")), "sign") == PARSE_EMPTY, "Sign only");
+  TEST_ASSERT(rexpect_err(vstr_parse_u64(VS("-1")), "neg") == PARSE_INVALID, "u64 rejects '-'");
+  TEST_ASSERT(rexpect_err(vstr_parse_u64(VS("12a45678")), "bad") == PARSE_INVALID, "Bad digit");
+  TEST_ASSERT(rexpect_err(vstr_parse_u64(VS(" 1")), "space") == PARSE_INVALID, "No whitespace");
+  TEST_ASSERT(rexpect_err(vstr_parse_u64(VS("18446744073709551616")), "of") == PARSE_OVERFLOW,
+              "u64 overflow");
+  TEST_ASSERT(rexpect_err(vstr_parse_u64(VS("99999999999999999999x")), "x") == PARSE_INVALID,
+              "Invalid digit wins over overflow");
+  TEST_ASSERT(rexpect_err(vstr_parse_i64(VS("9223372036854775808")), "of") == PARSE_OVERFLOW,
+              "i64 overflow");
+
+  /* 每个十的幂附近都与 fmt_u64 往返 */
+  char buf[FMT_NUM_BUF_SIZE];
+  bool all_ok = true;
+  for (u64 p = 1; p != 0 && p <= UINT64_MAX / 10; p *= 10)
+  {
+    u64 probes[] = {p - 1, p, p + 1, p * 9 + 7};
+    for (usize i = 0; i < 4; i++)
+    {
+      vstr text = {.ptr = buf, .len = fmt_u64(buf, probes[i])};
+      Result_u64_ParseError r = vstr_parse_u64(text);
+      all_ok = all_ok && ris_ok(r) && r.value.ok == probes[i];
+    }
+  }
+  TEST_ASSERT(all_ok, "vstr_parse_u64 should round-trip fmt_u64");
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 浮点数
+ * =========================================
+ */
+TEST_SUITE(test_parse_floats)
+{
+  SUITE_START("Parse Floats");
+
+  TEST_ASSERT(rexpect(vstr_parse_f64(VS("0.1")), "0.1") == 0.1, "0.1");
+  TEST_ASSERT(rexpect(vstr_parse_f64(VS("-2.5e3")), "-2.5e3") == -2500.0, "-2.5e3");
+  TEST_ASSERT(rexpect(vstr_parse_f64(VS(".5")), ".5") == 0.5, ".5");
+  TEST_ASSERT(rexpect(vstr_parse_f64(VS("5.")), "5.") == 5.0, "5.");
+  TEST_ASSERT(rexpect(vstr_parse_f64(VS("1E+2")), "1E+2") == 100.0, "1E+2");
+  TEST_ASSERT(rexpect(vstr_parse_f64(VS("1e400")), "1e400") == 1.0 / 0.0, "Overflow is inf");
+  TEST_ASSERT(rexpect(vstr_parse_f64(VS("-Infinity")), "-inf") == -1.0 / 0.0, "-Infinity");
+  f64 nan = rexpect(vstr_parse_f64(VS("NaN")), "nan");
+  TEST_ASSERT(nan != nan, "NaN");
+
+  f64 neg_zero = rexpect(vstr_parse_f64(VS("-0.0")), "-0.0");
+  TEST_ASSERT(neg_zero == 0 && 1.0 / neg_zero < 0, "-0.0 keeps its sign");
+
+  vstr slice = {.ptr = "3.25e2junk", .len = 6};
+  TEST_ASSERT(rexpect(vstr_parse_f64(slice), "slice") == 325.0, "Slice");
+
+  TEST_ASSERT(rexpect_err(vstr_parse_f64(VS("")), "empty") == PARSE_EMPTY, "Empty");
+  TEST_ASSERT(rexpect_err(vstr_parse_f64(VS(".")), "dot") == PARSE_INVALID, "Lone dot");
+  TEST_ASSERT(rexpect_err(vstr_parse_f64(VS("1e")), "1e") == PARSE_INVALID, "Missing exponent");
+  TEST_ASSERT(rexpect_err(vstr_parse_f64(VS("1.5x")), "1.5x") == PARSE_INVALID, "Trailing");
+
+  /* 难例: 正中间, 次正规数边界, 超过 19 位有效数字 */
+  str hard[] = {
+    "9007199254740993",
+    "9007199254740993.0000000000000000000000001",
+    "2.2250738585072011e-308",
+    "2.2250738585072012e-308",
+    "4.9406564584124654e-324",
+    "2.4703282292062327e-324",
+    "2.4703282292062328e-324",
+    "1.7976931348623157e308",
+    "1.7976931348623159e308",
+    "7.2057594037927933e16",
+    "123456789012345678901234567890",
+    "0.000000000000000000000000000000000000000000001",
+    "2.00000000000000011102230246251565404236316680908203125",
+    "2.000000000000000111022302462515654042363166809082031250000000000000000000001",
+  };
+  bool hard_ok = true;
+  for (usize i = 0; i < sizeof(hard) / sizeof(hard[0]); i++)
+  {
+    hard_ok = hard_ok && same_as_strtod(hard[i]);
+  }
+  TEST_ASSERT(hard_ok, "Hard cases should match strtod");
+
+  /* 伪随机位模式: fmt_f64 的输出必须解析回完全相同的值 */
+  char buf[FMT_NUM_BUF_SIZE + 1];
+  u64 seed = 0x9e3779b97f4a7c15ull;
+  bool roundtrip_ok = true;
+  bool digits_ok = true;
+  for (int i = 0; i < 100000; i++)
+  {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+
+    f64 d;
+    memcpy(&d, &seed, sizeof(d));
+    if (d == d && d - d == 0)
+    {
+      vstr text = {.ptr = buf, .len = fmt_f64(buf, d)};
+      Result_f64_ParseError r = vstr_parse_f64(text);
+      roundtrip_ok = roundtrip_ok && ris_ok(r) && memcmp(&r.value.ok, &d, sizeof(d)) == 0;
+    }
+
+    /* 随机的长数字串 (会触发截断和慢路径) */
+    char digits[64];
+    usize len = 0;
+    usize ndigits = 1 + (seed >> 8) % 30;
+    for (usize k = 0; k < ndigits; k++)
+    {
+      digits[len++] = (char)('0' + (seed >> (k % 60)) % 10);
+    }
+    digits[len++] = 'e';
+    len += fmt_i64(digits + len, (i64)((seed >> 40) % 700) - 350);
+    digits[len] = '\0';
+    digits_ok = digits_ok && same_as_strtod(digits);
+  }
+  TEST_ASSERT(roundtrip_ok, "vstr_parse_f64 should round-trip fmt_f64");
+  TEST_ASSERT(digits_ok, "Random digit strings should match strtod");
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_parse_integers);
+  RUN_SUITE(test_parse_floats);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_pool.c */
+
+#include <core/mem/sysalc.h>
+#include <stdatomic.h>
+#include <std/test/test.h>
+#include <std/thread/pool.h>
+
+static SystemAlloc g_sys;
+
+typedef struct Counts
+{
+  _Atomic u32 hits[1000];
+  _Atomic usize total;
+  ThreadPool *pool;
+} Counts;
+
+static void
+count_task(void *ctx, usize i)
+{
+  Counts *c = (Counts *)ctx;
+  atomic_fetch_add(&c->hits[i], 1);
+  atomic_fetch_add(&c->total, i);
+}
+
+/* 在任务里再次调用 pool_run: 应当顺序执行而不是死锁 */
+static void
+nested_task(void *ctx, usize i)
+{
+  Counts *c = (Counts *)ctx;
+  Counts inner = {0};
+  pool_run(c->pool, 10, count_task, &inner);
+  atomic_fetch_add(&c->hits[i], (u32)atomic_load(&inner.total));
+}
+
+/* 每个批次带着自己的规模; 任何越界下标都说明有线程把旧批次的 fn 用在了新下标上 */
+typedef struct Batch
+{
+  usize n;
+  _Atomic u32 hits[64];
+} Batch;
+
+static _Atomic usize g_out_of_range;
+
+static void
+batch_task(void *ctx, usize i)
+{
+  Batch *b = (Batch *)ctx;
+  if (i >= b->n)
+  {
+    atomic_fetch_add(&g_out_of_range, 1);
+    return;
+  }
+  atomic_fetch_add(&b->hits[i], 1);
+}
+
+/*
+ * =========================================
+ * 套件 1: 每个下标恰好执行一次
+ * =========================================
+ */
+TEST_SUITE(test_pool_run)
+{
+  SUITE_START("Pool Run");
+
+  ThreadPool *pool = oexpect(pool_new(&g_sys, 4), "Failed to create pool");
+  TEST_ASSERT(pool_threads(pool) == 4, "Pool should report 4 threads");
+
+  static Counts c;
+  bool all_ok = true;
+  for (u32 round = 0; round < 200 && all_ok; round++)
+  {
+    memset(&c, 0, sizeof(c));
+    usize n = 1 + (round * 37) % 1000;
+    pool_run(pool, n, count_task, &c);
+    all_ok = atomic_load(&c.total) == n * (n - 1) / 2;
+    for (usize i = 0; i < 1000 && all_ok; i++)
+    {
+      all_ok = atomic_load(&c.hits[i]) == (i < n ? 1u : 0u);
+    }
+  }
+  TEST_ASSERT(all_ok, "Every index should run exactly once, across 200 back-to-back runs");
+
+  memset(&c, 0, sizeof(c));
+  c.pool = pool;
+  pool_run(pool, 100, nested_task, &c);
+  all_ok = true;
+  for (usize i = 0; i < 100 && all_ok; i++)
+  {
+    all_ok = atomic_load(&c.hits[i]) == 45;
+  }
+  TEST_ASSERT(all_ok, "Nested pool_run should run inline");
+
+  pool_free(pool);
+
+  memset(&c, 0, sizeof(c));
+  pool_run(NULL, 10, count_task, &c);
+  TEST_ASSERT(atomic_load(&c.total) == 45, "A NULL pool runs sequentially");
+  TEST_ASSERT(pool_hardware_threads() >= 1, "At least one hardware thread");
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 超额订阅下交替大小批次
+ * =========================================
+ */
+TEST_SUITE(test_pool_oversubscribed)
+{
+  SUITE_START("Pool Oversubscribed");
+
+  ThreadPool *pool = oexpect(pool_new(&g_sys, 48), "Failed to create pool");
+
+  /* 迟到的工作线程最容易在大批次之后紧跟的小批次里越界 */
+  static Batch big = {.n = 64};
+  static Batch small = {.n = 2};
+  atomic_store(&g_out_of_range, 0);
+  bool all_ok = true;
+  for (u32 round = 0; round < 100000 && all_ok; round++)
+  {
+    Batch *b = (round & 1u) == 0 ? &big : &small;
+    for (usize i = 0; i < b->n; i++)
+    {
+      atomic_store(&b->hits[i], 0);
+    }
+    pool_run(pool, b->n, batch_task, b);
+    for (usize i = 0; i < b->n && all_ok; i++)
+    {
+      all_ok = atomic_load(&b->hits[i]) == 1;
+    }
+  }
+  TEST_ASSERT(all_ok, "Every index should run exactly once, across alternating batch sizes");
+  TEST_ASSERT(atomic_load(&g_out_of_range) == 0,
+              "No task should see an index from another batch, got {}",
+              atomic_load(&g_out_of_range));
+
+  pool_free(pool);
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_pool_run);
+  RUN_SUITE(test_pool_oversubscribed);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_pqueue.c */
+
+#include <core/mem/sysalc.h>
+#include <std/pqueue.h>
+#include <std/test/test.h>
+
+static SystemAlloc g_sys;
+
+static inline Ordering
+cmp_u32(const u32 *a, const u32 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+static inline Ordering
+cmp_u64(const u64 *a, const u64 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+static inline Ordering
+cmp_i32_desc(const i32 *a, const i32 *b)
+{
+  return *a > *b ? LESS : (*a < *b ? GREATER : EQUAL);
+}
+
+DEFINE_PRIORITY_QUEUE(Heap4, u32, cmp_u32, SystemAlloc, SYSTEM)
+DEFINE_PRIORITY_QUEUE_ARITY(Heap2, u32, cmp_u32, 2, SystemAlloc, SYSTEM)
+DEFINE_PRIORITY_QUEUE_ARITY(Heap3, u32, cmp_u32, 3, SystemAlloc, SYSTEM)
+DEFINE_PRIORITY_QUEUE(MaxHeap, i32, cmp_i32_desc, SystemAlloc, SYSTEM)
+DEFINE_INDEXED_PRIORITY_QUEUE(IdxHeap, u64, cmp_u64, SystemAlloc, SYSTEM)
+
+static u64 g_rng = 0x9e3779b97f4a7c15ull;
+
+static u32
+next_u32(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return (u32)g_rng;
+}
+
+#define N 5000
+
+/*
+ * =========================================
+ * 套件 1: 基本堆
+ * =========================================
+ */
+TEST_SUITE(test_pqueue_basic)
+{
+  SUITE_START("Priority Queue Basic");
+
+  Heap4 h;
+  Heap4_init(&h, &g_sys);
+  u32 v = 0;
+  TEST_ASSERT(Heap4_is_empty(&h) && Heap4_peek(&h) == NULL && !Heap4_pop(&h, &v),
+              "Empty queue");
+
+  static u32 input[N];
+  for (usize i = 0; i < N; i++)
+  {
+    input[i] = next_u32() % 1000; /* 大量重复 */
+    Heap4_push(&h, input[i]);
+  }
+  TEST_ASSERT(Heap4_len(&h) == N, "len == N after pushes");
+
+  bool sorted = true;
+  u32 prev = 0;
+  usize popped = 0;
+  while (Heap4_pop(&h, &v))
+  {
+    sorted = sorted && v >= prev;
+    prev = v;
+    popped++;
+  }
+  TEST_ASSERT(sorted && popped == N, "Pops come out in non-decreasing order");
+
+  /* heapify_from 与逐个 push 的结果一致 */
+  Heap4_heapify_from(&h, input, N);
+  Heap2 h2;
+  Heap2_init(&h2, &g_sys);
+  Heap2_heapify_from(&h2, input, N);
+  Heap3 h3;
+  Heap3_init(&h3, &g_sys);
+  for (usize i = 0; i < N; i++)
+  {
+    Heap3_push(&h3, input[i]);
+  }
+  bool same = true;
+  u32 a = 0, b = 0, c = 0;
+  while (Heap4_pop(&h, &a))
+  {
+    same = same && Heap2_pop(&h2, &b) && Heap3_pop(&h3, &c) && a == b && b == c;
+  }
+  TEST_ASSERT(same && Heap2_is_empty(&h2) && Heap3_is_empty(&h3),
+              "Arity 2, 3 and 4 (heapify and push) agree");
+
+  /* push_pop */
+  Heap4_push(&h, 10);
+  Heap4_push(&h, 20);
+  TEST_ASSERT(Heap4_push_pop(&h, 5) == 5, "push_pop returns a value earlier than the top");
+  TEST_ASSERT(Heap4_push_pop(&h, 15) == 10 && *Heap4_peek(&h) == 15,
+              "push_pop swaps with the top otherwise");
+
+  Heap4_deinit(&h);
+  Heap2_deinit(&h2);
+  Heap3_deinit(&h3);
+
+  MaxHeap *mh = MaxHeap_new(&g_sys);
+  i32 vals[] = {3, -1, 7, 7, 0};
+  MaxHeap_heapify_from(mh, vals, 5);
+  i32 top = 0;
+  TEST_ASSERT(MaxHeap_pop(mh, &top) && top == 7, "Descending comparator gives a max-heap");
+  MaxHeap_destroy(mh);
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 索引堆
+ * =========================================
+ */
+
+/* 参考模型: prio[id], present[id] */
+static u64 g_prio[512];
+static bool g_present[512];
+
+static bool
+model_min(usize *id)
+{
+  bool any = false;
+  for (usize i = 0; i < 512; i++)
+  {
+    if (g_present[i] && (!any || g_prio[i] < g_prio[*id]))
+    {
+      *id = i;
+      any = true;
+    }
+  }
+  return any;
+}
+
+TEST_SUITE(test_pqueue_indexed)
+{
+  SUITE_START("Priority Queue Indexed");
+
+  IdxHeap q;
+  IdxHeap_init(&q, &g_sys);
+  IdxHeap_push(&q, 5, 50);
+  IdxHeap_push(&q, 1, 10);
+  IdxHeap_push(&q, 9, 90);
+  TEST_ASSERT(IdxHeap_contains(&q, 9) && !IdxHeap_contains(&q, 2) && !IdxHeap_contains(&q, 100),
+              "contains");
+  IdxHeap_decrease_key(&q, 9, 5);
+  usize id = 0;
+  TEST_ASSERT(*IdxHeap_peek(&q, &id) == 5 && id == 9, "decrease_key moves id 9 to the top");
+  IdxHeap_update(&q, 9, 100);
+  TEST_ASSERT(*IdxHeap_peek(&q, &id) == 10 && id == 1, "update can move an id later");
+  TEST_ASSERT(!IdxHeap_push_or_decrease(&q, 5, 60) && *IdxHeap_get(&q, 5) == 50,
+              "push_or_decrease ignores a later priority");
+  TEST_ASSERT(IdxHeap_push_or_decrease(&q, 5, 1) && *IdxHeap_get(&q, 5) == 1,
+              "push_or_decrease applies an earlier priority");
+  u64 prio = 0;
+  TEST_ASSERT(IdxHeap_remove(&q, 1, &prio) && prio == 10 && !IdxHeap_contains(&q, 1),
+              "remove by id");
+  IdxHeap_clear(&q);
+  TEST_ASSERT(IdxHeap_is_empty(&q) && !IdxHeap_contains(&q, 5), "clear resets positions");
+
+  /* 随机操作, 与线性扫描的模型比较 */
+  bool all_ok = true;
+  for (usize step = 0; step < 20000 && all_ok; step++)
+  {
+    usize target = next_u32() % 512;
+    u64 p = next_u32() % 10000;
+    switch (next_u32() % 4)
+    {
+    case 0:
+      if (!g_present[target])
+      {
+        IdxHeap_push(&q, target, p);
+        g_present[target] = true;
+        g_prio[target] = p;
+      }
+      break;
+    case 1:
+      if (g_present[target])
+      {
+        IdxHeap_update(&q, target, p);
+        g_prio[target] = p;
+      }
+      break;
+    case 2:
+    {
+      bool changed = IdxHeap_push_or_decrease(&q, target, p);
+      bool expect = !g_present[target] || p < g_prio[target];
+      all_ok = changed == expect;
+      if (expect)
+      {
+        g_present[target] = true;
+        g_prio[target] = p;
+      }
+      break;
+    }
+    default:
+    {
+      usize mid = 0;
+      bool any = model_min(&mid);
+      usize got = 0;
+      u64 got_prio = 0;
+      all_ok = IdxHeap_pop(&q, &got, &got_prio) == any;
+      if (any)
+      {
+        /* 优先级相同时 id 可能不同, 只比较优先级 */
+        all_ok = all_ok && got_prio == g_prio[mid] && g_present[got] && g_prio[got] == got_prio;
+        g_present[got] = false;
+      }
+      break;
+    }
+    }
+  }
+  TEST_ASSERT(all_ok, "Random push / update / decrease / pop should match the model");
+
+  IdxHeap_deinit(&q);
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_pqueue_basic);
+  RUN_SUITE(test_pqueue_indexed);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_psort.c */
+
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/test/test.h>
+#include <std/thread/psort.h>
+#include <std/vector.h>
+
+static SystemAlloc g_sys;
+
+static inline Ordering
+cmp_u64(const u64 *a, const u64 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+DEFINE_SORT(u64s, u64, cmp_u64)
+DEFINE_PARALLEL_SORT(u64s, u64, SystemAlloc, SYSTEM)
+DEFINE_VECTOR(Vec_u64, u64, SystemAlloc, SYSTEM)
+
+DEFINE_SORT(u64b, u64, cmp_u64)
+DEFINE_PARALLEL_SORT(u64b, u64, Bump, BUMP)
+
+static u64 g_rng = 0x9E3779B97F4A7C15ull;
+
+static u64
+next_rand(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+/* 排序结果应与顺序 pdqsort 完全一致 */
+static bool
+check_against_sequential(ThreadPool *pool, usize len, u64 modulo)
+{
+  Vec_u64 a, b;
+  Vec_u64_init(&a, &g_sys);
+  Vec_u64_init(&b, &g_sys);
+  for (usize i = 0; i < len; i++)
+  {
+    u64 v = modulo == 0 ? next_rand() : next_rand() % modulo;
+    Vec_u64_push(&a, v);
+    Vec_u64_push(&b, v);
+  }
+  u64s_par_sort(pool, &g_sys, a.data, a.len);
+  u64s_sort(b.data, b.len);
+  bool ok = memcmp(a.data, b.data, len * sizeof(u64)) == 0;
+  Vec_u64_deinit(&a);
+  Vec_u64_deinit(&b);
+  return ok;
+}
+
+/*
+ * =========================================
+ * 套件 1: 各种线程数与长度
+ * =========================================
+ */
+TEST_SUITE(test_psort_basic)
+{
+  SUITE_START("Parallel Sort");
+
+  usize threads[] = {1, 2, 3, 4, 7, 8};
+  for (usize t = 0; t < sizeof(threads) / sizeof(threads[0]); t++)
+  {
+    ThreadPool *pool = oexpect(pool_new(&g_sys, threads[t]), "Failed to create pool");
+
+    /* 长度覆盖: 低于阈值, 不被线程数整除, 段数不是 2 的幂 */
+    usize lens[] = {0, 1, 1000, PSORT_SEQUENTIAL_THRESHOLD, 100003, 250000};
+    bool all_ok = true;
+    for (usize l = 0; l < sizeof(lens) / sizeof(lens[0]) && all_ok; l++)
+    {
+      all_ok = check_against_sequential(pool, lens[l], 0) &&
+               check_against_sequential(pool, lens[l], 16);
+    }
+    TEST_ASSERT(all_ok, "{} thread(s): random and duplicate-heavy inputs sort correctly",
+                threads[t]);
+    pool_free(pool);
+  }
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 已排序 / 逆序, 以及 Bump 临时缓冲区
+ * =========================================
+ */
+TEST_SUITE(test_psort_patterns)
+{
+  SUITE_START("Parallel Sort Patterns");
+
+  ThreadPool *pool = oexpect(pool_new(&g_sys, 4), "Failed to create pool");
+  enum
+  {
+    N = 200000
+  };
+  static u64 data[N];
+
+  for (usize i = 0; i < N; i++)
+  {
+    data[i] = N - i;
+  }
+  u64s_par_sort(pool, &g_sys, data, N);
+  TEST_ASSERT(u64s_is_sorted(data, N) && data[0] == 1 && data[N - 1] == N,
+              "Reversed input should sort");
+
+  u64s_par_sort(pool, &g_sys, data, N);
+  TEST_ASSERT(u64s_is_sorted(data, N) && data[0] == 1, "Sorted input stays sorted");
+
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+  for (usize i = 0; i < N; i++)
+  {
+    data[i] = next_rand();
+  }
+  u64b_par_sort(pool, arena, data, N);
+  TEST_ASSERT(u64b_is_sorted(data, N), "Scratch from a Bump arena works");
+  TEST_ASSERT(bump_get_allocated_bytes(arena) >= N * sizeof(u64),
+              "Scratch buffer should come from the arena");
+  bump_free(arena);
+
+  pool_free(pool);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_psort_basic);
+  RUN_SUITE(test_psort_patterns);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_queue.c */
+
+#include <core/mem/sysalc.h>
+#include <std/test/test.h>
+#include <std/thread/queue.h>
+#include <threads.h>
+
+static SystemAlloc g_sys;
+
+DEFINE_SPSC_QUEUE(Ring_u64, u64, SystemAlloc, SYSTEM)
+DEFINE_MPMC_QUEUE(Mpmc_u64, u64, SystemAlloc, SYSTEM)
+
+/*
+ * =========================================
+ * 套件 1: 单线程语义
+ * =========================================
+ */
+TEST_SUITE(test_queue_basic)
+{
+  SUITE_START("Queue Basic");
+
+  Ring_u64 ring;
+  Ring_u64_init(&ring, &g_sys, 5);
+  TEST_ASSERT(Ring_u64_capacity(&ring) == 8, "Capacity rounds up to 8");
+
+  u64 v = 0;
+  TEST_ASSERT(!Ring_u64_pop(&ring, &v), "Pop on empty ring fails");
+  bool all_ok = true;
+  for (u64 i = 0; i < 8; i++)
+  {
+    all_ok = all_ok && Ring_u64_push(&ring, i);
+  }
+  TEST_ASSERT(all_ok && !Ring_u64_push(&ring, 99), "Ring holds exactly 8");
+  TEST_ASSERT(Ring_u64_len(&ring) == 8, "Length is 8");
+
+  /* 回绕多圈, 保持 FIFO */
+  all_ok = true;
+  for (u64 i = 0; i < 100 && all_ok; i++)
+  {
+    all_ok = Ring_u64_pop(&ring, &v) && v == i && Ring_u64_push(&ring, i + 8);
+  }
+  TEST_ASSERT(all_ok, "FIFO order survives wrap-around");
+
+  u64 batch[16];
+  TEST_ASSERT(Ring_u64_pop_n(&ring, batch, 16) == 8 && batch[0] == 100 && batch[7] == 107,
+              "pop_n drains what is available");
+  for (u64 i = 0; i < 16; i++)
+  {
+    batch[i] = 1000 + i;
+  }
+  TEST_ASSERT(Ring_u64_push_n(&ring, batch, 16) == 8, "push_n stops at capacity");
+  TEST_ASSERT(Ring_u64_pop_n(&ring, batch, 3) == 3 && batch[2] == 1002, "Partial pop_n");
+  Ring_u64_deinit(&ring);
+
+  Mpmc_u64 q;
+  Mpmc_u64_init(&q, &g_sys, 4);
+  TEST_ASSERT(!Mpmc_u64_pop(&q, &v), "Pop on empty MPMC queue fails");
+  all_ok = true;
+  for (u64 i = 0; i < 4; i++)
+  {
+    all_ok = all_ok && Mpmc_u64_push(&q, i * 10);
+  }
+  TEST_ASSERT(all_ok && !Mpmc_u64_push(&q, 1), "MPMC queue holds exactly 4");
+  all_ok = true;
+  for (u64 i = 0; i < 50 && all_ok; i++)
+  {
+    all_ok = Mpmc_u64_pop(&q, &v) && v == i * 10 && Mpmc_u64_push(&q, (i + 4) * 10);
+  }
+  TEST_ASSERT(all_ok, "MPMC FIFO order survives wrap-around");
+  Mpmc_u64_deinit(&q);
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 多线程
+ * =========================================
+ */
+#define SPSC_COUNT 200000
+
+static int
+spsc_producer(void *arg)
+{
+  Ring_u64 *ring = (Ring_u64 *)arg;
+  u64 batch[7];
+  u64 next = 0;
+  while (next < SPSC_COUNT)
+  {
+    /* 交替使用单个与批量接口 */
+    if (next % 2 == 0)
+    {
+      if (Ring_u64_push(ring, next))
+        next++;
+      else
+        thrd_yield();
+      continue;
+    }
+    usize n = 0;
+    for (; n < 7 && next + n < SPSC_COUNT; n++)
+    {
+      batch[n] = next + n;
+    }
+    usize pushed = Ring_u64_push_n(ring, batch, n);
+    next += pushed;
+    if (pushed == 0)
+      thrd_yield();
+  }
+  return 0;
+}
+
+#define MPMC_THREADS 4
+#define MPMC_PER_THREAD 50000
+
+typedef struct MpmcCtx
+{
+  Mpmc_u64 q;
+  _Atomic u32 seen[MPMC_THREADS * MPMC_PER_THREAD];
+  _Atomic usize consumed;
+  _Atomic u32 next_id;
+} MpmcCtx;
+
+static int
+mpmc_producer(void *arg)
+{
+  MpmcCtx *ctx = (MpmcCtx *)arg;
+  u64 id = atomic_fetch_add(&ctx->next_id, 1);
+  for (u64 i = 0; i < MPMC_PER_THREAD; i++)
+  {
+    while (!Mpmc_u64_push(&ctx->q, id * MPMC_PER_THREAD + i))
+    {
+      thrd_yield();
+    }
+  }
+  return 0;
+}
+
+static int
+mpmc_consumer(void *arg)
+{
+  MpmcCtx *ctx = (MpmcCtx *)arg;
+  u64 v = 0;
+  while (atomic_load(&ctx->consumed) < MPMC_THREADS * MPMC_PER_THREAD)
+  {
+    if (Mpmc_u64_pop(&ctx->q, &v))
+    {
+      atomic_fetch_add(&ctx->seen[v], 1);
+      atomic_fetch_add(&ctx->consumed, 1);
+    }
+    else
+    {
+      thrd_yield();
+    }
+  }
+  return 0;
+}
+
+TEST_SUITE(test_queue_threads)
+{
+  SUITE_START("Queue Threads");
+
+  Ring_u64 ring;
+  Ring_u64_init(&ring, &g_sys, 64);
+  thrd_t producer;
+  thrd_create(&producer, spsc_producer, &ring);
+
+  bool in_order = true;
+  u64 expected = 0;
+  u64 batch[5];
+  while (expected < SPSC_COUNT && in_order)
+  {
+    usize n = Ring_u64_pop_n(&ring, batch, 5);
+    for (usize i = 0; i < n; i++)
+    {
+      in_order = in_order && batch[i] == expected++;
+    }
+    if (n == 0)
+      thrd_yield();
+  }
+  thrd_join(producer, NULL);
+  TEST_ASSERT(in_order && expected == SPSC_COUNT, "SPSC delivers every value in order");
+  Ring_u64_deinit(&ring);
+
+  static MpmcCtx ctx;
+  Mpmc_u64_init(&ctx.q, &g_sys, 128);
+  thrd_t threads[2 * MPMC_THREADS];
+  for (usize i = 0; i < MPMC_THREADS; i++)
+  {
+    thrd_create(&threads[i], mpmc_producer, &ctx);
+    thrd_create(&threads[MPMC_THREADS + i], mpmc_consumer, &ctx);
+  }
+  for (usize i = 0; i < 2 * MPMC_THREADS; i++)
+  {
+    thrd_join(threads[i], NULL);
+  }
+  bool exactly_once = true;
+  for (usize i = 0; i < MPMC_THREADS * MPMC_PER_THREAD && exactly_once; i++)
+  {
+    exactly_once = atomic_load(&ctx.seen[i]) == 1;
+  }
+  TEST_ASSERT(exactly_once, "MPMC delivers every value exactly once (4 producers, 4 consumers)");
+  Mpmc_u64_deinit(&ctx.q);
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_queue_basic);
+  RUN_SUITE(test_queue_threads);
+
+  TEST_SUMMARY();
+}
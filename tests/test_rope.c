@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_rope.c */
+
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/rope/rope.h>
+#include <std/test/test.h>
+#include <unistd.h> // pipe, read, close
+
+static SystemAlloc g_sys;
+
+/*
+ * =========================================
+ * 套件 1: 追加与拍平
+ * =========================================
+ */
+TEST_SUITE(test_rope_append)
+{
+  SUITE_START("Rope Append");
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+
+  Rope r;
+  rope_init(&r, arena);
+  TEST_ASSERT(rope_len(&r) == 0, "New rope should be empty");
+  TEST_ASSERT(str_cmp(rope_flatten(&r), "") == EQUAL, "Empty rope should flatten to \"\"");
+
+  rope_push_str(&r, "hello");
+  rope_push(&r, ' ');
+  rope_format(&r, "world #{}", 7);
+  TEST_ASSERT(rope_len(&r) == 14, "Length should be 14");
+  TEST_ASSERT(str_cmp(rope_flatten(&r), "hello world #7") == EQUAL, "Flatten mismatch");
+  TEST_ASSERT(rope_char_at(&r, 6) == 'w', "char_at(6) should be 'w'");
+
+  /* 跨越多个尾部缓冲区 + 大块叶子 */
+  Rope big;
+  rope_init(&big, arena);
+  usize expected = 0;
+  for (int i = 0; i < 5000; i++)
+  {
+    rope_push_str(&big, "0123456789");
+    expected += 10;
+  }
+  static char large[3 * ROPE_CHUNK_SIZE];
+  memset(large, 'z', sizeof(large));
+  rope_push_bytes(&big, large, sizeof(large));
+  expected += sizeof(large);
+
+  TEST_ASSERT(rope_len(&big) == expected, "Big rope length mismatch");
+  TEST_ASSERT(rope_char_at(&big, 12345) == '5', "char_at(12345) should be '5'");
+  TEST_ASSERT(rope_char_at(&big, expected - 1) == 'z', "Last char should be 'z'");
+
+  usize total = 0;
+  usize pieces = 0;
+  for_rope_slices(piece, &big)
+  {
+    total += piece.len;
+    pieces++;
+  }
+  TEST_ASSERT(total == expected, "Slices should cover the whole rope");
+  TEST_ASSERT(pieces > 1, "Big rope should consist of several slices");
+
+  bump_free(arena);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: insert / remove / substr / concat
+ * =========================================
+ */
+TEST_SUITE(test_rope_edit)
+{
+  SUITE_START("Rope Edit");
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+
+  Rope r;
+  rope_init(&r, arena);
+  rope_push_str(&r, "int main() { return 0; }");
+
+  rope_insert(&r, 12, " puts(\"hi\");", 12);
+  TEST_ASSERT(str_cmp(rope_flatten(&r), "int main() { puts(\"hi\"); return 0; }") == EQUAL,
+              "Insert mismatch: {}",
+              rope_flatten(&r));
+
+  rope_insert(&r, 0, "// gen\n", 7);
+  TEST_ASSERT(str_starts_with(rope_flatten(&r), "// gen\nint main()"), "Insert at 0 failed");
+
+  rope_remove(&r, 0, 7);
+  TEST_ASSERT(str_cmp(rope_flatten(&r), "int main() { puts(\"hi\"); return 0; }") == EQUAL,
+              "Remove mismatch: {}",
+              rope_flatten(&r));
+
+  Rope sub = rope_substr(&r, 4, 10);
+  TEST_ASSERT(str_cmp(rope_flatten(&sub), "main()") == EQUAL, "Substr mismatch");
+  TEST_ASSERT(rope_len(&r) == 36, "Source rope should be unchanged by substr");
+
+  Rope tail;
+  rope_init(&tail, arena);
+  rope_push_str(&tail, " // end");
+  rope_concat(&r, &tail);
+  TEST_ASSERT(str_ends_with(rope_flatten(&r), "return 0; } // end"), "Concat mismatch");
+  TEST_ASSERT(str_cmp(rope_flatten(&tail), " // end") == EQUAL, "Concat must not modify other");
+
+  /* 大量随机位置插入, 与朴素字符串对照 */
+  Rope many;
+  rope_init(&many, arena);
+  static char model[4096];
+  usize model_len = 0;
+  u32 seed = 12345;
+  for (int i = 0; i < 1000; i++)
+  {
+    seed = seed * 1103515245u + 12345u;
+    usize pos = model_len == 0 ? 0 : (seed >> 8) % (model_len + 1);
+    char c = (char)('a' + (seed >> 4) % 26);
+    rope_insert(&many, pos, &c, 1);
+    memmove(model + pos + 1, model + pos, model_len - pos);
+    model[pos] = c;
+    model_len++;
+  }
+  model[model_len] = '\0';
+  TEST_ASSERT(str_cmp(rope_flatten(&many), model) == EQUAL, "Random inserts diverged from model");
+
+  bump_free(arena);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: writev 输出
+ * =========================================
+ */
+TEST_SUITE(test_rope_write_fd)
+{
+  SUITE_START("Rope Write FD");
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+
+  Rope r;
+  rope_init(&r, arena);
+  for (int i = 0; i < 100; i++)
+  {
+    rope_insert(&r, rope_len(&r) / 2, "ab", 2);
+  }
+
+  int fds[2];
+  TEST_ASSERT_FATAL(pipe(fds) == 0, "pipe() failed");
+  TEST_ASSERT(rope_write_fd(&r, fds[1]), "rope_write_fd failed");
+  close(fds[1]);
+
+  char buf[512];
+  usize got = 0;
+  ssize_t n;
+  while ((n = read(fds[0], buf + got, sizeof(buf) - got)) > 0)
+  {
+    got += (usize)n;
+  }
+  close(fds[0]);
+
+  TEST_ASSERT(got == rope_len(&r), "Written length mismatch");
+  TEST_ASSERT(memcmp(buf, rope_flatten(&r), got) == 0, "Written content mismatch");
+
+  bump_free(arena);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_rope_append);
+  RUN_SUITE(test_rope_edit);
+  RUN_SUITE(test_rope_write_fd);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_segvec.c */
+
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/segvec.h>
+#include <std/test/test.h>
+
+static SystemAlloc g_sys;
+
+DEFINE_SEGVEC(SegVec_u64, u64, SystemAlloc, SYSTEM)
+DEFINE_SEGVEC(SegVec_bump, u32, Bump, BUMP)
+
+/*
+ * =========================================
+ * 套件 1: 下标 -> (段, 偏移)
+ * =========================================
+ */
+TEST_SUITE(test_segvec_layout)
+{
+  SUITE_START("SegVec Layout");
+
+  TEST_ASSERT(segvec_seg_of(0) == 0 && segvec_offset_in(0, 0) == 0, "0 -> (0, 0)");
+  TEST_ASSERT(segvec_seg_of(SEGVEC_FIRST - 1) == 0, "Last slot of segment 0");
+  TEST_ASSERT(segvec_seg_of(SEGVEC_FIRST) == 1 && segvec_offset_in(SEGVEC_FIRST, 1) == 0,
+              "First slot of segment 1");
+  TEST_ASSERT(segvec_seg_of(3 * SEGVEC_FIRST) == 2 && segvec_offset_in(3 * SEGVEC_FIRST, 2) == 0,
+              "First slot of segment 2");
+
+  /* 穷举: 每个下标恰好落在一个段内, 且段内偏移连续 */
+  bool all_ok = true;
+  usize expected_seg = 0, expected_off = 0;
+  for (usize i = 0; i < 100000 && all_ok; i++)
+  {
+    if (expected_off == segvec_seg_cap(expected_seg))
+    {
+      expected_seg++;
+      expected_off = 0;
+    }
+    usize k = segvec_seg_of(i);
+    all_ok = k == expected_seg && segvec_offset_in(i, k) == expected_off;
+    expected_off++;
+  }
+  TEST_ASSERT(all_ok, "Index mapping should be contiguous across segments");
+  TEST_ASSERT(segvec_total_cap(3) == SEGVEC_FIRST * 7, "Three segments hold 7 * FIRST");
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 稳定地址, 访问与遍历
+ * =========================================
+ */
+TEST_SUITE(test_segvec_stable)
+{
+  SUITE_START("SegVec Stable");
+
+  SegVec_u64 v;
+  SegVec_u64_init(&v, &g_sys);
+  TEST_ASSERT(SegVec_u64_len(&v) == 0 && SegVec_u64_cap(&v) == 0, "Empty vector allocates nothing");
+
+  /* 记住前几个元素的地址, 增长之后必须不变 */
+  u64 *first = SegVec_u64_push(&v, 100);
+  u64 *tenth = NULL;
+  for (u64 i = 1; i < 50000; i++)
+  {
+    u64 *p = SegVec_u64_push(&v, 100 + i);
+    if (i == 10)
+    {
+      tenth = p;
+    }
+  }
+  TEST_ASSERT(SegVec_u64_len(&v) == 50000, "Length should be 50000");
+  TEST_ASSERT(first == SegVec_u64_get(&v, 0) && *first == 100, "First element must not move");
+  TEST_ASSERT(tenth == SegVec_u64_get(&v, 10) && *tenth == 110, "Tenth element must not move");
+
+  bool all_ok = true;
+  for (usize i = 0; i < 50000 && all_ok; i++)
+  {
+    all_ok = *SegVec_u64_get(&v, i) == 100 + i;
+  }
+  TEST_ASSERT(all_ok, "Random access should match push order");
+
+  /* 按段遍历: 总数和内容都与下标访问一致 */
+  usize seen = 0;
+  usize slices = 0;
+  all_ok = true;
+  for_segvec_slices(SegVec_u64, s, &v)
+  {
+    for (usize i = 0; i < s.len; i++)
+    {
+      all_ok = all_ok && s.ptr[i] == 100 + seen + i;
+    }
+    seen += s.len;
+    slices++;
+  }
+  TEST_ASSERT(all_ok && seen == 50000, "Slices should cover every element in order");
+  TEST_ASSERT(slices == v.nseg, "One slice per allocated segment ({} vs {})", slices, v.nseg);
+
+  u64 last = 0;
+  TEST_ASSERT(SegVec_u64_pop(&v, &last) && last == 100 + 49999, "Pop should return the last");
+  usize cap = SegVec_u64_cap(&v);
+  SegVec_u64_clear(&v);
+  TEST_ASSERT(SegVec_u64_len(&v) == 0 && SegVec_u64_cap(&v) == cap, "Clear keeps segments");
+  TEST_ASSERT(!SegVec_u64_pop(&v, NULL), "Pop on empty vector should fail");
+
+  slices = 0;
+  for_segvec_slices(SegVec_u64, s, &v)
+  {
+    slices += s.len;
+  }
+  TEST_ASSERT(slices == 0, "Empty vector yields no slices");
+
+  SegVec_u64_deinit(&v);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: Bump 分配器
+ * =========================================
+ */
+TEST_SUITE(test_segvec_bump)
+{
+  SUITE_START("SegVec Bump");
+
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+
+  SegVec_bump *v = SegVec_bump_new(arena);
+  SegVec_bump_reserve_to(v, 100);
+  TEST_ASSERT(SegVec_bump_cap(v) >= 100, "Reserve should allocate enough segments");
+  usize nseg = v->nseg;
+
+  for (u32 i = 0; i < 100; i++)
+  {
+    SegVec_bump_push(v, i * 3);
+  }
+  TEST_ASSERT(v->nseg == nseg, "Reserved segments should be enough");
+  TEST_ASSERT(*SegVec_bump_get(v, 99) == 297, "Value[99] should be 297");
+
+  bump_free(arena);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_segvec_layout);
+  RUN_SUITE(test_segvec_stable);
+  RUN_SUITE(test_segvec_bump);
+
+  TEST_SUMMARY();
+}
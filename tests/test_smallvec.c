@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_smallvec.c */
+
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/smallvec.h>
+#include <std/test/test.h>
+
+static SystemAlloc g_sys;
+
+DEFINE_SMALLVEC(SmallVec_i32, i32, 4, SystemAlloc, SYSTEM)
+
+typedef struct Pair
+{
+  u64 key;
+  f64 value;
+} Pair;
+
+DEFINE_SMALLVEC(SmallVec_pair, Pair, 2, Bump, BUMP)
+
+/*
+ * =========================================
+ * 套件 1: 内联存储 (不分配)
+ * =========================================
+ */
+TEST_SUITE(test_smallvec_inline)
+{
+  SUITE_START("SmallVec Inline");
+
+  SmallVec_i32 v;
+  SmallVec_i32_init(&v, &g_sys);
+  TEST_ASSERT(SmallVec_i32_len(&v) == 0, "Length should be 0");
+  TEST_ASSERT(SmallVec_i32_cap(&v) == 4, "Capacity should be the inline capacity");
+  TEST_ASSERT(SmallVec_i32_is_inline(&v), "Empty vector should be inline");
+
+  for (i32 i = 0; i < 4; i++)
+  {
+    SmallVec_i32_push(&v, i * 10);
+  }
+  TEST_ASSERT(SmallVec_i32_len(&v) == 4, "Length should be 4");
+  TEST_ASSERT(SmallVec_i32_is_inline(&v), "N elements should stay inline");
+  TEST_ASSERT(SmallVec_i32_as_ptr(&v) == v.repr.buf, "Data should live inside the struct");
+  TEST_ASSERT(SmallVec_i32_as_const_ptr(&v)[3] == 30, "Value[3] should be 30");
+
+  SmallVec_i32_clear(&v);
+  TEST_ASSERT(SmallVec_i32_len(&v) == 0 && SmallVec_i32_is_inline(&v), "Clear keeps inline");
+
+  /* 容量够用时 reserve 不应溢出 */
+  SmallVec_i32_reserve_to(&v, 3);
+  TEST_ASSERT(SmallVec_i32_is_inline(&v), "Reserving <= N should not spill");
+
+  SmallVec_i32_deinit(&v);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 溢出到堆
+ * =========================================
+ */
+TEST_SUITE(test_smallvec_spill)
+{
+  SUITE_START("SmallVec Spill");
+
+  SmallVec_i32 *v = SmallVec_i32_new(&g_sys);
+  for (i32 i = 0; i < 5; i++)
+  {
+    SmallVec_i32_push(v, i);
+  }
+  TEST_ASSERT(!SmallVec_i32_is_inline(v), "N + 1 elements should spill");
+  TEST_ASSERT(SmallVec_i32_cap(v) >= 5, "Capacity should be >= 5");
+
+  for (i32 i = 5; i < 1000; i++)
+  {
+    SmallVec_i32_push(v, i);
+  }
+  bool all_ok = SmallVec_i32_len(v) == 1000;
+  for (i32 i = 0; i < 1000 && all_ok; i++)
+  {
+    all_ok = SmallVec_i32_as_ptr(v)[i] == i;
+  }
+  TEST_ASSERT(all_ok, "Elements should survive the spill and later growth");
+
+  /* 清空后保留堆容量 */
+  SmallVec_i32_clear(v);
+  TEST_ASSERT(!SmallVec_i32_is_inline(v), "Clear should keep the heap buffer");
+  SmallVec_i32_push(v, 7);
+  TEST_ASSERT(SmallVec_i32_as_ptr(v)[0] == 7, "Push after clear");
+
+  /* deinit 回到空的内联状态 */
+  SmallVec_i32_deinit(v);
+  TEST_ASSERT(SmallVec_i32_is_inline(v) && SmallVec_i32_len(v) == 0, "Deinit resets to inline");
+
+  SmallVec_i32_destroy(v);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: 结构体元素与 Bump
+ * =========================================
+ */
+TEST_SUITE(test_smallvec_bump)
+{
+  SUITE_START("SmallVec Bump");
+
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+
+  SmallVec_pair v;
+  SmallVec_pair_init(&v, arena);
+  SmallVec_pair_push(&v, (Pair){1, 0.5});
+  SmallVec_pair_push(&v, (Pair){2, 1.5});
+  TEST_ASSERT(SmallVec_pair_is_inline(&v), "Two pairs should be inline");
+  TEST_ASSERT(bump_get_allocated_bytes(arena) == 0, "Inline pushes should not allocate");
+
+  SmallVec_pair_push(&v, (Pair){3, 2.5});
+  TEST_ASSERT(!SmallVec_pair_is_inline(&v), "Third pair should spill into the arena");
+  TEST_ASSERT(bump_get_allocated_bytes(arena) > 0, "Spill should allocate from the arena");
+
+  const Pair *p = SmallVec_pair_as_const_ptr(&v);
+  TEST_ASSERT(p[0].key == 1 && p[1].key == 2 && p[2].key == 3, "Keys mismatch");
+  TEST_ASSERT(p[0].value == 0.5 && p[2].value == 2.5, "Values mismatch");
+
+  bump_free(arena);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_smallvec_inline);
+  RUN_SUITE(test_smallvec_spill);
+  RUN_SUITE(test_smallvec_bump);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_soa_vector.c */
+
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/soa_vector.h>
+#include <std/test/test.h>
+
+static SystemAlloc g_sys;
+
+#define PARTICLE_FIELDS(X, ctx)                                                                    \
+  X(ctx, f32, x)                                                                                   \
+  X(ctx, f64, mass)                                                                                \
+  X(ctx, u8, flags)                                                                                \
+  X(ctx, u32, id)
+
+DEFINE_SOA_VECTOR(Particles, PARTICLE_FIELDS, SystemAlloc, SYSTEM)
+
+#define EDGE_FIELDS(X, ctx)                                                                        \
+  X(ctx, u32, from)                                                                                \
+  X(ctx, u32, to)
+
+DEFINE_SOA_VECTOR(Edges, EDGE_FIELDS, Bump, BUMP)
+
+/*
+ * =========================================
+ * 套件 1: 按行访问
+ * =========================================
+ */
+TEST_SUITE(test_soa_rows)
+{
+  SUITE_START("SoA Rows");
+
+  Particles p;
+  Particles_init(&p, &g_sys);
+  TEST_ASSERT(Particles_len(&p) == 0 && p.block == NULL, "Empty vector allocates nothing");
+
+  for (u32 i = 0; i < 1000; i++)
+  {
+    Particles_Row row = {.x = (f32)i * 0.5f, .mass = i * 2.0, .flags = (u8)i, .id = i};
+    Particles_push(&p, row);
+  }
+  TEST_ASSERT(Particles_len(&p) == 1000 && Particles_cap(&p) >= 1000, "Length should be 1000");
+
+  bool all_ok = true;
+  for (u32 i = 0; i < 1000 && all_ok; i++)
+  {
+    Particles_Row row = Particles_get(&p, i);
+    all_ok = row.x == (f32)i * 0.5f && row.mass == i * 2.0 && row.flags == (u8)i && row.id == i;
+  }
+  TEST_ASSERT(all_ok, "Rows should survive growth");
+
+  Particles_set(&p, 3, (Particles_Row){.x = -1.0f, .mass = -2.0, .flags = 7, .id = 99});
+  Particles_Row row = Particles_get(&p, 3);
+  TEST_ASSERT(row.x == -1.0f && row.mass == -2.0 && row.flags == 7 && row.id == 99, "Set row 3");
+
+  Particles_swap_remove(&p, 0);
+  TEST_ASSERT(Particles_len(&p) == 999, "Length should be 999");
+  TEST_ASSERT(Particles_get(&p, 0).id == 999, "Last row fills the hole");
+
+  Particles_clear(&p);
+  TEST_ASSERT(Particles_len(&p) == 0 && Particles_cap(&p) >= 1000, "Clear keeps capacity");
+
+  Particles_deinit(&p);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 按字段访问与单块布局
+ * =========================================
+ */
+TEST_SUITE(test_soa_fields)
+{
+  SUITE_START("SoA Fields");
+
+  Particles *p = Particles_new(&g_sys);
+  Particles_reserve_to(p, 100);
+  for (u32 i = 0; i < 100; i++)
+  {
+    Particles_push(p, (Particles_Row){.x = 1.0f, .mass = (f64)i, .flags = 0, .id = i});
+  }
+
+  /* 字段数组是连续的普通数组 */
+  f64 total = 0;
+  const f64 *mass = Particles_mass_ptr(p);
+  for (usize i = 0; i < Particles_len(p); i++)
+  {
+    total += mass[i];
+  }
+  TEST_ASSERT(total == 4950.0, "Mass column sum should be 4950, got {}", total);
+
+  u32 *ids = Particles_id_ptr(p);
+  ids[5] = 500;
+  TEST_ASSERT(Particles_get(p, 5).id == 500, "Writes through field pointers are visible");
+
+  /* 所有字段都在同一个块内, 起点按 SOA_ALIGN 对齐, 互不重叠 */
+  byte *base = (byte *)p->block;
+  byte *end = base + Particles_block_size(p->cap);
+  bool aligned = ((uintptr_t)p->x % SOA_ALIGN) == 0 && ((uintptr_t)p->mass % SOA_ALIGN) == 0 &&
+                 ((uintptr_t)p->flags % SOA_ALIGN) == 0 && ((uintptr_t)p->id % SOA_ALIGN) == 0;
+  TEST_ASSERT(aligned, "Every column should start on a SOA_ALIGN boundary");
+  TEST_ASSERT((byte *)p->x == base, "First column starts the block");
+  TEST_ASSERT((byte *)p->mass >= (byte *)(p->x + p->cap) &&
+                (byte *)p->flags >= (byte *)(p->mass + p->cap) &&
+                (byte *)p->id >= (byte *)(p->flags + p->cap) && (byte *)(p->id + p->cap) <= end,
+              "Columns should not overlap and must fit in the block");
+
+  Particles_destroy(p);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: Bump 分配器
+ * =========================================
+ */
+TEST_SUITE(test_soa_bump)
+{
+  SUITE_START("SoA Bump");
+
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+
+  Edges e;
+  Edges_init(&e, arena);
+  for (u32 i = 0; i < 300; i++)
+  {
+    Edges_push(&e, (Edges_Row){.from = i, .to = i + 1});
+  }
+  bool all_ok = true;
+  for (u32 i = 0; i < 300 && all_ok; i++)
+  {
+    all_ok = Edges_from_ptr(&e)[i] == i && Edges_to_ptr(&e)[i] == i + 1;
+  }
+  TEST_ASSERT(all_ok, "Edge columns mismatch");
+
+  bump_free(arena);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_soa_rows);
+  RUN_SUITE(test_soa_fields);
+  RUN_SUITE(test_soa_bump);
+
+  TEST_SUMMARY();
+}
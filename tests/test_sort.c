@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_sort.c */
+
+#include <core/mem/sysalc.h>
+#include <math.h>
+#include <std/sort.h>
+#include <std/test/test.h>
+#include <std/vector.h>
+
+static SystemAlloc g_sys;
+
+static inline Ordering
+cmp_u32(const u32 *a, const u32 *b)
+{
+  return *a < *b ? LESS : (*a > *b ? GREATER : EQUAL);
+}
+
+static inline Ordering
+cmp_i64_desc(const i64 *a, const i64 *b)
+{
+  return *a > *b ? LESS : (*a < *b ? GREATER : EQUAL);
+}
+
+typedef struct Pair
+{
+  u32 key;
+  u32 seq;
+} Pair;
+
+static inline Ordering
+cmp_pair(const Pair *a, const Pair *b)
+{
+  return cmp_u32(&a->key, &b->key);
+}
+
+static inline u32
+pair_key(const Pair *p)
+{
+  return p->key;
+}
+
+DEFINE_SORT(u32s, u32, cmp_u32)
+DEFINE_SORT(i64s_desc, i64, cmp_i64_desc)
+DEFINE_SORT(pairs, Pair, cmp_pair)
+DEFINE_RADIX_SORT(pairs_radix, Pair, u32, pair_key)
+DEFINE_VECTOR(Vec_u32, u32, SystemAlloc, SYSTEM)
+
+static u64 g_rng = 0x9E3779B97F4A7C15ull;
+
+static u64
+next_rand(void)
+{
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 7;
+  g_rng ^= g_rng << 17;
+  return g_rng;
+}
+
+/* 与插入排序的结果逐个比较 */
+static bool
+matches_reference(const u32 *data, const u32 *input, usize len)
+{
+  u32 *ref = ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(u32, len));
+  memcpy(ref, input, len * sizeof(u32));
+  u32s_insertion_sort(ref, ref + len);
+  bool ok = memcmp(ref, data, len * sizeof(u32)) == 0;
+  RELEASE(SYSTEM, &g_sys, ref, LAYOUT_OF_ARRAY(u32, len));
+  return ok;
+}
+
+/*
+ * =========================================
+ * 套件 1: pdqsort 在各种输入模式下的正确性
+ * =========================================
+ */
+TEST_SUITE(test_sort_patterns)
+{
+  SUITE_START("Sort Patterns");
+
+  enum
+  {
+    N = 5000
+  };
+  static u32 input[N];
+  static u32 data[N];
+
+  const char *names[] = {"random", "sorted", "reversed", "all equal", "few distinct", "organ pipe",
+                         "sorted + noise"};
+  for (usize pattern = 0; pattern < sizeof(names) / sizeof(names[0]); pattern++)
+  {
+    for (usize i = 0; i < N; i++)
+    {
+      switch (pattern)
+      {
+      case 0: input[i] = (u32)next_rand(); break;
+      case 1: input[i] = (u32)i; break;
+      case 2: input[i] = (u32)(N - i); break;
+      case 3: input[i] = 7; break;
+      case 4: input[i] = (u32)(next_rand() % 4); break;
+      case 5: input[i] = (u32)(i < N / 2 ? i : N - i); break;
+      default: input[i] = (u32)i + (next_rand() % 100 == 0 ? (u32)next_rand() : 0); break;
+      }
+    }
+    memcpy(data, input, sizeof(data));
+    u32s_sort(data, N);
+    TEST_ASSERT(u32s_is_sorted(data, N) && matches_reference(data, input, N),
+                "pdqsort should sort the '{}' pattern", names[pattern]);
+  }
+
+  /* 所有小长度 (覆盖插入排序和边界) */
+  bool all_ok = true;
+  for (usize len = 0; len < 300 && all_ok; len++)
+  {
+    for (usize i = 0; i < len; i++)
+    {
+      input[i] = (u32)(next_rand() % 50);
+    }
+    memcpy(data, input, len * sizeof(u32));
+    u32s_sort(data, len);
+    all_ok = matches_reference(data, input, len);
+  }
+  TEST_ASSERT(all_ok, "pdqsort should sort every length below 300");
+
+  /* 降序比较器 */
+  static i64 sdata[N];
+  for (usize i = 0; i < N; i++)
+  {
+    sdata[i] = (i64)next_rand();
+  }
+  i64s_desc_sort(sdata, N);
+  TEST_ASSERT(i64s_desc_is_sorted(sdata, N) && sdata[0] >= sdata[N - 1],
+              "A descending comparator yields descending order");
+
+  /* 直接对 DEFINE_VECTOR 的存储排序 */
+  Vec_u32 vec;
+  Vec_u32_init(&vec, &g_sys);
+  for (u32 i = 0; i < 1000; i++)
+  {
+    Vec_u32_push(&vec, (i * 7919u) % 1000);
+  }
+  u32s_sort(vec.data, vec.len);
+  all_ok = true;
+  for (u32 i = 0; i < 1000 && all_ok; i++)
+  {
+    all_ok = vec.data[i] == i;
+  }
+  TEST_ASSERT(all_ok, "Sorting a vector's storage yields 0..999");
+  Vec_u32_deinit(&vec);
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 堆排序保底
+ * =========================================
+ */
+TEST_SUITE(test_sort_fallback)
+{
+  SUITE_START("Sort Fallback");
+
+  enum
+  {
+    N = 2000
+  };
+  static u32 data[N];
+  for (usize i = 0; i < N; i++)
+  {
+    data[i] = (u32)next_rand();
+  }
+  u32s_heap_sort(data, data + N);
+  TEST_ASSERT(u32s_is_sorted(data, N), "Heap sort should sort random input");
+
+  /* bad_allowed = 1: 第一次不均衡划分就直接转堆排序 */
+  for (usize i = 0; i < N; i++)
+  {
+    data[i] = (u32)(i % 2 == 0 ? i : N - i);
+  }
+  u32s_pdq_loop(data, data + N, 1, true);
+  TEST_ASSERT(u32s_is_sorted(data, N), "pdqsort with no bad-partition budget still sorts");
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: 基数排序
+ * =========================================
+ */
+TEST_SUITE(test_radix_sort)
+{
+  SUITE_START("Radix Sort");
+
+  enum
+  {
+    N = 10000
+  };
+  static u32 u[N], u_ref[N], u_tmp[N];
+  for (usize i = 0; i < N; i++)
+  {
+    u[i] = u_ref[i] = (u32)next_rand();
+  }
+  radix_sort_u32(u, N, u_tmp);
+  u32s_sort(u_ref, N);
+  TEST_ASSERT(memcmp(u, u_ref, sizeof(u)) == 0, "radix_sort_u32 should match pdqsort");
+
+  /* 只有低字节不同: 高字节的三趟被跳过, 结果要回到原数组 */
+  for (usize i = 0; i < N; i++)
+  {
+    u[i] = 0xABCDEF00u | (u32)(next_rand() & 0xFF);
+  }
+  radix_sort_u32(u, N, u_tmp);
+  TEST_ASSERT(u32s_is_sorted(u, N), "Skipped passes should still leave data in place");
+
+  static i64 s[N], s_tmp[N];
+  for (usize i = 0; i < N; i++)
+  {
+    s[i] = (i64)next_rand();
+  }
+  s[0] = INT64_MIN;
+  s[1] = INT64_MAX;
+  s[2] = 0;
+  s[3] = -1;
+  radix_sort_i64(s, N, s_tmp);
+  bool all_ok = s[0] == INT64_MIN && s[N - 1] == INT64_MAX;
+  for (usize i = 1; i < N && all_ok; i++)
+  {
+    all_ok = s[i - 1] <= s[i];
+  }
+  TEST_ASSERT(all_ok, "radix_sort_i64 should order negatives before positives");
+
+  f64 f[] = {3.5, -0.0, -2.25, 1e300, 0.0, -1e300, 1e-300, -1e-300, 42.0, -42.0};
+  f64 f_tmp[sizeof(f) / sizeof(f[0])];
+  usize fn = sizeof(f) / sizeof(f[0]);
+  radix_sort_f64(f, fn, f_tmp);
+  all_ok = true;
+  for (usize i = 1; i < fn && all_ok; i++)
+  {
+    all_ok = f[i - 1] <= f[i];
+  }
+  TEST_ASSERT(all_ok && f[0] == -1e300 && f[fn - 1] == 1e300, "radix_sort_f64 orders floats");
+  TEST_ASSERT(signbit(f[4]) && !signbit(f[5]), "-0.0 sorts before +0.0");
+
+  f32 g[] = {1.5f, -1.5f, 0.25f, -100.0f, 100.0f};
+  f32 g_tmp[5];
+  radix_sort_f32(g, 5, g_tmp);
+  TEST_ASSERT(g[0] == -100.0f && g[1] == -1.5f && g[2] == 0.25f && g[4] == 100.0f,
+              "radix_sort_f32 orders floats");
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 4: 结构体键与稳定性
+ * =========================================
+ */
+TEST_SUITE(test_radix_sort_struct)
+{
+  SUITE_START("Radix Sort Struct");
+
+  enum
+  {
+    N = 4000
+  };
+  static Pair p[N], p_tmp[N], q[N];
+  for (u32 i = 0; i < N; i++)
+  {
+    p[i] = (Pair){.key = (u32)(next_rand() % 64), .seq = i};
+  }
+  memcpy(q, p, sizeof(p));
+
+  pairs_radix(p, N, p_tmp);
+  bool stable = true;
+  for (usize i = 1; i < N && stable; i++)
+  {
+    stable = p[i - 1].key < p[i].key || (p[i - 1].key == p[i].key && p[i - 1].seq < p[i].seq);
+  }
+  TEST_ASSERT(stable, "Key-extracted radix sort is stable");
+
+  pairs_sort(q, N);
+  bool same_keys = true;
+  for (usize i = 0; i < N && same_keys; i++)
+  {
+    same_keys = p[i].key == q[i].key;
+  }
+  TEST_ASSERT(pairs_is_sorted(q, N) && same_keys, "pdqsort on structs agrees on key order");
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_sort_patterns);
+  RUN_SUITE(test_sort_fallback);
+  RUN_SUITE(test_radix_sort);
+  RUN_SUITE(test_radix_sort_struct);
+
+  TEST_SUMMARY();
+}
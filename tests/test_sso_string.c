@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_sso_string.c */
+
+#include <core/mem/sysalc.h>
+#include <std/alloc/bump.h>
+#include <std/string.h>
+#include <std/test/test.h>
+
+static SystemAlloc g_sys;
+
+/*
+ * =========================================
+ * 套件 1: 内联存储 (不分配)
+ * =========================================
+ */
+TEST_SUITE(test_sso_inline)
+{
+  SUITE_START("SSO String Inline");
+
+  sso_sstring s;
+  sso_sstring_init(&s, &g_sys);
+
+  TEST_ASSERT(sizeof(sso_sstring) == 4 * sizeof(void *), "SSO header should be 4 words");
+  TEST_ASSERT(sso_sstring_len(&s) == 0, "Length should be 0");
+  TEST_ASSERT(sso_sstring_is_inline(&s), "Empty string should be inline");
+  TEST_ASSERT(str_cmp(s_as_str(&s), "") == EQUAL, "Empty string should be \"\"");
+
+  s_push_str(&s, "hello");
+  sso_sstring_push(&s, '!');
+  TEST_ASSERT(sso_sstring_len(&s) == 6, "Length should be 6");
+  TEST_ASSERT(sso_sstring_is_inline(&s), "6 bytes should stay inline");
+  TEST_ASSERT(str_cmp(s_as_str(&s), "hello!") == EQUAL, "Content mismatch");
+
+  /* 恰好填满内联缓冲区 */
+  sso_sstring_clear(&s);
+  sso_sstring_push_bytes(&s, "0123456789abcdefghijklmnopq", SSO_INLINE_CAP);
+  TEST_ASSERT(sso_sstring_len(&s) == SSO_INLINE_CAP, "Length should be SSO_INLINE_CAP");
+  TEST_ASSERT(sso_sstring_is_inline(&s), "SSO_INLINE_CAP bytes should stay inline");
+  TEST_ASSERT(str_cmp(s_as_str(&s), "0123456789abcdefghijklm") == EQUAL, "Content mismatch");
+
+  sso_sstring_deinit(&s);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 溢出到堆
+ * =========================================
+ */
+TEST_SUITE(test_sso_spill)
+{
+  SUITE_START("SSO String Spill");
+
+  sso_sstring *s = sso_sstring_new_from_str(&g_sys, "0123456789abcdefghijklm");
+  TEST_ASSERT(sso_sstring_is_inline(s), "23 bytes should be inline");
+
+  sso_sstring_push(s, 'n');
+  TEST_ASSERT(!sso_sstring_is_inline(s), "24 bytes should spill to the heap");
+  TEST_ASSERT(sso_sstring_len(s) == 24, "Length should be 24");
+  TEST_ASSERT(sso_sstring_cap(s) >= 24, "Capacity should be >= 24");
+  TEST_ASSERT(str_cmp(s_as_str(s), "0123456789abcdefghijklmn") == EQUAL, "Content mismatch");
+
+  for (int i = 0; i < 100; i++)
+  {
+    s_push_str(s, "xy");
+  }
+  TEST_ASSERT(sso_sstring_len(s) == 224, "Length should be 224");
+  TEST_ASSERT(s_as_str(s)[223] == 'y' && s_as_str(s)[224] == '\0', "Tail mismatch");
+
+  /* clear 保留堆容量 */
+  usize cap = sso_sstring_cap(s);
+  sso_sstring_clear(s);
+  TEST_ASSERT(sso_sstring_len(s) == 0, "Length should be 0 after clear");
+  TEST_ASSERT(sso_sstring_cap(s) == cap, "Clear should keep capacity");
+  TEST_ASSERT(str_cmp(s_as_str(s), "") == EQUAL, "Cleared string should be \"\"");
+
+  sso_sstring_destroy(s);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: s_format 与 Bump 变体
+ * =========================================
+ */
+TEST_SUITE(test_sso_format)
+{
+  SUITE_START("SSO String Format");
+
+  Bump *arena = oexpect(bump_new(&g_sys), "Failed to create arena");
+
+  sso_bstring b;
+  sso_bstring_init(&b, arena);
+  s_format(&b, "id={} ok={}", 42, (char)'y');
+  TEST_ASSERT(sso_bstring_is_inline(&b), "Short formatted output should be inline");
+  TEST_ASSERT(str_cmp(s_as_str(&b), "id=42 ok=y") == EQUAL, "Format mismatch: {}", s_as_str(&b));
+
+  s_format(&b, " and a rather long tail: {}", "spilling into the arena");
+  TEST_ASSERT(!sso_bstring_is_inline(&b), "Long formatted output should spill");
+  TEST_ASSERT(str_cmp(s_as_str(&b), "id=42 ok=y and a rather long tail: spilling into the arena") ==
+                EQUAL,
+              "Format mismatch: {}",
+              s_as_str(&b));
+
+  sso_sstring s;
+  sso_sstring_init(&s, &g_sys);
+  s_format(&s, "{}-{}", "a", "b");
+  TEST_ASSERT(str_cmp(s_as_str(&s), "a-b") == EQUAL, "sso_sstring format mismatch");
+  sso_sstring_deinit(&s);
+
+  bump_free(arena);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_sso_inline);
+  RUN_SUITE(test_sso_spill);
+  RUN_SUITE(test_sso_format);
+
+  TEST_SUMMARY();
+}
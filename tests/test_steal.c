@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_steal.c */
+
+#include <core/mem/sysalc.h>
+#include <std/test/test.h>
+#include <std/thread/steal.h>
+#include <stdatomic.h>
+
+static SystemAlloc g_sys;
+
+/*
+ * =========================================
+ * 任务
+ * =========================================
+ */
+
+typedef struct Fib
+{
+  u32 n;
+  u64 result;
+} Fib;
+
+static void
+fib_task(void *ctx)
+{
+  Fib *f = (Fib *)ctx;
+  if (f->n < 2)
+  {
+    f->result = f->n;
+    return;
+  }
+  Fib a = {.n = f->n - 1};
+  Fib b = {.n = f->n - 2};
+  StealTask *t = steal_spawn(fib_task, &a);
+  fib_task(&b);
+  steal_join(t);
+  f->result = a.result + b.result;
+}
+
+static u64
+fib_seq(u32 n)
+{
+  return n < 2 ? n : fib_seq(n - 1) + fib_seq(n - 2);
+}
+
+/* 一个任务先 spawn 很多子任务再统一 join: 队列需要扩容 */
+#define WIDE 3000
+
+typedef struct Wide
+{
+  _Atomic u32 hits[WIDE];
+  _Atomic usize bad_index;
+} Wide;
+
+static Wide g_wide;
+static usize g_threads;
+
+static void
+wide_leaf(void *ctx)
+{
+  usize i = (usize)((_Atomic u32 *)ctx - g_wide.hits);
+  atomic_fetch_add(&g_wide.hits[i], 1);
+  if (steal_worker_index() >= g_threads)
+  {
+    atomic_fetch_add(&g_wide.bad_index, 1);
+  }
+}
+
+static void
+wide_root(void *ctx)
+{
+  (void)ctx;
+  static StealTask *tasks[WIDE];
+  for (usize i = 0; i < WIDE; i++)
+  {
+    tasks[i] = steal_spawn(wide_leaf, &g_wide.hits[i]);
+  }
+  /* 按 spawn 的顺序 join (不是 LIFO) */
+  for (usize i = 0; i < WIDE; i++)
+  {
+    steal_join(tasks[i]);
+  }
+}
+
+/* 在任务内部再次调用 steal_pool_run: 直接执行 */
+typedef struct Nested
+{
+  StealPool *pool;
+  Fib fib;
+} Nested;
+
+static void
+nested_task(void *ctx)
+{
+  Nested *n = (Nested *)ctx;
+  steal_pool_run(n->pool, fib_task, &n->fib);
+}
+
+/*
+ * =========================================
+ * 套件
+ * =========================================
+ */
+
+TEST_SUITE(test_steal_fork_join)
+{
+  SUITE_START("Steal Fork Join");
+
+  /* 没有池: spawn 立即执行 */
+  Fib f = {.n = 20};
+  steal_pool_run(NULL, fib_task, &f);
+  TEST_ASSERT(f.result == fib_seq(20), "NULL pool runs fib sequentially");
+  TEST_ASSERT(steal_worker_index() == STEAL_NO_WORKER, "Main thread is not a worker");
+
+  static const usize counts[] = {1, 2, 4, 8};
+  for (usize c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+  {
+    StealPool *pool = oexpect(steal_pool_new(&g_sys, counts[c]), "Failed to create pool");
+    g_threads = steal_pool_threads(pool);
+
+    f = (Fib){.n = 24};
+    steal_pool_run(pool, fib_task, &f);
+    TEST_ASSERT(f.result == 46368, "fib(24) with {} thread(s)", counts[c]);
+
+    /* 多次小批量: 工作线程反复睡眠 / 唤醒 */
+    bool all_ok = true;
+    for (u32 round = 0; round < 200 && all_ok; round++)
+    {
+      f = (Fib){.n = round % 12};
+      steal_pool_run(pool, fib_task, &f);
+      all_ok = f.result == fib_seq(round % 12);
+    }
+    TEST_ASSERT(all_ok, "200 small runs with {} thread(s)", counts[c]);
+
+    for (usize i = 0; i < WIDE; i++)
+    {
+      atomic_store(&g_wide.hits[i], 0);
+    }
+    atomic_store(&g_wide.bad_index, 0);
+    steal_pool_run(pool, wide_root, NULL);
+    bool once = true;
+    for (usize i = 0; i < WIDE; i++)
+    {
+      once = once && atomic_load(&g_wide.hits[i]) == 1;
+    }
+    TEST_ASSERT(once && atomic_load(&g_wide.bad_index) == 0,
+                "3000 spawns before any join run exactly once ({} thread(s))",
+                counts[c]);
+
+    Nested n = {.pool = pool, .fib = {.n = 18}};
+    steal_pool_run(pool, nested_task, &n);
+    TEST_ASSERT(n.fib.result == fib_seq(18), "Nested steal_pool_run runs inline");
+
+    steal_pool_free(pool);
+  }
+
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_steal_fork_join);
+
+  TEST_SUMMARY();
+}
@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_taskgraph.c */
+
+#include <core/mem/sysalc.h>
+#include <std/test/test.h>
+#include <std/thread/taskgraph.h>
+
+static SystemAlloc g_sys;
+
+/*
+ * 每个任务的 ctx 是一个 Cell: 输出 = 自身的值 + 所有输入之和。
+ * fail 非 0 时任务失败; calls 记录执行次数。
+ */
+typedef struct Cell
+{
+  i64 own;
+  i64 out;
+  i32 fail;
+  _Atomic usize calls;
+} Cell;
+
+static TaskResult
+cell_task(void *ctx, const anyptr *inputs, usize ninputs)
+{
+  Cell *c = (Cell *)ctx;
+  atomic_fetch_add(&c->calls, 1);
+  if (c->fail != 0)
+  {
+    return TASK_FAIL(c->fail, "cell failed");
+  }
+  i64 sum = c->own;
+  for (usize i = 0; i < ninputs; i++)
+  {
+    sum += ((const Cell *)inputs[i])->out;
+  }
+  c->out = sum;
+  return TASK_OK(c);
+}
+
+static i64
+cell_value(TaskGraph *g, TaskId id)
+{
+  return ((Cell *)rexpect(task_graph_result(g, id), "Task should succeed"))->out;
+}
+
+/*
+ * =========================================
+ * 套件 1: 依赖与输出
+ * =========================================
+ */
+static void
+check_diamond(StealPool *pool)
+{
+  /*   a
+   *  / \
+   * b   c
+   *  \ /
+   *   d     e (独立)
+   */
+  TaskGraph *g = oexpect(task_graph_new(&g_sys), "Failed to create graph");
+  Cell cells[5] = {{.own = 1}, {.own = 10}, {.own = 100}, {.own = 1000}, {.own = 7}};
+  TaskId a = task_graph_add(g, cell_task, &cells[0], NULL, 0);
+  TaskId b = task_graph_add(g, cell_task, &cells[1], (TaskId[]){a}, 1);
+  TaskId c = task_graph_add(g, cell_task, &cells[2], (TaskId[]){a}, 1);
+  TaskId d = task_graph_add(g, cell_task, &cells[3], (TaskId[]){b, c}, 2);
+  TaskId e = task_graph_add(g, cell_task, &cells[4], NULL, 0);
+  TEST_ASSERT(task_graph_len(g) == 5 && a == 0 && e == 4, "Ids are assigned in order");
+
+  TEST_ASSERT(task_graph_run(g, pool), "Diamond runs without errors");
+  TEST_ASSERT(cell_value(g, b) == 11 && cell_value(g, c) == 101, "Inputs carry the Ok values");
+  TEST_ASSERT(cell_value(g, d) == 1112, "Join node sees both branches (got {})", cell_value(g, d));
+  TEST_ASSERT(cell_value(g, e) == 7, "Independent source runs");
+
+  /* 再次执行: 每个任务恰好再执行一次 */
+  cells[0].own = 2;
+  TEST_ASSERT(task_graph_run(g, pool), "Graph can be run again");
+  TEST_ASSERT(cell_value(g, d) == 1114, "Rerun recomputes downstream results");
+  bool once = true;
+  for (usize i = 0; i < 5; i++)
+  {
+    once = once && atomic_load(&cells[i].calls) == 2;
+  }
+  TEST_ASSERT(once, "Every task ran exactly once per run");
+
+  /* 运行之后还能继续添加任务 */
+  Cell f = {.own = 5};
+  TaskId fid = task_graph_add(g, cell_task, &f, (TaskId[]){d, d, e}, 3);
+  TEST_ASSERT(task_graph_run(g, pool) && cell_value(g, fid) == 5 + 1114 * 2 + 7,
+              "Tasks added after a run are wired in (duplicate edges count twice)");
+
+  task_graph_free(g);
+}
+
+TEST_SUITE(test_taskgraph_basic)
+{
+  SUITE_START("TaskGraph Basic");
+
+  check_diamond(NULL);
+  StealPool *pool = oexpect(steal_pool_new(&g_sys, 4), "Failed to create pool");
+  check_diamond(pool);
+
+  TaskGraph *g = oexpect(task_graph_new(&g_sys), "Failed to create graph");
+  TEST_ASSERT(task_graph_run(g, pool), "Empty graph succeeds");
+  task_graph_free(g);
+
+  steal_pool_free(pool);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 错误沿边传播
+ * =========================================
+ */
+TEST_SUITE(test_taskgraph_errors)
+{
+  SUITE_START("TaskGraph Errors");
+
+  StealPool *pool = oexpect(steal_pool_new(&g_sys, 4), "Failed to create pool");
+  TaskGraph *g = oexpect(task_graph_new(&g_sys), "Failed to create graph");
+
+  /* parse -> intern -> analyze, 另有一条与 parse 无关的分支 */
+  Cell parse = {.own = 1, .fail = 42};
+  Cell intern = {.own = 2};
+  Cell analyze = {.own = 3};
+  Cell other = {.own = 4};
+  Cell report = {.own = 5};
+  TaskId p = task_graph_add(g, cell_task, &parse, NULL, 0);
+  TaskId i = task_graph_add(g, cell_task, &intern, (TaskId[]){p}, 1);
+  TaskId o = task_graph_add(g, cell_task, &other, NULL, 0);
+  TaskId a = task_graph_add(g, cell_task, &analyze, (TaskId[]){o, i}, 2);
+  TaskId r = task_graph_add(g, cell_task, &report, (TaskId[]){o}, 1);
+
+  TEST_ASSERT(!task_graph_run(g, pool), "Run reports the failure");
+  TaskError e = rexpect_err(task_graph_result(g, p), "parse should fail");
+  TEST_ASSERT(e.code == 42 && e.origin == p, "Failing task's error has its own id as origin");
+  e = rexpect_err(task_graph_result(g, a), "analyze should fail");
+  TEST_ASSERT(e.code == 42 && e.origin == p, "Error propagates two edges down with its origin");
+  TEST_ASSERT(atomic_load(&intern.calls) == 0 && atomic_load(&analyze.calls) == 0,
+              "Downstream tasks of a failure are skipped");
+  TEST_ASSERT(cell_value(g, r) == 9 && atomic_load(&other.calls) == 1,
+              "Unrelated branches still run");
+
+  /* 两个依赖都失败: 取声明顺序中的第一个 */
+  other.fail = 7;
+  task_graph_run(g, pool);
+  e = rexpect_err(task_graph_result(g, a), "analyze should fail");
+  TEST_ASSERT(e.origin == o && e.code == 7, "First failing dependency in declaration order wins");
+
+  parse.fail = 0;
+  other.fail = 0;
+  TEST_ASSERT(task_graph_run(g, pool) && cell_value(g, a) == 3 + 4 + (2 + 1),
+              "Graph recovers once the errors are gone");
+
+  task_graph_free(g);
+  steal_pool_free(pool);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: 大图
+ * =========================================
+ */
+
+#define CHAIN_LEN 200000
+#define DAG_NODES 4000
+#define DAG_MAX_DEPS 4
+
+/* 输出 = 1 + 所有输入之和 (对依赖做树形计数), 用 u64 避免溢出问题 */
+static TaskResult
+count_task(void *ctx, const anyptr *inputs, usize ninputs)
+{
+  u64 *out = (u64 *)ctx;
+  u64 sum = 1;
+  for (usize i = 0; i < ninputs; i++)
+  {
+    sum += *(const u64 *)inputs[i];
+  }
+  *out = sum;
+  return TASK_OK(out);
+}
+
+TEST_SUITE(test_taskgraph_large)
+{
+  SUITE_START("TaskGraph Large");
+
+  StealPool *pool = oexpect(steal_pool_new(&g_sys, 4), "Failed to create pool");
+
+  /* 长链: 原地继续执行, 不能递归 CHAIN_LEN 层 */
+  TaskGraph *chain = oexpect(task_graph_new(&g_sys), "Failed to create graph");
+  u64 *chain_out = ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(u64, CHAIN_LEN));
+  TaskId prev = task_graph_add(chain, count_task, &chain_out[0], NULL, 0);
+  for (usize k = 1; k < CHAIN_LEN; k++)
+  {
+    prev = task_graph_add(chain, count_task, &chain_out[k], &prev, 1);
+  }
+  TEST_ASSERT(task_graph_run(chain, pool) && chain_out[CHAIN_LEN - 1] == CHAIN_LEN,
+              "Chain of {} tasks runs to the end",
+              (usize)CHAIN_LEN);
+  task_graph_free(chain);
+  RELEASE(SYSTEM, &g_sys, chain_out, LAYOUT_OF_ARRAY(u64, CHAIN_LEN));
+
+  /* 随机 DAG: 与顺序执行的参考结果逐个比较 */
+  TaskGraph *g = oexpect(task_graph_new(&g_sys), "Failed to create graph");
+  u64 *out = ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(u64, DAG_NODES));
+  u64 *expect = ALLOC(SYSTEM, &g_sys, LAYOUT_OF_ARRAY(u64, DAG_NODES));
+  u64 rng = 0x9E3779B97F4A7C15ull;
+  for (usize k = 0; k < DAG_NODES; k++)
+  {
+    TaskId deps[DAG_MAX_DEPS];
+    usize ndeps = 0;
+    if (k != 0)
+    {
+      rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+      ndeps = (rng >> 33) % (DAG_MAX_DEPS + 1);
+      for (usize j = 0; j < ndeps; j++)
+      {
+        rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+        /* 偏向最近的任务, 让图既有深度也有宽度 */
+        usize back = 1 + (rng >> 33) % (k < 64 ? k : 64);
+        deps[j] = k - back;
+      }
+    }
+    task_graph_add(g, count_task, &out[k], deps, ndeps);
+    expect[k] = 1;
+    for (usize j = 0; j < ndeps; j++)
+    {
+      expect[k] += expect[deps[j]];
+    }
+  }
+
+  bool all_match = true;
+  for (int round = 0; round < 5; round++)
+  {
+    task_graph_run(g, round == 0 ? NULL : pool);
+    for (usize k = 0; k < DAG_NODES; k++)
+    {
+      all_match = all_match && out[k] == expect[k];
+    }
+  }
+  TEST_ASSERT(all_match, "Random DAG matches the sequential reference, with and without a pool");
+
+  task_graph_free(g);
+  RELEASE(SYSTEM, &g_sys, out, LAYOUT_OF_ARRAY(u64, DAG_NODES));
+  RELEASE(SYSTEM, &g_sys, expect, LAYOUT_OF_ARRAY(u64, DAG_NODES));
+  steal_pool_free(pool);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_taskgraph_basic);
+  RUN_SUITE(test_taskgraph_errors);
+  RUN_SUITE(test_taskgraph_large);
+
+  TEST_SUMMARY();
+}
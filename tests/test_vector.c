@@ -76,6 +76,83 @@ TEST_SUITE(test_vector_push)
   SUITE_END();
 }
 
+/*
+ * =s=======================================
+ * 套件 3: 批量操作
+ * =s=======================================
+ */
+
+/* 检查 vec 的内容是否与 expected 完全相同 */
+static bool
+vec_equals(const Vec_i32 *vec, const int *expected, usize count)
+{
+  if (vec->len != count)
+  {
+    return false;
+  }
+  for (usize i = 0; i < count; i++)
+  {
+    if (vec->data[i] != expected[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST_SUITE(test_vector_bulk)
+{
+  SUITE_START("Vector Bulk");
+  Vec_i32 vec;
+  Vec_i32_init(&vec, &g_sys);
+
+  int items[] = {1, 2, 3, 4, 5};
+  Vec_i32_extend_from_slice(&vec, items, 5);
+  TEST_ASSERT(vec_equals(&vec, items, 5), "Extend should append all items");
+  TEST_ASSERT(vec.cap == 8, "Extend should reserve once (cap {})", vec.cap);
+
+  /* 一次追加超过翻倍的量: 容量直接取所需值 */
+  int many[20] = {0};
+  Vec_i32_extend_from_slice(&vec, many, 20);
+  TEST_ASSERT(vec.len == 25 && vec.cap == 25, "Large extend should reserve exactly");
+  Vec_i32_truncate(&vec, 5);
+  TEST_ASSERT(vec_equals(&vec, items, 5), "Truncate should keep the prefix");
+  Vec_i32_truncate(&vec, 100);
+  TEST_ASSERT(vec.len == 5, "Truncate past len is a no-op");
+
+  int mid[] = {8, 9};
+  Vec_i32_insert_range(&vec, 2, mid, 2);
+  TEST_ASSERT(vec_equals(&vec, (int[]){1, 2, 8, 9, 3, 4, 5}, 7), "Insert range in the middle");
+  Vec_i32_insert_range(&vec, 0, mid, 1);
+  Vec_i32_insert_range(&vec, vec.len, mid + 1, 1);
+  TEST_ASSERT(vec_equals(&vec, (int[]){8, 1, 2, 8, 9, 3, 4, 5, 9}, 9), "Insert at both ends");
+
+  Vec_i32_remove_range(&vec, 3, 5);
+  TEST_ASSERT(vec_equals(&vec, (int[]){8, 1, 2, 3, 4, 5, 9}, 7), "Remove range");
+  Vec_i32_remove_range(&vec, 2, 2);
+  TEST_ASSERT(vec.len == 7, "Empty range removes nothing");
+
+  int removed = Vec_i32_swap_remove(&vec, 0);
+  TEST_ASSERT(removed == 8, "swap_remove should return the element");
+  TEST_ASSERT(vec_equals(&vec, (int[]){9, 1, 2, 3, 4, 5}, 6), "Last element fills the hole");
+
+  int last = 0;
+  TEST_ASSERT(Vec_i32_pop(&vec, &last) && last == 5, "Pop should return 5");
+  TEST_ASSERT(Vec_i32_pop(&vec, NULL) && vec.len == 4, "Pop with NULL out");
+
+  Vec_i32_resize_with(&vec, 7, -1);
+  TEST_ASSERT(vec_equals(&vec, (int[]){9, 1, 2, 3, -1, -1, -1}, 7), "Resize should fill");
+  Vec_i32_resize_with(&vec, 2, 0);
+  TEST_ASSERT(vec_equals(&vec, (int[]){9, 1}, 2), "Resize should shrink");
+
+  Vec_i32_clear(&vec);
+  TEST_ASSERT(!Vec_i32_pop(&vec, &last), "Pop on empty vector should fail");
+
+  Vec_i32_deinit(&vec);
+
+  SUITE_END();
+}
+
 /*
  * =s=======================================
  * 主测试运行器 (Test Runner Main)
@@ -86,6 +163,7 @@ main(void)
 {
   RUN_SUITE(test_vector_init);
   RUN_SUITE(test_vector_push);
+  RUN_SUITE(test_vector_bulk);
 
   // ... (运行 test_string.c 中的套件)
   // (你需要在 main 中调用所有测试函数)
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2025 Karesis
+ *
+ * This file is part of libkx.
+ *
+ * libkx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libkx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* tests/test_vformat.c */
+
+#include <core/fmt/vformat.h>
+#include <core/mem/sysalc.h>
+#include <std/string.h>
+#include <std/test/test.h>
+
+static SystemAlloc g_sys;
+
+/*
+ * =========================================
+ * 套件 1: fmt_compile 段表
+ * =========================================
+ */
+TEST_SUITE(test_fmt_compile)
+{
+  SUITE_START("Fmt Compile");
+
+  FmtCompiled c;
+  TEST_ASSERT(fmt_compile(&c, "id={} name={}\n"), "Compile failed");
+  TEST_ASSERT(c.nseg == 3, "Expected 3 segments, got {}", c.nseg);
+  TEST_ASSERT(c.segs[0].start == 0 && c.segs[0].len == 3, "Segment 0 should be \"id=\"");
+  TEST_ASSERT(c.segs[1].start == 5 && c.segs[1].len == 6, "Segment 1 should be \" name=\"");
+  TEST_ASSERT(c.segs[2].start == 13 && c.segs[2].len == 1, "Segment 2 should be \"\\n\"");
+
+  TEST_ASSERT(fmt_compile(&c, "{}{}"), "Compile failed");
+  TEST_ASSERT(c.nseg == 3 && c.segs[0].len == 0 && c.segs[1].len == 0 && c.segs[2].len == 0,
+              "Adjacent placeholders should give empty segments");
+
+  TEST_ASSERT(fmt_compile(&c, "a{b}{"), "Compile failed");
+  TEST_ASSERT(c.nseg == 1 && c.segs[0].len == 5, "Lone braces are literal text");
+
+  /* 超过 FMT_MAX_ARGS 个占位符: 多余的并入最后一段 */
+  TEST_ASSERT(fmt_compile(&c, "{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}!"), "Compile failed");
+  TEST_ASSERT(c.nseg == FMT_MAX_ARGS + 1, "Slots should be capped at FMT_MAX_ARGS");
+  TEST_ASSERT(c.segs[FMT_MAX_ARGS].len == 5, "Tail should hold \"{}{}!\"");
+
+  /* 格式说明在编译时解析一次 */
+  TEST_ASSERT(fmt_compile(&c, "x={:*>8.2} y={:08X}"), "Compile failed");
+  TEST_ASSERT(c.nseg == 3 && c.segs[1].start == 10 && c.segs[1].len == 3, "Spec segments");
+  TEST_ASSERT(c.specs[0].fill == '*' && c.specs[0].align == FMT_ALIGN_RIGHT &&
+                c.specs[0].width == 8 && c.specs[0].precision == 2,
+              "Spec 0 should be fill '*', right, width 8, precision 2");
+  TEST_ASSERT(c.specs[1].zero_pad && c.specs[1].width == 8 && c.specs[1].type == 'X' &&
+                c.specs[1].precision == FMT_NO_PRECISION,
+              "Spec 1 should be zero-padded upper hex of width 8");
+
+  TEST_ASSERT(!fmt_compile(&c, NULL), "NULL fmt should fail");
+
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 2: 调用点缓存
+ * =========================================
+ */
+static void
+format_with(sstring *s, const char *fmt, int a, int b)
+{
+  /* 同一调用点, 但格式串不是字面量 */
+  s_format(s, fmt, a, b);
+}
+
+/* 另一个调用点: 第一次编译的就是可变缓冲区 */
+static void
+format_buf_with(sstring *s, const char *fmt, int a, int b)
+{
+  s_format(s, fmt, a, b);
+}
+
+TEST_SUITE(test_fmt_cache)
+{
+  SUITE_START("Fmt Cache");
+
+  sstring *s = sstring_new(&g_sys);
+
+  /* 同一调用点执行多次: 第一次编译, 之后走缓存, 结果必须一致 */
+  str expected[3] = {"[add] 0 + 0 = 0.", "[add] 1 + 1 = 2.", "[add] 2 + 2 = 4."};
+  for (int i = 0; i < 3; i++)
+  {
+    sstring_clear(s);
+    s_format(s, "[{}] {} + {} = {}{}", "add", i, i, i + i, (char)'.');
+    TEST_ASSERT(str_cmp(s_as_str(s), expected[i]) == EQUAL,
+                "Cached format mismatch: {}",
+                s_as_str(s));
+  }
+
+  /* 参数不足时保留 "{}" */
+  for (int i = 0; i < 2; i++)
+  {
+    sstring_clear(s);
+    s_format(s, "x={} y={}", 7);
+    TEST_ASSERT(str_cmp(s_as_str(s), "x=7 y={}") == EQUAL, "Missing arg mismatch: {}", s_as_str(s));
+  }
+
+  /* 非字面量格式串: 缓存校验失败时退回运行时解析 */
+  sstring_clear(s);
+  format_with(s, "{}-{};", 1, 2);
+  format_with(s, "<{}|{}>", 3, 4);
+  format_with(s, "{}-{};", 5, 6);
+  TEST_ASSERT(str_cmp(s_as_str(s), "1-2;<3|4>5-6;") == EQUAL,
+              "Non-literal fmt mismatch: {}",
+              s_as_str(s));
+
+  /* 同一地址换了内容 (栈上缓冲区被复用): 不能复用旧的段表 */
+  char buf[32];
+  sstring_clear(s);
+  strcpy(buf, "[{}, {}] and more text");
+  format_buf_with(s, buf, 1, 2);
+  format_buf_with(s, buf, 3, 4);
+  strcpy(buf, "{}+{}");
+  format_buf_with(s, buf, 5, 6);
+  strcpy(buf, "<{}|{}> and more text");
+  format_buf_with(s, buf, 7, 8);
+  str reused = "[1, 2] and more text[3, 4] and more text5+6<7|8> and more text";
+  TEST_ASSERT(
+    str_cmp(s_as_str(s), reused) == EQUAL, "Reused buffer fmt mismatch: {}", s_as_str(s));
+
+  /* 只有字面量进入缓存; 缓冲区里的格式串不编译, 也不占用缓存 */
+  TEST_ASSERT(FMT_CACHE_LOOKUP("a={} b={}") != NULL, "Literal fmt should be cached");
+  TEST_ASSERT(FMT_CACHE_LOOKUP(buf) == NULL, "Non-literal fmt should bypass the cache");
+
+  sstring_destroy(s);
+  SUITE_END();
+}
+
+/*
+ * =========================================
+ * 套件 3: 格式说明 "{:...}"
+ * =========================================
+ */
+#define EXPECT_FORMAT(s, expected, fmt, ...)                                                       \
+  do                                                                                               \
+  {                                                                                                \
+    sstring_clear(s);                                                                              \
+    s_format(s, fmt, __VA_ARGS__);                                                                 \
+    TEST_ASSERT(str_cmp(s_as_str(s), expected) == EQUAL,                                           \
+                "\"{}\": expected \"{}\", got \"{}\"",                                             \
+                (str)fmt,                                                                          \
+                (str)expected,                                                                     \
+                s_as_str(s));                                                                      \
+  } while (0)
+
+static void
+format_runtime(sstring *s, const char *fmt, i32 value)
+{
+  s_format(s, fmt, value);
+}
+
+TEST_SUITE(test_fmt_specs)
+{
+  SUITE_START("Fmt Specs");
+
+  sstring *s = sstring_new(&g_sys);
+
+  /* 进制: 有符号数按类型宽度取补码 */
+  EXPECT_FORMAT(s, "ff FF 1010", "{:x} {:X} {:b}", 255, 255, 10);
+  EXPECT_FORMAT(s, "ff ffff", "{:x} {:x}", (i8)-1, (i16)-1);
+  EXPECT_FORMAT(s, "ffffffffffffffff", "{:x}", (i64)-1);
+  EXPECT_FORMAT(s, "000000ff", "{:08x}", 255u);
+
+  /* 宽度和 0 填充: 符号在 0 之前 */
+  EXPECT_FORMAT(s, "00042|-0042", "{:05}|{:05}", 42, -42);
+  EXPECT_FORMAT(s, "123456", "{:03}", 123456);
+
+  /* 对齐和填充字符: 数字默认右对齐, 其余默认左对齐 */
+  EXPECT_FORMAT(s, "[   42][ab   ]", "[{:5}][{:5}]", 42, "ab");
+  EXPECT_FORMAT(s, "[42   ][   ab]", "[{:<5}][{:>5}]", 42, "ab");
+  EXPECT_FORMAT(s, "[*ab**][-x-]", "[{:*^5}][{:-^3}]", "ab", (char)'x');
+  EXPECT_FORMAT(s, "[ééé  ]", "[{:<5}]", "ééé");
+  EXPECT_FORMAT(s, "________________________________________42", "{:_>42}", 42);
+
+  /* 精度: 按精确的二进制值舍入 */
+  EXPECT_FORMAT(s, "2.67 0.12 3", "{:.2} {:.2} {:.0}", 2.675, 0.125, 3.14159);
+  EXPECT_FORMAT(s, "   -1.500", "{:9.3}", -1.5);
+  EXPECT_FORMAT(s, "-0001.500", "{:09.3}", -1.5);
+  EXPECT_FORMAT(s, "0.100", "{:.3}", 0.1f);
+
+  /* 非法的格式说明是字面文本 */
+  EXPECT_FORMAT(s, "{:q} {:.} {:.20} 1", "{:q} {:.} {:.20} {}", 1);
+  EXPECT_FORMAT(s, "{:5", "{:5", 1);
+
+  /* 参数不足: 占位符原文保留 (编译路径与运行时路径一致) */
+  for (int i = 0; i < 2; i++)
+  {
+    EXPECT_FORMAT(s, "7 {:>4x}!", "{} {:>4x}!", 7);
+  }
+
+  /* 运行时解析 (非字面量格式串) 与预编译段表的结果一致 */
+  sstring_clear(s);
+  format_runtime(s, "<{:>6x}>", 0xbeef);
+  format_runtime(s, "<{:^7}>", -12);
+  format_runtime(s, "<{:>6x}>", 0xbeef);
+  TEST_ASSERT(str_cmp(s_as_str(s), "<  beef><  -12  ><  beef>") == EQUAL,
+              "Runtime spec mismatch: {}",
+              s_as_str(s));
+
+  sstring_destroy(s);
+  SUITE_END();
+}
+
+int
+main(void)
+{
+  RUN_SUITE(test_fmt_compile);
+  RUN_SUITE(test_fmt_cache);
+  RUN_SUITE(test_fmt_specs);
+
+  TEST_SUMMARY();
+}